@@ -94,6 +94,36 @@ SuiteSparse_long amd_l_order_partial        /* returns AMD_OK, AMD_OK_BUT_JUMBLE
     SuiteSparse_long orderingMethod         /* indicates partial ordering mode */
 ) ;
 
+/* amd_par_order: multithreaded AMD.  Pivots of low approximate degree that
+ * are at least distance 3 apart in the quotient graph of A+A' are eliminated
+ * concurrently (with OpenMP, if AMD is compiled with it).  Arguments are as
+ * for amd_order, plus nthreads (if <= 0, the OpenMP default is used).  The
+ * pivots are chosen deterministically, so the permutation depends only on A,
+ * not on the thread schedule nor on nthreads > 1.  Small matrices, and
+ * nthreads = 1, are ordered by amd_order. */
+int amd_par_order              /* returns AMD_OK, AMD_OK_BUT_JUMBLED,
+                                * AMD_INVALID, or AMD_OUT_OF_MEMORY */
+(
+    int n,                     /* A is n-by-n.  n must be >= 0. */
+    const int Ap [ ],          /* column pointers for A, of size n+1 */
+    const int Ai [ ],          /* row indices of A, of size nz = Ap [n] */
+    int P [ ],                 /* output permutation, of size n */
+    double Control [ ],        /* input Control settings, of size AMD_CONTROL */
+    double Info [ ],           /* output Info statistics, of size AMD_INFO */
+    int nthreads               /* number of threads */
+) ;
+
+SuiteSparse_long amd_l_par_order    /* see above for description of arguments */
+(
+    SuiteSparse_long n,
+    const SuiteSparse_long Ap [ ],
+    const SuiteSparse_long Ai [ ],
+    SuiteSparse_long P [ ],
+    double Control [ ],
+    double Info [ ],
+    SuiteSparse_long nthreads
+) ;
+
 /* Input arguments (not modified):
  *
  *       n: the matrix A is n-by-n.
@@ -440,6 +470,8 @@ void amd_l_info     (double Info [ ]) ;
 #define AMD_ORDERING (0)
 #define AMD_ORDERING_NV (1)
 #define AMD_ORDERING_RA (2)
+#define AMD_ORDERING_CAMD (3)   /* klu_analyze_partial only: CAMD, with the
+                                 * varying columns last in each block */
 
 #define AMD_CONTROL 5          /* size of Control array */
 #define AMD_INFO 20            /* size of Info array */
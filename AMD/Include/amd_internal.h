@@ -161,15 +161,19 @@
 
 #define AMD_order amd_l_order
 #define AMD_order_partial amd_l_order_partial
+#define AMD_par_order amd_l_par_order
 #define AMD_defaults amd_l_defaults
 #define AMD_control amd_l_control
 #define AMD_info amd_l_info
 #define AMD_1 amd_l1
+#define AMD_1_par amd_l1_par
 #define AMD_2 amd_l2
 #define AMD_RA amd_l_ra
 #define AMD_NV amd_l_nv
 #define AMD_valid amd_l_valid
 #define AMD_aat amd_l_aat
+#define AMD_aat_par amd_l_aat_par
+#define AMD_aat_scatter amd_l_aat_scatter
 #define AMD_postorder amd_l_postorder
 #define AMD_postorder_partial amd_l_postorder_partial
 #define AMD_post_tree amd_l_post_tree
@@ -186,16 +190,20 @@
 
 #define AMD_order amd_order
 #define AMD_order_partial amd_order_partial
+#define AMD_par_order amd_par_order
 #define AMD_defaults amd_defaults
 #define AMD_control amd_control
 #define AMD_info amd_info
 #define AMD_1 amd_1
+#define AMD_1_par amd_1_par
 #define AMD_1_partial amd_1_partial
 #define AMD_2 amd_2
 #define AMD_RA amd_ra
 #define AMD_NV amd_nv
 #define AMD_valid amd_valid
 #define AMD_aat amd_aat
+#define AMD_aat_par amd_aat_par
+#define AMD_aat_scatter amd_aat_scatter
 #define AMD_postorder amd_postorder
 #define AMD_postorder_partial amd_postorder_partial
 #define AMD_post_tree amd_post_tree
@@ -220,6 +228,33 @@ GLOBAL size_t AMD_aat
     double Info [ ]
 ) ;
 
+/* A+A' is built by AMD_aat_par and AMD_1_par instead of AMD_aat and AMD_1
+ * for matrices of this size or larger */
+#define AMD_AAT_PAR_MIN 10000
+
+GLOBAL size_t AMD_aat_par
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    Int Len [ ],
+    Int Rp [ ],
+    Int Ri [ ],
+    double Info [ ]
+) ;
+
+GLOBAL Int AMD_aat_scatter
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    const Int Rp [ ],
+    const Int Ri [ ],
+    const Int Len [ ],
+    Int Pe [ ],
+    Int Iw [ ]
+) ;
+
 GLOBAL void AMD_1
 (
     Int n,
@@ -234,6 +269,22 @@ GLOBAL void AMD_1
     double Info [ ]
 ) ;
 
+GLOBAL void AMD_1_par
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    const Int Rp [ ],
+    const Int Ri [ ],
+    Int P [ ],
+    Int Pinv [ ],
+    Int Len [ ],
+    Int slen,
+    Int S [ ],
+    double Control [ ],
+    double Info [ ]
+) ;
+
 GLOBAL void AMD_1_partial
 (
     Int n,
@@ -179,6 +179,54 @@ GLOBAL void AMD_1
 	Nv, Pinv, P, Head, Elen, Degree, W, Control, Info) ;
 }
 
+/* AMD_1_par: same as AMD_1, except that A+A' is constructed in parallel from
+ * A and R = A', which must be preceded by a call to AMD_aat_par instead of
+ * AMD_aat.  The result is the same as AMD_1. */
+
+GLOBAL void AMD_1_par
+(
+    Int n,		/* n > 0 */
+    const Int Ap [ ],	/* input of size n+1, not modified */
+    const Int Ai [ ],	/* input of size nz = Ap [n], not modified */
+    const Int Rp [ ],	/* R = A', from AMD_aat_par, not modified */
+    const Int Ri [ ],
+    Int P [ ],		/* size n output permutation */
+    Int Pinv [ ],	/* size n output inverse permutation */
+    Int Len [ ],	/* size n input, undefined on output */
+    Int slen,		/* slen >= sum (Len [0..n-1]) + 7n,
+			 * ideally slen = 1.2 * sum (Len) + 8n */
+    Int S [ ],		/* size slen workspace */
+    double Control [ ],	/* input array of size AMD_CONTROL */
+    double Info [ ]	/* output array of size AMD_INFO */
+)
+{
+    Int pfree, iwlen, *Iw, *Pe, *Nv, *Head, *Elen, *Degree, *s, *W ;
+
+    ASSERT (n > 0) ;
+
+    iwlen = slen - 6*n ;
+    s = S ;
+    Pe = s ;	    s += n ;
+    Nv = s ;	    s += n ;
+    Head = s ;	    s += n ;
+    Elen = s ;	    s += n ;
+    Degree = s ;    s += n ;
+    W = s ;	    s += n ;
+    Iw = s ;	    s += iwlen ;
+
+    pfree = AMD_aat_scatter (n, Ap, Ai, Rp, Ri, Len, Pe, Iw) ;
+    if (pfree == EMPTY)
+    {
+	/* out of memory: construct A+A' sequentially instead */
+	AMD_1 (n, Ap, Ai, P, Pinv, Len, slen, S, Control, Info) ;
+	return ;
+    }
+    ASSERT (iwlen >= pfree + n) ;
+
+    AMD_2 (n, Pe, Iw, Len, iwlen, pfree,
+	Nv, Pinv, P, Head, Elen, Degree, W, Control, Info) ;
+}
+
 GLOBAL void AMD_1_partial
 (
     Int n,		/* n > 0 */
@@ -28,7 +28,8 @@ GLOBAL Int AMD_order
     double Info [ ]
 )
 {
-    Int *Len, *S, nz, i, *Pinv, info, status, *Rp, *Ri, *Cp, *Ci, ok ;
+    Int *Len, *S, nz, i, *Pinv, info, status, *Rp, *Ri, *Cp, *Ci, *Tp, *Ti,
+	ok ;
     size_t nzaat, slen ;
     double mem = 0 ;
 
@@ -138,7 +139,34 @@ GLOBAL Int AMD_order
     /* determine the symmetry and count off-diagonal nonzeros in A+A' */
     /* --------------------------------------------------------------------- */
 
-    nzaat = AMD_aat (n, Cp, Ci, Len, P, Info) ;
+    /* Large matrices: A+A' is built in parallel, from C and T = C'.  If T
+     * cannot be allocated, A+A' is built sequentially instead. */
+    Tp = NULL ;
+    Ti = NULL ;
+    if (n >= AMD_AAT_PAR_MIN)
+    {
+	Tp = SuiteSparse_malloc (n+1, sizeof (Int)) ;
+	Ti = SuiteSparse_malloc (nz,  sizeof (Int)) ;
+	if (!Tp || !Ti)
+	{
+	    Tp = SuiteSparse_free (Tp) ;
+	    Ti = SuiteSparse_free (Ti) ;
+	}
+	else
+	{
+	    mem += (n+1) ;
+	    mem += MAX (nz,1) ;
+	}
+    }
+
+    if (Tp != NULL)
+    {
+	nzaat = AMD_aat_par (n, Cp, Ci, Len, Tp, Ti, Info) ;
+    }
+    else
+    {
+	nzaat = AMD_aat (n, Cp, Ci, Len, P, Info) ;
+    }
     AMD_DEBUG1 (("nzaat: %g\n", (double) nzaat)) ;
     ASSERT ((MAX (nz-n, 0) <= nzaat) && (nzaat <= 2 * (size_t) nz)) ;
 
@@ -166,6 +194,8 @@ GLOBAL Int AMD_order
     if (!S)
     {
 	/* :: out of memory :: (or problem too large) */
+	SuiteSparse_free (Tp) ;
+	SuiteSparse_free (Ti) ;
 	SuiteSparse_free (Rp) ;
 	SuiteSparse_free (Ri) ;
 	SuiteSparse_free (Len) ;
@@ -183,12 +213,21 @@ GLOBAL Int AMD_order
     /* order the matrix */
     /* --------------------------------------------------------------------- */
 
-    AMD_1 (n, Cp, Ci, P, Pinv, Len, slen, S, Control, Info) ;
+    if (Tp != NULL)
+    {
+	AMD_1_par (n, Cp, Ci, Tp, Ti, P, Pinv, Len, slen, S, Control, Info) ;
+    }
+    else
+    {
+	AMD_1 (n, Cp, Ci, P, Pinv, Len, slen, S, Control, Info) ;
+    }
 
     /* --------------------------------------------------------------------- */
     /* free the workspace */
     /* --------------------------------------------------------------------- */
 
+    SuiteSparse_free (Tp) ;
+    SuiteSparse_free (Ti) ;
     SuiteSparse_free (Rp) ;
     SuiteSparse_free (Ri) ;
     SuiteSparse_free (Len) ;
@@ -0,0 +1,891 @@
+/* ========================================================================= */
+/* === AMD_par_order ======================================================= */
+/* ========================================================================= */
+
+/* ------------------------------------------------------------------------- */
+/* AMD, Copyright (c) Timothy A. Davis,					     */
+/* Patrick R. Amestoy, and Iain S. Duff.  See ../README.txt for License.     */
+/* email: DrTimothyAldenDavis@gmail.com                                      */
+/* ------------------------------------------------------------------------- */
+
+/* User-callable multithreaded AMD ordering routine.  See amd.h for
+ * documentation.
+ *
+ * Like AMD_2, this routine eliminates the nodes of the quotient graph of
+ * A+A' in order of their approximate external degree, but it eliminates
+ * several pivots at a time.  In each step, the variables whose degree is at
+ * most AMD_PAR_MULT times the minimum degree are candidate pivots, and a
+ * distance-2 independent set of them is selected: no two of the pivots are
+ * adjacent, nor have a common neighbor, in the quotient graph.  The pivots
+ * can then be eliminated concurrently, since each one creates its new
+ * element, absorbs its adjacent elements, updates the degrees and detects
+ * the supervariables of its own variables only.
+ *
+ * The candidates are ranked by degree, and at random among those of equal
+ * degree, and a candidate is selected if it has the lowest rank of all the
+ * candidates that it is within distance 2 of, as in Luby's algorithm.  The
+ * random numbers come from a fixed seed, and the degree lists and the output
+ * permutation are updated by one thread, between steps, in the order of
+ * rank.  None of this depends on the thread schedule, nor on the number of
+ * threads, so the permutation depends only on the matrix.
+ *
+ * Unlike AMD_2, which works in place in a single array, each variable and
+ * each element has its own list, since the lists of the pivots of a step are
+ * built concurrently.  The lists are compacted as they are rebuilt, so there
+ * is no garbage collection.
+ *
+ * The Info statistics are counted as in AMD_2, from the size of each new
+ * element, in the order of the pivots.
+ */
+
+#include "amd_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* smaller matrices are ordered with AMD_order */
+#define AMD_PAR_MIN 1000
+
+/* candidate pivots have a degree of at most AMD_PAR_MULT times the minimum */
+#define AMD_PAR_MULT 1.1
+
+/* at most AMD_PAR_CAND candidate pivots are considered in each step */
+#define AMD_PAR_CAND 4096
+
+/* the kinds of nodes in the quotient graph */
+#define VARIABLE 0	/* a principal variable, not yet eliminated */
+#define ELEMENT 1	/* an element: an eliminated pivot */
+#define ABSORBED 2	/* an element absorbed into another one */
+#define MERGED 3	/* a variable merged into a supervariable */
+#define DENSE 4		/* a dense variable, ordered last */
+
+/* ========================================================================= */
+/* === claim =============================================================== */
+/* ========================================================================= */
+
+/* Owner [i] = min (Owner [i], key), atomically.  Values below base are left
+ * over from earlier steps and count as unclaimed. */
+
+static void claim (Int *Owner, Int i, Int key, Int base)
+{
+#if defined (_OPENMP) && defined (__GNUC__)
+    Int old = __atomic_load_n (&Owner [i], __ATOMIC_RELAXED) ;
+    while (old < base || old > key)
+    {
+	if (__atomic_compare_exchange_n (&Owner [i], &old, key, 0,
+	    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	{
+	    break ;
+	}
+    }
+#elif defined (_OPENMP)
+    #pragma omp critical (amd_par_claim)
+    {
+	if (Owner [i] < base || Owner [i] > key)
+	{
+	    Owner [i] = key ;
+	}
+    }
+#else
+    if (Owner [i] < base || Owner [i] > key)
+    {
+	Owner [i] = key ;
+    }
+#endif
+}
+
+/* ========================================================================= */
+/* === next_stamp ========================================================== */
+/* ========================================================================= */
+
+/* Returns a new stamp for the Mark [0..n-1] and Wflg [0..n-1] arrays of one
+ * thread (Wflg = Mark + n).  As in clear_flag in AMD_2, the marks are reset
+ * before the counter can overflow, so that a stale mark never matches. */
+
+static Int next_stamp (Int *Stamp, Int *Mark, Int n)
+{
+    Int x ;
+    if (*Stamp >= Int_MAX - 1)
+    {
+	for (x = 0 ; x < 2*n ; x++)
+	{
+	    Mark [x] = 0 ;
+	}
+	*Stamp = 0 ;
+    }
+    return (++(*Stamp)) ;
+}
+
+/* ========================================================================= */
+/* === AMD_par_order ======================================================= */
+/* ========================================================================= */
+
+GLOBAL Int AMD_par_order
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    Int P [ ],
+    double Control [ ],
+    double Info [ ],
+    Int nthreads
+)
+{
+    Int *Len, *Pinv, *Rp, *Ri, *Cp, *Ci, *Tp, *Ti, *Sp, *Si, *Cnt, *Kind, *Nv,
+	*Deg, *Ext, *Alen, *Elen, *Cap, *Enz, *Esize, *Head, *Next, *Last,
+	*Where, *SvNext, *SvTail, *Hnext, *Owner, *Cand, *Selected, *Piv,
+	*Work, *Stamp, **Adj, **Elem, nz, i, j, k, p, e, r, t, ndense, status,
+	info, result, ok, nel, nleft,
+	mindeg, limit, ncand, npiv, base, nout, deg, oom, first ;
+    double mem, dense, f, d, s, lnz, lnzme, ndiv, nms_lu, nms_ldl, dmax ;
+    size_t nzaat, tlen, seed ;
+
+    /* ---------------------------------------------------------------------- */
+    /* determine the number of threads */
+    /* ---------------------------------------------------------------------- */
+
+    if (nthreads <= 0)
+    {
+#ifdef _OPENMP
+	nthreads = omp_get_max_threads ( ) ;
+#else
+	nthreads = 1 ;
+#endif
+    }
+    if (nthreads == 1 || n < AMD_PAR_MIN)
+    {
+	/* one thread, or too small to gain anything: use the sequential AMD */
+	return (AMD_order (n, Ap, Ai, P, Control, Info)) ;
+    }
+
+#ifndef NDEBUG
+    AMD_debug_init ("amd_par") ;
+#endif
+
+    /* clear the Info array, if it exists */
+    info = Info != (double *) NULL ;
+    if (info)
+    {
+	for (i = 0 ; i < AMD_INFO ; i++)
+	{
+	    Info [i] = EMPTY ;
+	}
+	Info [AMD_N] = n ;
+	Info [AMD_STATUS] = AMD_OK ;
+    }
+
+    /* make sure inputs exist (n > 0 here) */
+    if (Ai == (Int *) NULL || Ap == (Int *) NULL || P == (Int *) NULL)
+    {
+	if (info) Info [AMD_STATUS] = AMD_INVALID ;
+	return (AMD_INVALID) ;
+    }
+
+    nz = Ap [n] ;
+    if (info)
+    {
+	Info [AMD_NZ] = nz ;
+    }
+    if (nz < 0)
+    {
+	if (info) Info [AMD_STATUS] = AMD_INVALID ;
+	return (AMD_INVALID) ;
+    }
+
+    /* check if n or nz will cause size_t overflow */
+    if (((size_t) n) >= SIZE_T_MAX / (4 * sizeof (Int))
+     || ((size_t) nz) >= SIZE_T_MAX / (2 * sizeof (Int)) || nz > Int_MAX / 2)
+    {
+	if (info) Info [AMD_STATUS] = AMD_OUT_OF_MEMORY ;
+	return (AMD_OUT_OF_MEMORY) ;
+    }
+
+    /* check the input matrix:	AMD_OK, AMD_INVALID, or AMD_OK_BUT_JUMBLED */
+    status = AMD_valid (n, n, Ap, Ai) ;
+    if (status == AMD_INVALID)
+    {
+	if (info) Info [AMD_STATUS] = AMD_INVALID ;
+	return (AMD_INVALID) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate workspace */
+    /* ---------------------------------------------------------------------- */
+
+    tlen = (size_t) nz ;
+    Rp = NULL ;
+    Ri = NULL ;
+    Sp = NULL ;
+    Si = NULL ;
+    Len      = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Pinv     = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Tp       = SuiteSparse_malloc (n+1, sizeof (Int)) ;
+    Ti       = SuiteSparse_malloc (tlen, sizeof (Int)) ;
+    Cnt      = SuiteSparse_malloc (n+1, sizeof (Int)) ;
+    Kind     = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Nv       = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Deg      = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Ext      = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Alen     = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Elen     = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Cap      = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Enz      = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Esize    = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Head     = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Next     = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Last     = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Where    = SuiteSparse_malloc (n, sizeof (Int)) ;
+    SvNext   = SuiteSparse_malloc (n, sizeof (Int)) ;
+    SvTail   = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Hnext    = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Owner    = SuiteSparse_malloc (n, sizeof (Int)) ;
+    Cand     = SuiteSparse_malloc (AMD_PAR_CAND, sizeof (Int)) ;
+    Selected = SuiteSparse_malloc (AMD_PAR_CAND, sizeof (Int)) ;
+    Piv      = SuiteSparse_malloc (AMD_PAR_CAND, sizeof (Int)) ;
+    Stamp    = SuiteSparse_malloc (nthreads, sizeof (Int)) ;
+    Work     = SuiteSparse_malloc (4 * ((size_t) n), nthreads * sizeof (Int)) ;
+    Adj      = SuiteSparse_calloc (n, sizeof (Int *)) ;
+    Elem     = SuiteSparse_calloc (n, sizeof (Int *)) ;
+    mem = 25*((double) n) + 3*((double) AMD_PAR_CAND) + 4*((double) n)*nthreads
+	+ MAX (tlen, 1) ;
+    ok = (Len && Pinv && Tp && Ti && Cnt && Kind && Nv && Deg && Ext && Alen
+	&& Elen && Cap && Enz && Esize && Head && Next && Last && Where
+	&& SvNext && SvTail && Hnext && Owner && Cand && Selected && Piv
+	&& Stamp && Work && Adj && Elem) ;
+
+    if (ok && status == AMD_OK_BUT_JUMBLED)
+    {
+	/* sort the input matrix and remove duplicate entries */
+	AMD_DEBUG1 (("Matrix is jumbled\n")) ;
+	Rp = SuiteSparse_malloc (n+1, sizeof (Int)) ;
+	Ri = SuiteSparse_malloc (nz,  sizeof (Int)) ;
+	mem += (n+1) ;
+	mem += MAX (nz,1) ;
+	ok = (Rp && Ri) ;
+	if (ok)
+	{
+	    /* use Len and Pinv as workspace to create R = A' */
+	    AMD_preprocess (n, Ap, Ai, Rp, Ri, Len, Pinv) ;
+	}
+	Cp = Rp ;
+	Ci = Ri ;
+    }
+    else
+    {
+	Cp = (Int *) Ap ;
+	Ci = (Int *) Ai ;
+    }
+
+    nzaat = 0 ;
+    if (ok)
+    {
+	/* determine the symmetry and count off-diagonal nonzeros in A+A',
+	 * with T = C' */
+	nzaat = AMD_aat_par (n, Cp, Ci, Len, Tp, Ti, Info) ;
+	AMD_DEBUG1 (("nzaat: %g\n", (double) nzaat)) ;
+	Sp = SuiteSparse_malloc (n+1, sizeof (Int)) ;
+	Si = SuiteSparse_malloc (nzaat, sizeof (Int)) ;
+	mem += (n+1) ;
+	mem += 2 * ((double) MAX (nzaat,1)) ;
+	ok = (Sp && Si) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* construct the pattern S of A+A', with sorted columns */
+    /* ---------------------------------------------------------------------- */
+
+    if (ok)
+    {
+	/* Len [i] is the number of entries in column i of A+A', excluding the
+	 * diagonal */
+	Sp [n] = AMD_aat_scatter (n, Cp, Ci, Tp, Ti, Len, Sp, Si) ;
+    }
+    SuiteSparse_free (Tp) ;
+    SuiteSparse_free (Ti) ;
+    SuiteSparse_free (Rp) ;
+    SuiteSparse_free (Ri) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* find the "dense" rows/columns, as AMD does */
+    /* ---------------------------------------------------------------------- */
+
+    dense = (Control != (double *) NULL) ? Control [AMD_DENSE] :
+	AMD_DEFAULT_DENSE ;
+    if (dense < 0)
+    {
+	dense = n ;
+    }
+    else
+    {
+	dense = dense * sqrt ((double) n) ;
+    }
+    dense = MAX (16, dense) ;
+    dense = MIN (n, dense) ;
+
+    ndense = 0 ;
+    if (ok)
+    {
+	for (i = 0 ; i < n ; i++)
+	{
+	    Kind [i] = (Len [i] > dense) ? DENSE : VARIABLE ;
+	    ndense += (Kind [i] == DENSE) ;
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* initialize the quotient graph and the degree lists */
+    /* ---------------------------------------------------------------------- */
+
+    /* Adj [i] holds the Alen [i] variables adjacent to variable i, followed
+     * by its Elen [i] elements, and has room for Cap [i] entries.  Elem [e]
+     * holds the Enz [e] variables of element e, some of which may have been
+     * merged since, and Esize [e] is the number of variables it represents.
+     * Head [deg] is the list of the variables of degree deg, linked by
+     * Next and Last, and Where [i] is the list variable i is in. */
+
+    for (i = 0 ; ok && i < n ; i++)
+    {
+	Nv [i] = 1 ;
+	Alen [i] = 0 ;
+	Elen [i] = 0 ;
+	Cap [i] = 0 ;
+	Enz [i] = 0 ;
+	Esize [i] = 0 ;
+	Head [i] = EMPTY ;
+	Where [i] = EMPTY ;
+	SvNext [i] = EMPTY ;
+	SvTail [i] = i ;
+	Owner [i] = EMPTY ;
+    }
+    for (i = 0 ; ok && i < n ; i++)
+    {
+	if (Kind [i] != VARIABLE) continue ;
+	Cap [i] = Len [i] + 1 ;
+	Adj [i] = SuiteSparse_malloc (Cap [i], sizeof (Int)) ;
+	ok = (Adj [i] != NULL) ;
+	for (p = Sp [i] ; ok && p < Sp [i+1] ; p++)
+	{
+	    j = Si [p] ;
+	    if (Kind [j] == VARIABLE)
+	    {
+		Adj [i] [Alen [i]++] = j ;
+	    }
+	}
+    }
+    SuiteSparse_free (Sp) ;
+    SuiteSparse_free (Si) ;
+    mindeg = n ;
+    for (i = n-1 ; ok && i >= 0 ; i--)
+    {
+	if (Kind [i] != VARIABLE) continue ;
+	deg = Alen [i] ;
+	Deg [i] = deg ;
+	Where [i] = deg ;
+	Last [i] = EMPTY ;
+	Next [i] = Head [deg] ;
+	if (Head [deg] != EMPTY) Last [Head [deg]] = i ;
+	Head [deg] = i ;
+	mindeg = MIN (mindeg, deg) ;
+    }
+    for (t = 0 ; ok && t < nthreads ; t++)
+    {
+	Stamp [t] = 0 ;
+	for (k = 0 ; k < 4*n ; k++)
+	{
+	    Work [t*4*n + k] = (k < 3*n) ? 0 : EMPTY ;
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* eliminate distance-2 independent sets of pivots */
+    /* ---------------------------------------------------------------------- */
+
+    lnz = 0 ;
+    ndiv = 0 ;
+    nms_lu = 0 ;
+    nms_ldl = 0 ;
+    dmax = 1 ;
+    nel = 0 ;
+    nout = 0 ;
+    base = 0 ;
+    seed = 1 ;
+    oom = !ok ;
+    while (!oom && nel < n - ndense)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* find the candidate pivots */
+	/* ------------------------------------------------------------------ */
+
+	while (Head [mindeg] == EMPTY)
+	{
+	    mindeg++ ;
+	}
+	limit = MIN (n-1, MAX (mindeg, (Int) (AMD_PAR_MULT * mindeg))) ;
+	ncand = 0 ;
+	for (deg = mindeg ; deg <= limit && ncand < AMD_PAR_CAND ; deg++)
+	{
+	    first = ncand ;
+	    for (i = Head [deg] ; i != EMPTY && ncand < AMD_PAR_CAND ;
+		i = Next [i])
+	    {
+		Cand [ncand++] = i ;
+	    }
+
+	    /* shuffle the candidates of equal degree, so that their ranks are
+	     * not correlated with their position in the graph */
+	    for (r = ncand-1 ; r > first ; r--)
+	    {
+		seed = seed * 1103515245 + 12345 ;
+		k = first + (Int) ((seed / 65536) % ((size_t) (r - first + 1))) ;
+		i = Cand [r] ;
+		Cand [r] = Cand [k] ;
+		Cand [k] = i ;
+	    }
+	}
+	if (base > Int_MAX - 2 * AMD_PAR_CAND)
+	{
+	    for (i = 0 ; i < n ; i++)
+	    {
+		Owner [i] = EMPTY ;
+	    }
+	    base = 0 ;
+	}
+
+	/* ------------------------------------------------------------------ */
+	/* each candidate claims the variables within distance 2 of it */
+	/* ------------------------------------------------------------------ */
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic,16) num_threads(nthreads) \
+	    private(i, j, p, e, t)
+#endif
+	for (r = 0 ; r < ncand ; r++)
+	{
+	    i = Cand [r] ;
+	    claim (Owner, i, base + r, base) ;
+	    for (p = 0 ; p < Alen [i] ; p++)
+	    {
+		j = Adj [i] [p] ;
+		if (Kind [j] == VARIABLE) claim (Owner, j, base + r, base) ;
+	    }
+	    for (p = Alen [i] ; p < Alen [i] + Elen [i] ; p++)
+	    {
+		e = Adj [i] [p] ;
+		for (t = 0 ; t < Enz [e] ; t++)
+		{
+		    j = Elem [e] [t] ;
+		    if (Kind [j] == VARIABLE) claim (Owner, j, base + r, base) ;
+		}
+	    }
+	}
+
+	/* ------------------------------------------------------------------ */
+	/* select the candidates that own all the variables they claimed */
+	/* ------------------------------------------------------------------ */
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic,16) num_threads(nthreads) \
+	    private(i, j, p, e, t)
+#endif
+	for (r = 0 ; r < ncand ; r++)
+	{
+	    i = Cand [r] ;
+	    Selected [r] = (Owner [i] == base + r) ;
+	    for (p = 0 ; Selected [r] && p < Alen [i] ; p++)
+	    {
+		j = Adj [i] [p] ;
+		Selected [r] = (Kind [j] != VARIABLE || Owner [j] == base + r) ;
+	    }
+	    for (p = Alen [i] ; Selected [r] && p < Alen [i] + Elen [i] ; p++)
+	    {
+		e = Adj [i] [p] ;
+		for (t = 0 ; Selected [r] && t < Enz [e] ; t++)
+		{
+		    j = Elem [e] [t] ;
+		    Selected [r] = (Kind [j] != VARIABLE
+			|| Owner [j] == base + r) ;
+		}
+	    }
+	}
+	npiv = 0 ;
+	for (r = 0 ; r < ncand ; r++)
+	{
+	    if (Selected [r]) Piv [npiv++] = Cand [r] ;
+	}
+	base += ncand ;
+	nleft = n - ndense - nel ;
+	ASSERT (npiv > 0) ;
+
+	/* ------------------------------------------------------------------ */
+	/* eliminate the pivots, and rebuild the lists of their variables */
+	/* ------------------------------------------------------------------ */
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads) \
+	    reduction(|:oom) private(i, j, p, e, t, k, deg)
+#endif
+	for (r = 0 ; r < npiv ; r++)
+	{
+	    Int me, stamp, len, nlp, degme, ext, q, *Lme, *Mark, *Wflg, *W, *New ;
+	    int okay ;
+#ifdef _OPENMP
+	    t = omp_get_thread_num ( ) ;
+#else
+	    t = 0 ;
+#endif
+	    Mark = Work + t*4*n ;
+	    Wflg = Mark + n ;
+	    W = Mark + 2*n ;
+	    stamp = next_stamp (&Stamp [t], Mark, n) ;
+	    me = Piv [r] ;
+
+	    /* Lme = the variables adjacent to me, and those of its elements */
+	    len = Alen [me] ;
+	    for (p = Alen [me] ; p < Alen [me] + Elen [me] ; p++)
+	    {
+		len += Enz [Adj [me] [p]] ;
+	    }
+	    Lme = SuiteSparse_malloc (MAX (len, 1), sizeof (Int)) ;
+	    if (Lme == NULL)
+	    {
+		oom = 1 ;
+		continue ;
+	    }
+	    nlp = 0 ;
+	    degme = 0 ;
+	    Mark [me] = stamp ;
+	    for (p = 0 ; p < Alen [me] ; p++)
+	    {
+		i = Adj [me] [p] ;
+		if (Kind [i] == VARIABLE && Mark [i] != stamp)
+		{
+		    Mark [i] = stamp ;
+		    Lme [nlp++] = i ;
+		    degme += Nv [i] ;
+		}
+	    }
+	    for (p = Alen [me] ; p < Alen [me] + Elen [me] ; p++)
+	    {
+		/* element e is absorbed into the new element me */
+		e = Adj [me] [p] ;
+		for (q = 0 ; q < Enz [e] ; q++)
+		{
+		    i = Elem [e] [q] ;
+		    if (Kind [i] == VARIABLE && Mark [i] != stamp)
+		    {
+			Mark [i] = stamp ;
+			Lme [nlp++] = i ;
+			degme += Nv [i] ;
+		    }
+		}
+		SuiteSparse_free (Elem [e]) ;
+		Elem [e] = NULL ;
+		Enz [e] = 0 ;
+		Kind [e] = ABSORBED ;
+	    }
+	    SuiteSparse_free (Adj [me]) ;
+	    Adj [me] = NULL ;
+	    Alen [me] = 0 ;
+	    Elen [me] = 0 ;
+	    Cap [me] = 0 ;
+	    Kind [me] = ELEMENT ;
+	    Elem [me] = Lme ;
+	    Enz [me] = nlp ;
+	    Esize [me] = degme ;
+
+	    /* W [e] = |Le \ Lme| for each element e adjacent to Lme */
+	    for (k = 0 ; k < nlp ; k++)
+	    {
+		i = Lme [k] ;
+		for (p = Alen [i] ; p < Alen [i] + Elen [i] ; p++)
+		{
+		    e = Adj [i] [p] ;
+		    if (Kind [e] != ELEMENT) continue ;
+		    if (Wflg [e] != stamp)
+		    {
+			Wflg [e] = stamp ;
+			W [e] = Esize [e] ;
+		    }
+		    W [e] -= Nv [i] ;
+		}
+	    }
+
+	    /* rebuild the list of each variable of Lme: drop the variables of
+	     * Lme, which are now covered by me, and the absorbed elements, and
+	     * add me.  Ext [i] is the external degree of i outside of me. */
+	    for (k = 0 ; !oom && k < nlp ; k++)
+	    {
+		i = Lme [k] ;
+		if (Alen [i] + Elen [i] >= Cap [i])
+		{
+		    New = SuiteSparse_realloc (2 * Cap [i] + 1, Cap [i],
+			sizeof (Int), Adj [i], &okay) ;
+		    if (!okay)
+		    {
+			oom = 1 ;
+			break ;
+		    }
+		    Adj [i] = New ;
+		    Cap [i] = 2 * Cap [i] + 1 ;
+		}
+		New = Adj [i] ;
+		ext = 0 ;
+		q = 0 ;
+		for (p = 0 ; p < Alen [i] ; p++)
+		{
+		    j = New [p] ;
+		    if (Kind [j] == VARIABLE && Mark [j] != stamp)
+		    {
+			New [q++] = j ;
+			ext += Nv [j] ;
+		    }
+		}
+		len = q ;
+		for (p = Alen [i] ; p < Alen [i] + Elen [i] ; p++)
+		{
+		    e = New [p] ;
+		    if (Kind [e] != ELEMENT) continue ;
+		    if (W [e] == 0)
+		    {
+			/* aggressive absorption: Le is a subset of Lme */
+			SuiteSparse_free (Elem [e]) ;
+			Elem [e] = NULL ;
+			Enz [e] = 0 ;
+			Kind [e] = ABSORBED ;
+		    }
+		    else
+		    {
+			New [q++] = e ;
+			ext += W [e] ;
+		    }
+		}
+		New [q++] = me ;
+		Alen [i] = len ;
+		Elen [i] = q - len ;
+		Ext [i] = ext ;
+	    }
+	}
+
+	/* ------------------------------------------------------------------ */
+	/* find the supervariables, and update the degrees */
+	/* ------------------------------------------------------------------ */
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads) \
+	    private(i, j, p, e, t, k, deg)
+#endif
+	for (r = 0 ; r < npiv ; r++)
+	{
+	    Int me, stamp, nlp, degme, h, len, *Lme, *Mark, *Hhead ;
+	    size_t hash ;
+	    if (oom) continue ;
+#ifdef _OPENMP
+	    t = omp_get_thread_num ( ) ;
+#else
+	    t = 0 ;
+#endif
+	    Mark = Work + t*4*n ;
+	    Hhead = Mark + 3*n ;
+	    me = Piv [r] ;
+	    Lme = Elem [me] ;
+	    nlp = Enz [me] ;
+	    degme = Esize [me] ;
+
+	    /* hash the variables of Lme by their lists */
+	    for (k = 0 ; k < nlp ; k++)
+	    {
+		i = Lme [k] ;
+		hash = 0 ;
+		for (p = 0 ; p < Alen [i] + Elen [i] ; p++)
+		{
+		    hash += Adj [i] [p] ;
+		}
+		h = (Int) (hash % ((size_t) n)) ;
+		Hnext [i] = Hhead [h] ;
+		Hhead [h] = i ;
+		Cnt [i] = h ;
+	    }
+
+	    /* merge the variables with the same lists into supervariables */
+	    for (k = 0 ; k < nlp ; k++)
+	    {
+		h = Cnt [Lme [k]] ;
+		for (i = Hhead [h] ; i != EMPTY ; i = Hnext [i])
+		{
+		    if (Kind [i] != VARIABLE) continue ;
+		    len = Alen [i] + Elen [i] ;
+		    stamp = next_stamp (&Stamp [t], Mark, n) ;
+		    for (p = 0 ; p < len ; p++)
+		    {
+			Mark [Adj [i] [p]] = stamp ;
+		    }
+		    for (j = Hnext [i] ; j != EMPTY ; j = Hnext [j])
+		    {
+			if (Kind [j] != VARIABLE || Alen [j] != Alen [i]
+			    || Elen [j] != Elen [i]) continue ;
+			for (p = 0 ; p < len && Mark [Adj [j] [p]] == stamp ; p++) ;
+			if (p < len) continue ;
+			/* j is indistinguishable from i: merge it into i */
+			Nv [i] += Nv [j] ;
+			Nv [j] = 0 ;
+			Kind [j] = MERGED ;
+			SvNext [SvTail [i]] = j ;
+			SvTail [i] = SvTail [j] ;
+			SuiteSparse_free (Adj [j]) ;
+			Adj [j] = NULL ;
+			Alen [j] = 0 ;
+			Elen [j] = 0 ;
+			Cap [j] = 0 ;
+		    }
+		}
+		Hhead [h] = EMPTY ;
+	    }
+
+	    /* approximate external degree of each principal variable */
+	    for (k = 0 ; k < nlp ; k++)
+	    {
+		i = Lme [k] ;
+		if (Kind [i] != VARIABLE) continue ;
+		deg = Ext [i] + degme - Nv [i] ;
+		deg = MIN (deg, Deg [i] + degme) ;
+		deg = MIN (deg, nleft - Nv [me] - Nv [i]) ;
+		Deg [i] = MAX (deg, 0) ;
+	    }
+	}
+
+	if (oom) break ;
+
+	/* ------------------------------------------------------------------ */
+	/* update the degree lists and the permutation, in order of rank */
+	/* ------------------------------------------------------------------ */
+
+	for (r = 0 ; r < npiv ; r++)
+	{
+	    Int me, nlp, q, *Lme ;
+	    me = Piv [r] ;
+	    Lme = Elem [me] ;
+	    nlp = Enz [me] ;
+
+	    /* remove me and the merged variables from the degree lists, and
+	     * move the variables of Lme to their new lists */
+	    q = 0 ;
+	    for (k = -1 ; k < nlp ; k++)
+	    {
+		i = (k < 0) ? me : Lme [k] ;
+		if (Next [i] != EMPTY) Last [Next [i]] = Last [i] ;
+		if (Last [i] != EMPTY) Next [Last [i]] = Next [i] ;
+		else Head [Where [i]] = Next [i] ;
+		Where [i] = EMPTY ;
+		if (k < 0 || Kind [i] != VARIABLE) continue ;
+		deg = Deg [i] ;
+		Where [i] = deg ;
+		Last [i] = EMPTY ;
+		Next [i] = Head [deg] ;
+		if (Head [deg] != EMPTY) Last [Head [deg]] = i ;
+		Head [deg] = i ;
+		mindeg = MIN (mindeg, deg) ;
+		Lme [q++] = i ;
+	    }
+	    Enz [me] = q ;
+
+	    /* me and the variables merged into it are next in the order */
+	    for (i = me ; i != EMPTY ; i = SvNext [i])
+	    {
+		P [nout++] = i ;
+	    }
+	    nel += Nv [me] ;
+
+	    /* the statistics, as counted by AMD_2 */
+	    f = Nv [me] ;
+	    d = Esize [me] + ndense ;
+	    dmax = MAX (dmax, f + d) ;
+	    lnzme = f*d + (f-1)*f/2 ;
+	    lnz += lnzme ;
+	    ndiv += lnzme ;
+	    s = f*d*d + d*(f-1)*f + (f-1)*f*(2*f-1)/6 ;
+	    nms_lu += s ;
+	    nms_ldl += (s + lnzme)/2 ;
+	}
+    }
+
+    /* the dense variables are ordered last */
+    for (i = 0 ; !oom && i < n ; i++)
+    {
+	if (Kind [i] == DENSE) P [nout++] = i ;
+    }
+    ASSERT (oom || nout == n) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* free the quotient graph */
+    /* ---------------------------------------------------------------------- */
+
+    for (i = 0 ; Adj && Elem && i < n ; i++)
+    {
+	SuiteSparse_free (Adj [i]) ;
+	SuiteSparse_free (Elem [i]) ;
+    }
+    result = oom ? AMD_OUT_OF_MEMORY : AMD_OK ;
+
+    if (info && result == AMD_OK)
+    {
+	/* count the work to factorize the ndense-by-ndense submatrix */
+	f = ndense ;
+	dmax = MAX (dmax, (double) ndense) ;
+	lnzme = (f-1)*f/2 ;
+	lnz += lnzme ;
+	ndiv += lnzme ;
+	s = (f-1)*f*(2*f-1)/6 ;
+	nms_lu += s ;
+	nms_ldl += (s + lnzme)/2 ;
+
+	Info [AMD_LNZ] = lnz ;
+	Info [AMD_NDIV] = ndiv ;
+	Info [AMD_NMULTSUBS_LDL] = nms_ldl ;
+	Info [AMD_NMULTSUBS_LU] = nms_lu ;
+	Info [AMD_NDENSE] = ndense ;
+	Info [AMD_DMAX] = dmax ;
+	Info [AMD_NCMPA] = 0 ;
+	Info [AMD_MEMORY] = mem * sizeof (Int) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* free the workspace */
+    /* ---------------------------------------------------------------------- */
+
+    SuiteSparse_free (Len) ;
+    SuiteSparse_free (Pinv) ;
+    SuiteSparse_free (Cnt) ;
+    SuiteSparse_free (Kind) ;
+    SuiteSparse_free (Nv) ;
+    SuiteSparse_free (Deg) ;
+    SuiteSparse_free (Ext) ;
+    SuiteSparse_free (Alen) ;
+    SuiteSparse_free (Elen) ;
+    SuiteSparse_free (Cap) ;
+    SuiteSparse_free (Enz) ;
+    SuiteSparse_free (Esize) ;
+    SuiteSparse_free (Head) ;
+    SuiteSparse_free (Next) ;
+    SuiteSparse_free (Last) ;
+    SuiteSparse_free (Where) ;
+    SuiteSparse_free (SvNext) ;
+    SuiteSparse_free (SvTail) ;
+    SuiteSparse_free (Hnext) ;
+    SuiteSparse_free (Owner) ;
+    SuiteSparse_free (Cand) ;
+    SuiteSparse_free (Selected) ;
+    SuiteSparse_free (Piv) ;
+    SuiteSparse_free (Stamp) ;
+    SuiteSparse_free (Work) ;
+    SuiteSparse_free (Adj) ;
+    SuiteSparse_free (Elem) ;
+
+    if (result != AMD_OK)
+    {
+	if (info) Info [AMD_STATUS] = result ;
+	return (result) ;
+    }
+    if (info) Info [AMD_STATUS] = status ;
+    return (status) ;
+}
@@ -123,6 +123,68 @@ SuiteSparse_long btf_l_maxtrans (SuiteSparse_long, SuiteSparse_long,
     SuiteSparse_long *, SuiteSparse_long *) ;
 
 
+/* btf_maxtrans_update is the same as btf_maxtrans, except that Match is an
+ * input matching on input (typically from btf_maxtrans of a similar matrix).
+ * Pairs of Match that are not entries of A are removed, and only the
+ * unmatched columns are augmented. */
+
+int btf_maxtrans_update /* returns # of columns matched */
+(
+    /* --- input, not modified: --- */
+    int nrow,       /* A is nrow-by-ncol in compressed column form */
+    int ncol,
+    int Ap [ ],     /* size ncol+1 */
+    int Ai [ ],     /* size nz = Ap [ncol] */
+    double maxwork, /* maximum amount of work to do is maxwork*nnz(A); no limit
+                     * if <= 0 */
+
+    /* --- output, not defined on input --- */
+    double *work,   /* same as btf_maxtrans */
+
+    /* --- input/output --- */
+    int Match [ ],  /* size nrow.  Match [i] = j if column j matched to row i,
+                     * EMPTY (-1) if row i is not matched */
+
+    /* --- workspace, not defined on input or output --- */
+    int Work [ ]    /* size 6*ncol */
+) ;
+
+SuiteSparse_long btf_l_maxtrans_update (SuiteSparse_long, SuiteSparse_long,
+    SuiteSparse_long *, SuiteSparse_long *, double, double *,
+    SuiteSparse_long *, SuiteSparse_long *) ;
+
+
+/* btf_maxtrans_pf is the same as btf_maxtrans, except that it uses the
+ * Pothen-Fan algorithm with lookahead, multithreaded if BTF is compiled with
+ * OpenMP.  There is no work limit: the matching is always maximum, and the
+ * number of columns matched is the structural rank of A.  It is much faster
+ * than btf_maxtrans on large matrices with many zeros on the diagonal, for
+ * which btf_maxtrans can reach its work limit.  The matching may depend on the
+ * thread schedule, but its size does not. */
+
+int btf_maxtrans_pf /* returns # of columns matched */
+(
+    /* --- input, not modified: --- */
+    int nrow,       /* A is nrow-by-ncol in compressed column form */
+    int ncol,
+    int Ap [ ],     /* size ncol+1 */
+    int Ai [ ],     /* size nz = Ap [ncol] */
+    int nthreads,   /* # of threads to use; the OpenMP default if <= 0 */
+
+    /* --- output, not defined on input --- */
+    double *work,   /* the total work performed */
+    int Match [ ],  /* size nrow.  Match [i] = j if column j matched to row i
+                     * (see above for the singular-matrix case) */
+
+    /* --- workspace, not defined on input or output --- */
+    int Work [ ]    /* size 5*ncol + nrow */
+) ;
+
+SuiteSparse_long btf_l_maxtrans_pf (SuiteSparse_long, SuiteSparse_long,
+    SuiteSparse_long *, SuiteSparse_long *, SuiteSparse_long, double *,
+    SuiteSparse_long *, SuiteSparse_long *) ;
+
+
 /* ========================================================================== */
 /* === BTF_STRONGCOMP ======================================================= */
 /* ========================================================================== */
@@ -219,6 +281,81 @@ SuiteSparse_long btf_l_order (SuiteSparse_long, SuiteSparse_long *,
     SuiteSparse_long *) ;
 
 
+/* BTF_ORDER_PF is the same as BTF_ORDER, except that the maximum matching is
+ * found by btf_maxtrans_pf, with no work limit.  The number of nonzeros on
+ * the diagonal of P*A*Q is always the structural rank of A. */
+
+int btf_order_pf    /* returns number of blocks found */
+(
+    /* --- input, not modified: --- */
+    int n,          /* A is n-by-n in compressed column form */
+    int Ap [ ],     /* size n+1 */
+    int Ai [ ],     /* size nz = Ap [n] */
+    int nthreads,   /* # of threads for the matching; the OpenMP default
+                     * if <= 0 */
+
+    /* --- output, not defined on input --- */
+    double *work,   /* return value from btf_maxtrans_pf */
+    int P [ ],      /* size n, row permutation */
+    int Q [ ],      /* size n, column permutation */
+    int R [ ],      /* size n+1.  block b is in rows/cols R[b] ... R[b+1]-1 */
+    int *nmatch,    /* # nonzeros on diagonal of P*A*Q */
+
+    /* --- workspace, not defined on input or output --- */
+    int Work [ ]    /* size 6n */
+) ;
+
+SuiteSparse_long btf_l_order_pf (SuiteSparse_long, SuiteSparse_long *,
+    SuiteSparse_long *, SuiteSparse_long, double *, SuiteSparse_long *,
+    SuiteSparse_long *, SuiteSparse_long *, SuiteSparse_long *,
+    SuiteSparse_long *) ;
+
+
+/* BTF_ORDER_UPDATE is the same as BTF_ORDER, for a matrix whose pattern
+ * differs from an earlier one (ordered with permutations Pold and Qold) in a
+ * few entries.  The earlier matching is kept where it is still valid, and only
+ * the columns that lost their match are augmented.  If the earlier blocks Rold
+ * and the added or removed entries (Ci [k], Cj [k]) are given, Bold [b] is set
+ * to the earlier block identical to block b of P*A*Q, which need not be
+ * ordered or factorized again, or to -1 if block b is new or changed. */
+
+int btf_order_update    /* returns number of blocks found */
+(
+    /* --- input, not modified: --- */
+    int n,          /* A is n-by-n in compressed column form */
+    int Ap [ ],     /* size n+1 */
+    int Ai [ ],     /* size nz = Ap [n] */
+    double maxwork, /* do at most maxwork*nnz(A) work in the maximum
+                     * transversal; no limit if <= 0 */
+    int Pold [ ],   /* size n, earlier row permutation */
+    int Qold [ ],   /* size n, earlier column permutation */
+    int Rold [ ],   /* size nblocks_old+1, earlier blocks (may be NULL) */
+    int nblocks_old,
+    int nchanged,   /* # of entries added to or removed from the pattern */
+    int Ci [ ],     /* size nchanged, rows of the changed entries */
+    int Cj [ ],     /* size nchanged, columns of the changed entries */
+
+    /* --- output, not defined on input --- */
+    double *work,   /* return value from btf_maxtrans_update */
+    int P [ ],      /* size n, row permutation */
+    int Q [ ],      /* size n, column permutation */
+    int R [ ],      /* size n+1.  block b is in rows/cols R[b] ... R[b+1]-1 */
+    int *nmatch,    /* # nonzeros on diagonal of P*A*Q */
+    int Bold [ ],   /* size n, earlier block identical to block b, or -1.
+                     * May be NULL. */
+
+    /* --- workspace, not defined on input or output --- */
+    int Work [ ]    /* size 6n */
+) ;
+
+SuiteSparse_long btf_l_order_update (SuiteSparse_long, SuiteSparse_long *,
+    SuiteSparse_long *, double, SuiteSparse_long *, SuiteSparse_long *,
+    SuiteSparse_long *, SuiteSparse_long, SuiteSparse_long, SuiteSparse_long *,
+    SuiteSparse_long *, double *, SuiteSparse_long *, SuiteSparse_long *,
+    SuiteSparse_long *, SuiteSparse_long *, SuiteSparse_long *,
+    SuiteSparse_long *) ;
+
+
 /* ========================================================================== */
 /* === BTF marking of singular columns ====================================== */
 /* ========================================================================== */
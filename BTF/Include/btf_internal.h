@@ -49,6 +49,7 @@
 #undef FALSE
 #undef PRINTF
 #undef MIN
+#undef MAX
 
 #ifndef NPRINT
 #define PRINTF(s) { printf s ; } ;
@@ -60,5 +61,6 @@
 #define FALSE 0
 #define EMPTY (-1)
 #define MIN(a,b) (((a) < (b)) ?  (a) : (b))
+#define MAX(a,b) (((a) > (b)) ?  (a) : (b))
 
 #endif
@@ -385,3 +385,133 @@ Int BTF(maxtrans)   /* returns # of columns in the matching */
 
     return (nmatch) ;
 }
+
+/* ========================================================================== */
+/* === maxtrans_update ====================================================== */
+/* ========================================================================== */
+
+/* Same as maxtrans, except that Match holds a matching on input (typically
+ * the maximum matching of a similar matrix, found by an earlier call to
+ * maxtrans).  Pairs (i,j) with A(i,j) not present in A, or with column j
+ * matched twice, are removed.  The rest of the matching is kept, and only the
+ * unmatched columns are augmented.  If A differs from the earlier matrix in a
+ * few entries, only a few columns are unmatched, and the work is much less
+ * than a full maxtrans.
+ */
+
+Int BTF(maxtrans_update)    /* returns # of columns in the matching */
+(
+    /* --- input --- */
+    Int nrow,       /* A is nrow-by-ncol in compressed column form */
+    Int ncol,
+    Int Ap [ ],     /* size ncol+1 */
+    Int Ai [ ],     /* size nz = Ap [ncol] */
+    double maxwork, /* do at most maxwork*nnz(A) work; no limit if <= 0 */
+
+    /* --- output --- */
+    double *work,   /* same as maxtrans */
+
+    /* --- input/output --- */
+    Int Match [ ],  /* size nrow.  Match [i] = j if column j matched to row i,
+                     * EMPTY if row i is not matched */
+
+    /* --- workspace --- */
+    Int Work [ ]    /* size 6*ncol */
+)
+{
+    Int *Cheap, *Flag, *Istack, *Jstack, *Pstack, *Colmatch ;
+    Int i, j, k, p, pend, nmatch, work_limit_reached, result ;
+
+    /* ---------------------------------------------------------------------- */
+    /* get workspace and initialize */
+    /* ---------------------------------------------------------------------- */
+
+    Cheap  = Work ; Work += ncol ;
+    Flag   = Work ; Work += ncol ;
+    Istack = Work ; Work += ncol ;
+    Jstack = Work ; Work += ncol ;
+    Pstack = Work ; Work += ncol ;
+    Colmatch = Work ;
+
+    for (j = 0 ; j < ncol ; j++)
+    {
+        Cheap [j] = Ap [j] ;
+        Flag [j] = EMPTY ;
+        Colmatch [j] = EMPTY ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* keep the pairs of the input matching that are still entries of A */
+    /* ---------------------------------------------------------------------- */
+
+    for (i = 0 ; i < nrow ; i++)
+    {
+        j = Match [i] ;
+        if (j >= 0 && j < ncol && Colmatch [j] == EMPTY)
+        {
+            /* tentatively match column j with row i */
+            Colmatch [j] = i ;
+        }
+        Match [i] = EMPTY ;
+    }
+    nmatch = 0 ;
+    for (j = 0 ; j < ncol ; j++)
+    {
+        i = Colmatch [j] ;
+        if (i == EMPTY)
+        {
+            continue ;
+        }
+        Colmatch [j] = EMPTY ;
+        pend = Ap [j+1] ;
+        for (p = Ap [j] ; p < pend ; p++)
+        {
+            if (Ai [p] == i)
+            {
+                /* A(i,j) is present: keep the pair */
+                Match [i] = j ;
+                Colmatch [j] = i ;
+                nmatch++ ;
+                break ;
+            }
+        }
+    }
+
+    if (maxwork > 0)
+    {
+        maxwork *= Ap [ncol] ;
+    }
+    *work = 0 ;
+
+    /* ---------------------------------------------------------------------- */
+    /* find a matching row for each unmatched column k */
+    /* ---------------------------------------------------------------------- */
+
+    /* a matched column stays matched while other columns are augmented, so
+     * Colmatch need not be updated */
+    work_limit_reached = FALSE ;
+    for (k = 0 ; k < ncol ; k++)
+    {
+        if (Colmatch [k] != EMPTY)
+        {
+            continue ;
+        }
+        result = augment (k, Ap, Ai, Match, Cheap, Flag, Istack, Jstack, Pstack,
+            work, maxwork) ;
+        if (result == TRUE)
+        {
+            nmatch++ ;
+        }
+        else if (result == EMPTY)
+        {
+            work_limit_reached = TRUE ;
+        }
+    }
+
+    if (work_limit_reached)
+    {
+        *work = EMPTY ;
+    }
+
+    return (nmatch) ;
+}
@@ -0,0 +1,351 @@
+/* ========================================================================== */
+/* === BTF_MAXTRANS_PF ====================================================== */
+/* ========================================================================== */
+
+/* Finds a maximum matching of a sparse matrix with the Pothen-Fan algorithm
+ * with lookahead and fairness (PF+), multithreaded if BTF is compiled with
+ * OpenMP.  The input and output are the same as btf_maxtrans, except that
+ * there is no limit on the work, so the matching is always maximum and the
+ * number of columns matched is the structural rank of A.
+ *
+ * btf_maxtrans searches for one augmenting path at a time, and each search
+ * starts over with all columns unvisited.  The Pothen-Fan algorithm works in
+ * phases instead.  In each phase, a depth-first search is started from every
+ * unmatched column, concurrently, and the searches of a phase are vertex
+ * disjoint: a row is visited by at most one search in the phase, which claims
+ * it atomically.  A search that finds an unmatched row augments the matching
+ * along its path right away; no other search can touch the rows of that path.
+ * When a phase finds no augmenting path, the matching is maximum.  Two things
+ * make the searches short:
+ *
+ *  (1) lookahead: before going deeper from column j, all of column j is
+ *      scanned for an unmatched row.  The scan resumes where it left off (the
+ *      rows before it stay matched for good), so the lookahead costs O(nnz(A))
+ *      in total, as the cheap match in btf_maxtrans.
+ *
+ *  (2) fairness: the rows of a column are scanned forward in even phases and
+ *      backward in odd ones, so a search does not always start down the same
+ *      dead end.
+ *
+ * The matching depends on the thread schedule, but its size does not.
+ *
+ * References: A. Pothen and C.-J. Fan, "Computing the block triangular form of
+ * a sparse matrix", ACM Trans. Mathematical Software, 16(4), 1990, and
+ * A. Azad, M. Halappanavar, S. Rajamanickam, E. Boman, A. Khan, and A. Pothen,
+ * "Multithreaded algorithms for maximum matching in bipartite graphs", IPDPS
+ * 2012.
+ */
+
+#include "btf.h"
+#include "btf_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* ========================================================================== */
+/* === claim ================================================================ */
+/* ========================================================================== */
+
+/* Visited [i] = phase, atomically.  Returns TRUE if row i was not yet visited
+ * in this phase, and is now claimed by the caller. */
+
+static Int claim (Int *Visited, Int i, Int phase)
+{
+    Int old ;
+#if defined (_OPENMP) && defined (__GNUC__)
+    old = __atomic_exchange_n (&Visited [i], phase, __ATOMIC_RELAXED) ;
+#elif defined (_OPENMP)
+    #pragma omp critical (btf_pf_claim)
+    {
+        old = Visited [i] ;
+        Visited [i] = phase ;
+    }
+#else
+    old = Visited [i] ;
+    Visited [i] = phase ;
+#endif
+    return (old != phase) ;
+}
+
+/* Match [i], read while other searches may be augmenting */
+static Int get_match (Int *Match, Int i)
+{
+#if defined (_OPENMP) && defined (__GNUC__)
+    return (__atomic_load_n (&Match [i], __ATOMIC_RELAXED)) ;
+#else
+    return (Match [i]) ;
+#endif
+}
+
+/* ========================================================================== */
+/* === search =============================================================== */
+/* ========================================================================== */
+
+/* Depth-first search from the unmatched column k, with lookahead.  The rows
+ * visited are claimed for this phase.  If an unmatched row is found, the
+ * matching is augmented along the path and TRUE is returned. */
+
+static Int search
+(
+    Int k,              /* an unmatched column */
+    Int phase,          /* the phase, 1, 2, ... */
+    Int Ap [ ],         /* column pointers, size ncol+1 */
+    Int Ai [ ],         /* row indices, size nz = Ap [ncol] */
+    Int Match [ ],      /* size nrow, Match [i] = j if col j matched to i */
+    Int Look [ ],       /* rows Ai [Ap [j] .. Look [j]-1] are matched */
+    Int Visited [ ],    /* size nrow, Visited [i] = phase if row i visited */
+    Int Istack [ ],     /* size ncol.  Row index stack. */
+    Int Jstack [ ],     /* size ncol.  Column index stack. */
+    Int Pstack [ ],     /* size ncol.  # of entries of column scanned */
+    double *work        /* work performed */
+)
+{
+    Int head, i, j, j2, p, pstart, pend, len, found, forward ;
+
+    forward = (phase % 2 == 0) ;
+    found = FALSE ;
+    head = 0 ;
+    Jstack [0] = k ;
+    Pstack [0] = EMPTY ;
+
+    while (head >= 0)
+    {
+        j = Jstack [head] ;
+        pstart = Ap [j] ;
+        pend = Ap [j+1] ;
+
+        if (Pstack [head] == EMPTY)
+        {
+            /* first visit of column j: look ahead for an unmatched row.
+             * Column j is visited by no other search in this phase, so Look
+             * [j] is only modified here. */
+            Pstack [head] = 0 ;
+            for (p = Look [j] ; p < pend ; p++)
+            {
+                i = Ai [p] ;
+                if (get_match (Match, i) == EMPTY && claim (Visited, i, phase))
+                {
+                    found = TRUE ;
+                    break ;
+                }
+            }
+            *work += (p - Look [j] + 1) ;
+            Look [j] = p ;
+            if (found)
+            {
+                /* end of augmenting path, column j matched with row i */
+                Istack [head] = i ;
+                break ;
+            }
+        }
+
+        /* continue the search with the next unvisited row of column j, in the
+         * order of this phase */
+        len = pend - pstart ;
+        i = EMPTY ;
+        for ( ; Pstack [head] < len ; Pstack [head]++)
+        {
+            p = forward ? (pstart + Pstack [head]) : (pend - 1 - Pstack [head]);
+            i = Ai [p] ;
+            if (claim (Visited, i, phase))
+            {
+                break ;
+            }
+        }
+        *work += 1 ;
+
+        if (Pstack [head] == len)
+        {
+            /* all rows of column j are visited: backtrack */
+            head-- ;
+            continue ;
+        }
+        Pstack [head]++ ;
+
+        /* row i is claimed, so Match [i] can only change here */
+        j2 = Match [i] ;
+        Istack [head] = i ;
+        if (j2 == EMPTY)
+        {
+            /* the lookahead skips an unmatched row only if another search
+             * has claimed it, so this is not expected, but an unmatched row
+             * ends the path just as well */
+            found = TRUE ;
+            break ;
+        }
+        Jstack [++head] = j2 ;
+        Pstack [head] = EMPTY ;
+    }
+
+    if (found)
+    {
+        /* augment the matching along the path */
+        for (p = head ; p >= 0 ; p--)
+        {
+#if defined (_OPENMP) && defined (__GNUC__)
+            __atomic_store_n (&Match [Istack [p]], Jstack [p], __ATOMIC_RELAXED);
+#else
+            Match [Istack [p]] = Jstack [p] ;
+#endif
+        }
+    }
+    return (found) ;
+}
+
+/* ========================================================================== */
+/* === maxtrans_pf ========================================================== */
+/* ========================================================================== */
+
+Int BTF(maxtrans_pf)    /* returns # of columns in the matching */
+(
+    /* --- input --- */
+    Int nrow,       /* A is nrow-by-ncol in compressed column form */
+    Int ncol,
+    Int Ap [ ],     /* size ncol+1 */
+    Int Ai [ ],     /* size nz = Ap [ncol] */
+    Int nthreads,   /* # of threads to use; the OpenMP default if <= 0 */
+
+    /* --- output --- */
+    double *work,   /* the total work performed */
+    Int Match [ ],  /* size nrow.  Match [i] = j if column j matched to row i */
+
+    /* --- workspace --- */
+    Int Work [ ]    /* size 5*ncol + nrow */
+)
+{
+    Int *Look, *Visited, *Unmatched, *Stacks ;
+    Int i, j, k, p, pend, nmatch, nun, phase, naug ;
+    double w ;
+
+    /* ---------------------------------------------------------------------- */
+    /* get workspace and initialize */
+    /* ---------------------------------------------------------------------- */
+
+#ifdef _OPENMP
+    if (nthreads <= 0)
+    {
+        nthreads = omp_get_max_threads ( ) ;
+    }
+#else
+    nthreads = 1 ;
+#endif
+    nthreads = MAX (nthreads, 1) ;
+
+    Look      = Work ; Work += ncol ;
+    Unmatched = Work ; Work += ncol ;
+    Visited   = Work ; Work += nrow ;
+    Stacks    = Work ;                  /* size 3*ncol, for one thread */
+
+    *work = 0 ;
+    for (i = 0 ; i < nrow ; i++)
+    {
+        Match [i] = EMPTY ;
+        Visited [i] = EMPTY ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* cheap match */
+    /* ---------------------------------------------------------------------- */
+
+    nmatch = 0 ;
+    nun = 0 ;
+    for (j = 0 ; j < ncol ; j++)
+    {
+        pend = Ap [j+1] ;
+        for (p = Ap [j] ; p < pend ; p++)
+        {
+            i = Ai [p] ;
+            if (Match [i] == EMPTY)
+            {
+                Match [i] = j ;
+                nmatch++ ;
+                break ;
+            }
+        }
+        *work += (p - Ap [j] + 1) ;
+        if (p == pend)
+        {
+            /* column j is unmatched; the rows of column j are all matched */
+            Unmatched [nun++] = j ;
+        }
+        Look [j] = p ;
+    }
+
+    if (nun == 0 || nmatch == nrow)
+    {
+        return (nmatch) ;
+    }
+
+    /* one set of stacks per thread: thread 0 uses Work, the others get their
+     * own, and the search runs on one thread if they cannot be allocated */
+    if (nthreads > 1)
+    {
+        Stacks = SuiteSparse_malloc (3 * ((size_t) ncol), nthreads *
+            sizeof (Int)) ;
+        if (Stacks == NULL)
+        {
+            Stacks = Work ;
+            nthreads = 1 ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* augment in phases, until a phase finds no augmenting path */
+    /* ---------------------------------------------------------------------- */
+
+    for (phase = 1 ; nun > 0 ; phase++)
+    {
+        naug = 0 ;
+        w = 0 ;
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic,16) num_threads(nthreads) \
+            reduction(+:naug) reduction(+:w)
+#endif
+        for (k = 0 ; k < nun ; k++)
+        {
+            Int t, *Istack, *Jstack, *Pstack ;
+            double tw = 0 ;
+#ifdef _OPENMP
+            t = omp_get_thread_num ( ) ;
+#else
+            t = 0 ;
+#endif
+            Istack = Stacks + 3 * ((size_t) ncol) * t ;
+            Jstack = Istack + ncol ;
+            Pstack = Jstack + ncol ;
+            if (search (Unmatched [k], phase, Ap, Ai, Match, Look, Visited,
+                Istack, Jstack, Pstack, &tw))
+            {
+                /* column Unmatched [k] is now matched */
+                Unmatched [k] = BTF_FLIP (Unmatched [k]) ;
+                naug++ ;
+            }
+            w += tw ;
+        }
+
+        *work += w ;
+        if (naug == 0)
+        {
+            break ;
+        }
+        nmatch += naug ;
+
+        /* keep the columns still unmatched for the next phase */
+        j = 0 ;
+        for (k = 0 ; k < nun ; k++)
+        {
+            if (Unmatched [k] >= 0)
+            {
+                Unmatched [j++] = Unmatched [k] ;
+            }
+        }
+        nun = j ;
+    }
+
+    if (nthreads > 1)
+    {
+        SuiteSparse_free (Stacks) ;
+    }
+    return (nmatch) ;
+}
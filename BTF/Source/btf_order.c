@@ -29,50 +29,27 @@
 #include "btf.h"
 #include "btf_internal.h"
 
-/* This function only operates on square matrices (either structurally full-
- * rank, or structurally rank deficient). */
-
-Int BTF(order)      /* returns number of blocks found */
-(
-    /* input, not modified: */
-    Int n,          /* A is n-by-n in compressed column form */
-    Int Ap [ ],     /* size n+1 */
-    Int Ai [ ],     /* size nz = Ap [n] */
-    double maxwork, /* do at most maxwork*nnz(A) work in the maximum
-                     * transversal; no limit if <= 0 */
+/* ========================================================================== */
+/* === complete_permutation ================================================= */
+/* ========================================================================== */
 
-    /* output, not defined on input */
-    double *work,   /* work performed in maxtrans, or -1 if limit reached */
-    Int P [ ],      /* size n, row permutation */
-    Int Q [ ],      /* size n, column permutation */
-    Int R [ ],      /* size n+1.  block b is in rows/cols R[b] ... R[b+1]-1 */
-    Int *nmatch,    /* # nonzeros on diagonal of P*A*Q */
+/* Since the matrix is square, ensure BTF_UNFLIP(Q[0..n-1]) is a permutation of
+ * the columns of A so that A has as many nonzeros on the diagonal as possible.
+ * On input, Q [i] = j if row i is matched to column j, or EMPTY if unmatched.
+ */
 
-    /* workspace, not defined on input or output */
-    Int Work [ ]    /* size 5n */
+static void complete_permutation
+(
+    Int n,
+    Int nmatch,
+    Int Q [ ],
+    Int Work [ ]    /* size 2n */
 )
 {
     Int *Flag ;
-    Int nblocks, i, j, nbadcol ;
+    Int i, j, nbadcol ;
 
-    /* ---------------------------------------------------------------------- */
-    /* compute the maximum matching */
-    /* ---------------------------------------------------------------------- */
-
-    /* if maxwork > 0, then a maximum matching might not be found */
-
-    *nmatch = BTF(maxtrans) (n, n, Ap, Ai, maxwork, work, Q, Work) ;
-
-    /* ---------------------------------------------------------------------- */
-    /* complete permutation if the matrix is structurally singular */
-    /* ---------------------------------------------------------------------- */
-
-    /* Since the matrix is square, ensure BTF_UNFLIP(Q[0..n-1]) is a
-     * permutation of the columns of A so that A has as many nonzeros on the
-     * diagonal as possible.
-     */
-
-    if (*nmatch < n)
+    if (nmatch < n)
     {
         /* get a size-n work array */
         Flag = Work + n ;
@@ -102,7 +79,7 @@ Int BTF(order)      /* returns number of blocks found */
                 Work [nbadcol++] = j ;
             }
         }
-        ASSERT (*nmatch + nbadcol == n) ;
+        ASSERT (nmatch + nbadcol == n) ;
 
         /* make an assignment for each unmatched row */
         for (i = 0 ; i < n ; i++)
@@ -122,11 +99,248 @@ Int BTF(order)      /* returns number of blocks found */
      * will always be in the valid range 0 to n-1.  The entry A(i,j) is zero
      * if BTF_ISFLIPPED (Q [i]) is true, and nonzero otherwise.  nmatch
      * is the number of entries in the Q array that are non-negative. */
+}
+
+/* ========================================================================== */
+/* === BTF_ORDER ============================================================ */
+/* ========================================================================== */
+
+/* This function only operates on square matrices (either structurally full-
+ * rank, or structurally rank deficient). */
+
+Int BTF(order)      /* returns number of blocks found */
+(
+    /* input, not modified: */
+    Int n,          /* A is n-by-n in compressed column form */
+    Int Ap [ ],     /* size n+1 */
+    Int Ai [ ],     /* size nz = Ap [n] */
+    double maxwork, /* do at most maxwork*nnz(A) work in the maximum
+                     * transversal; no limit if <= 0 */
+
+    /* output, not defined on input */
+    double *work,   /* work performed in maxtrans, or -1 if limit reached */
+    Int P [ ],      /* size n, row permutation */
+    Int Q [ ],      /* size n, column permutation */
+    Int R [ ],      /* size n+1.  block b is in rows/cols R[b] ... R[b+1]-1 */
+    Int *nmatch,    /* # nonzeros on diagonal of P*A*Q */
+
+    /* workspace, not defined on input or output */
+    Int Work [ ]    /* size 5n */
+)
+{
+    Int nblocks ;
+
+    /* ---------------------------------------------------------------------- */
+    /* compute the maximum matching */
+    /* ---------------------------------------------------------------------- */
+
+    /* if maxwork > 0, then a maximum matching might not be found */
+
+    *nmatch = BTF(maxtrans) (n, n, Ap, Ai, maxwork, work, Q, Work) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* complete permutation if the matrix is structurally singular */
+    /* ---------------------------------------------------------------------- */
+
+    complete_permutation (n, *nmatch, Q, Work) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* find the strongly connected components */
+    /* ---------------------------------------------------------------------- */
+
+    nblocks = BTF(strongcomp) (n, Ap, Ai, Q, P, R, Work) ;
+    return (nblocks) ;
+}
+
+
+/* ========================================================================== */
+/* === BTF_ORDER_PF ========================================================= */
+/* ========================================================================== */
+
+/* Same as BTF_ORDER, with the maximum matching found by btf_maxtrans_pf.  The
+ * matching is always maximum, so A(P,Q) has a zero-free diagonal if A has full
+ * structural rank. */
+
+Int BTF(order_pf)   /* returns number of blocks found */
+(
+    /* input, not modified: */
+    Int n,          /* A is n-by-n in compressed column form */
+    Int Ap [ ],     /* size n+1 */
+    Int Ai [ ],     /* size nz = Ap [n] */
+    Int nthreads,   /* # of threads for the matching; the default if <= 0 */
+
+    /* output, not defined on input */
+    double *work,   /* work performed in maxtrans_pf */
+    Int P [ ],      /* size n, row permutation */
+    Int Q [ ],      /* size n, column permutation */
+    Int R [ ],      /* size n+1.  block b is in rows/cols R[b] ... R[b+1]-1 */
+    Int *nmatch,    /* # nonzeros on diagonal of P*A*Q */
+
+    /* workspace, not defined on input or output */
+    Int Work [ ]    /* size 6n */
+)
+{
+    *nmatch = BTF(maxtrans_pf) (n, n, Ap, Ai, nthreads, work, Q, Work) ;
+    complete_permutation (n, *nmatch, Q, Work) ;
+    return (BTF(strongcomp) (n, Ap, Ai, Q, P, R, Work)) ;
+}
+
+
+/* ========================================================================== */
+/* === BTF_ORDER_UPDATE ===================================================== */
+/* ========================================================================== */
+
+/* Same as BTF_ORDER, for a matrix A whose pattern differs from an earlier
+ * matrix in a few entries.  The maximum matching of the earlier matrix, given
+ * by its BTF_ORDER output Pold and Qold (or any P and Q with the same row and
+ * column pairs on the diagonal, such as the P and Q of a KLU Symbolic object),
+ * is kept where it is still valid, and only the columns that lost their match
+ * are augmented (see btf_maxtrans_update).
+ *
+ * If Rold and the list of added or removed entries (Ci, Cj) are also given,
+ * Bold [b] is set to the block of the earlier ordering that is identical to
+ * block b of A(P,Q): it has the same rows and columns, the same matching, and
+ * contains none of the changed entries.  Those blocks need not be ordered or
+ * factorized again.  Bold [b] is EMPTY for all other blocks.
+ */
+
+Int BTF(order_update)   /* returns number of blocks found */
+(
+    /* input, not modified: */
+    Int n,          /* A is n-by-n in compressed column form */
+    Int Ap [ ],     /* size n+1 */
+    Int Ai [ ],     /* size nz = Ap [n] */
+    double maxwork, /* do at most maxwork*nnz(A) work in the maximum
+                     * transversal; no limit if <= 0 */
+    Int Pold [ ],   /* size n, earlier row permutation */
+    Int Qold [ ],   /* size n, earlier column permutation */
+    Int Rold [ ],   /* size nblocks_old+1, earlier blocks (may be NULL) */
+    Int nblocks_old,
+    Int nchanged,   /* # of entries added to or removed from the pattern */
+    Int Ci [ ],     /* size nchanged, row indices of the changed entries */
+    Int Cj [ ],     /* size nchanged, column indices of the changed entries */
+
+    /* output, not defined on input */
+    double *work,   /* work performed in maxtrans, or -1 if limit reached */
+    Int P [ ],      /* size n, row permutation */
+    Int Q [ ],      /* size n, column permutation */
+    Int R [ ],      /* size n+1.  block b is in rows/cols R[b] ... R[b+1]-1 */
+    Int *nmatch,    /* # nonzeros on diagonal of P*A*Q */
+    Int Bold [ ],   /* size n.  Bold [b] is the earlier block identical to
+                     * block b, or EMPTY.  May be NULL. */
+
+    /* workspace, not defined on input or output */
+    Int Work [ ]    /* size 6n */
+)
+{
+    Int *Oldblock, *Oldrow, *Colblock, *Rowblock ;
+    Int nblocks, b, i, j, k, k1, k2, ob ;
+
+    /* ---------------------------------------------------------------------- */
+    /* get the earlier matching, Q [i] = j if row i is matched to column j */
+    /* ---------------------------------------------------------------------- */
+
+    for (i = 0 ; i < n ; i++)
+    {
+        Q [i] = EMPTY ;
+    }
+    for (k = 0 ; k < n ; k++)
+    {
+        i = Pold [k] ;
+        j = Qold [k] ;
+        if (i >= 0 && i < n && j >= 0 && j < n)
+        {
+            /* flipped columns of Qold were not matched */
+            Q [i] = j ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* update the maximum matching */
+    /* ---------------------------------------------------------------------- */
+
+    *nmatch = BTF(maxtrans_update) (n, n, Ap, Ai, maxwork, work, Q, Work) ;
+    complete_permutation (n, *nmatch, Q, Work) ;
 
     /* ---------------------------------------------------------------------- */
     /* find the strongly connected components */
     /* ---------------------------------------------------------------------- */
 
     nblocks = BTF(strongcomp) (n, Ap, Ai, Q, P, R, Work) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* find the blocks that are identical to blocks of the earlier ordering */
+    /* ---------------------------------------------------------------------- */
+
+    if (Bold == NULL)
+    {
+        return (nblocks) ;
+    }
+    for (b = 0 ; b < nblocks ; b++)
+    {
+        Bold [b] = EMPTY ;
+    }
+    if (Rold == NULL || nblocks_old <= 0 || (nchanged > 0 &&
+        (Ci == NULL || Cj == NULL)))
+    {
+        return (nblocks) ;
+    }
+
+    Oldblock = Work ;           /* Oldblock [j]: earlier block of column j */
+    Oldrow   = Work + n ;       /* Oldrow [j]: row matched to column j */
+    Colblock = Work + 2*n ;     /* Colblock [j]: block of column j */
+    Rowblock = Work + 3*n ;     /* Rowblock [i]: block of row i */
+
+    for (ob = 0 ; ob < nblocks_old ; ob++)
+    {
+        for (k = Rold [ob] ; k < Rold [ob+1] ; k++)
+        {
+            j = BTF_UNFLIP (Qold [k]) ;
+            Oldblock [j] = ob ;
+            Oldrow [j] = BTF_ISFLIPPED (Qold [k]) ? EMPTY : Pold [k] ;
+        }
+    }
+    for (b = 0 ; b < nblocks ; b++)
+    {
+        k1 = R [b] ;
+        k2 = R [b+1] ;
+        for (k = k1 ; k < k2 ; k++)
+        {
+            Colblock [BTF_UNFLIP (Q [k])] = b ;
+            Rowblock [P [k]] = b ;
+        }
+
+        /* block b is identical to block ob if all of its columns are in ob,
+         * with the same matching, and the two blocks have the same size */
+        ob = Oldblock [BTF_UNFLIP (Q [k1])] ;
+        if (Rold [ob+1] - Rold [ob] != k2 - k1)
+        {
+            continue ;
+        }
+        for (k = k1 ; k < k2 ; k++)
+        {
+            j = BTF_UNFLIP (Q [k]) ;
+            if (Oldblock [j] != ob ||
+                Oldrow [j] != (BTF_ISFLIPPED (Q [k]) ? EMPTY : P [k]))
+            {
+                break ;
+            }
+        }
+        if (k == k2)
+        {
+            Bold [b] = ob ;
+        }
+    }
+
+    /* a block with a changed entry in it must be ordered again */
+    for (k = 0 ; k < nchanged ; k++)
+    {
+        i = Ci [k] ;
+        j = Cj [k] ;
+        if (i >= 0 && i < n && j >= 0 && j < n && Rowblock [i] == Colblock [j])
+        {
+            Bold [Colblock [j]] = EMPTY ;
+        }
+    }
     return (nblocks) ;
 }
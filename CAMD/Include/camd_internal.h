@@ -165,10 +165,13 @@
 #define CAMD_control camd_l_control
 #define CAMD_info camd_l_info
 #define CAMD_1 camd_l1
+#define CAMD_1_par camd_l1_par
 #define CAMD_2 camd_l2
 #define CAMD_valid camd_l_valid
 #define CAMD_cvalid camd_l_cvalid
 #define CAMD_aat camd_l_aat
+#define CAMD_aat_par camd_l_aat_par
+#define CAMD_aat_scatter camd_l_aat_scatter
 #define CAMD_postorder camd_l_postorder
 #define CAMD_post_tree camd_l_post_tree
 #define CAMD_dump camd_l_dump
@@ -187,10 +190,13 @@
 #define CAMD_control camd_control
 #define CAMD_info camd_info
 #define CAMD_1 camd_1
+#define CAMD_1_par camd_1_par
 #define CAMD_2 camd_2
 #define CAMD_valid camd_valid
 #define CAMD_cvalid camd_cvalid
 #define CAMD_aat camd_aat
+#define CAMD_aat_par camd_aat_par
+#define CAMD_aat_scatter camd_aat_scatter
 #define CAMD_postorder camd_postorder
 #define CAMD_post_tree camd_post_tree
 #define CAMD_dump camd_dump
@@ -214,6 +220,33 @@ GLOBAL size_t CAMD_aat
     double Info [ ]
 ) ;
 
+/* A+A' is built by CAMD_aat_par and CAMD_1_par instead of CAMD_aat and CAMD_1
+ * for matrices of this size or larger */
+#define CAMD_AAT_PAR_MIN 10000
+
+GLOBAL size_t CAMD_aat_par
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    Int Len [ ],
+    Int Rp [ ],
+    Int Ri [ ],
+    double Info [ ]
+) ;
+
+GLOBAL Int CAMD_aat_scatter
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    const Int Rp [ ],
+    const Int Ri [ ],
+    const Int Len [ ],
+    Int Pe [ ],
+    Int Iw [ ]
+) ;
+
 GLOBAL void CAMD_1
 (
     Int n,
@@ -229,6 +262,23 @@ GLOBAL void CAMD_1
     const Int C [ ]
 ) ;
 
+GLOBAL void CAMD_1_par
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    const Int Rp [ ],
+    const Int Ri [ ],
+    Int P [ ],
+    Int Pinv [ ],
+    Int Len [ ],
+    Int slen,
+    Int S [ ],
+    double Control [ ],
+    double Info [ ],
+    const Int C [ ]
+) ;
+
 GLOBAL Int CAMD_postorder
 (
     Int j, Int k, Int n, Int head [], Int next [], Int post [], Int stack []
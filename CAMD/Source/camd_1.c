@@ -181,3 +181,56 @@ GLOBAL void CAMD_1
     CAMD_2 (n, Pe, Iw, Len, iwlen, pfree,
 	Nv, Pinv, P, Head, Elen, Degree, W, Control, Info, C, BucketSet) ;
 }
+
+/* CAMD_1_par: same as CAMD_1, except that A+A' is constructed in parallel
+ * from A and R = A', which must be preceded by a call to CAMD_aat_par instead
+ * of CAMD_aat.  The result is the same as CAMD_1. */
+
+GLOBAL void CAMD_1_par
+(
+    Int n,		/* n > 0 */
+    const Int Ap [ ],	/* input of size n+1, not modified */
+    const Int Ai [ ],	/* input of size nz = Ap [n], not modified */
+    const Int Rp [ ],	/* R = A', from CAMD_aat_par, not modified */
+    const Int Ri [ ],
+    Int P [ ],		/* size n output permutation */
+    Int Pinv [ ],	/* size n output inverse permutation */
+    Int Len [ ],	/* size n input, undefined on output */
+    Int slen,		/* slen >= sum (Len [0..n-1]) + 7n+2,
+			 * ideally slen = 1.2 * sum (Len) + 8n+2 */
+    Int S [ ],		/* size slen workspace */
+    double Control [ ],	/* input array of size CAMD_CONTROL */
+    double Info [ ],	/* output array of size CAMD_INFO */
+    const Int C [ ]	/* Constraint set of size n */
+)
+{
+    Int pfree, iwlen, *Iw, *Pe, *Nv, *Head, *Elen, *Degree, *s, *W,
+	*BucketSet ;
+
+    ASSERT (n > 0) ;
+
+    iwlen = slen - (7*n+2) ;	/* allocate 7*n+2 workspace from S */
+    s = S ;
+    Pe = s ;	    s += n ;
+    Nv = s ;	    s += n ;
+    Head = s ;	    s += n+1 ;
+    Elen = s ;	    s += n ;
+    Degree = s ;    s += n ;
+    W = s ;	    s += n+1 ;
+    BucketSet = s ; s += n ;
+    Iw = s ;	    s += iwlen ;
+
+    ASSERT (CAMD_cvalid (n, C)) ;
+
+    pfree = CAMD_aat_scatter (n, Ap, Ai, Rp, Ri, Len, Pe, Iw) ;
+    if (pfree == EMPTY)
+    {
+	/* out of memory: construct A+A' sequentially instead */
+	CAMD_1 (n, Ap, Ai, P, Pinv, Len, slen, S, Control, Info, C) ;
+	return ;
+    }
+    ASSERT (iwlen >= pfree + n) ;
+
+    CAMD_2 (n, Pe, Iw, Len, iwlen, pfree,
+	Nv, Pinv, P, Head, Elen, Degree, W, Control, Info, C, BucketSet) ;
+}
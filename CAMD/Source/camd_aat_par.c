@@ -0,0 +1,469 @@
+/* ========================================================================= */
+/* === CAMD_aat_par ======================================================== */
+/* ========================================================================= */
+
+/* ------------------------------------------------------------------------- */
+/* CAMD, Copyright (c) Timothy A. Davis, Yanqing Chen,			     */
+/* Patrick R. Amestoy, and Iain S. Duff.  See ../README.txt for License.     */
+/* email: DrTimothyAldenDavis@gmail.com                                      */
+/* ------------------------------------------------------------------------- */
+
+/* CAMD_aat_par:  multithreaded version of CAMD_aat, for large matrices.  The
+ * pattern of R = A' is computed first, so that column j of A+A' is the union
+ * of the sorted lists A (:,j) and R (:,j), without the diagonal.  Each column
+ * of A+A' is then counted, and later scattered into place by
+ * CAMD_aat_scatter, by one thread, with no dependence on the other columns.
+ *
+ * R is built by a column-count pass, a prefix sum, and a scatter.  Each
+ * thread owns a range of rows, and scans all the columns of A for the
+ * entries in its rows (a binary search finds the first one), so that no two
+ * threads write to the same row, and each row of R is sorted.
+ *
+ * Each column of A+A' is placed in the same order as CAMD_1 leaves it in, so
+ * the ordering is the same as that of CAMD_aat and CAMD_1, for any number of
+ * threads.  Assumes the input matrix has no errors, with sorted columns and
+ * no duplicates (CAMD_valid (n, n, Ap, Ai) must be CAMD_OK, but this condition
+ * is not checked).
+ */
+
+#include "camd_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* ========================================================================= */
+/* === first_entry ========================================================= */
+/* ========================================================================= */
+
+/* the first p in [p1,p2) with Ai [p] >= r0, or p2 if none */
+
+static Int first_entry (const Int Ai [ ], Int p1, Int p2, Int r0)
+{
+    Int mid ;
+    while (p1 < p2)
+    {
+	mid = p1 + (p2 - p1) / 2 ;
+	if (Ai [mid] < r0)
+	{
+	    p1 = mid + 1 ;
+	}
+	else
+	{
+	    p2 = mid ;
+	}
+    }
+    return (p1) ;
+}
+
+/* ========================================================================= */
+/* === cumsum ============================================================== */
+/* ========================================================================= */
+
+/* Cp [i] = sum (Cnt [0..i-1]) for i = 0 to n-1, in parallel.  Returns the
+ * total.  Each thread sums its own range of Cnt, and the ranges are then
+ * offset by the sums of the ranges before them. */
+
+static Int cumsum (Int n, const Int Cnt [ ], Int Cp [ ])
+{
+    Int *Tsum, total, nthreads ;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads ( ) ;
+#else
+    nthreads = 1 ;
+#endif
+    Tsum = (nthreads > 1) ? SuiteSparse_malloc (nthreads+1, sizeof (Int))
+	: NULL ;
+    if (Tsum == NULL)
+    {
+	Int i ;
+	total = 0 ;
+	for (i = 0 ; i < n ; i++)
+	{
+	    Cp [i] = total ;
+	    total += Cnt [i] ;
+	}
+	return (total) ;
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(nthreads)
+#endif
+    {
+	Int i, i1, i2, s, t, nt ;
+#ifdef _OPENMP
+	t = omp_get_thread_num ( ) ;
+	nt = omp_get_num_threads ( ) ;
+#else
+	t = 0 ;
+	nt = 1 ;
+#endif
+	i1 = (Int) (((double) n) * t / nt) ;
+	i2 = (Int) (((double) n) * (t+1) / nt) ;
+	s = 0 ;
+	for (i = i1 ; i < i2 ; i++)
+	{
+	    s += Cnt [i] ;
+	}
+	Tsum [t+1] = s ;
+#ifdef _OPENMP
+	#pragma omp barrier
+	#pragma omp single
+#endif
+	{
+	    Tsum [0] = 0 ;
+	    for (s = 0 ; s < nt ; s++)
+	    {
+		Tsum [s+1] += Tsum [s] ;
+	    }
+	}
+	s = Tsum [t] ;
+	for (i = i1 ; i < i2 ; i++)
+	{
+	    Cp [i] = s ;
+	    s += Cnt [i] ;
+	}
+#ifdef _OPENMP
+	#pragma omp barrier
+	#pragma omp single
+#endif
+	{
+	    total = Tsum [nt] ;
+	}
+    }
+    SuiteSparse_free (Tsum) ;
+    return (total) ;
+}
+
+/* ========================================================================= */
+/* === CAMD_aat_par ======================================================== */
+/* ========================================================================= */
+
+GLOBAL size_t CAMD_aat_par	/* returns nz in A+A' */
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    Int Len [ ],	/* Len [j]: length of column j of A+A', excl diagonal*/
+    Int Rp [ ],		/* output of size n+1, the pattern of R = A' */
+    Int Ri [ ],		/* output of size nz = Ap [n] */
+    double Info [ ]
+)
+{
+    Int i, j, nz, nzdiag, nzboth ;
+    double sym ;
+    size_t nzaat ;
+
+    ASSERT (CAMD_valid (n, n, Ap, Ai) == CAMD_OK) ;
+
+    if (Info != (double *) NULL)
+    {
+	/* clear the Info array, if it exists */
+	for (i = 0 ; i < CAMD_INFO ; i++)
+	{
+	    Info [i] = EMPTY ;
+	}
+	Info [CAMD_STATUS] = CAMD_OK ;
+    }
+    nz = Ap [n] ;
+
+    /* --------------------------------------------------------------------- */
+    /* R = A', with Len as the row counts */
+    /* --------------------------------------------------------------------- */
+
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+	Int r, r0, r1, p, pend, k, t, nt ;
+#ifdef _OPENMP
+	t = omp_get_thread_num ( ) ;
+	nt = omp_get_num_threads ( ) ;
+#else
+	t = 0 ;
+	nt = 1 ;
+#endif
+	r0 = (Int) (((double) n) * t / nt) ;
+	r1 = (Int) (((double) n) * (t+1) / nt) ;
+	for (r = r0 ; r < r1 ; r++)
+	{
+	    Len [r] = 0 ;
+	}
+	for (k = 0 ; k < n ; k++)
+	{
+	    pend = Ap [k+1] ;
+	    for (p = first_entry (Ai, Ap [k], pend, r0) ;
+		 p < pend && Ai [p] < r1 ; p++)
+	    {
+		Len [Ai [p]]++ ;
+	    }
+	}
+    }
+    Rp [n] = cumsum (n, Len, Rp) ;
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+	Int r, r0, r1, p, pend, k, t, nt ;
+#ifdef _OPENMP
+	t = omp_get_thread_num ( ) ;
+	nt = omp_get_num_threads ( ) ;
+#else
+	t = 0 ;
+	nt = 1 ;
+#endif
+	r0 = (Int) (((double) n) * t / nt) ;
+	r1 = (Int) (((double) n) * (t+1) / nt) ;
+	for (r = r0 ; r < r1 ; r++)
+	{
+	    Len [r] = Rp [r] ;
+	}
+	for (k = 0 ; k < n ; k++)
+	{
+	    pend = Ap [k+1] ;
+	    for (p = first_entry (Ai, Ap [k], pend, r0) ;
+		 p < pend && Ai [p] < r1 ; p++)
+	    {
+		Ri [Len [Ai [p]]++] = k ;
+	    }
+	}
+    }
+
+    /* --------------------------------------------------------------------- */
+    /* count the union of A (:,j) and R (:,j) for each column j */
+    /* --------------------------------------------------------------------- */
+
+    nzdiag = 0 ;
+    nzboth = 0 ;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic,1024) \
+	reduction(+:nzdiag) reduction(+:nzboth)
+#endif
+    for (j = 0 ; j < n ; j++)
+    {
+	Int pa, pa2, pr, pr2, ia, ir, len ;
+	pa = Ap [j] ;
+	pa2 = Ap [j+1] ;
+	pr = Rp [j] ;
+	pr2 = Rp [j+1] ;
+	len = 0 ;
+	while (pa < pa2 || pr < pr2)
+	{
+	    ia = (pa < pa2) ? Ai [pa] : n ;
+	    ir = (pr < pr2) ? Ri [pr] : n ;
+	    if (ia == ir)
+	    {
+		/* A (ia,j) and A (j,ia) are both present */
+		if (ia == j)
+		{
+		    nzdiag++ ;
+		}
+		else
+		{
+		    len++ ;
+		    nzboth++ ;
+		}
+		pa++ ;
+		pr++ ;
+	    }
+	    else if (ia < ir)
+	    {
+		len++ ;
+		pa++ ;
+	    }
+	    else
+	    {
+		len++ ;
+		pr++ ;
+	    }
+	}
+	Len [j] = len ;
+    }
+
+    /* each symmetric pair was counted in both of its columns */
+    nzboth /= 2 ;
+
+    /* --------------------------------------------------------------------- */
+    /* compute the symmetry of the nonzero pattern of A, as in CAMD_aat */
+    /* --------------------------------------------------------------------- */
+
+    if (nz == nzdiag)
+    {
+	sym = 1 ;
+    }
+    else
+    {
+	sym = (2 * (double) nzboth) / ((double) (nz - nzdiag)) ;
+    }
+
+    nzaat = 0 ;
+    for (j = 0 ; j < n ; j++)
+    {
+	nzaat += Len [j] ;
+    }
+
+    CAMD_DEBUG1 (("CAMD par nz in A+A', excluding diagonal (nzaat) = %g\n",
+	(double) nzaat)) ;
+
+    if (Info != (double *) NULL)
+    {
+	Info [CAMD_STATUS] = CAMD_OK ;
+	Info [CAMD_N] = n ;
+	Info [CAMD_NZ] = nz ;
+	Info [CAMD_SYMMETRY] = sym ;	    /* symmetry of pattern of A */
+	Info [CAMD_NZDIAG] = nzdiag ;	    /* nonzeros on diagonal of A */
+	Info [CAMD_NZ_A_PLUS_AT] = nzaat ;   /* nonzeros in A+A' */
+    }
+
+    return (nzaat) ;
+}
+
+/* ========================================================================= */
+/* === compare_keys ======================================================== */
+/* ========================================================================= */
+
+/* CAMD_1 visits the entries of A in steps k = 0 to n-1, and then once more in
+ * a final clean-up step (k = n).  Step k adds the pair {i,j} to columns i and
+ * j of A+A', for each entry A (i,j) of the upper part of column j = k, in
+ * order of i.  Right after each such pair, it adds the pairs of the entries
+ * of the lower part of column i that have not been added yet, have no
+ * matching upper entry, and have a row index less than k.  An entry is thus
+ * added in step s, while scanning column j, with rank r in that scan: r = 0
+ * for the upper entry, and r = 1+i for the lower entry in row i. */
+
+typedef struct
+{
+    Int s ;	/* the step that adds the entry */
+    Int j ;	/* the column of A being scanned */
+    Int r ;	/* the rank of the entry in that scan */
+    Int i ;	/* the row index of the entry in column c of A+A' */
+} aat_key ;
+
+static int compare_keys (const void *p1, const void *p2)
+{
+    const aat_key *a = (const aat_key *) p1, *b = (const aat_key *) p2 ;
+    if (a->s != b->s) return ((a->s < b->s) ? -1 : 1) ;
+    if (a->j != b->j) return ((a->j < b->j) ? -1 : 1) ;
+    if (a->r != b->r) return ((a->r < b->r) ? -1 : 1) ;
+    return (0) ;
+}
+
+/* ========================================================================= */
+/* === CAMD_aat_scatter ==================================================== */
+/* ========================================================================= */
+
+/* Construct the pattern of A+A', without the diagonal, from A and R = A' as
+ * computed by CAMD_aat_par.  Column c is placed in Iw [Pe [c] ... Pe [c] +
+ * Len [c] - 1], in the same order as CAMD_1.  Returns the total, sum (Len), or
+ * EMPTY if out of memory, in which case CAMD_1 must be used instead. */
+
+GLOBAL Int CAMD_aat_scatter
+(
+    Int n,
+    const Int Ap [ ],
+    const Int Ai [ ],
+    const Int Rp [ ],
+    const Int Ri [ ],
+    const Int Len [ ],
+    Int Pe [ ],		/* output of size n */
+    Int Iw [ ]		/* output of size sum (Len) */
+)
+{
+    aat_key *Keys ;
+    Int c, pfree, maxlen, nthreads ;
+
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads ( ) ;
+#else
+    nthreads = 1 ;
+#endif
+    maxlen = 1 ;
+    for (c = 0 ; c < n ; c++)
+    {
+	maxlen = MAX (maxlen, Len [c]) ;
+    }
+    Keys = SuiteSparse_malloc (((size_t) nthreads) * maxlen,
+	sizeof (aat_key)) ;
+    if (Keys == NULL)
+    {
+	return (EMPTY) ;
+    }
+
+    pfree = cumsum (n, Len, Pe) ;
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic,1024) num_threads(nthreads)
+#endif
+    for (c = 0 ; c < n ; c++)
+    {
+	Int pa, pa2, pr, pr2, ia, ir, x, s, k, len ;
+	aat_key *K ;
+#ifdef _OPENMP
+	K = Keys + omp_get_thread_num ( ) * maxlen ;
+#else
+	K = Keys ;
+#endif
+	pa = Ap [c] ;
+	pa2 = Ap [c+1] ;
+	pr = Rp [c] ;
+	pr2 = Rp [c+1] ;
+	len = 0 ;
+	while (pa < pa2 || pr < pr2)
+	{
+	    ia = (pa < pa2) ? Ai [pa] : n ;
+	    ir = (pr < pr2) ? Ri [pr] : n ;
+	    x = MIN (ia, ir) ;
+	    if (x == c)
+	    {
+		/* skip the diagonal */
+	    }
+	    else if (x < c && ia == x)
+	    {
+		/* A (x,c) is in the upper part of column c */
+		K [len].s = c ;
+		K [len].j = x ;
+		K [len].r = 0 ;
+	    }
+	    else if (x > c && ir == x)
+	    {
+		/* A (c,x) is in the upper part of column x */
+		K [len].s = x ;
+		K [len].j = c ;
+		K [len].r = 0 ;
+	    }
+	    else if (x > c)
+	    {
+		/* A (x,c) is in the lower part of column c, and A (c,x) is not
+		 * present.  It is added by the first step after x that scans
+		 * column c, which is the next entry ir of R (:,c), if any. */
+		K [len].s = ir ;
+		K [len].j = c ;
+		K [len].r = 1 + x ;
+	    }
+	    else
+	    {
+		/* A (c,x) is in the lower part of column x, and A (x,c) is not
+		 * present.  It is added by the first step after c that scans
+		 * column x. */
+		s = first_entry (Ri, Rp [x], Rp [x+1], c+1) ;
+		K [len].s = (s < Rp [x+1]) ? Ri [s] : n ;
+		K [len].j = x ;
+		K [len].r = 1 + c ;
+	    }
+	    if (x != c)
+	    {
+		K [len++].i = x ;
+	    }
+	    pa += (ia == x) ;
+	    pr += (ir == x) ;
+	}
+	ASSERT (len == Len [c]) ;
+	qsort (K, len, sizeof (aat_key), compare_keys) ;
+	for (k = 0 ; k < len ; k++)
+	{
+	    Iw [Pe [c] + k] = K [k].i ;
+	}
+    }
+
+    SuiteSparse_free (Keys) ;
+    return (pfree) ;
+}
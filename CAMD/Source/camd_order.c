@@ -29,7 +29,8 @@ GLOBAL Int CAMD_order
     const Int C [ ]
 )
 {
-    Int *Len, *S, nz, i, *Pinv, info, status, *Rp, *Ri, *Cp, *Ci, ok ;
+    Int *Len, *S, nz, i, *Pinv, info, status, *Rp, *Ri, *Cp, *Ci, *Tp, *Ti,
+	ok ;
     size_t nzaat, slen ;
     double mem = 0 ;
 
@@ -139,7 +140,34 @@ GLOBAL Int CAMD_order
     /* determine the symmetry and count off-diagonal nonzeros in A+A' */
     /* --------------------------------------------------------------------- */
 
-    nzaat = CAMD_aat (n, Cp, Ci, Len, P, Info) ;
+    /* Large matrices: A+A' is built in parallel, from C and T = C'.  If T
+     * cannot be allocated, A+A' is built sequentially instead. */
+    Tp = NULL ;
+    Ti = NULL ;
+    if (n >= CAMD_AAT_PAR_MIN)
+    {
+	Tp = SuiteSparse_malloc (n+1, sizeof (Int)) ;
+	Ti = SuiteSparse_malloc (nz,  sizeof (Int)) ;
+	if (!Tp || !Ti)
+	{
+	    Tp = SuiteSparse_free (Tp) ;
+	    Ti = SuiteSparse_free (Ti) ;
+	}
+	else
+	{
+	    mem += (n+1) ;
+	    mem += MAX (nz,1) ;
+	}
+    }
+
+    if (Tp != NULL)
+    {
+	nzaat = CAMD_aat_par (n, Cp, Ci, Len, Tp, Ti, Info) ;
+    }
+    else
+    {
+	nzaat = CAMD_aat (n, Cp, Ci, Len, P, Info) ;
+    }
     CAMD_DEBUG1 (("nzaat: %g\n", (double) nzaat)) ;
     ASSERT ((MAX (nz-n, 0) <= nzaat) && (nzaat <= 2 * (size_t) nz)) ;
 
@@ -167,6 +195,8 @@ GLOBAL Int CAMD_order
     if (!S)
     {
 	/* :: out of memory :: (or problem too large) */
+	SuiteSparse_free (Tp) ;
+	SuiteSparse_free (Ti) ;
 	SuiteSparse_free (Rp) ;
 	SuiteSparse_free (Ri) ;
 	SuiteSparse_free (Len) ;
@@ -184,12 +214,22 @@ GLOBAL Int CAMD_order
     /* order the matrix */
     /* --------------------------------------------------------------------- */
 
-    CAMD_1 (n, Cp, Ci, P, Pinv, Len, slen, S, Control, Info, C) ;
+    if (Tp != NULL)
+    {
+	CAMD_1_par (n, Cp, Ci, Tp, Ti, P, Pinv, Len, slen, S, Control, Info,
+	    C) ;
+    }
+    else
+    {
+	CAMD_1 (n, Cp, Ci, P, Pinv, Len, slen, S, Control, Info, C) ;
+    }
 
     /* --------------------------------------------------------------------- */
     /* free the workspace */
     /* --------------------------------------------------------------------- */
 
+    SuiteSparse_free (Tp) ;
+    SuiteSparse_free (Ti) ;
     SuiteSparse_free (Rp) ;
     SuiteSparse_free (Ri) ;
     SuiteSparse_free (Len) ;
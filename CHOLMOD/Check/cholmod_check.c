@@ -184,6 +184,25 @@ static void print_value
     }
 }
 
+/* print the value of entry p of a factor, in single or double precision */
+
+static void print_factor_value
+(
+    Int print,
+    cholmod_factor *L,
+    Int p,
+    cholmod_common *Common)
+{
+    if (L->dtype == CHOLMOD_SINGLE)
+    {
+	PRINTVALUE ((double) (((float *) L->x) [p])) ;
+    }
+    else
+    {
+	print_value (print, L->xtype, L->x, L->z, p, Common) ;
+    }
+}
+
 /* ========================================================================== */
 /* === cholmod_check_common ================================================= */
 /* ========================================================================== */
@@ -629,6 +648,8 @@ int CHOLMOD(gpu_stats)
     P2 (" time %12.4e\n", Common->CHOLMOD_CPU_TRSM_TIME) ;
     P2 ("      GPU calls %12.0f", (double) Common->CHOLMOD_GPU_TRSM_CALLS) ;
     P2 (" time %12.4e\n", Common->CHOLMOD_GPU_TRSM_TIME) ;
+    P2 ("SMALL CPU calls %12.0f", (double) Common->CHOLMOD_CPU_SMALL_CALLS) ;
+    P2 (" time %12.4e\n", Common->CHOLMOD_CPU_SMALL_TIME) ;
 
     cpu_time = Common->CHOLMOD_CPU_SYRK_TIME + Common->CHOLMOD_CPU_TRSM_TIME +
                Common->CHOLMOD_CPU_GEMM_TIME + Common->CHOLMOD_CPU_POTRF_TIME ;
@@ -639,6 +660,8 @@ int CHOLMOD(gpu_stats)
     P2 ("time in the BLAS: CPU %12.4e", cpu_time) ;
     P2 (" GPU %12.4e", gpu_time) ;
     P2 (" total: %12.4e\n", cpu_time + gpu_time) ;
+    P2 ("time in the small supernode kernels: %12.4e\n",
+        Common->CHOLMOD_CPU_SMALL_TIME) ;
 
     P2 ("assembly time %12.4e", Common->CHOLMOD_ASSEMBLE_TIME) ;
     P2 ("  %12.4e\n", Common->CHOLMOD_ASSEMBLE_TIME2) ;
@@ -1554,11 +1577,13 @@ static int check_factor
     switch (L->dtype)
     {
 	case CHOLMOD_DOUBLE:  P4 ("%s", ", double\n") ;	       break ;
-	case CHOLMOD_SINGLE:  ERR ("single unsupported") ;
+	case CHOLMOD_SINGLE:  P4 ("%s", ", single\n") ;	       break ;
 	default:	      ERR ("unknown dtype") ;
     }
 
-    if (L->itype != ITYPE || L->dtype != DTYPE)
+    /* a real factor may be single precision (see cholmod_factor_dtype) */
+    if (L->itype != ITYPE || (L->dtype != DTYPE &&
+	!(L->dtype == CHOLMOD_SINGLE && L->xtype == CHOLMOD_REAL)))
     {
 	ERR ("integer and real type must match routine") ;
     }
@@ -1749,7 +1774,7 @@ static int check_factor
 		ERR ("diagonal missing") ;
 	    }
 
-	    print_value (print, xtype, Lx, Lz, p, Common) ;
+	    print_factor_value (print, L, p, Common) ;
 
 	    P4 ("%s", "\n") ;
 	    ilast = j ;
@@ -1767,7 +1792,7 @@ static int check_factor
 		    ERR ("row indices out of order") ;
 		}
 
-		print_value (print, xtype, Lx, Lz, p, Common) ;
+		print_factor_value (print, L, p, Common) ;
 
 		P4 ("%s", "\n") ;
 		ilast = i ;
@@ -1946,9 +1971,8 @@ static int check_factor
 			    ERR ("row index invalid") ;
 			}
 
-			/* PRINTVALUE (Lx [psx + jj + jj*nsrow]) ; */
-			print_value (print, xtype, Lx, NULL,
-				psx + jj + jj*nsrow, Common) ;
+			print_factor_value (print, L, psx + jj + jj*nsrow,
+			    Common) ;
 
 			P4 ("%s", "\n") ;
 			for (ii = jj + 1 ; ii < nsrow ; ii++)
@@ -1961,9 +1985,8 @@ static int check_factor
 				ERR ("row index out of range") ;
 			    }
 
-			    /* PRINTVALUE (Lx [psx + ii + jj*nsrow]) ; */
-			    print_value (print, xtype, Lx, NULL,
-				    psx + ii + jj*nsrow, Common) ;
+			    print_factor_value (print, L, psx + ii + jj*nsrow,
+				Common) ;
 
 			    P4 ("%s", "\n") ;
 			    ilast = i ;
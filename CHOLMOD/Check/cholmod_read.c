@@ -56,6 +56,11 @@
  * Note that complex matrices are always returned in CHOLMOD_COMPLEX format,
  * not CHOLMOD_ZOMPLEX.
  *
+ * cholmod_read_triplet_file and cholmod_read_sparse_file read the same format
+ * from a named file, which is mapped into memory and parsed in parallel.
+ * cholmod_read_sparse_binary reads the binary compressed-column format written
+ * by cholmod_write_sparse_binary (see cholmod_write.c), with no parsing.
+ *
  * -----------------------------------------------------------------------------
  * Triplet matrices:
  * -----------------------------------------------------------------------------
@@ -149,9 +154,25 @@
 #include <string.h>
 #include <ctype.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if !defined (_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#define HAVE_MMAP
+#endif
+
 /* The MatrixMarket format specificies a maximum line length of 1024 */
 #define MAXLINE 1030
 
+/* read_triplet_mapped gives each chunk at least this many bytes */
+#define CHUNK_MIN 65536
+
 /* ========================================================================== */
 /* === get_line ============================================================= */
 /* ========================================================================== */
@@ -487,72 +508,62 @@ static int read_header	/* returns TRUE if successful, FALSE on error */
 
 
 /* ========================================================================== */
-/* === read_triplet ========================================================= */
+/* === start_triplet ======================================================== */
 /* ========================================================================== */
 
-/* Header has already been read in, including first line (nrow ncol nnz stype).
- * Read the triplets. */
+/* Determine the stype of the triplet matrix to return, and how much extra
+ * space it needs for the remainder of a symmetric, skew-symmetric or Hermitian
+ * matrix.  Allocates the workspace for finish_triplet.  Returns TRUE if
+ * successful, FALSE otherwise.
+ */
 
-static cholmod_triplet *read_triplet
+static int start_triplet
 (
     /* ---- input ---- */
-    FILE *f,		    /* file to read from, must already be open */
     size_t nrow,	    /* number of rows */
     size_t ncol,	    /* number of columns */
     size_t nnz,		    /* number of triplets in file to read */
-    int stype,		    /* stype from header, or "unknown" */
+    /* ---- in/out --- */
+    int *stype,		    /* in: stype from header; out: stype of T */
+    /* ---- input ---- */
     int prefer_unsym,	    /* if TRUE, always return T->stype of zero */
-    /* ---- workspace */
-    char *buf,		    /* of size MAXLINE+1 */
+    /* ---- output --- */
+    Int *unknown,	    /* TRUE if the stype is not given in the file */
+    Int *skew_symmetric,    /* TRUE if the matrix is skew-symmetric */
+    Int *complex_symmetric, /* TRUE if the matrix is complex symmetric */
+    size_t *extra,	    /* space for the remainder of the matrix */
+    size_t *nnz2,	    /* size of T to allocate (nnz + extra) */
     /* --------------- */
     cholmod_common *Common
 )
 {
-    double x, z ;
-    double *Tx ;
-    Int *Ti, *Tj, *Rdeg, *Cdeg ;
-    cholmod_triplet *T ;
-    double l1, l2 ;
-    Int nitems, xtype, unknown, k, nshould, is_lower, is_upper, one_based, i, j,
-	imax, jmax, skew_symmetric, p, complex_symmetric ;
-    size_t s, nnz2, extra ;
+    size_t s ;
     int ok = TRUE ;
 
-    /* ---------------------------------------------------------------------- */
-    /* quick return for empty matrix */
-    /* ---------------------------------------------------------------------- */
-
-    if (nrow == 0 || ncol == 0 || nnz == 0)
-    {
-	/* return an empty matrix */
-	return (CHOLMOD(allocate_triplet) (nrow, ncol, 0, 0, CHOLMOD_REAL,
-		    Common)) ;
-    }
-
     /* ---------------------------------------------------------------------- */
     /* special stype cases: unknown, skew symmetric, and complex symmetric  */
     /* ---------------------------------------------------------------------- */
 
-    unknown = (stype == STYPE_UNKNOWN) ;
-    skew_symmetric = (stype == STYPE_SKEW_SYMMETRIC) ;
-    complex_symmetric = (stype == STYPE_COMPLEX_SYMMETRIC_LOWER) ;
+    *unknown = (*stype == STYPE_UNKNOWN) ;
+    *skew_symmetric = (*stype == STYPE_SKEW_SYMMETRIC) ;
+    *complex_symmetric = (*stype == STYPE_COMPLEX_SYMMETRIC_LOWER) ;
 
-    extra = 0 ;
-    if (stype < STYPE_SYMMETRIC_LOWER
-	|| (prefer_unsym && stype != STYPE_UNSYMMETRIC))
+    *extra = 0 ;
+    if (*stype < STYPE_SYMMETRIC_LOWER
+	|| (prefer_unsym && *stype != STYPE_UNSYMMETRIC))
     {
 	/* 999: unknown might be converted to unsymmetric */
 	/*  1:  symmetric upper converted to unsym. if prefer_unsym is TRUE */
 	/* -1:  symmetric lower converted to unsym. if prefer_unsym is TRUE */
 	/* -2:  real or complex skew symmetric converted to unsymmetric */
 	/* -3:  complex symmetric converted to unsymmetric */
-	stype = STYPE_UNSYMMETRIC ;
-	extra = nnz ;
+	*stype = STYPE_UNSYMMETRIC ;
+	*extra = nnz ;
     }
-    nnz2 = CHOLMOD(add_size_t) (nnz, extra, &ok) ;
+    *nnz2 = CHOLMOD(add_size_t) (nnz, *extra, &ok) ;
 
     /* ---------------------------------------------------------------------- */
-    /* allocate workspace */
+    /* allocate workspace for finish_triplet */
     /* ---------------------------------------------------------------------- */
 
     /* s = nrow + ncol */
@@ -560,151 +571,62 @@ static cholmod_triplet *read_triplet
     if (!ok || nrow > Int_max || ncol > Int_max || nnz > Int_max)
     {
 	ERROR (CHOLMOD_TOO_LARGE, "problem too large") ;
-	return (NULL) ;
+	return (FALSE) ;
     }
 
     CHOLMOD(allocate_work) (0, s, 0, Common) ;
-    Rdeg = Common->Iwork ;	/* size nrow */
-    Cdeg = Rdeg + nrow ;	/* size ncol */
-
-    /* ---------------------------------------------------------------------- */
-    /* read the triplets */
-    /* ---------------------------------------------------------------------- */
-
-    is_lower = TRUE ;
-    is_upper = TRUE ;
-    one_based = TRUE ;
-    imax = 0 ;
-    jmax = 0 ;
-
-    Tx = NULL ;
-    Ti = NULL ;
-    Tj = NULL ;
-    xtype = 999 ;
-    nshould = 0 ;
-
-    for (k = 0 ; k < (Int) nnz ; k++)
+    if (Common->status < CHOLMOD_OK)
     {
+	/* out of memory */
+	return (FALSE) ;
+    }
+    return (TRUE) ;
 
-	/* ------------------------------------------------------------------ */
-	/* get the next triplet, skipping blank lines and comment lines */
-	/* ------------------------------------------------------------------ */
-
-	l1 = EMPTY ;
-	l2 = EMPTY ;
-	x = 0 ;
-	z = 0 ;
-
-	for ( ; ; )
-	{
-	    if (!get_line (f, buf))
-	    {
-		/* premature end of file - not enough triplets read in */
-		ERROR (CHOLMOD_INVALID, "premature EOF") ;
-		return (NULL) ;
-	    }
-	    if (is_blank_line (buf))
-	    {
-		/* blank line or comment */
-		continue ;
-	    }
-	    nitems = sscanf (buf, "%lg %lg %lg %lg\n", &l1, &l2, &x, &z) ;
-	    x = fix_inf (x) ;
-	    z = fix_inf (z) ;
-	    break ;
-	}
-
-	nitems = (nitems == EOF) ? 0 : nitems ;
-	i = l1 ;
-	j = l2 ;
-
-	/* ------------------------------------------------------------------ */
-	/* for first triplet: determine type and allocate triplet matrix */
-	/* ------------------------------------------------------------------ */
-
-	if (k == 0)
-	{
-	    if (nitems < 2 || nitems > 4)
-	    {
-		/* invalid matrix */
-		ERROR (CHOLMOD_INVALID, "invalid format") ;
-		return (NULL) ;
-	    }
-	    else if (nitems == 2)
-	    {
-		/* this will be converted into a real matrix later */
-		xtype = CHOLMOD_PATTERN ;
-	    }
-	    else if (nitems == 3)
-	    {
-		xtype = CHOLMOD_REAL ;
-	    }
-	    else if (nitems == 4)
-	    {
-		xtype = CHOLMOD_COMPLEX ;
-	    }
-
-	    /* the rest of the lines should have the same number of entries */
-	    nshould = nitems ;
-
-	    /* allocate triplet matrix */
-	    T = CHOLMOD(allocate_triplet) (nrow, ncol, nnz2, stype,
-		    (xtype == CHOLMOD_PATTERN ? CHOLMOD_REAL : xtype), Common) ;
-	    if (Common->status < CHOLMOD_OK)
-	    {
-		/* out of memory */
-		return (NULL) ;
-	    }
-	    Ti = T->i ;
-	    Tj = T->j ;
-	    Tx = T->x ;
-	    T->nnz = nnz ;
-	}
-
-	/* ------------------------------------------------------------------ */
-	/* save the entry in the triplet matrix */
-	/* ------------------------------------------------------------------ */
-
-	if (nitems != nshould || i < 0 || j < 0)
-	{
-	    /* wrong format, premature end-of-file, or negative indices */
-	    CHOLMOD(free_triplet) (&T, Common) ;
-	    ERROR (CHOLMOD_INVALID, "invalid matrix file") ;
-	    return (NULL) ;
-	}
+}
 
-	Ti [k] = i ;
-	Tj [k] = j ;
 
-	if (i < j)
-	{
-	    /* this entry is in the upper triangular part */
-	    is_lower = FALSE ;
-	}
-	if (i > j)
-	{
-	    /* this entry is in the lower triangular part */
-	    is_upper = FALSE ;
-	}
+/* ========================================================================== */
+/* === finish_triplet ======================================================= */
+/* ========================================================================== */
 
-	if (xtype == CHOLMOD_REAL)
-	{
-	    Tx [k] = x ;
-	}
-	else if (xtype == CHOLMOD_COMPLEX)
-	{
-	    Tx [2*k  ] = x ;	/* real part */
-	    Tx [2*k+1] = z ;	/* imaginary part */
-	}
+/* All nnz triplets have been read into T.  Convert T to zero-based, check the
+ * indices, determine the stype if not yet known, add the remainder of
+ * symmetric, skew-symmetric and Hermitian matrices, and create the values of a
+ * pattern-only matrix.  T is freed on error.  Shared by read_triplet and
+ * read_triplet_mapped.
+ */
 
-	if (i == 0 || j == 0)
-	{
-	    one_based = FALSE ;
-	}
+static cholmod_triplet *finish_triplet
+(
+    /* ---- input ---- */
+    cholmod_triplet *T,	    /* triplets read in, with T->nnz = nnz */
+    size_t nrow,	    /* number of rows */
+    size_t ncol,	    /* number of columns */
+    size_t nnz,		    /* number of triplets read in */
+    Int xtype,		    /* pattern, real, or complex, from the file */
+    int stype,		    /* stype of T (after conversion to unsymmetric) */
+    Int unknown,	    /* TRUE if the stype is not given in the file */
+    Int skew_symmetric,	    /* TRUE if the matrix is skew-symmetric */
+    Int complex_symmetric,  /* TRUE if the matrix is complex symmetric */
+    size_t extra,	    /* space in T for the remainder of the matrix */
+    Int is_lower,	    /* TRUE if no entries are in the upper part */
+    Int is_upper,	    /* TRUE if no entries are in the lower part */
+    Int one_based,	    /* TRUE if no zero index appears in the file */
+    Int imax,		    /* largest row index in the file */
+    Int jmax,		    /* largest column index in the file */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double *Tx ;
+    Int *Ti, *Tj, *Rdeg, *Cdeg ;
+    Int k, i, j, p ;
 
-	imax = MAX (i, imax) ;
-	jmax = MAX (j, jmax) ;
-    }
+    Ti = T->i ;
+    Tj = T->j ;
+    Tx = T->x ;
+    Rdeg = Common->Iwork ;	/* size nrow */
+    Cdeg = Rdeg + nrow ;	/* size ncol */
 
     /* ---------------------------------------------------------------------- */
     /* convert to zero-based */
@@ -871,19 +793,21 @@ static cholmod_triplet *read_triplet
 
 
 /* ========================================================================== */
-/* === read_dense =========================================================== */
+/* === read_triplet ========================================================= */
 /* ========================================================================== */
 
-/* Header has already been read in, including first line (nrow ncol).
- * Read a dense matrix. */
+/* Header has already been read in, including first line (nrow ncol nnz stype).
+ * Read the triplets. */
 
-static cholmod_dense *read_dense
+static cholmod_triplet *read_triplet
 (
     /* ---- input ---- */
     FILE *f,		    /* file to read from, must already be open */
     size_t nrow,	    /* number of rows */
     size_t ncol,	    /* number of columns */
-    int stype,		    /* stype from header */
+    size_t nnz,		    /* number of triplets in file to read */
+    int stype,		    /* stype from header, or "unknown" */
+    int prefer_unsym,	    /* if TRUE, always return T->stype of zero */
     /* ---- workspace */
     char *buf,		    /* of size MAXLINE+1 */
     /* --------------- */
@@ -891,53 +815,782 @@ static cholmod_dense *read_dense
 )
 {
     double x, z ;
-    double *Xx = NULL ;
-    cholmod_dense *X ;
-    Int nitems, xtype = -1, nshould = 0, i, j, k, kup, first ;
+    double *Tx ;
+    Int *Ti, *Tj ;
+    cholmod_triplet *T ;
+    double l1, l2 ;
+    Int nitems, xtype, unknown, k, nshould, is_lower, is_upper, one_based, i, j,
+	imax, jmax, skew_symmetric, complex_symmetric ;
+    size_t nnz2, extra ;
 
     /* ---------------------------------------------------------------------- */
     /* quick return for empty matrix */
     /* ---------------------------------------------------------------------- */
 
-    if (nrow == 0 || ncol == 0)
+    if (nrow == 0 || ncol == 0 || nnz == 0)
     {
-	/* return an empty dense matrix */
-	return (CHOLMOD(zeros) (nrow, ncol, CHOLMOD_REAL, Common)) ;
+	/* return an empty matrix */
+	return (CHOLMOD(allocate_triplet) (nrow, ncol, 0, 0, CHOLMOD_REAL,
+		    Common)) ;
     }
 
     /* ---------------------------------------------------------------------- */
-    /* read the entries */
+    /* determine the stype and allocate workspace */
     /* ---------------------------------------------------------------------- */
 
-    first = TRUE ;
-
-    for (j = 0 ; j < (Int) ncol ; j++)
+    if (!start_triplet (nrow, ncol, nnz, &stype, prefer_unsym, &unknown,
+	&skew_symmetric, &complex_symmetric, &extra, &nnz2, Common))
     {
+	return (NULL) ;
+    }
 
-	/* ------------------------------------------------------------------ */
-	/* get the row index of the first entry in the file for column j */
-	/* ------------------------------------------------------------------ */
+    /* ---------------------------------------------------------------------- */
+    /* read the triplets */
+    /* ---------------------------------------------------------------------- */
 
-	if (stype == STYPE_UNSYMMETRIC)
-	{
-	    i = 0 ;
-	}
-	else if (stype == STYPE_SKEW_SYMMETRIC)
-	{
-	    i = j+1 ;
-	}
-	else /* real symmetric or complex Hermitian lower */
-	{
-	    i = j ;
-	}
+    is_lower = TRUE ;
+    is_upper = TRUE ;
+    one_based = TRUE ;
+    imax = 0 ;
+    jmax = 0 ;
+
+    T = NULL ;
+    Tx = NULL ;
+    Ti = NULL ;
+    Tj = NULL ;
+    xtype = 999 ;
+    nshould = 0 ;
+
+    for (k = 0 ; k < (Int) nnz ; k++)
+    {
 
 	/* ------------------------------------------------------------------ */
-	/* get column j */
+	/* get the next triplet, skipping blank lines and comment lines */
 	/* ------------------------------------------------------------------ */
 
-	for ( ; i < (Int) nrow ; i++)
-	{
-
+	l1 = EMPTY ;
+	l2 = EMPTY ;
+	x = 0 ;
+	z = 0 ;
+
+	for ( ; ; )
+	{
+	    if (!get_line (f, buf))
+	    {
+		/* premature end of file - not enough triplets read in */
+		CHOLMOD(free_triplet) (&T, Common) ;
+		ERROR (CHOLMOD_INVALID, "premature EOF") ;
+		return (NULL) ;
+	    }
+	    if (is_blank_line (buf))
+	    {
+		/* blank line or comment */
+		continue ;
+	    }
+	    nitems = sscanf (buf, "%lg %lg %lg %lg\n", &l1, &l2, &x, &z) ;
+	    x = fix_inf (x) ;
+	    z = fix_inf (z) ;
+	    break ;
+	}
+
+	nitems = (nitems == EOF) ? 0 : nitems ;
+	i = l1 ;
+	j = l2 ;
+
+	/* ------------------------------------------------------------------ */
+	/* for first triplet: determine type and allocate triplet matrix */
+	/* ------------------------------------------------------------------ */
+
+	if (k == 0)
+	{
+	    if (nitems < 2 || nitems > 4)
+	    {
+		/* invalid matrix */
+		ERROR (CHOLMOD_INVALID, "invalid format") ;
+		return (NULL) ;
+	    }
+	    else if (nitems == 2)
+	    {
+		/* this will be converted into a real matrix later */
+		xtype = CHOLMOD_PATTERN ;
+	    }
+	    else if (nitems == 3)
+	    {
+		xtype = CHOLMOD_REAL ;
+	    }
+	    else if (nitems == 4)
+	    {
+		xtype = CHOLMOD_COMPLEX ;
+	    }
+
+	    /* the rest of the lines should have the same number of entries */
+	    nshould = nitems ;
+
+	    /* allocate triplet matrix */
+	    T = CHOLMOD(allocate_triplet) (nrow, ncol, nnz2, stype,
+		    (xtype == CHOLMOD_PATTERN ? CHOLMOD_REAL : xtype), Common) ;
+	    if (Common->status < CHOLMOD_OK)
+	    {
+		/* out of memory */
+		return (NULL) ;
+	    }
+	    Ti = T->i ;
+	    Tj = T->j ;
+	    Tx = T->x ;
+	    T->nnz = nnz ;
+	}
+
+	/* ------------------------------------------------------------------ */
+	/* save the entry in the triplet matrix */
+	/* ------------------------------------------------------------------ */
+
+	if (nitems != nshould || i < 0 || j < 0)
+	{
+	    /* wrong format, premature end-of-file, or negative indices */
+	    CHOLMOD(free_triplet) (&T, Common) ;
+	    ERROR (CHOLMOD_INVALID, "invalid matrix file") ;
+	    return (NULL) ;
+	}
+
+	Ti [k] = i ;
+	Tj [k] = j ;
+
+	if (i < j)
+	{
+	    /* this entry is in the upper triangular part */
+	    is_lower = FALSE ;
+	}
+	if (i > j)
+	{
+	    /* this entry is in the lower triangular part */
+	    is_upper = FALSE ;
+	}
+
+	if (xtype == CHOLMOD_REAL)
+	{
+	    Tx [k] = x ;
+	}
+	else if (xtype == CHOLMOD_COMPLEX)
+	{
+	    Tx [2*k  ] = x ;	/* real part */
+	    Tx [2*k+1] = z ;	/* imaginary part */
+	}
+
+	if (i == 0 || j == 0)
+	{
+	    one_based = FALSE ;
+	}
+
+	imax = MAX (i, imax) ;
+	jmax = MAX (j, jmax) ;
+    }
+
+    return (finish_triplet (T, nrow, ncol, nnz, xtype, stype, unknown,
+	skew_symmetric, complex_symmetric, extra, is_lower, is_upper, one_based,
+	imax, jmax, Common)) ;
+}
+
+
+/* ========================================================================== */
+/* === map_file ============================================================= */
+/* ========================================================================== */
+
+/* Map an entire file into memory, read-only.  If mmap is not available, or if
+ * it fails, the file is read into a buffer allocated by cholmod_malloc
+ * instead (*mapped is FALSE).  Returns NULL if the file cannot be opened or
+ * read.
+ */
+
+static char *map_file
+(
+    /* ---- input ---- */
+    const char *filename,   /* name of the file to map */
+    /* ---- output --- */
+    size_t *size,	    /* size of the file, in bytes */
+    int *mapped,	    /* TRUE if mmap was used */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    char *data = NULL ;
+    FILE *f ;
+    long len ;
+
+    *size = 0 ;
+    *mapped = FALSE ;
+
+#ifdef HAVE_MMAP
+    {
+	struct stat st ;
+	void *m ;
+	int fd = open (filename, O_RDONLY) ;
+	if (fd >= 0)
+	{
+	    if (fstat (fd, &st) == 0 && st.st_size > 0)
+	    {
+		m = mmap (NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+		    fd, 0) ;
+		if (m != MAP_FAILED)
+		{
+		    data = m ;
+		    *size = (size_t) st.st_size ;
+		    *mapped = TRUE ;
+		}
+	    }
+	    close (fd) ;
+	}
+	if (*mapped)
+	{
+	    return (data) ;
+	}
+    }
+#endif
+
+    /* mmap not available or failed; read the whole file instead */
+    f = fopen (filename, "rb") ;
+    if (f == NULL)
+    {
+	return (NULL) ;
+    }
+    if (fseek (f, 0, SEEK_END) != 0 || (len = ftell (f)) < 0
+	|| fseek (f, 0, SEEK_SET) != 0)
+    {
+	fclose (f) ;
+	return (NULL) ;
+    }
+    data = CHOLMOD(malloc) ((size_t) len + 1, sizeof (char), Common) ;
+    if (data != NULL && fread (data, 1, (size_t) len, f) != (size_t) len)
+    {
+	CHOLMOD(free) ((size_t) len + 1, sizeof (char), data, Common) ;
+	data = NULL ;
+    }
+    fclose (f) ;
+    *size = (size_t) len ;
+    return (data) ;
+}
+
+
+/* ========================================================================== */
+/* === unmap_file =========================================================== */
+/* ========================================================================== */
+
+/* Release a file mapped or read by map_file. */
+
+static void unmap_file (char *data, size_t size, int mapped,
+    cholmod_common *Common)
+{
+#ifdef HAVE_MMAP
+    if (mapped)
+    {
+	munmap (data, size) ;
+	return ;
+    }
+#endif
+    CHOLMOD(free) (size + 1, sizeof (char), data, Common) ;
+}
+
+
+/* ========================================================================== */
+/* === next_line ============================================================ */
+/* ========================================================================== */
+
+/* Return the end of the line starting at s (the newline, or the end of the
+ * buffer if the last line has no newline). */
+
+static const char *next_line (const char *s, const char *end)
+{
+    const char *e = memchr (s, '\n', end - s) ;
+    return ((e == NULL) ? end : e) ;
+}
+
+
+/* ========================================================================== */
+/* === is_blank_range ======================================================= */
+/* ========================================================================== */
+
+/* TRUE if the line s [0..e-1] is blank or a comment, FALSE otherwise.  Same
+ * as is_blank_line, for a line that is not NUL-terminated. */
+
+static int is_blank_range (const char *s, const char *e)
+{
+    if (s < e && s [0] == '%')
+    {
+	/* a comment line */
+	return (TRUE) ;
+    }
+    for ( ; s < e ; s++)
+    {
+	if (!isspace ((unsigned char) *s))
+	{
+	    /* non-space character */
+	    return (FALSE) ;
+	}
+    }
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === parse_double ========================================================= */
+/* ========================================================================== */
+
+/* Parse the number in the token t [0..len-1], which contains no white space.
+ * Returns the number of characters parsed (0 if the token does not start with
+ * a number).  Numbers with at most 15 significant digits and a decimal
+ * exponent of at most 22 in magnitude are exact in double precision, and
+ * their product or quotient is correctly rounded (Clinger's fast path).  All
+ * other numbers (and inf, nan, hexadecimal, ...) are handed to strtod, so the
+ * result is the same as the %lg format of sscanf in read_triplet.
+ */
+
+static size_t parse_double (const char *t, size_t len, double *x)
+{
+    static const double power10 [23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+	1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+	1e19, 1e20, 1e21, 1e22 } ;
+    char buf [64], *tend ;
+    double m = 0 ;
+    size_t k = 0 ;
+    int neg = FALSE, ndigits = 0, nsig = 0, e10 = 0, e = 0, eneg = FALSE ;
+
+    /* ---------------------------------------------------------------------- */
+    /* fast path: [+-]digits[.digits][(e|E)[+-]digits] */
+    /* ---------------------------------------------------------------------- */
+
+    if (k < len && (t [k] == '-' || t [k] == '+'))
+    {
+	neg = (t [k++] == '-') ;
+    }
+    for ( ; k < len && isdigit ((unsigned char) t [k]) ; k++, ndigits++)
+    {
+	if (m > 0 || t [k] != '0') nsig++ ;
+	m = 10 * m + (t [k] - '0') ;
+    }
+    if (k < len && t [k] == '.')
+    {
+	for (k++ ; k < len && isdigit ((unsigned char) t [k]) ; k++, ndigits++)
+	{
+	    if (m > 0 || t [k] != '0') nsig++ ;
+	    m = 10 * m + (t [k] - '0') ;
+	    e10-- ;
+	}
+    }
+    if (ndigits > 0 && k < len && (t [k] == 'e' || t [k] == 'E'))
+    {
+	k++ ;
+	if (k < len && (t [k] == '-' || t [k] == '+'))
+	{
+	    eneg = (t [k++] == '-') ;
+	}
+	if (k == len || !isdigit ((unsigned char) t [k]))
+	{
+	    /* "1e" or "1e+" with no exponent digits */
+	    ndigits = 0 ;
+	}
+	for ( ; k < len && isdigit ((unsigned char) t [k]) && e < 1000 ; k++)
+	{
+	    e = 10 * e + (t [k] - '0') ;
+	}
+	e10 += eneg ? (-e) : e ;
+    }
+    if (ndigits > 0 && k == len && nsig <= 15 && e10 >= -22 && e10 <= 22)
+    {
+	m = (e10 < 0) ? (m / power10 [-e10]) : (m * power10 [e10]) ;
+	*x = neg ? (-m) : m ;
+	return (len) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* slow path: use strtod on a NUL-terminated copy of the token */
+    /* ---------------------------------------------------------------------- */
+
+    len = MIN (len, sizeof (buf) - 1) ;
+    memcpy (buf, t, len) ;
+    buf [len] = '\0' ;
+    *x = strtod (buf, &tend) ;
+    return ((size_t) (tend - buf)) ;
+}
+
+
+/* ========================================================================== */
+/* === parse_line =========================================================== */
+/* ========================================================================== */
+
+/* Parse up to 4 numbers in the line s [0..e-1].  Returns the number of numbers
+ * parsed, just like sscanf (buf, "%lg %lg %lg %lg\n", ...) in read_triplet.
+ */
+
+static Int parse_line (const char *s, const char *e, double *v)
+{
+    const char *t ;
+    size_t len, k ;
+    Int nitems ;
+
+    for (nitems = 0 ; nitems < 4 ; nitems++)
+    {
+	while (s < e && isspace ((unsigned char) *s)) s++ ;
+	for (t = s ; t < e && !isspace ((unsigned char) *t) ; t++) ;
+	len = t - s ;
+	k = (len == 0) ? 0 : parse_double (s, len, &v [nitems]) ;
+	if (k == 0)
+	{
+	    /* no number here */
+	    break ;
+	}
+	if (k < len)
+	{
+	    /* a number followed by junk: sscanf stops here too */
+	    nitems++ ;
+	    break ;
+	}
+	s = t ;
+    }
+    return (nitems) ;
+}
+
+
+/* ========================================================================== */
+/* === read_triplet_mapped ================================================== */
+/* ========================================================================== */
+
+/* Same as read_triplet, except that the file has been mapped into memory
+ * (data [0..size-1]), and the header has already been parsed, ending at
+ * data [offset].  The triplets are split into chunks at line boundaries, and
+ * each chunk is parsed by a separate thread.  A first pass counts the entry
+ * lines in each chunk (skipping comments and blank lines), so that a second
+ * pass can place each triplet directly into its position in T.
+ */
+
+static cholmod_triplet *read_triplet_mapped
+(
+    /* ---- input ---- */
+    const char *data,	    /* the file, of size size */
+    size_t size,
+    size_t offset,	    /* the triplets start at data [offset] */
+    size_t nrow,	    /* number of rows */
+    size_t ncol,	    /* number of columns */
+    size_t nnz,		    /* number of triplets in file to read */
+    int stype,		    /* stype from header, or "unknown" */
+    int prefer_unsym,	    /* if TRUE, always return T->stype of zero */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double v [4] ;
+    double *Tx ;
+    Int *Ti, *Tj ;
+    cholmod_triplet *T ;
+    const char *s, *e, *end ;
+    size_t *Cstart, *Kstart ;
+    size_t nnz2, extra, nchunks, c ;
+    Int nitems, xtype, unknown, nshould, is_lower, is_upper, one_based,
+	imax, jmax, skew_symmetric, complex_symmetric, nbad ;
+    int nthreads ;
+
+    /* ---------------------------------------------------------------------- */
+    /* quick return for empty matrix */
+    /* ---------------------------------------------------------------------- */
+
+    if (nrow == 0 || ncol == 0 || nnz == 0)
+    {
+	/* return an empty matrix */
+	return (CHOLMOD(allocate_triplet) (nrow, ncol, 0, 0, CHOLMOD_REAL,
+		    Common)) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* determine the stype and allocate workspace */
+    /* ---------------------------------------------------------------------- */
+
+    if (!start_triplet (nrow, ncol, nnz, &stype, prefer_unsym, &unknown,
+	&skew_symmetric, &complex_symmetric, &extra, &nnz2, Common))
+    {
+	return (NULL) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* parse the first triplet to determine the xtype */
+    /* ---------------------------------------------------------------------- */
+
+    end = data + size ;
+    nitems = 0 ;
+    for (s = data + offset ; s < end ; s = e + 1)
+    {
+	e = next_line (s, end) ;
+	if (!is_blank_range (s, e))
+	{
+	    nitems = parse_line (s, e, v) ;
+	    break ;
+	}
+    }
+    if (s >= end)
+    {
+	/* premature end of file - no triplets at all */
+	ERROR (CHOLMOD_INVALID, "premature EOF") ;
+	return (NULL) ;
+    }
+    if (nitems < 2 || nitems > 4)
+    {
+	/* invalid matrix */
+	ERROR (CHOLMOD_INVALID, "invalid format") ;
+	return (NULL) ;
+    }
+    xtype = (nitems == 2) ? CHOLMOD_PATTERN :
+	   ((nitems == 3) ? CHOLMOD_REAL : CHOLMOD_COMPLEX) ;
+
+    /* the rest of the lines should have the same number of entries */
+    nshould = nitems ;
+
+    /* ---------------------------------------------------------------------- */
+    /* split the triplets into chunks, at line boundaries */
+    /* ---------------------------------------------------------------------- */
+
+    offset = s - data ;
+    nthreads = 1 ;
+#ifdef _OPENMP
+    nthreads = MAX (1, Common->nthreads_max) ;
+#endif
+    nchunks = MAX (1, (size - offset) / CHUNK_MIN) ;
+    nchunks = MIN (nchunks, 8 * (size_t) nthreads) ;
+
+    Cstart = CHOLMOD(malloc) (2*(nchunks+1), sizeof (size_t), Common) ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	/* out of memory */
+	return (NULL) ;
+    }
+    Kstart = Cstart + nchunks + 1 ;
+
+    Cstart [0] = offset ;
+    for (c = 1 ; c < nchunks ; c++)
+    {
+	/* chunk c starts at the first line starting at or after its share */
+	s = data + MAX (Cstart [c-1], offset + c * ((size - offset) / nchunks)) ;
+	if (s > data + offset && s [-1] != '\n')
+	{
+	    e = next_line (s, end) ;
+	    s = (e < end) ? (e + 1) : end ;
+	}
+	Cstart [c] = s - data ;
+    }
+    Cstart [nchunks] = size ;
+
+    /* ---------------------------------------------------------------------- */
+    /* count the triplets in each chunk */
+    /* ---------------------------------------------------------------------- */
+
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic,1) \
+	private(s, e)
+#endif
+    for (c = 0 ; c < nchunks ; c++)
+    {
+	size_t count = 0 ;
+	const char *cend = data + Cstart [c+1] ;
+	for (s = data + Cstart [c] ; s < cend ; s = e + 1)
+	{
+	    e = next_line (s, cend) ;
+	    if (!is_blank_range (s, e))
+	    {
+		count++ ;
+	    }
+	}
+	Kstart [c+1] = count ;
+    }
+
+    /* Kstart [c] = the index of the first triplet in chunk c */
+    Kstart [0] = 0 ;
+    for (c = 0 ; c < nchunks ; c++)
+    {
+	Kstart [c+1] = MIN (Kstart [c] + Kstart [c+1], nnz) ;
+    }
+    if (Kstart [nchunks] < nnz)
+    {
+	/* premature end of file - not enough triplets in the file */
+	CHOLMOD(free) (2*(nchunks+1), sizeof (size_t), Cstart, Common) ;
+	ERROR (CHOLMOD_INVALID, "premature EOF") ;
+	return (NULL) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate the triplet matrix */
+    /* ---------------------------------------------------------------------- */
+
+    T = CHOLMOD(allocate_triplet) (nrow, ncol, nnz2, stype,
+	    (xtype == CHOLMOD_PATTERN ? CHOLMOD_REAL : xtype), Common) ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	/* out of memory */
+	CHOLMOD(free) (2*(nchunks+1), sizeof (size_t), Cstart, Common) ;
+	return (NULL) ;
+    }
+    Ti = T->i ;
+    Tj = T->j ;
+    Tx = T->x ;
+    T->nnz = nnz ;
+
+    /* ---------------------------------------------------------------------- */
+    /* parse each chunk directly into T */
+    /* ---------------------------------------------------------------------- */
+
+    is_lower = TRUE ;
+    is_upper = TRUE ;
+    one_based = TRUE ;
+    imax = 0 ;
+    jmax = 0 ;
+    nbad = 0 ;
+
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic,1) \
+	private(s, e, v, nitems) reduction(&&:is_lower,is_upper,one_based) \
+	reduction(max:imax,jmax) reduction(+:nbad)
+#endif
+    for (c = 0 ; c < nchunks ; c++)
+    {
+	double x, z ;
+	Int i, j ;
+	size_t k = Kstart [c], klast = Kstart [c+1] ;
+	const char *cend = data + Cstart [c+1] ;
+	for (s = data + Cstart [c] ; s < cend && k < klast ; s = e + 1)
+	{
+	    e = next_line (s, cend) ;
+	    if (is_blank_range (s, e))
+	    {
+		/* blank line or comment */
+		continue ;
+	    }
+	    v [0] = EMPTY ;
+	    v [1] = EMPTY ;
+	    v [2] = 0 ;
+	    v [3] = 0 ;
+	    nitems = parse_line (s, e, v) ;
+	    i = v [0] ;
+	    j = v [1] ;
+	    x = fix_inf (v [2]) ;
+	    z = fix_inf (v [3]) ;
+	    if (nitems != nshould || i < 0 || j < 0)
+	    {
+		/* wrong format or negative indices */
+		nbad++ ;
+		break ;
+	    }
+	    Ti [k] = i ;
+	    Tj [k] = j ;
+	    if (i < j)
+	    {
+		/* this entry is in the upper triangular part */
+		is_lower = FALSE ;
+	    }
+	    if (i > j)
+	    {
+		/* this entry is in the lower triangular part */
+		is_upper = FALSE ;
+	    }
+	    if (xtype == CHOLMOD_REAL)
+	    {
+		Tx [k] = x ;
+	    }
+	    else if (xtype == CHOLMOD_COMPLEX)
+	    {
+		Tx [2*k  ] = x ;	/* real part */
+		Tx [2*k+1] = z ;	/* imaginary part */
+	    }
+	    if (i == 0 || j == 0)
+	    {
+		one_based = FALSE ;
+	    }
+	    imax = MAX (i, imax) ;
+	    jmax = MAX (j, jmax) ;
+	    k++ ;
+	}
+    }
+
+    CHOLMOD(free) (2*(nchunks+1), sizeof (size_t), Cstart, Common) ;
+    if (nbad > 0)
+    {
+	CHOLMOD(free_triplet) (&T, Common) ;
+	ERROR (CHOLMOD_INVALID, "invalid matrix file") ;
+	return (NULL) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* finish the triplet matrix, just as read_triplet does */
+    /* ---------------------------------------------------------------------- */
+
+    return (finish_triplet (T, nrow, ncol, nnz, xtype, stype, unknown,
+	skew_symmetric, complex_symmetric, extra, is_lower, is_upper, one_based,
+	imax, jmax, Common)) ;
+}
+
+
+/* ========================================================================== */
+/* === read_dense =========================================================== */
+/* ========================================================================== */
+
+/* Header has already been read in, including first line (nrow ncol).
+ * Read a dense matrix. */
+
+static cholmod_dense *read_dense
+(
+    /* ---- input ---- */
+    FILE *f,		    /* file to read from, must already be open */
+    size_t nrow,	    /* number of rows */
+    size_t ncol,	    /* number of columns */
+    int stype,		    /* stype from header */
+    /* ---- workspace */
+    char *buf,		    /* of size MAXLINE+1 */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double x, z ;
+    double *Xx = NULL ;
+    cholmod_dense *X ;
+    Int nitems, xtype = -1, nshould = 0, i, j, k, kup, first ;
+
+    /* ---------------------------------------------------------------------- */
+    /* quick return for empty matrix */
+    /* ---------------------------------------------------------------------- */
+
+    if (nrow == 0 || ncol == 0)
+    {
+	/* return an empty dense matrix */
+	return (CHOLMOD(zeros) (nrow, ncol, CHOLMOD_REAL, Common)) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* read the entries */
+    /* ---------------------------------------------------------------------- */
+
+    first = TRUE ;
+
+    for (j = 0 ; j < (Int) ncol ; j++)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* get the row index of the first entry in the file for column j */
+	/* ------------------------------------------------------------------ */
+
+	if (stype == STYPE_UNSYMMETRIC)
+	{
+	    i = 0 ;
+	}
+	else if (stype == STYPE_SKEW_SYMMETRIC)
+	{
+	    i = j+1 ;
+	}
+	else /* real symmetric or complex Hermitian lower */
+	{
+	    i = j ;
+	}
+
+	/* ------------------------------------------------------------------ */
+	/* get column j */
+	/* ------------------------------------------------------------------ */
+
+	for ( ; i < (Int) nrow ; i++)
+	{
+
 	    /* -------------------------------------------------------------- */
 	    /* get the next entry, skipping blank lines and comment lines */
 	    /* -------------------------------------------------------------- */
@@ -1170,6 +1823,128 @@ cholmod_sparse *CHOLMOD(read_sparse)
 }
 
 
+/* ========================================================================== */
+/* === cholmod_read_triplet_file ============================================ */
+/* ========================================================================== */
+
+/* Read in a triplet matrix from a named file.  The file format and the result
+ * are the same as cholmod_read_triplet, but the file is mapped into memory
+ * (with mmap, if available) and the triplets are parsed in parallel, with up
+ * to Common->nthreads_max threads.  Numbers are converted with a fast parser
+ * that gives the same result as the sscanf used by cholmod_read_triplet.
+ * Lines longer than 1024 characters are not truncated.
+ */
+
+cholmod_triplet *CHOLMOD(read_triplet_file)
+(
+    /* ---- input ---- */
+    const char *filename,   /* name of the file to read */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    char buf [MAXLINE+1] ;
+    cholmod_triplet *T ;
+    FILE *f ;
+    char *data ;
+    size_t nrow, ncol, nnz, size ;
+    long offset ;
+    int stype, mtype, mapped, ok ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    RETURN_IF_NULL_COMMON (NULL) ;
+    RETURN_IF_NULL (filename, NULL) ;
+    Common->status = CHOLMOD_OK ;
+
+    /* ---------------------------------------------------------------------- */
+    /* read the header and first data line */
+    /* ---------------------------------------------------------------------- */
+
+    f = fopen (filename, "r") ;
+    if (f == NULL)
+    {
+	ERROR (CHOLMOD_INVALID, "unable to open file") ;
+	return (NULL) ;
+    }
+    ok = read_header (f, buf, &mtype, &nrow, &ncol, &nnz, &stype) ;
+    offset = ftell (f) ;
+    fclose (f) ;
+    if (!ok || mtype != CHOLMOD_TRIPLET || offset < 0)
+    {
+	/* invalid matrix - this function can only read in a triplet matrix */
+	ERROR (CHOLMOD_INVALID, "invalid format") ;
+	return (NULL) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* map the file into memory and read the triplets */
+    /* ---------------------------------------------------------------------- */
+
+    data = map_file (filename, &size, &mapped, Common) ;
+    if (data == NULL)
+    {
+	if (Common->status == CHOLMOD_OK)
+	{
+	    ERROR (CHOLMOD_INVALID, "unable to read file") ;
+	}
+	return (NULL) ;
+    }
+    T = read_triplet_mapped (data, size, MIN ((size_t) offset, size), nrow,
+	ncol, nnz, stype, FALSE, Common) ;
+    unmap_file (data, size, mapped, Common) ;
+    return (T) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_read_sparse_file ============================================= */
+/* ========================================================================== */
+
+/* Read a sparse matrix from a named file, with cholmod_read_triplet_file.
+ * Otherwise the same as cholmod_read_sparse.
+ */
+
+cholmod_sparse *CHOLMOD(read_sparse_file)
+(
+    /* ---- input ---- */
+    const char *filename,   /* name of the file to read */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    cholmod_sparse *A, *A2 ;
+    cholmod_triplet *T ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    RETURN_IF_NULL_COMMON (NULL) ;
+    RETURN_IF_NULL (filename, NULL) ;
+    Common->status = CHOLMOD_OK ;
+
+    /* ---------------------------------------------------------------------- */
+    /* convert to a sparse matrix in compressed-column form */
+    /* ---------------------------------------------------------------------- */
+
+    T = CHOLMOD(read_triplet_file) (filename, Common) ;
+    A = CHOLMOD(triplet_to_sparse) (T, 0, Common) ;
+    CHOLMOD(free_triplet) (&T, Common) ;
+
+    if (Common->prefer_upper && A != NULL && A->stype == -1)
+    {
+	/* A=A' */
+	A2 = CHOLMOD(transpose) (A, 2, Common) ;
+	CHOLMOD(free_sparse) (&A, Common) ;
+	A = A2 ;
+    }
+    return (A) ;
+}
+
+
 /* ========================================================================== */
 /* === cholmod_read_dense =================================================== */
 /* ========================================================================== */
@@ -1313,4 +2088,154 @@ void *CHOLMOD(read_matrix)
     }
     return (G) ;
 }
+
+
+/* ========================================================================== */
+/* === read_binary_ints ===================================================== */
+/* ========================================================================== */
+
+/* Read n integers of isize bytes each (4 or 8) into X, converting them to Int
+ * if needed.  Returns TRUE if successful, FALSE if the file is too short or an
+ * integer does not fit in an Int.
+ */
+
+static int read_binary_ints (FILE *f, Int *X, size_t n, size_t isize)
+{
+    SuiteSparse_long lbuf [1024] ;
+    int ibuf [1024] ;
+    size_t k, nb, t ;
+
+    if (isize == sizeof (Int))
+    {
+	/* same integer size as the file: read it directly */
+	return (fread (X, sizeof (Int), n, f) == n) ;
+    }
+    for (k = 0 ; k < n ; k += nb)
+    {
+	nb = MIN (n - k, 1024) ;
+	if (isize == sizeof (int))
+	{
+	    if (fread (ibuf, sizeof (int), nb, f) != nb) return (FALSE) ;
+	    for (t = 0 ; t < nb ; t++) X [k+t] = ibuf [t] ;
+	}
+	else
+	{
+	    if (fread (lbuf, sizeof (SuiteSparse_long), nb, f) != nb)
+	    {
+		return (FALSE) ;
+	    }
+	    for (t = 0 ; t < nb ; t++)
+	    {
+		if (lbuf [t] > Int_max || lbuf [t] < -Int_max) return (FALSE) ;
+		X [k+t] = lbuf [t] ;
+	    }
+	}
+    }
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_read_sparse_binary =========================================== */
+/* ========================================================================== */
+
+/* Read a sparse matrix written by cholmod_write_sparse_binary.  The file holds
+ * the raw compressed-column arrays, so nothing is parsed; only the column
+ * pointers and row indices are checked.  The matrix is returned exactly as it
+ * was written (same xtype, stype and sorted status), always packed.  A file
+ * written by the int version can be read by the SuiteSparse_long version and
+ * vice versa, if the indices fit.  The file must have been written on a
+ * machine with the same byte order.
+ */
+
+cholmod_sparse *CHOLMOD(read_sparse_binary)
+(
+    /* ---- input ---- */
+    FILE *f,		/* file to read from, must already be open */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    char magic [8] ;
+    SuiteSparse_long h [8] ;
+    cholmod_sparse *A ;
+    Int *Ap, *Ai ;
+    size_t nrow, ncol, nnz, isize, nx ;
+    Int j, p, xtype, stype, ok ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    RETURN_IF_NULL_COMMON (NULL) ;
+    RETURN_IF_NULL (f, NULL) ;
+    Common->status = CHOLMOD_OK ;
+
+    /* ---------------------------------------------------------------------- */
+    /* read the header */
+    /* ---------------------------------------------------------------------- */
+
+    /* see cholmod_write_sparse_binary for the file format; h = [version
+     * sizeof(Int) nrow ncol nnz stype xtype sorted] */
+    if (fread (magic, 1, 8, f) != 8 || strncmp (magic, "CHOLMODS", 8) != 0
+	|| fread (h, sizeof (SuiteSparse_long), 8, f) != 8
+	|| h [0] != 1
+	|| !(h [1] == sizeof (int) || h [1] == sizeof (SuiteSparse_long))
+	|| h [2] < 0 || h [2] > Int_max || h [3] < 0 || h [3] > Int_max
+	|| h [4] < 0 || h [4] > Int_max
+	|| h [6] < CHOLMOD_PATTERN || h [6] > CHOLMOD_ZOMPLEX)
+    {
+	ERROR (CHOLMOD_INVALID, "invalid format") ;
+	return (NULL) ;
+    }
+    isize = h [1] ;
+    nrow = h [2] ;
+    ncol = h [3] ;
+    nnz = h [4] ;
+    stype = h [5] ;
+    xtype = h [6] ;
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate the matrix and read in its arrays */
+    /* ---------------------------------------------------------------------- */
+
+    A = CHOLMOD(allocate_sparse) (nrow, ncol, nnz, h [7] != 0, TRUE, stype,
+	    xtype, Common) ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	/* out of memory, or invalid stype */
+	return (NULL) ;
+    }
+    Ap = A->p ;
+    Ai = A->i ;
+
+    nx = (xtype == CHOLMOD_PATTERN) ? 0 :
+	((xtype == CHOLMOD_COMPLEX) ? (2*nnz) : nnz) ;
+    ok = read_binary_ints (f, Ap, ncol+1, isize)
+	&& read_binary_ints (f, Ai, nnz, isize)
+	&& fread (A->x, sizeof (double), nx, f) == nx
+	&& (xtype != CHOLMOD_ZOMPLEX
+	    || fread (A->z, sizeof (double), nnz, f) == nnz) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check the column pointers and row indices */
+    /* ---------------------------------------------------------------------- */
+
+    ok = ok && (Ap [0] == 0) && (Ap [ncol] == (Int) nnz) ;
+    for (j = 0 ; ok && j < (Int) ncol ; j++)
+    {
+	ok = (Ap [j] <= Ap [j+1]) ;
+    }
+    for (p = 0 ; ok && p < (Int) nnz ; p++)
+    {
+	ok = (Ai [p] >= 0 && Ai [p] < (Int) nrow) ;
+    }
+    if (!ok)
+    {
+	CHOLMOD(free_sparse) (&A, Common) ;
+	ERROR (CHOLMOD_INVALID, "invalid matrix file") ;
+	return (NULL) ;
+    }
+    return (A) ;
+}
 #endif
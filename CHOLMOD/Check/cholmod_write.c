@@ -742,4 +742,145 @@ int CHOLMOD(write_dense)
 
     return ((nrow == ncol) ? CHOLMOD_MM_UNSYMMETRIC : CHOLMOD_MM_RECTANGULAR) ;
 }
+
+
+/* ========================================================================== */
+/* === cholmod_write_sparse_binary ========================================== */
+/* ========================================================================== */
+
+/* Write a sparse matrix to a file in a binary compressed-column form that
+ * cholmod_read_sparse_binary reads back without any parsing.  The file starts
+ * with the 8 characters "CHOLMODS", then 8 SuiteSparse_long integers:
+ *
+ *	version (1), sizeof (Int), nrow, ncol, nnz, stype, xtype, sorted
+ *
+ * followed by the column pointers (ncol+1 Int's), the row indices (nnz Int's),
+ * and the numerical values: none for a pattern matrix, nnz doubles for a real
+ * matrix, 2*nnz interleaved doubles for a complex matrix, and nnz real parts
+ * followed by nnz imaginary parts for a zomplex matrix.  An unpacked matrix is
+ * written as if it were packed.  All values are in the byte order of the
+ * machine that writes the file.  The matrix is written as-is; entries in the
+ * ignored triangular part of a symmetric matrix are kept.
+ *
+ * Returns TRUE if successful, FALSE otherwise.
+ */
+
+int CHOLMOD(write_sparse_binary)
+(
+    /* ---- input ---- */
+    FILE *f,		    /* file to write to, must already be open */
+    cholmod_sparse *A,	    /* matrix to write */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    SuiteSparse_long h [8] ;
+    double *Ax, *Az ;
+    Int *Ap, *Ai, *Anz ;
+    Int j, p, nz, ncol, xtype ;
+    int ok ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    RETURN_IF_NULL_COMMON (FALSE) ;
+    RETURN_IF_NULL (f, FALSE) ;
+    RETURN_IF_NULL (A, FALSE) ;
+    RETURN_IF_XTYPE_INVALID (A, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, FALSE) ;
+    Common->status = CHOLMOD_OK ;
+
+    Ap = A->p ;
+    Ai = A->i ;
+    Ax = A->x ;
+    Az = A->z ;
+    Anz = A->nz ;
+    ncol = A->ncol ;
+    xtype = A->xtype ;
+
+    /* ---------------------------------------------------------------------- */
+    /* write the header */
+    /* ---------------------------------------------------------------------- */
+
+    h [0] = 1 ;
+    h [1] = sizeof (Int) ;
+    h [2] = A->nrow ;
+    h [3] = ncol ;
+    h [4] = CHOLMOD(nnz) (A, Common) ;
+    h [5] = A->stype ;
+    h [6] = xtype ;
+    h [7] = A->sorted ;
+    ok = (fwrite ("CHOLMODS", 1, 8, f) == 8)
+	&& (fwrite (h, sizeof (SuiteSparse_long), 8, f) == 8) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* write the arrays */
+    /* ---------------------------------------------------------------------- */
+
+    if (A->packed)
+    {
+	nz = Ap [ncol] ;
+	ok = ok && (fwrite (Ap, sizeof (Int), ncol+1, f) == (size_t) (ncol+1))
+	    && (fwrite (Ai, sizeof (Int), nz, f) == (size_t) nz) ;
+	if (xtype == CHOLMOD_REAL || xtype == CHOLMOD_ZOMPLEX)
+	{
+	    ok = ok && (fwrite (Ax, sizeof (double), nz, f) == (size_t) nz) ;
+	}
+	else if (xtype == CHOLMOD_COMPLEX)
+	{
+	    ok = ok && (fwrite (Ax, sizeof (double), 2*nz, f) == (size_t) (2*nz));
+	}
+	if (xtype == CHOLMOD_ZOMPLEX)
+	{
+	    ok = ok && (fwrite (Az, sizeof (double), nz, f) == (size_t) nz) ;
+	}
+    }
+    else
+    {
+	/* write the column pointers of the packed matrix, then each column */
+	p = 0 ;
+	ok = ok && (fwrite (&p, sizeof (Int), 1, f) == 1) ;
+	for (j = 0 ; ok && j < ncol ; j++)
+	{
+	    p += Anz [j] ;
+	    ok = (fwrite (&p, sizeof (Int), 1, f) == 1) ;
+	}
+	for (j = 0 ; ok && j < ncol ; j++)
+	{
+	    ok = (fwrite (Ai + Ap [j], sizeof (Int), Anz [j], f)
+		== (size_t) Anz [j]) ;
+	}
+	if (xtype == CHOLMOD_REAL || xtype == CHOLMOD_ZOMPLEX)
+	{
+	    for (j = 0 ; ok && j < ncol ; j++)
+	    {
+		ok = (fwrite (Ax + Ap [j], sizeof (double), Anz [j], f)
+		    == (size_t) Anz [j]) ;
+	    }
+	}
+	else if (xtype == CHOLMOD_COMPLEX)
+	{
+	    for (j = 0 ; ok && j < ncol ; j++)
+	    {
+		ok = (fwrite (Ax + 2*Ap [j], sizeof (double), 2*Anz [j], f)
+		    == (size_t) (2*Anz [j])) ;
+	    }
+	}
+	if (xtype == CHOLMOD_ZOMPLEX)
+	{
+	    for (j = 0 ; ok && j < ncol ; j++)
+	    {
+		ok = (fwrite (Az + Ap [j], sizeof (double), Anz [j], f)
+		    == (size_t) Anz [j]) ;
+	    }
+	}
+    }
+
+    if (!ok)
+    {
+	ERROR (CHOLMOD_INVALID, "error reading/writing file") ;
+	return (FALSE) ;
+    }
+    return (TRUE) ;
+}
 #endif
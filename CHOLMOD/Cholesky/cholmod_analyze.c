@@ -74,6 +74,11 @@
  * requested ordering method.  Parameters for each method can also be modified
  * (refer to cholmod.h for details).
  *
+ * If Common->nmethods > 1 and Common->nthreads_max > 1, the methods are tried
+ * concurrently, each thread with its own workspace.  The result is the same
+ * as trying them one after another.  METIS and NESDIS use the process-wide
+ * rand () generator, so they are never run at the same time as each other.
+ *
  * Note that it is possible for METIS to terminate your program if it runs out
  * of memory.  This is not the case for any CHOLMOD or minimum degree ordering
  * routine (AMD, COLAMD, CAMD, CCOLAMD, or CSYMAMD).  Since NESDIS relies on
@@ -119,6 +124,10 @@
 #include "cholmod_partition.h"
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 /* ========================================================================== */
 /* === cholmod_analyze ====================================================== */
@@ -373,6 +382,352 @@ int CHOLMOD(analyze_ordering)
 }
 
 
+/* ========================================================================== */
+/* === try_ordering ========================================================= */
+/* ========================================================================== */
+
+/* Find the fill-reducing permutation for one ordering method, and analyze it
+ * (unless the ordering method already computed Common->fl and Common->lnz, in
+ * which case *skip_analysis is TRUE).  Returns TRUE if successful, or FALSE
+ * if the method failed (Common->status gives the reason).  UserPerm must be
+ * non-NULL for the CHOLMOD_GIVEN ordering.
+ *
+ * workspace: the same as cholmod_analyze_p2.  Parent, First, Level, and Post
+ *	are the last 4*nrow entries of Common->Iwork.
+ */
+
+static int try_ordering
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to order and analyze */
+    Int ordering,	/* ordering method to try */
+    Int *UserPerm,	/* user-provided permutation, size A->nrow */
+    Int *fset,		/* subset of 0:(A->ncol)-1 */
+    size_t fsize,	/* size of fset */
+    /* ---- output --- */
+    Int *Perm,		/* size n, fill-reducing permutation */
+    Int *ColCount,	/* size n, nnz in each column of L */
+    Int *Parent,	/* size n, elimination tree */
+    Int *skip_analysis,	/* TRUE if Perm was not analyzed */
+    /* ---- workspace  */
+    Int *Post,		/* size n */
+    Int *First,		/* size n */
+    Int *Level,		/* size n */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    Int k, n ;
+
+    n = A->nrow ;
+    *skip_analysis = FALSE ;
+
+    /* ---------------------------------------------------------------------- */
+    /* find the fill-reducing permutation */
+    /* ---------------------------------------------------------------------- */
+
+    if (ordering == CHOLMOD_NATURAL)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* natural ordering */
+	/* ------------------------------------------------------------------ */
+
+	for (k = 0 ; k < n ; k++)
+	{
+	    Perm [k] = k ;
+	}
+
+    }
+    else if (ordering == CHOLMOD_GIVEN)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* use given ordering of A */
+	/* ------------------------------------------------------------------ */
+
+	for (k = 0 ; k < n ; k++)
+	{
+	    /* UserPerm is checked in cholmod_ptranspose */
+	    Perm [k] = UserPerm [k] ;
+	}
+
+    }
+    else if (ordering == CHOLMOD_AMD)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* AMD ordering of A, A*A', or A(:,f)*A(:,f)' */
+	/* ------------------------------------------------------------------ */
+
+	CHOLMOD(amd) (A, fset, fsize, Perm, Common) ;
+	*skip_analysis = TRUE ;
+
+    }
+    else if (ordering == CHOLMOD_COLAMD)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* AMD for symmetric case, COLAMD for A*A' or A(:,f)*A(:,f)' */
+	/* ------------------------------------------------------------------ */
+
+	if (A->stype)
+	{
+	    CHOLMOD(amd) (A, fset, fsize, Perm, Common) ;
+	    *skip_analysis = TRUE ;
+	}
+	else
+	{
+	    /* Alternative:
+	    CHOLMOD(ccolamd) (A, fset, fsize, NULL, Perm, Common) ;
+	    */
+	    /* do not postorder, it is done later, below */
+	    /* workspace: Iwork (4*nrow+uncol), Flag (nrow), Head (nrow+1)*/
+	    CHOLMOD(colamd) (A, fset, fsize, FALSE, Perm, Common) ;
+	}
+
+    }
+    else if (ordering == CHOLMOD_METIS)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* use METIS_NodeND directly (via a CHOLMOD wrapper) */
+	/* ------------------------------------------------------------------ */
+
+#ifndef NPARTITION
+	/* postorder parameter is false, because it will be later, below */
+	/* workspace: Iwork (4*nrow+uncol), Flag (nrow), Head (nrow+1) */
+	Common->called_nd = TRUE ;
+	/* METIS uses the process-wide rand () generator, so concurrent
+	 * orderings (see try_orderings_parallel) call it one at a time */
+#ifdef _OPENMP
+	#pragma omp critical (cholmod_metis)
+#endif
+	CHOLMOD(metis) (A, fset, fsize, FALSE, Perm, Common) ;
+#else
+	Common->status = CHOLMOD_NOT_INSTALLED ;
+#endif
+
+    }
+    else if (ordering == CHOLMOD_NESDIS)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* use CHOLMOD's nested dissection */
+	/* ------------------------------------------------------------------ */
+
+	/* this method is based on METIS' node bissection routine
+	 * (METIS_ComputeVertexSeparator).  In contrast to METIS_NodeND,
+	 * it calls CAMD or CCOLAMD on the whole graph, instead of MMD
+	 * on just the leaves.  CParent and Cmember use Level and Post. */
+#ifndef NPARTITION
+	/* workspace: Flag (nrow), Head (nrow+1), Iwork (2*nrow) */
+	Common->called_nd = TRUE ;
+#ifdef _OPENMP
+	#pragma omp critical (cholmod_metis)
+#endif
+	CHOLMOD(nested_dissection) (A, fset, fsize, Perm, Level, Post,
+		Common) ;
+#else
+	Common->status = CHOLMOD_NOT_INSTALLED ;
+#endif
+
+    }
+    else
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* invalid ordering method */
+	/* ------------------------------------------------------------------ */
+
+	Common->status = CHOLMOD_INVALID ;
+	PRINT1 (("No such ordering: "ID"\n", ordering)) ;
+    }
+
+    ASSERT (CHOLMOD(dump_work) (TRUE, TRUE, 0, Common)) ;
+
+    if (Common->status < CHOLMOD_OK)
+    {
+	/* out of memory, or method failed */
+	return (FALSE) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* analyze the ordering */
+    /* ---------------------------------------------------------------------- */
+
+    if (!(*skip_analysis))
+    {
+	if (!CHOLMOD(analyze_ordering) (A, ordering, Perm, fset, fsize,
+		Parent, Post, ColCount, First, Level, Common))
+	{
+	    /* ordering method failed */
+	    return (FALSE) ;
+	}
+    }
+    return (TRUE) ;
+}
+
+
+#ifdef _OPENMP
+/* ========================================================================== */
+/* === try_orderings_parallel =============================================== */
+/* ========================================================================== */
+
+/* Try ordering methods 0 to nmethods-1 concurrently, for
+ * Common->nthreads_max > 1.  Each thread works with its own copy of Common
+ * (and thus its own Flag, Head, and Iwork workspace), so the ordering methods
+ * and cholmod_analyze_ordering can run unchanged.  The results of method m
+ * are placed in Twork [3*n*m ...]: its Perm, ColCount, and Parent, each of
+ * size n, with its status, flop count, nnz(L), and whether it was analyzed in
+ * Tstatus [m], Tfl [m], Tlnz [m], and Tskip [m].  METIS and NESDIS share the
+ * rand () generator and are called one at a time.  Returns FALSE, with
+ * Common->status set, if the copies of Common cannot be allocated.
+ */
+
+static int try_orderings_parallel
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to order and analyze */
+    Int *UserPerm,	/* user-provided permutation, size A->nrow */
+    Int *fset,		/* subset of 0:(A->ncol)-1 */
+    size_t fsize,	/* size of fset */
+    Int nmethods,	/* # of methods to try */
+    int nthreads,	/* # of threads to use */
+    size_t iworksize,	/* size of Iwork (6*nrow + uncol) */
+    /* ---- output --- */
+    Int *Twork,		/* size 3*n*nmethods */
+    int *Tstatus,	/* size nmethods */
+    double *Tfl,	/* size nmethods */
+    double *Tlnz,	/* size nmethods */
+    Int *Tskip,		/* size nmethods */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    cholmod_common *Tcommon, *C ;
+    double memory_usage ;
+    Int n, t, uncol, method ;
+
+    n = A->nrow ;
+    uncol = (A->stype == 0) ? (A->ncol) : 0 ;
+
+    /* ---------------------------------------------------------------------- */
+    /* make a copy of Common for each thread, with no workspace */
+    /* ---------------------------------------------------------------------- */
+
+    Tcommon = CHOLMOD(malloc) (nthreads, sizeof (cholmod_common), Common) ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	return (FALSE) ;
+    }
+    for (t = 0 ; t < nthreads ; t++)
+    {
+	C = Tcommon + t ;
+	*C = *Common ;
+	C->Flag = NULL ;
+	C->Head = NULL ;
+	C->Iwork = NULL ;
+	C->Xwork = NULL ;
+	C->nrow = 0 ;
+	C->iworksize = 0 ;
+	C->xworksize = 0 ;
+	C->mark = EMPTY ;
+	C->no_workspace_reallocate = FALSE ;
+	C->try_catch = TRUE ;
+	C->malloc_count = 0 ;
+	C->memory_inuse = 0 ;
+	C->memory_usage = 0 ;
+	C->called_nd = FALSE ;
+	C->anz = EMPTY ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* try each method in its own thread */
+    /* ---------------------------------------------------------------------- */
+
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic,1) \
+	private(C)
+    for (method = 0 ; method < nmethods ; method++)
+    {
+	Int *Work4n, *Perm, *ColCount, k, ordering, skip = FALSE ;
+	C = Tcommon + omp_get_thread_num () ;
+	ordering = Common->method [method].ordering ;
+	Tstatus [method] = CHOLMOD_OK ;
+	Tfl [method] = EMPTY ;
+	Tlnz [method] = EMPTY ;
+	Tskip [method] = FALSE ;
+	if (ordering == CHOLMOD_GIVEN && UserPerm == NULL)
+	{
+	    /* skipped by cholmod_analyze_p2 */
+	    continue ;
+	}
+	C->current = method ;
+	C->status = CHOLMOD_OK ;
+	C->fl = EMPTY ;
+	C->lnz = EMPTY ;
+	CHOLMOD(allocate_work) (n, iworksize, 0, C) ;
+	if (C->status >= CHOLMOD_OK)
+	{
+	    C->no_workspace_reallocate = TRUE ;
+	    Work4n = C->Iwork ;
+	    Work4n += 2*((size_t) n) + uncol ;
+	    Perm     = Twork + 3*((size_t) n)*method ;
+	    ColCount = Perm + n ;
+	    if (!try_ordering (A, ordering, UserPerm, fset, fsize, Perm,
+		ColCount, Work4n, &skip, Work4n + 3*((size_t) n),
+		Work4n + n, Work4n + 2*((size_t) n), C))
+	    {
+		if (C->status >= CHOLMOD_OK)
+		{
+		    /* the method failed without saying why */
+		    C->status = CHOLMOD_INVALID ;
+		}
+	    }
+	    else if (!skip)
+	    {
+		/* save the etree, needed if this method is the best one */
+		for (k = 0 ; k < n ; k++)
+		{
+		    ColCount [n+k] = Work4n [k] ;
+		}
+	    }
+	    C->no_workspace_reallocate = FALSE ;
+	}
+	Tstatus [method] = C->status ;
+	Tfl [method] = C->fl ;
+	Tlnz [method] = C->lnz ;
+	Tskip [method] = skip ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* free the workspace of each thread and merge the statistics */
+    /* ---------------------------------------------------------------------- */
+
+    memory_usage = Common->memory_inuse ;
+    for (t = 0 ; t < nthreads ; t++)
+    {
+	C = Tcommon + t ;
+	memory_usage += C->memory_usage ;
+	/* not cholmod_free_work, which would free the GPU workspace of Common */
+	C->Flag  = CHOLMOD(free) (C->nrow, sizeof (Int), C->Flag, C) ;
+	C->Head  = CHOLMOD(free) (C->nrow+1, sizeof (Int), C->Head, C) ;
+	C->Iwork = CHOLMOD(free) (C->iworksize, sizeof (Int), C->Iwork, C) ;
+	C->Xwork = CHOLMOD(free) (C->xworksize, sizeof (double), C->Xwork, C) ;
+	Common->malloc_count += C->malloc_count ;
+	Common->called_nd = Common->called_nd || C->called_nd ;
+	if (C->anz != EMPTY)
+	{
+	    Common->anz = C->anz ;
+	}
+    }
+    Common->memory_usage = MAX (Common->memory_usage, memory_usage) ;
+    CHOLMOD(free) (nthreads, sizeof (cholmod_common), Tcommon, Common) ;
+    return (TRUE) ;
+}
+#endif
+
+
 /* ========================================================================== */
 /* === Free workspace and return L ========================================== */
 /* ========================================================================== */
@@ -413,13 +768,16 @@ cholmod_factor *CHOLMOD(analyze_p2)
 )
 {
     double lnz_best ;
-    Int *First, *Level, *Work4n, *Cmember, *CParent, *ColCount, *Lperm, *Parent,
-	*Post, *Perm, *Lparent, *Lcolcount ;
+    double Tfl [CHOLMOD_MAXMETHODS], Tlnz [CHOLMOD_MAXMETHODS] ;
+    Int Tskip [CHOLMOD_MAXMETHODS] ;
+    int Tstatus [CHOLMOD_MAXMETHODS] ;
+    Int *First, *Level, *Work4n, *ColCount, *Lperm, *Parent, *Post, *Perm,
+	*Lparent, *Lcolcount, *Twork ;
     cholmod_factor *L ;
     Int k, n, ordering, method, nmethods, status, default_strategy, ncol, uncol,
 	skip_analysis, skip_best ;
     Int amd_backup ;
-    size_t s ;
+    size_t s, twsize ;
     int ok = TRUE ;
 
     /* ---------------------------------------------------------------------- */
@@ -536,11 +894,10 @@ cholmod_factor *CHOLMOD(analyze_p2)
     Level  = Work4n + 2*((size_t) n) ;
     Post   = Work4n + 3*((size_t) n) ;
 
-    /* note that this assignment means that cholmod_nested_dissection,
-     * cholmod_ccolamd, and cholmod_camd can use only the first 4n+uncol
-     * space in Common->Iwork */
-    Cmember = Post ;
-    CParent = Level ;
+    /* note that try_ordering passes Level and Post to
+     * cholmod_nested_dissection as its CParent and Cmember, which means that
+     * cholmod_nested_dissection, cholmod_ccolamd, and cholmod_camd can use
+     * only the first 4n+uncol space in Common->Iwork */
 
     /* ---------------------------------------------------------------------- */
     /* allocate more workspace, and an empty simplicial symbolic factor */
@@ -566,6 +923,33 @@ cholmod_factor *CHOLMOD(analyze_p2)
     /* turn off error handling [ */
     Common->try_catch = TRUE ;
 
+    /* ---------------------------------------------------------------------- */
+    /* try the methods concurrently, if requested */
+    /* ---------------------------------------------------------------------- */
+
+    /* The default strategy is sequential: METIS is tried only if AMD does
+     * poorly.  Otherwise, all nmethods methods are tried concurrently, and
+     * their results are then considered one at a time, in order, below. */
+    Twork = NULL ;
+    twsize = 0 ;
+#ifdef _OPENMP
+    if (!default_strategy && Common->nthreads_max > 1 && nmethods > 1)
+    {
+	int nthreads = MIN (Common->nthreads_max, nmethods) ;
+	/* twsize = 3*n*nmethods */
+	twsize = CHOLMOD(mult_size_t) (n, 3*nmethods, &ok) ;
+	Twork = ok ? CHOLMOD(malloc) (twsize, sizeof (Int), Common) : NULL ;
+	if (Twork != NULL && !try_orderings_parallel (A, UserPerm, fset, fsize,
+	    nmethods, nthreads, s, Twork, Tstatus, Tfl, Tlnz, Tskip, Common))
+	{
+	    Twork = CHOLMOD(free) (twsize, sizeof (Int), Twork, Common) ;
+	}
+	/* on failure, try the methods one at a time instead */
+	Common->status = CHOLMOD_OK ;
+	ok = TRUE ;
+    }
+#endif
+
     for (method = 0 ; method <= nmethods ; method++)
     {
 
@@ -597,153 +981,58 @@ cholmod_factor *CHOLMOD(analyze_p2)
 	Common->current = method ;
 	PRINT1 (("method "ID": Try method: "ID"\n", method, ordering)) ;
 
-	/* ------------------------------------------------------------------ */
-	/* find the fill-reducing permutation */
-	/* ------------------------------------------------------------------ */
-
-	if (ordering == CHOLMOD_NATURAL)
+	if (ordering == CHOLMOD_GIVEN && UserPerm == NULL)
 	{
-
-	    /* -------------------------------------------------------------- */
-	    /* natural ordering */
-	    /* -------------------------------------------------------------- */
-
-	    for (k = 0 ; k < n ; k++)
-	    {
-		Perm [k] = k ;
-	    }
-
-	}
-	else if (ordering == CHOLMOD_GIVEN)
-	{
-
-	    /* -------------------------------------------------------------- */
-	    /* use given ordering of A, if provided */
-	    /* -------------------------------------------------------------- */
-
-	    if (UserPerm == NULL)
-	    {
-		/* this is not an error condition */
-		PRINT1 (("skip, no user perm given\n")) ;
-		continue ;
-	    }
-	    for (k = 0 ; k < n ; k++)
-	    {
-		/* UserPerm is checked in cholmod_ptranspose */
-		Perm [k] = UserPerm [k] ;
-	    }
-
+	    /* this is not an error condition */
+	    PRINT1 (("skip, no user perm given\n")) ;
+	    continue ;
 	}
-	else if (ordering == CHOLMOD_AMD)
+	if (ordering == CHOLMOD_AMD)
 	{
-
-	    /* -------------------------------------------------------------- */
-	    /* AMD ordering of A, A*A', or A(:,f)*A(:,f)' */
-	    /* -------------------------------------------------------------- */
-
             amd_backup = FALSE ;    /* no need to try AMD twice ... */
-	    CHOLMOD(amd) (A, fset, fsize, Perm, Common) ;
-	    skip_analysis = TRUE ;
-
 	}
-	else if (ordering == CHOLMOD_COLAMD)
-	{
 
-	    /* -------------------------------------------------------------- */
-	    /* AMD for symmetric case, COLAMD for A*A' or A(:,f)*A(:,f)' */
-	    /* -------------------------------------------------------------- */
+	/* ------------------------------------------------------------------ */
+	/* find and analyze the fill-reducing permutation */
+	/* ------------------------------------------------------------------ */
 
-	    if (A->stype)
-	    {
-		CHOLMOD(amd) (A, fset, fsize, Perm, Common) ;
-		skip_analysis = TRUE ;
-	    }
-	    else
+	if (Twork != NULL && method < nmethods)
+	{
+	    /* this method was already tried by try_orderings_parallel */
+	    Common->status = Tstatus [method] ;
+	    Common->fl = Tfl [method] ;
+	    Common->lnz = Tlnz [method] ;
+	    skip_analysis = Tskip [method] ;
+	    ok = (Common->status >= CHOLMOD_OK) ;
+	    if (ok)
 	    {
-		/* Alternative:
-		CHOLMOD(ccolamd) (A, fset, fsize, NULL, Perm, Common) ;
-		*/
-		/* do not postorder, it is done later, below */
-		/* workspace: Iwork (4*nrow+uncol), Flag (nrow), Head (nrow+1)*/
-		CHOLMOD(colamd) (A, fset, fsize, FALSE, Perm, Common) ;
+		Int *Tperm = Twork + 3*((size_t) n)*method ;
+		for (k = 0 ; k < n ; k++)
+		{
+		    Perm [k] = Tperm [k] ;
+		}
+		for (k = 0 ; !skip_analysis && k < n ; k++)
+		{
+		    ColCount [k] = Tperm [n+k] ;
+		    Parent [k] = Tperm [2*n+k] ;
+		}
 	    }
-
-	}
-	else if (ordering == CHOLMOD_METIS)
-	{
-
-	    /* -------------------------------------------------------------- */
-	    /* use METIS_NodeND directly (via a CHOLMOD wrapper) */
-	    /* -------------------------------------------------------------- */
-
-#ifndef NPARTITION
-	    /* postorder parameter is false, because it will be later, below */
-	    /* workspace: Iwork (4*nrow+uncol), Flag (nrow), Head (nrow+1) */
-	    Common->called_nd = TRUE ;
-	    CHOLMOD(metis) (A, fset, fsize, FALSE, Perm, Common) ;
-#else
-	    Common->status = CHOLMOD_NOT_INSTALLED ;
-#endif
-
-	}
-	else if (ordering == CHOLMOD_NESDIS)
-	{
-
-	    /* -------------------------------------------------------------- */
-	    /* use CHOLMOD's nested dissection */
-	    /* -------------------------------------------------------------- */
-
-	    /* this method is based on METIS' node bissection routine
-	     * (METIS_ComputeVertexSeparator).  In contrast to METIS_NodeND,
-	     * it calls CAMD or CCOLAMD on the whole graph, instead of MMD
-	     * on just the leaves. */
-#ifndef NPARTITION
-	    /* workspace: Flag (nrow), Head (nrow+1), Iwork (2*nrow) */
-	    Common->called_nd = TRUE ;
-	    CHOLMOD(nested_dissection) (A, fset, fsize, Perm, CParent, Cmember,
-		    Common) ;
-#else
-	    Common->status = CHOLMOD_NOT_INSTALLED ;
-#endif
-
 	}
 	else
 	{
-
-	    /* -------------------------------------------------------------- */
-	    /* invalid ordering method */
-	    /* -------------------------------------------------------------- */
-
-	    Common->status = CHOLMOD_INVALID ;
-	    PRINT1 (("No such ordering: "ID"\n", ordering)) ;
+	    ok = try_ordering (A, ordering, UserPerm, fset, fsize, Perm,
+		ColCount, Parent, &skip_analysis, Post, First, Level, Common) ;
 	}
 
-	ASSERT (CHOLMOD(dump_work) (TRUE, TRUE, 0, Common)) ;
-
-	if (Common->status < CHOLMOD_OK)
+	if (!ok)
 	{
-	    /* out of memory, or method failed */
+	    /* out of memory, or method failed; clear status and try next
+	     * method */
 	    status = MIN (status, Common->status) ;
 	    Common->status = CHOLMOD_OK ;
 	    continue ;
 	}
 
-	/* ------------------------------------------------------------------ */
-	/* analyze the ordering */
-	/* ------------------------------------------------------------------ */
-
-	if (!skip_analysis)
-	{
-	    if (!CHOLMOD(analyze_ordering) (A, ordering, Perm, fset, fsize,
-		    Parent, Post, ColCount, First, Level, Common))
-	    {
-		/* ordering method failed; clear status and try next method */
-		status = MIN (status, Common->status) ;
-		Common->status = CHOLMOD_OK ;
-		continue ;
-	    }
-	}
-
 	ASSERT (Common->fl >= 0 && Common->lnz >= 0) ;
 	Common->method [method].fl  = Common->fl ;
 	Common->method [method].lnz = Common->lnz ;
@@ -805,6 +1094,7 @@ cholmod_factor *CHOLMOD(analyze_p2)
 
     /* turn error printing back on ] */
     Common->try_catch = FALSE ;
+    Twork = CHOLMOD(free) (twsize, sizeof (Int), Twork, Common) ;
 
     /* ---------------------------------------------------------------------- */
     /* return if no ordering method succeeded */
@@ -46,6 +46,10 @@
  * column at which the failure occurred.  Columns L->minor to L->n-1 are
  * set to zero.
  *
+ * If Common->single_factor is TRUE, a real L is converted to single precision
+ * when done (see cholmod_factor_dtype and cholmod_solve_refine).  A single
+ * precision L on input is converted back to double and refactorized.
+ *
  * Supports any xtype (pattern, real, complex, or zomplex), except that the
  * input matrix A cannot be pattern-only.  If L is simplicial, its numeric
  * xtype matches A on output.  If L is supernodal, its xtype is real if A is
@@ -88,6 +92,77 @@ int CHOLMOD(factorize)
 }
 
 
+/* ========================================================================== */
+/* === rowfac_path ========================================================== */
+/* ========================================================================== */
+
+/* Simplicial partial refactorization: computes rows Path [0..pathlen-1] of
+ * the numeric factor L again.  Since the path is closed under ancestors in
+ * the etree, the entries of each column of L in the rows on the path are the
+ * last entries in that column.  They are removed, and cholmod_rowfac then
+ * appends them again, one row of L at a time.  workspace: as cholmod_rowfac.
+ */
+
+static int rowfac_path
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize, triu(A) or A */
+    cholmod_sparse *F,	/* used for A*A' case only */
+    double beta [2],	/* factorize beta*I+A or beta*I+AA' */
+    Int *Path,		/* rows of L to compute, in increasing order */
+    Int pathlen,	/* size of Path */
+    /* ---- in/out --- */
+    cholmod_factor *L,
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double fl = 0 ;
+    Int *Lp, *Li, *Lnz, *Flag, j, k, t, n, lnz, mark ;
+    int ok = TRUE ;
+
+    n = L->n ;
+    Lp = L->p ;
+    Li = L->i ;
+    Lnz = L->nz ;
+    Flag = Common->Flag ;
+
+    /* remove the rows on the path from L */
+    CHOLMOD_CLEAR_FLAG (Common) ;
+    mark = Common->mark ;
+    for (t = 0 ; t < pathlen ; t++)
+    {
+	Flag [Path [t]] = mark ;
+    }
+    for (j = 0 ; j < n ; j++)
+    {
+	lnz = Lnz [j] ;
+	while (lnz > 1 && Flag [Li [Lp [j] + lnz - 1]] == mark)
+	{
+	    lnz-- ;
+	}
+	Lnz [j] = lnz ;
+    }
+    CHOLMOD_CLEAR_FLAG (Common) ;
+
+    /* compute them again */
+    for (t = 0 ; ok && t < pathlen ; t++)
+    {
+	k = Path [t] ;
+	ASSERT (Lnz [k] == 1) ;
+	ok = CHOLMOD(rowfac) (A, F, beta, k, k+1, L, Common) ;
+	fl += Common->rowfacfl ;
+    }
+    Common->rowfacfl = fl ;
+    if (ok && L->minor < L->n)
+    {
+	/* cholmod_rowfac clears the status of each row */
+	Common->status = CHOLMOD_NOT_POSDEF ;
+    }
+    return (ok) ;
+}
+
+
 /* ========================================================================== */
 /* === cholmod_factorize_p ================================================== */
 /* ========================================================================== */
@@ -106,6 +181,64 @@ int CHOLMOD(factorize_p)
     /* --------------- */
     cholmod_common *Common
 )
+{
+    return (CHOLMOD(factorize_partial_p) (A, beta, fset, fsize, NULL, 0, L,
+	Common)) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_factorize_partial ============================================ */
+/* ========================================================================== */
+
+/* Partial refactorization.  L must be a numeric factor of a matrix with the
+ * same nonzero pattern as A, and the values of A may differ from that matrix
+ * only in the columns given to cholmod_compute_path.  Only the columns of L
+ * on the path, Path [0..pathlen-1], are computed again; the rest of L is
+ * kept.  The whole matrix is factorized instead if L is symbolic, if the
+ * prior factorization failed (L->minor < n), or if Path is NULL. */
+
+int CHOLMOD(factorize_partial)
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize */
+    Int *Path,		/* from cholmod_compute_path */
+    size_t pathlen,	/* size of Path */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* resulting factorization */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double zero [2] ;
+    zero [0] = 0 ;
+    zero [1] = 0 ;
+    return (CHOLMOD(factorize_partial_p) (A, zero, NULL, 0, Path, pathlen, L,
+	Common)) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_factorize_partial_p ========================================== */
+/* ========================================================================== */
+
+/* Same as cholmod_factorize_partial, but with more options.  beta and fset
+ * must be the same as for the prior factorization. */
+
+int CHOLMOD(factorize_partial_p)
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize */
+    double beta [2],	/* factorize beta*I+A or beta*I+A'*A */
+    Int *fset,		/* subset of 0:(A->ncol)-1 */
+    size_t fsize,	/* size of fset */
+    Int *Path,		/* from cholmod_compute_path, or NULL */
+    size_t pathlen,	/* size of Path */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* resulting factorization */
+    /* --------------- */
+    cholmod_common *Common
+)
 {
     cholmod_sparse *S, *F, *A1, *A2 ;
     Int nrow, ncol, stype, convert, n, nsuper, grow2, status ;
@@ -135,9 +268,30 @@ int CHOLMOD(factorize_p)
 	ERROR (CHOLMOD_INVALID, "matrix invalid") ;
 	return (FALSE) ;
     }
+    if (pathlen > L->n)
+    {
+	ERROR (CHOLMOD_INVALID, "path invalid") ;
+	return (FALSE) ;
+    }
     DEBUG (CHOLMOD(dump_sparse) (A, "A for cholmod_factorize", Common)) ;
     Common->status = CHOLMOD_OK ;
 
+    if (L->dtype == CHOLMOD_SINGLE)
+    {
+	/* refactorize a single precision L in double precision, from scratch */
+	if (!CHOLMOD(factor_dtype) (CHOLMOD_DOUBLE, L, Common))
+	{
+	    return (FALSE) ;
+	}
+	Path = NULL ;
+    }
+
+    if (L->xtype == CHOLMOD_PATTERN || L->minor < L->n || pathlen == L->n)
+    {
+	/* factorize the whole matrix */
+	Path = NULL ;
+    }
+
     /* ---------------------------------------------------------------------- */
     /* allocate workspace */
     /* ---------------------------------------------------------------------- */
@@ -262,7 +416,8 @@ int CHOLMOD(factorize_p)
 	/* workspace: Flag (nrow), Head (nrow+1), Iwork (2*nrow+2*nsuper) */
 	if (Common->status == CHOLMOD_OK)
 	{
-	    CHOLMOD(super_numeric) (S, F, beta, L, Common) ;
+	    CHOLMOD(super_numeric_path) (S, F, beta, Path, pathlen, L,
+		Common) ;
 	}
 	status = Common->status ;
 	ASSERT (IMPLIES (status >= CHOLMOD_OK, L->xtype != CHOLMOD_PATTERN)) ;
@@ -387,7 +542,12 @@ int CHOLMOD(factorize_p)
 
 	/* factorize beta*I+S (symmetric) or beta*I+F*F' (unsymmetric) */
 	/* workspace: Flag (nrow), W (nrow), Iwork (2*nrow) */
-	if (Common->status == CHOLMOD_OK)
+	if (Common->status == CHOLMOD_OK && Path != NULL)
+	{
+	    /* workspace: Flag (nrow), W (nrow), Iwork (nrow) */
+	    rowfac_path (S, F, beta, Path, pathlen, L, Common) ;
+	}
+	else if (Common->status == CHOLMOD_OK)
 	{
 	    grow2 = Common->grow2 ;
 	    L->is_ll = BOOLEAN (Common->final_ll) ;
@@ -420,6 +580,255 @@ int CHOLMOD(factorize_p)
     CHOLMOD(free_sparse) (&A1, Common) ;
     CHOLMOD(free_sparse) (&A2, Common) ;
     Common->status = MAX (Common->status, status) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* keep a real L in single precision, if requested */
+    /* ---------------------------------------------------------------------- */
+
+    if (Common->single_factor && Common->status >= CHOLMOD_OK
+	&& L->xtype == CHOLMOD_REAL)
+    {
+	/* if out of memory, L is left in double precision */
+	int try_catch = Common->try_catch ;
+	status = Common->status ;
+	Common->try_catch = TRUE ;
+	CHOLMOD(factor_dtype) (CHOLMOD_SINGLE, L, Common) ;
+	Common->try_catch = try_catch ;
+	Common->status = status ;
+    }
     return (Common->status >= CHOLMOD_OK) ;
 }
+
+
+/* ========================================================================== */
+/* === cholmod_compute_path ================================================= */
+/* ========================================================================== */
+
+/* mark the path in the etree of L from column k to the root, stopping at the
+ * first column already marked */
+
+static void mark_path
+(
+    Int k,
+    Int mark,
+    Int *Flag,
+    Int *SuperMap,
+    cholmod_factor *L
+)
+{
+    Int *Super = L->super, *Lpi = L->pi, *Ls = L->s, *Lp = L->p, *Li = L->i,
+	*Lnz = L->nz ;
+    Int s, p ;
+    while (k != EMPTY && Flag [k] < mark)
+    {
+	Flag [k] = mark ;
+	if (L->is_super)
+	{
+	    /* the parent of k is the next column of its supernode, or the
+	     * first row below the diagonal block */
+	    s = SuperMap [k] ;
+	    if (k+1 < Super [s+1])
+	    {
+		k++ ;
+	    }
+	    else
+	    {
+		p = Lpi [s] + Super [s+1] - Super [s] ;
+		k = (p < Lpi [s+1]) ? Ls [p] : EMPTY ;
+	    }
+	}
+	else
+	{
+	    k = (Lnz [k] > 1) ? Li [Lp [k] + 1] : EMPTY ;
+	}
+    }
+}
+
+
+/* Computes the factorization path for cholmod_factorize_partial: the columns
+ * of L that change when the values in the columns Changed [0..nchanged-1] of a
+ * symmetric A change (and so the symmetric rows as well).  For A*A', list the
+ * rows of A that change.  A changed entry A(i,j) also changes column Pinv [i]
+ * of L, which need not be on the etree path from Pinv [j] when Pinv [i] is
+ * less than Pinv [j].  The path is thus the union of the paths in the
+ * elimination tree of L, to the roots of the tree, from Pinv [i] for each row
+ * and column index i of a changed entry of A (or of A*A').  It is returned in
+ * increasing order in Path, of size n, and depends only on the patterns of A
+ * and L, so it can be computed once and used for many partial
+ * refactorizations.  The etree is found from the pattern of L, which must be
+ * supernodal, or simplicial numeric.  For the unsymmetric case, all columns of
+ * A are used, so the path is correct for any fset.
+ *
+ * Returns the length of the path, or EMPTY on error.
+ * workspace: Flag (n), Iwork (3*n)
+ */
+
+SuiteSparse_long CHOLMOD(compute_path)
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize, only its pattern is used */
+    Int *Changed,	/* columns of A with changed values */
+    size_t nchanged,	/* size of Changed */
+    cholmod_factor *L,	/* factor from cholmod_analyze or cholmod_factorize */
+    /* ---- output --- */
+    Int *Path,		/* size n, the factorization path */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    Int *Perm, *Pinv, *SuperMap, *Is_changed, *Flag, *Super, *Ap, *Ai, *Anz,
+	n, i, j, k, p, pend, s, t, mark, pathlen, stype, packed, any ;
+    size_t w ;
+    int ok = TRUE ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    RETURN_IF_NULL_COMMON (EMPTY) ;
+    RETURN_IF_NULL (A, EMPTY) ;
+    RETURN_IF_NULL (L, EMPTY) ;
+    RETURN_IF_NULL (Path, EMPTY) ;
+    RETURN_IF_XTYPE_INVALID (A, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, EMPTY) ;
+    RETURN_IF_XTYPE_INVALID (L, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, EMPTY) ;
+    if (nchanged > 0)
+    {
+	RETURN_IF_NULL (Changed, EMPTY) ;
+    }
+    if (!(L->is_super) && L->xtype == CHOLMOD_PATTERN)
+    {
+	ERROR (CHOLMOD_INVALID, "simplicial L must be numeric") ;
+	return (EMPTY) ;
+    }
+    n = L->n ;
+    stype = A->stype ;
+    if (A->nrow != L->n || (stype != 0 && A->ncol != L->n))
+    {
+	ERROR (CHOLMOD_INVALID, "A and L dimensions do not match") ;
+	return (EMPTY) ;
+    }
+    Common->status = CHOLMOD_OK ;
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate workspace */
+    /* ---------------------------------------------------------------------- */
+
+    w = CHOLMOD(mult_size_t) (n, 3, &ok) ;
+    if (!ok)
+    {
+	ERROR (CHOLMOD_TOO_LARGE, "problem too large") ;
+	return (EMPTY) ;
+    }
+    CHOLMOD(allocate_work) (n, w, 0, Common) ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	return (EMPTY) ;
+    }
+    Flag = Common->Flag ;
+    Pinv = Common->Iwork ;		/* size n */
+    SuperMap = Pinv + n ;		/* size n, supernodal case only */
+    Is_changed = SuperMap + n ;		/* size n */
+
+    Perm = L->Perm ;
+    for (k = 0 ; k < n ; k++)
+    {
+	Pinv [(Perm == NULL) ? k : Perm [k]] = k ;
+	Is_changed [k] = FALSE ;
+    }
+
+    Super = L->super ;
+    if (L->is_super)
+    {
+	for (s = 0 ; s < (Int) L->nsuper ; s++)
+	{
+	    for (k = Super [s] ; k < Super [s+1] ; k++)
+	    {
+		SuperMap [k] = s ;
+	    }
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* mark the path from each changed column itself */
+    /* ---------------------------------------------------------------------- */
+
+    CHOLMOD_CLEAR_FLAG (Common) ;
+    mark = Common->mark ;
+    for (t = 0 ; t < (Int) nchanged ; t++)
+    {
+	j = Changed [t] ;
+	if (j < 0 || j >= n)
+	{
+	    ERROR (CHOLMOD_INVALID, "column out of range") ;
+	    CHOLMOD_CLEAR_FLAG (Common) ;
+	    return (EMPTY) ;
+	}
+	Is_changed [j] = TRUE ;
+	mark_path (Pinv [j], mark, Flag, SuperMap, L) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* mark the paths from the other indices of each changed entry */
+    /* ---------------------------------------------------------------------- */
+
+    Ap = A->p ;
+    Ai = A->i ;
+    Anz = A->nz ;
+    packed = A->packed ;
+    for (j = 0 ; j < (Int) (A->ncol) ; j++)
+    {
+	p = Ap [j] ;
+	pend = (packed) ? (Ap [j+1]) : (p + Anz [j]) ;
+	if (stype != 0)
+	{
+	    /* A(i,j) and A(j,i) change if either i or j is changed */
+	    for ( ; p < pend ; p++)
+	    {
+		i = Ai [p] ;
+		if ((stype > 0 && i > j) || (stype < 0 && i < j))
+		{
+		    continue ;	/* ignore entries outside the stored part */
+		}
+		if (Is_changed [i] || Is_changed [j])
+		{
+		    mark_path (Pinv [i], mark, Flag, SuperMap, L) ;
+		    mark_path (Pinv [j], mark, Flag, SuperMap, L) ;
+		}
+	    }
+	}
+	else
+	{
+	    /* (A*A')(i,k) changes for every pair of rows i and k in A(:,j) if
+	     * either row is changed */
+	    any = FALSE ;
+	    for ( ; p < pend && !any ; p++)
+	    {
+		any = Is_changed [Ai [p]] ;
+	    }
+	    if (any)
+	    {
+		p = Ap [j] ;
+		for ( ; p < pend ; p++)
+		{
+		    mark_path (Pinv [Ai [p]], mark, Flag, SuperMap, L) ;
+		}
+	    }
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* return the path in increasing order */
+    /* ---------------------------------------------------------------------- */
+
+    pathlen = 0 ;
+    for (k = 0 ; k < n ; k++)
+    {
+	if (Flag [k] == mark)
+	{
+	    Path [pathlen++] = k ;
+	}
+    }
+    CHOLMOD_CLEAR_FLAG (Common) ;
+    return (pathlen) ;
+}
 #endif
@@ -80,6 +80,7 @@ double CHOLMOD(rcond)	    /* return min(diag(L)) / max(diag(L)) */
 
     RETURN_IF_NULL_COMMON (EMPTY) ;
     RETURN_IF_NULL (L, EMPTY) ;
+    RETURN_IF_SINGLE (L, EMPTY) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, EMPTY) ;
     Common->status = CHOLMOD_OK ;
 
@@ -63,6 +63,7 @@ int CHOLMOD(resymbol)
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (A, FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (A, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
     Common->status = CHOLMOD_OK ;
@@ -250,6 +251,7 @@ int CHOLMOD(resymbol_noperm)
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (A, FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (A, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
     ncol = A->ncol ;
@@ -421,6 +421,7 @@ int CHOLMOD(row_lsubtree)
     RETURN_IF_NULL (A, FALSE) ;
     RETURN_IF_NULL (R, FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (A, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, FALSE) ;
     RETURN_IF_XTYPE_INVALID (R, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
@@ -650,6 +651,7 @@ int CHOLMOD(rowfac_mask2)
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (A, FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (A, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, FALSE) ;
     if (L->xtype != CHOLMOD_PATTERN && A->xtype != L->xtype)
@@ -42,13 +42,18 @@
  *
  * This routine returns X as NULL only if it runs out of memory.  If L is
  * indefinite or singular, then X may contain Inf's or NaN's, but it will
- * exist on output.
+ * exist on output. *
+ * cholmod_solve_refine solves Ax=b with a single or double precision L, with
+ * iterative refinement in double precision against the original A.
  */
 
 #ifndef NCHOLESKY
 
 #include "cholmod_internal.h"
 #include "cholmod_cholesky.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifndef NSUPERNODAL
 #include "cholmod_supernodal.h"
@@ -932,6 +937,376 @@ static void iptrans
 }
 
 
+#ifdef _OPENMP
+
+/* ========================================================================== */
+/* === simplicial_psolve ==================================================== */
+/* ========================================================================== */
+
+/* Solves LL'x=b or LDL'x=b for a real simplicial L and a single
+ * right-hand-side, with up to Common->nthreads_max threads.  Y holds b' on
+ * input and x' on output, with a stride of incy.
+ *
+ * As in the parallel supernodal solves, the etree is split into independent
+ * subtrees (a subtree with more than 1/(4*nthreads) of the nonzeros in L is
+ * split, starting at the roots), which are solved in parallel, with the top
+ * of the tree solved by this thread.  The schedule takes O(n) time and is
+ * found here, since the pattern of a simplicial factor can change (by
+ * cholmod_updown, cholmod_rowadd, and so on).  In the forward solve, each
+ * thread keeps the updates of its subtree to the rows above it in its own W.
+ * These rows must be in the pattern of the root of the subtree, which holds
+ * for any factor computed by CHOLMOD.  They are saved in Eb when the subtree
+ * is done, and then added into x in the order of the subtrees.
+ *
+ * Returns TRUE if the solve was done.  Otherwise, Y is left unchanged if L
+ * has no independent subtrees or if out of memory, or is undefined if the
+ * pattern of L was not as required.
+ */
+
+static int simplicial_psolve
+(
+    cholmod_factor *L,
+    double *Yx,
+    Int incy,
+    cholmod_common *Common
+)
+{
+    double xj, total, limit, *Lx, *Ww, *W, *Eb ;
+    Int *Lp, *Li, *Lnz, *Iw, *Parent, *Child, *Sibling, *Stack, *Owner,
+	*Tstart, *Tlist, *Eoff, *Mw, *Mark ;
+    Int n, j, c, p, pend, i, r, t, kk, klast, top, ntasks, nthreads, is_ll,
+	nfail = 0 ;
+    size_t iwsize, wsize, ebsize ;
+    int ok = TRUE, try_catch ;
+
+    n = L->n ;
+    Lp = L->p ;
+    Li = L->i ;
+    Lx = L->x ;
+    Lnz = L->nz ;
+    is_ll = L->is_ll ;
+    nthreads = Common->nthreads_max ;
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate workspace */
+    /* ---------------------------------------------------------------------- */
+
+    iwsize = CHOLMOD(mult_size_t) (n, 8, &ok) ;
+    iwsize = CHOLMOD(add_size_t) (iwsize, 2, &ok) ;
+    wsize = CHOLMOD(mult_size_t) (n, nthreads, &ok) ;
+    if (!ok)
+    {
+	return (FALSE) ;
+    }
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Iw = CHOLMOD(malloc) (iwsize, sizeof (Int), Common) ;
+    Common->try_catch = try_catch ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	Common->status = CHOLMOD_OK ;
+	return (FALSE) ;
+    }
+    Parent = Iw ;		/* size n */
+    Child = Iw + n ;		/* size n */
+    Sibling = Iw + 2*n ;	/* size n */
+    Stack = Iw + 3*n ;		/* size n */
+    Owner = Iw + 4*n ;		/* size n */
+    Tlist = Iw + 5*n ;		/* size n */
+    Tstart = Iw + 6*n ;		/* size n+1 */
+    Eoff = Iw + 7*n + 1 ;	/* size n+1 */
+
+    /* ---------------------------------------------------------------------- */
+    /* find the etree and the nonzeros in each subtree */
+    /* ---------------------------------------------------------------------- */
+
+    /* Ww is not yet allocated; use Eb for the work in each subtree */
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Eb = CHOLMOD(malloc) (n, sizeof (double), Common) ;
+    Common->try_catch = try_catch ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	Common->status = CHOLMOD_OK ;
+	CHOLMOD(free) (iwsize, sizeof (Int), Iw, Common) ;
+	return (FALSE) ;
+    }
+    for (j = 0 ; j < n ; j++)
+    {
+	Eb [j] = 0 ;
+	Child [j] = EMPTY ;
+    }
+    for (j = n-1 ; j >= 0 ; j--)
+    {
+	Parent [j] = (Lnz [j] > 1) ? Li [Lp [j] + 1] : EMPTY ;
+	if (Parent [j] != EMPTY)
+	{
+	    Sibling [j] = Child [Parent [j]] ;
+	    Child [Parent [j]] = j ;
+	}
+    }
+    total = 0 ;
+    for (j = 0 ; j < n ; j++)
+    {
+	Eb [j] += Lnz [j] ;
+	total += Lnz [j] ;
+	if (Parent [j] != EMPTY)
+	{
+	    Eb [Parent [j]] += Eb [j] ;
+	}
+    }
+    limit = total / (4 * (double) nthreads) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* split the large subtrees, starting at the roots */
+    /* ---------------------------------------------------------------------- */
+
+    top = 0 ;
+    for (j = 0 ; j < n ; j++)
+    {
+	Owner [j] = EMPTY ;
+	if (Parent [j] == EMPTY)
+	{
+	    Stack [top++] = j ;
+	}
+    }
+    ntasks = 0 ;
+    while (top > 0)
+    {
+	j = Stack [--top] ;
+	if (Eb [j] > limit && Child [j] != EMPTY)
+	{
+	    for (c = Child [j] ; c != EMPTY ; c = Sibling [c])
+	    {
+		Stack [top++] = c ;
+	    }
+	}
+	else
+	{
+	    Owner [j] = ntasks++ ;
+	}
+    }
+    Eb = CHOLMOD(free) (n, sizeof (double), Eb, Common) ;
+    if (ntasks < 2)
+    {
+	CHOLMOD(free) (iwsize, sizeof (Int), Iw, Common) ;
+	return (FALSE) ;
+    }
+    for (j = n-1 ; j >= 0 ; j--)
+    {
+	if (Owner [j] == EMPTY && Parent [j] != EMPTY)
+	{
+	    Owner [j] = Owner [Parent [j]] ;
+	}
+    }
+
+    /* list the columns of each subtree, and then the top of the tree */
+    for (t = 0 ; t <= ntasks ; t++)
+    {
+	Tstart [t] = 0 ;
+    }
+    for (j = 0 ; j < n ; j++)
+    {
+	if (Owner [j] != EMPTY)
+	{
+	    Tstart [Owner [j] + 1]++ ;
+	}
+    }
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	Tstart [t+1] += Tstart [t] ;
+	Stack [t] = Tstart [t] ;
+    }
+    kk = Tstart [ntasks] ;
+    for (j = 0 ; j < n ; j++)
+    {
+	if (Owner [j] != EMPTY)
+	{
+	    Tlist [Stack [Owner [j]]++] = j ;
+	}
+	else
+	{
+	    Tlist [kk++] = j ;
+	}
+    }
+
+    /* Eb [Eoff [t] ...] holds the updates of subtree t to the rows of its
+     * root r below the diagonal */
+    ebsize = 0 ;
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	r = Tlist [Tstart [t+1] - 1] ;
+	Eoff [t] = ebsize ;
+	ebsize += Lnz [r] - 1 ;
+    }
+    Eoff [ntasks] = ebsize ;
+
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Ww = CHOLMOD(calloc) (wsize, sizeof (double), Common) ;
+    Mw = CHOLMOD(malloc) (wsize, sizeof (Int), Common) ;
+    Eb = CHOLMOD(malloc) (ebsize, sizeof (double), Common) ;
+    Common->try_catch = try_catch ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	Common->status = CHOLMOD_OK ;
+	CHOLMOD(free) (iwsize, sizeof (Int), Iw, Common) ;
+	CHOLMOD(free) (wsize, sizeof (double), Ww, Common) ;
+	CHOLMOD(free) (wsize, sizeof (Int), Mw, Common) ;
+	CHOLMOD(free) (ebsize, sizeof (double), Eb, Common) ;
+	return (FALSE) ;
+    }
+    for (i = 0 ; i < (Int) wsize ; i++)
+    {
+	Mw [i] = EMPTY ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* solve Lx=b (LL') or LDx=b (LDL'): the subtrees in parallel */
+    /* ---------------------------------------------------------------------- */
+
+#pragma omp parallel for num_threads(nthreads) schedule (dynamic,1) \
+    private (W, Mark, xj, r, klast, kk, j, p, pend, i) reduction (+:nfail)
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	W = Ww + n * ((size_t) omp_get_thread_num ( )) ;
+	Mark = Mw + n * ((size_t) omp_get_thread_num ( )) ;
+	r = Tlist [Tstart [t+1] - 1] ;
+	klast = r + 1 ;
+	/* mark the rows above the subtree that it may update */
+	for (p = Lp [r] + 1 ; p < Lp [r] + Lnz [r] ; p++)
+	{
+	    Mark [Li [p]] = t ;
+	}
+	for (kk = Tstart [t] ; kk < Tstart [t+1] ; kk++)
+	{
+	    j = Tlist [kk] ;
+	    xj = Yx [j*incy] ;
+	    if (is_ll)
+	    {
+		xj /= Lx [Lp [j]] ;
+		Yx [j*incy] = xj ;
+	    }
+	    pend = Lp [j] + Lnz [j] ;
+	    for (p = Lp [j] + 1 ; p < pend ; p++)
+	    {
+		i = Li [p] ;
+		if (i < klast)
+		{
+		    Yx [i*incy] -= Lx [p] * xj ;
+		}
+		else if (Mark [i] == t)
+		{
+		    W [i] -= Lx [p] * xj ;
+		}
+		else
+		{
+		    /* row i is not in the pattern of the root */
+		    nfail++ ;
+		}
+	    }
+	}
+	/* save the updates to the rows above the subtree, and clear W */
+	for (p = Lp [r] + 1, kk = Eoff [t] ; p < Lp [r] + Lnz [r] ; p++, kk++)
+	{
+	    Eb [kk] = W [Li [p]] ;
+	    W [Li [p]] = 0 ;
+	}
+    }
+
+    CHOLMOD(free) (wsize, sizeof (double), Ww, Common) ;
+    CHOLMOD(free) (wsize, sizeof (Int), Mw, Common) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* add the updates into x, and solve the top of the tree */
+    /* ---------------------------------------------------------------------- */
+
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	r = Tlist [Tstart [t+1] - 1] ;
+	for (p = Lp [r] + 1, kk = Eoff [t] ; p < Lp [r] + Lnz [r] ; p++, kk++)
+	{
+	    Yx [Li [p]*incy] += Eb [kk] ;
+	}
+    }
+    CHOLMOD(free) (ebsize, sizeof (double), Eb, Common) ;
+    if (nfail > 0)
+    {
+	CHOLMOD(free) (iwsize, sizeof (Int), Iw, Common) ;
+	return (FALSE) ;
+    }
+    for (kk = Tstart [ntasks] ; kk < n ; kk++)
+    {
+	j = Tlist [kk] ;
+	xj = Yx [j*incy] ;
+	if (is_ll)
+	{
+	    xj /= Lx [Lp [j]] ;
+	    Yx [j*incy] = xj ;
+	}
+	pend = Lp [j] + Lnz [j] ;
+	for (p = Lp [j] + 1 ; p < pend ; p++)
+	{
+	    Yx [Li [p]*incy] -= Lx [p] * xj ;
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* solve L'x=b (LL') or DL'x=b (LDL'): the top of the tree, then the
+     * subtrees in parallel */
+    /* ---------------------------------------------------------------------- */
+
+    for (kk = n-1 ; kk >= Tstart [ntasks] ; kk--)
+    {
+	j = Tlist [kk] ;
+	xj = Yx [j*incy] ;
+	if (!is_ll)
+	{
+	    xj /= Lx [Lp [j]] ;
+	}
+	pend = Lp [j] + Lnz [j] ;
+	for (p = Lp [j] + 1 ; p < pend ; p++)
+	{
+	    xj -= Lx [p] * Yx [Li [p]*incy] ;
+	}
+	if (is_ll)
+	{
+	    xj /= Lx [Lp [j]] ;
+	}
+	Yx [j*incy] = xj ;
+    }
+
+#pragma omp parallel for num_threads(nthreads) schedule (dynamic,1) \
+    private (xj, kk, j, p, pend)
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	for (kk = Tstart [t+1] - 1 ; kk >= Tstart [t] ; kk--)
+	{
+	    j = Tlist [kk] ;
+	    xj = Yx [j*incy] ;
+	    if (!is_ll)
+	    {
+		xj /= Lx [Lp [j]] ;
+	    }
+	    pend = Lp [j] + Lnz [j] ;
+	    for (p = Lp [j] + 1 ; p < pend ; p++)
+	    {
+		xj -= Lx [p] * Yx [Li [p]*incy] ;
+	    }
+	    if (is_ll)
+	    {
+		xj /= Lx [Lp [j]] ;
+	    }
+	    Yx [j*incy] = xj ;
+	}
+    }
+
+    CHOLMOD(free) (iwsize, sizeof (Int), Iw, Common) ;
+    return (TRUE) ;
+}
+#endif
+
+
 /* ========================================================================== */
 /* === cholmod_solve ======================================================== */
 /* ========================================================================== */
@@ -1060,6 +1435,7 @@ int CHOLMOD(solve2)         /* returns TRUE on success, FALSE on failure */
 
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_NULL (B, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
     RETURN_IF_XTYPE_INVALID (B, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
@@ -1645,6 +2021,25 @@ int CHOLMOD(solve2)         /* returns TRUE on success, FALSE on failure */
 
             ptrans (B, Perm, k1, ncols, Y) ;
 
+            /* -------------------------------------------------------------- */
+            /* solve Y = (L' \ (L \ Y'))' in parallel, if requested */
+            /* -------------------------------------------------------------- */
+
+#ifdef _OPENMP
+            if (Common->nthreads_max > 1 && nrhs == 1 && ytype == CHOLMOD_REAL
+                && L->xtype == CHOLMOD_REAL && B->xtype == CHOLMOD_REAL
+                && (sys == CHOLMOD_A || sys == CHOLMOD_LDLt))
+            {
+                if (simplicial_psolve (L, Y->x, Y->d, Common))
+                {
+                    iptrans (Y, Perm, k1, ncols, X) ;
+                    continue ;
+                }
+                /* Y may have been modified */
+                ptrans (B, Perm, k1, ncols, Y) ;
+            }
+#endif
+
             /* -------------------------------------------------------------- */
             /* solve Y = (L' \ (L \ Y'))', or other system, with template */
             /* -------------------------------------------------------------- */
@@ -1675,4 +2070,394 @@ int CHOLMOD(solve2)         /* returns TRUE on success, FALSE on failure */
     DEBUG (CHOLMOD(dump_dense) (X, "X result", Common)) ;
     return (TRUE) ;
 }
+
+
+/* ========================================================================== */
+/* === single_solve ========================================================= */
+/* ========================================================================== */
+
+/* Solves LL'x=b or LDL'x=b in place for a real L with single precision values
+ * (simplicial LL' or LDL', or supernodal LL'; see cholmod_factor_dtype), and a
+ * single right-hand-side x, already permuted by L->Perm.  L is read as float,
+ * but all of the arithmetic is done in double precision.
+ */
+
+static void single_solve
+(
+    cholmod_factor *L,
+    double *x		/* size n; b on input, x on output */
+)
+{
+    double xj ;
+    float *Lx, *Lj ;
+    Int *Lp, *Li, *Lnz, *Super, *Lpi, *Lpx, *Ls ;
+    Int n, j, p, pend, s, k1, psi, nsrow, nscol, ii, jj ;
+
+    n = L->n ;
+    Lx = L->x ;
+
+    if (L->is_super)
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* supernodal LL' */
+	/* ------------------------------------------------------------------ */
+
+	Super = L->super ;
+	Lpi = L->pi ;
+	Lpx = L->px ;
+	Ls = L->s ;
+
+	/* solve Lx=b, one column at a time */
+	for (s = 0 ; s < (Int) (L->nsuper) ; s++)
+	{
+	    k1 = Super [s] ;
+	    nscol = Super [s+1] - k1 ;
+	    psi = Lpi [s] ;
+	    nsrow = Lpi [s+1] - psi ;
+	    for (jj = 0 ; jj < nscol ; jj++)
+	    {
+		Lj = Lx + Lpx [s] + jj * nsrow ;
+		xj = x [k1 + jj] / Lj [jj] ;
+		x [k1 + jj] = xj ;
+		for (ii = jj + 1 ; ii < nsrow ; ii++)
+		{
+		    x [Ls [psi + ii]] -= Lj [ii] * xj ;
+		}
+	    }
+	}
+
+	/* solve L'x=b */
+	for (s = ((Int) (L->nsuper)) - 1 ; s >= 0 ; s--)
+	{
+	    k1 = Super [s] ;
+	    nscol = Super [s+1] - k1 ;
+	    psi = Lpi [s] ;
+	    nsrow = Lpi [s+1] - psi ;
+	    for (jj = nscol - 1 ; jj >= 0 ; jj--)
+	    {
+		Lj = Lx + Lpx [s] + jj * nsrow ;
+		xj = x [k1 + jj] ;
+		for (ii = jj + 1 ; ii < nsrow ; ii++)
+		{
+		    xj -= Lj [ii] * x [Ls [psi + ii]] ;
+		}
+		x [k1 + jj] = xj / Lj [jj] ;
+	    }
+	}
+
+    }
+    else
+    {
+
+	/* ------------------------------------------------------------------ */
+	/* simplicial LL' or LDL' (the diagonal holds D for LDL') */
+	/* ------------------------------------------------------------------ */
+
+	Lp = L->p ;
+	Li = L->i ;
+	Lnz = L->nz ;
+
+	/* solve Lx=b */
+	for (j = 0 ; j < n ; j++)
+	{
+	    p = Lp [j] ;
+	    pend = p + Lnz [j] ;
+	    xj = x [j] ;
+	    if (L->is_ll)
+	    {
+		xj /= Lx [p] ;
+		x [j] = xj ;
+	    }
+	    for (p++ ; p < pend ; p++)
+	    {
+		x [Li [p]] -= Lx [p] * xj ;
+	    }
+	}
+
+	/* solve Dx=b */
+	if (!L->is_ll)
+	{
+	    for (j = 0 ; j < n ; j++)
+	    {
+		x [j] /= Lx [Lp [j]] ;
+	    }
+	}
+
+	/* solve L'x=b */
+	for (j = n - 1 ; j >= 0 ; j--)
+	{
+	    p = Lp [j] ;
+	    pend = p + Lnz [j] ;
+	    xj = x [j] ;
+	    for (p++ ; p < pend ; p++)
+	    {
+		xj -= Lx [p] * x [Li [p]] ;
+	    }
+	    x [j] = (L->is_ll) ? (xj / Lx [Lp [j]]) : xj ;
+	}
+    }
+}
+
+
+/* ========================================================================== */
+/* === refine_residual ====================================================== */
+/* ========================================================================== */
+
+/* r = b - A*x and w = |A|*|x| + |b|, for a real symmetric A with its upper
+ * (A->stype > 0) or lower (A->stype < 0) triangular part stored.  Entries in
+ * the other part are ignored, as in cholmod_sdmult.  Returns the componentwise
+ * backward error max (|r| ./ w) of x. */
+
+static double refine_residual
+(
+    cholmod_sparse *A,
+    double *x,
+    double *b,
+    double *r,
+    double *w
+)
+{
+    double aij, e, berr ;
+    double *Ax ;
+    Int *Ap, *Ai, *Anz ;
+    Int n, i, j, p, pend, stype, packed ;
+
+    n = A->nrow ;
+    Ap = A->p ;
+    Ai = A->i ;
+    Anz = A->nz ;
+    Ax = A->x ;
+    stype = A->stype ;
+    packed = A->packed ;
+
+    for (i = 0 ; i < n ; i++)
+    {
+	r [i] = b [i] ;
+	w [i] = fabs (b [i]) ;
+    }
+    for (j = 0 ; j < n ; j++)
+    {
+	p = Ap [j] ;
+	pend = (packed) ? (Ap [j+1]) : (p + Anz [j]) ;
+	for ( ; p < pend ; p++)
+	{
+	    i = Ai [p] ;
+	    if ((stype > 0 && i > j) || (stype < 0 && i < j))
+	    {
+		continue ;
+	    }
+	    aij = Ax [p] ;
+	    r [i] -= aij * x [j] ;
+	    w [i] += fabs (aij * x [j]) ;
+	    if (i != j)
+	    {
+		r [j] -= aij * x [i] ;
+		w [j] += fabs (aij * x [i]) ;
+	    }
+	}
+    }
+
+    berr = 0 ;
+    for (i = 0 ; i < n ; i++)
+    {
+	if (w [i] > 0)
+	{
+	    e = fabs (r [i]) / w [i] ;
+	}
+	else
+	{
+	    /* the row of A and b are zero: r(i) is zero unless x has a NaN */
+	    e = (r [i] == 0) ? 0 : HUGE_DOUBLE ;
+	}
+	berr = MAX (berr, e) ;
+    }
+    return (berr) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_solve_refine ================================================= */
+/* ========================================================================== */
+
+/* Solves Ax=b with iterative refinement, where L is the factorization of a
+ * real symmetric matrix A from cholmod_factorize (with beta = 0).  L can have
+ * single precision values (see Common->single_factor and
+ * cholmod_factor_dtype), or be a regular double precision factor.  The
+ * residual r = b-A*x is computed in double precision with the original A, and
+ * the correction is found with L.  For each column of B, refinement stops when
+ * the componentwise backward error max (|b-A*x| ./ (|A|*|x|+|b|)) is at the
+ * level of the double precision roundoff, when it is no longer cut in half by
+ * a step, or after maxiter steps.  If L is single precision, a few steps
+ * typically recover a solution as accurate as with a double precision L, if
+ * A is well-conditioned.  The largest backward error of the columns of X is
+ * returned in *berr, if berr is not NULL.
+ *
+ * A must be square with A->stype nonzero (the unsymmetric case, where L is
+ * the factorization of A*A', is not supported).  L and B must be real.
+ * Returns X, or NULL if an error occurred.
+ *
+ * workspace: none.  Allocates three n-by-1 vectors, and the workspace of
+ *	cholmod_solve2 if L is double precision.
+ */
+
+cholmod_dense *CHOLMOD(solve_refine)
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix that L is the factorization of */
+    cholmod_factor *L,	/* factorization to use, single or double */
+    cholmod_dense *B,	/* right-hand-side */
+    int maxiter,	/* maximum number of refinement steps per column */
+    /* ---- output --- */
+    double *berr,	/* largest backward error of the columns of X */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    cholmod_dense *X, *R, *D, *Y, *E ;
+    double colberr, lastberr, maxberr ;
+    double *Xx, *Bx, *Rx, *Dx, *Wx, *Z ;
+    Int *Perm ;
+    Int n, nrhs, k, i, iter ;
+    int ok = TRUE, single ;
+    size_t wsize ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    RETURN_IF_NULL_COMMON (NULL) ;
+    RETURN_IF_NULL (A, NULL) ;
+    RETURN_IF_NULL (L, NULL) ;
+    RETURN_IF_NULL (B, NULL) ;
+    RETURN_IF_XTYPE_INVALID (A, CHOLMOD_REAL, CHOLMOD_REAL, NULL) ;
+    RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_REAL, NULL) ;
+    RETURN_IF_XTYPE_INVALID (B, CHOLMOD_REAL, CHOLMOD_REAL, NULL) ;
+    n = L->n ;
+    if (A->stype == 0 || A->nrow != L->n || A->ncol != L->n)
+    {
+	ERROR (CHOLMOD_INVALID, "A must be symmetric, and match L") ;
+	return (NULL) ;
+    }
+    if (B->nrow != L->n || B->d < B->nrow)
+    {
+	ERROR (CHOLMOD_INVALID, "dimensions of L and B do not match") ;
+	return (NULL) ;
+    }
+    Common->status = CHOLMOD_OK ;
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate the result and workspace */
+    /* ---------------------------------------------------------------------- */
+
+    nrhs = B->ncol ;
+    single = (L->dtype == CHOLMOD_SINGLE) ;
+    wsize = CHOLMOD(mult_size_t) (n, 2, &ok) ;
+    if (!ok)
+    {
+	ERROR (CHOLMOD_TOO_LARGE, "problem too large") ;
+	return (NULL) ;
+    }
+    X = CHOLMOD(allocate_dense) (n, nrhs, n, CHOLMOD_REAL, Common) ;
+    R = CHOLMOD(allocate_dense) (n, 1, n, CHOLMOD_REAL, Common) ;
+    Wx = CHOLMOD(malloc) (wsize, sizeof (double), Common) ;
+    D = NULL ;
+    Y = NULL ;
+    E = NULL ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	CHOLMOD(free_dense) (&X, Common) ;
+	CHOLMOD(free_dense) (&R, Common) ;
+	CHOLMOD(free) (wsize, sizeof (double), Wx, Common) ;
+	return (NULL) ;
+    }
+    Xx = X->x ;
+    Bx = B->x ;
+    Rx = R->x ;
+    Z = Wx + n ;
+    Perm = L->Perm ;
+    maxberr = 0 ;
+
+    /* ---------------------------------------------------------------------- */
+    /* solve each column, with refinement */
+    /* ---------------------------------------------------------------------- */
+
+    for (k = 0 ; k < nrhs ; k++)
+    {
+	/* start with x = 0 and r = b */
+	for (i = 0 ; i < n ; i++)
+	{
+	    Xx [i + k*n] = 0 ;
+	    Rx [i] = Bx [i + k*B->d] ;
+	}
+	lastberr = HUGE_DOUBLE ;
+	for (iter = 0 ; ; iter++)
+	{
+	    /* solve A*d = r with L, and x = x + d */
+	    if (single)
+	    {
+		for (i = 0 ; i < n ; i++)
+		{
+		    Z [i] = Rx [P (i)] ;
+		}
+		single_solve (L, Z) ;
+		for (i = 0 ; i < n ; i++)
+		{
+		    Xx [P (i) + k*n] += Z [i] ;
+		}
+	    }
+	    else
+	    {
+		ok = CHOLMOD(solve2) (CHOLMOD_A, L, R, NULL, &D, NULL, &Y, &E,
+		    Common) ;
+		if (!ok)
+		{
+		    break ;
+		}
+		Dx = D->x ;
+		for (i = 0 ; i < n ; i++)
+		{
+		    Xx [i + k*n] += Dx [i] ;
+		}
+	    }
+
+	    /* r = b - A*x, and the backward error of x */
+	    colberr = refine_residual (A, Xx + k*n, Bx + k*B->d, Rx, Wx) ;
+	    if (colberr <= DBL_EPSILON || iter >= maxiter
+		|| 2 * colberr > lastberr)
+	    {
+		break ;
+	    }
+	    lastberr = colberr ;
+	}
+	if (!ok)
+	{
+	    break ;	/* out of memory in cholmod_solve2 */
+	}
+	PRINT1 (("column "ID": refinement steps "ID" berr %g\n", k, iter,
+	    colberr)) ;
+	maxberr = MAX (maxberr, colberr) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* free workspace and return result */
+    /* ---------------------------------------------------------------------- */
+
+    CHOLMOD(free_dense) (&R, Common) ;
+    CHOLMOD(free_dense) (&D, Common) ;
+    CHOLMOD(free_dense) (&Y, Common) ;
+    CHOLMOD(free_dense) (&E, Common) ;
+    CHOLMOD(free) (wsize, sizeof (double), Wx, Common) ;
+    if (!ok)
+    {
+	CHOLMOD(free_dense) (&X, Common) ;
+	return (NULL) ;
+    }
+    if (berr != NULL)
+    {
+	*berr = maxberr ;
+    }
+    DEBUG (CHOLMOD(dump_dense) (X, "X refined", Common)) ;
+    return (X) ;
+}
 #endif
@@ -80,6 +80,7 @@ cholmod_sparse *CHOLMOD(spsolve)	    /* returns the sparse solution X */
 
     RETURN_IF_NULL_COMMON (NULL) ;
     RETURN_IF_NULL (L, NULL) ;
+    RETURN_IF_SINGLE (L, NULL) ;
     RETURN_IF_NULL (B, NULL) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, NULL) ;
     RETURN_IF_XTYPE_INVALID (B, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, NULL) ;
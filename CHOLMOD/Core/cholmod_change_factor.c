@@ -346,7 +346,7 @@ static void any_to_simplicial_symbolic
     /* free all but the symbolic analysis (Perm and ColCount) */
     L->p     = CHOLMOD(free) (n1,  sizeof (Int),      L->p,     Common) ;
     L->i     = CHOLMOD(free) (lnz, sizeof (Int),      L->i,     Common) ;
-    L->x     = CHOLMOD(free) (xs,  e*sizeof (double), L->x,     Common) ;
+    L->x     = CHOLMOD(ooc_free) (xs, e*sizeof (double), L->x, L->ooc, Common);
     L->z     = CHOLMOD(free) (lnz, sizeof (double),   L->z,     Common) ;
     L->nz    = CHOLMOD(free) (n,   sizeof (Int),      L->nz,    Common) ;
     L->next  = CHOLMOD(free) (n2,  sizeof (Int),      L->next,  Common) ;
@@ -355,6 +355,8 @@ static void any_to_simplicial_symbolic
     L->pi    = CHOLMOD(free) (s,   sizeof (Int),      L->pi,    Common) ;
     L->px    = CHOLMOD(free) (s,   sizeof (Int),      L->px,    Common) ;
     L->s     = CHOLMOD(free) (ss,  sizeof (Int),      L->s,     Common) ;
+    L->tasks = CHOLMOD(free) (2*s+1, sizeof (Int),    L->tasks, Common) ;
+    L->ooc = 0 ;
     L->nzmax = 0 ;
     L->is_super = FALSE ;
     L->xtype = CHOLMOD_PATTERN ;
@@ -382,9 +384,10 @@ static void ll_super_to_super_symbolic
     /* free all but the supernodal numerical factor */
     ASSERT (L->xtype != CHOLMOD_PATTERN && L->is_super && L->is_ll) ;
     DEBUG (CHOLMOD(dump_factor) (L, "start to super symbolic", Common)) ;
-    L->x = CHOLMOD(free) (L->xsize,
+    L->x = CHOLMOD(ooc_free) (L->xsize,
 	    (L->xtype == CHOLMOD_COMPLEX ? 2 : 1) * sizeof (double), L->x,
-	    Common) ;
+	    L->ooc, Common) ;
+    L->ooc = 0 ;
     L->xtype = CHOLMOD_PATTERN ;
     L->dtype = DTYPE ;
     L->minor = L->n ;
@@ -881,6 +884,12 @@ static void ll_super_to_simplicial_numeric
     PRINT1 (("simplicial lnz = "ID"  to_packed: %d  to_ll: %d L->xsize %g\n",
 		lnz, to_ll, to_packed, (double) L->xsize)) ;
 
+    /* the simplicial L->x is L->x itself, compacted, so it must be in memory */
+    if (!CHOLMOD(ooc_load) (L, Common))
+    {
+	return ;	/* out of memory */
+    }
+
     Li = CHOLMOD(malloc) (lnz, sizeof (Int), Common) ;
     if (Common->status < CHOLMOD_OK)
     {
@@ -922,6 +931,7 @@ static void ll_super_to_simplicial_numeric
     L->pi    = CHOLMOD(free) (nsuper+1, sizeof (Int), L->pi, Common) ;
     L->px    = CHOLMOD(free) (nsuper+1, sizeof (Int), L->px, Common) ;
     L->s     = CHOLMOD(free) (L->ssize, sizeof (Int), L->s, Common) ;
+    L->tasks = CHOLMOD(free) (2*nsuper+3, sizeof (Int), L->tasks, Common) ;
 
     L->ssize = 0 ;
     L->xsize = 0 ;
@@ -954,8 +964,9 @@ static int super_symbolic_to_ll_super
     Int wentry = (to_xtype == CHOLMOD_REAL) ? 1 : 2 ;
     PRINT1 (("convert super sym to num\n")) ;
     ASSERT (L->xtype == CHOLMOD_PATTERN && L->is_super) ;
-    Lx = CHOLMOD(malloc) (L->xsize, wentry * sizeof (double), Common) ;
-    PRINT1 (("xsize %g\n", (double) L->xsize)) ;
+    Lx = CHOLMOD(ooc_malloc) (L->xsize, wentry * sizeof (double), &(L->ooc),
+	    Common) ;
+    PRINT1 (("xsize %g ooc %g\n", (double) L->xsize, (double) L->ooc)) ;
     if (Common->status < CHOLMOD_OK)
     {
 	return (FALSE) ;	/* out of memory */
@@ -1049,6 +1060,13 @@ int CHOLMOD(change_factor)
 	return (FALSE) ;
     }
 
+    /* the conversions below assume L->x is double */
+    if (L->dtype == CHOLMOD_SINGLE
+	&& !CHOLMOD(factor_dtype) (CHOLMOD_DOUBLE, L, Common))
+    {
+	return (FALSE) ;
+    }
+
     /* ---------------------------------------------------------------------- */
     /* convert */
     /* ---------------------------------------------------------------------- */
@@ -214,6 +214,9 @@ int CHOLMOD(start)
     Common->cholmod_gpu_trsm_calls = 0 ;
     Common->cholmod_gpu_potrf_calls = 0 ;
 
+    Common->cholmod_cpu_small_calls = 0 ;
+    Common->cholmod_cpu_small_time = 0 ;
+
     Common->maxGpuMemBytes = 0;
     Common->maxGpuMemFraction = 0.0;
 
@@ -279,6 +282,11 @@ int CHOLMOD(defaults)
     Common->prefer_upper = TRUE ;
     Common->prefer_binary = FALSE ;
     Common->quick_return_if_not_posdef = FALSE ;
+    Common->nthreads_max = 1 ;
+    Common->ooc_size = 0 ;
+    Common->ooc_memory = 0 ;
+    Common->small_super = 0 ;
+    Common->single_factor = FALSE ;
 
     /* METIS workarounds */
     Common->metis_memory = 0.0 ;    /* > 0 for memory guard (2 is reasonable) */
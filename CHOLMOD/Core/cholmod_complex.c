@@ -470,6 +470,7 @@ int CHOLMOD(factor_xtype)
     Int ok ;
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
     if (L->is_super &&
 	    (L->xtype == CHOLMOD_ZOMPLEX || to_xtype == CHOLMOD_ZOMPLEX))
@@ -477,6 +478,10 @@ int CHOLMOD(factor_xtype)
 	ERROR (CHOLMOD_INVALID, "invalid xtype for supernodal L") ;
 	return (FALSE) ;
     }
+    if (L->xtype != to_xtype && !CHOLMOD(ooc_load) (L, Common))
+    {
+	return (FALSE) ;    /* out of memory */
+    }
     ok = change_complexity ((L->is_super ? L->xsize : L->nzmax), L->xtype,
 	    to_xtype, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, &(L->x), &(L->z), Common) ;
     if (ok)
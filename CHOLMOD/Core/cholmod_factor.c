@@ -29,6 +29,14 @@
  * cholmod_reallocate_column	resize a single column of a factor
  * cholmod_factor_to_sparse	create a sparse matrix copy of a factor
  * cholmod_copy_factor		create a copy of a factor
+ * cholmod_factor_dtype		change a factor to single or double precision
+ *
+ * Internal routines for a supernodal L->x held in a memory-mapped file
+ * (see Common->ooc_size and Common->ooc_memory):
+ * cholmod_ooc_malloc		allocate L->x, in a file if it is large
+ * cholmod_ooc_free		free L->x
+ * cholmod_ooc_load		move L->x from the file into memory
+ * cholmod_ooc_sweep		prefetch/release L->x during a sweep through L
  *
  * Note that there is no cholmod_sparse_to_factor routine to create a factor
  * as a copy of a sparse matrix.  It could be done, after a fashion, but a
@@ -44,6 +52,16 @@
 
 #include "cholmod_internal.h"
 #include "cholmod_core.h"
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#define HAVE_MMAP
+#endif
 
 
 /* ========================================================================== */
@@ -129,6 +147,8 @@ cholmod_factor *CHOLMOD(allocate_factor)
     L->pi = NULL ;
     L->px = NULL ;
     L->s = NULL ;
+    L->tasks = NULL ;	    /* only created by cholmod_super_*solve when needed */
+    L->ooc = 0 ;	    /* L->x is not held in a file */
     L->useGPU = 0;
 
     /* L has not been factorized */
@@ -213,15 +233,20 @@ int CHOLMOD(free_factor)
     CHOLMOD(free) (s,   sizeof (Int), L->px,       Common) ;
     CHOLMOD(free) (s,   sizeof (Int), L->super,    Common) ;
     CHOLMOD(free) (ss,  sizeof (Int), L->s,        Common) ;
+    CHOLMOD(free) (2*s+1, sizeof (Int), L->tasks,  Common) ;
 
     /* numerical values for both simplicial and supernodal L */
-    if (L->xtype == CHOLMOD_REAL)
+    if (L->xtype == CHOLMOD_REAL && L->dtype == CHOLMOD_SINGLE)
     {
-	CHOLMOD(free) (xs, sizeof (double), L->x, Common) ;
+	CHOLMOD(free) (xs, sizeof (float), L->x, Common) ;
+    }
+    else if (L->xtype == CHOLMOD_REAL)
+    {
+	CHOLMOD(ooc_free) (xs, sizeof (double), L->x, L->ooc, Common) ;
     }
     else if (L->xtype == CHOLMOD_COMPLEX)
     {
-	CHOLMOD(free) (xs, 2*sizeof (double), L->x, Common) ;
+	CHOLMOD(ooc_free) (xs, 2*sizeof (double), L->x, L->ooc, Common) ;
     }
     else if (L->xtype == CHOLMOD_ZOMPLEX)
     {
@@ -260,6 +285,7 @@ int CHOLMOD(reallocate_factor)
 
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
     PRINT1 (("realloc factor: xtype %d\n", L->xtype)) ;
     if (L->is_super)
@@ -314,6 +340,7 @@ int CHOLMOD(reallocate_column)
 
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
     if (L->is_super)
     {
@@ -503,6 +530,7 @@ int CHOLMOD(pack_factor)
 
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, FALSE) ;
     Common->status = CHOLMOD_OK ;
     DEBUG (CHOLMOD(dump_factor) (L, "start pack", Common)) ;
@@ -615,6 +643,7 @@ cholmod_sparse *CHOLMOD(factor_to_sparse)
 
     RETURN_IF_NULL_COMMON (NULL) ;
     RETURN_IF_NULL (L, NULL) ;
+    RETURN_IF_SINGLE (L, NULL) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, NULL) ;
     Common->status = CHOLMOD_OK ;
     DEBUG (CHOLMOD(dump_factor) (L, "start convert to matrix", Common)) ;
@@ -709,6 +738,7 @@ cholmod_factor *CHOLMOD(copy_factor)
 
     RETURN_IF_NULL_COMMON (NULL) ;
     RETURN_IF_NULL (L, NULL) ;
+    RETURN_IF_SINGLE (L, NULL) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, NULL) ;
     Common->status = CHOLMOD_OK ;
     DEBUG (CHOLMOD(dump_factor) (L, "start copy", Common)) ;
@@ -932,3 +962,346 @@ cholmod_factor *CHOLMOD(copy_factor)
     ASSERT (L2->xtype == L->xtype && L2->is_super == L->is_super) ;
     return (L2) ;
 }
+
+
+/* ========================================================================== */
+/* === cholmod_factor_dtype ================================================= */
+/* ========================================================================== */
+
+/* Convert the numerical values of a real factor (simplicial or supernodal)
+ * to single (CHOLMOD_SINGLE) or double (CHOLMOD_DOUBLE) precision, in place.
+ * A single precision factor takes half the memory.  It can only be used by
+ * cholmod_solve_refine, cholmod_factorize (which converts it back to double
+ * and refactorizes), cholmod_change_factor (which converts it back to double
+ * first), and cholmod_free_factor; other routines return an error.  Values
+ * too large for a float become Inf.  A symbolic factor is not changed.  The
+ * values of a single precision L are always held in memory (see
+ * Common->ooc_size).
+ *
+ * Returns TRUE if successful, or FALSE if L is complex or zomplex, or if out
+ * of memory (L is then unchanged).
+ *
+ * workspace: none
+ */
+
+int CHOLMOD(factor_dtype)
+(
+    /* ---- input ---- */
+    int to_dtype,	/* CHOLMOD_SINGLE or CHOLMOD_DOUBLE */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* factor to change */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double *Lx ;
+    float *Lf ;
+    size_t xs, p, ooc ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    RETURN_IF_NULL_COMMON (FALSE) ;
+    RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_XTYPE_INVALID (L, CHOLMOD_PATTERN, CHOLMOD_ZOMPLEX, FALSE) ;
+    if (to_dtype != CHOLMOD_SINGLE && to_dtype != CHOLMOD_DOUBLE)
+    {
+	ERROR (CHOLMOD_INVALID, "invalid dtype") ;
+	return (FALSE) ;
+    }
+    Common->status = CHOLMOD_OK ;
+    if (L->xtype == CHOLMOD_PATTERN || L->dtype == to_dtype)
+    {
+	return (TRUE) ;	    /* nothing to do */
+    }
+    if (L->xtype != CHOLMOD_REAL)
+    {
+	ERROR (CHOLMOD_INVALID, "single precision factor must be real") ;
+	return (FALSE) ;
+    }
+    xs = (L->is_super) ? (L->xsize) : (L->nzmax) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* convert L->x */
+    /* ---------------------------------------------------------------------- */
+
+    if (to_dtype == CHOLMOD_SINGLE)
+    {
+	Lf = CHOLMOD(malloc) (xs, sizeof (float), Common) ;
+	if (Common->status < CHOLMOD_OK)
+	{
+	    return (FALSE) ;	/* out of memory */
+	}
+	Lx = L->x ;
+	for (p = 0 ; p < xs ; p++)
+	{
+	    Lf [p] = (float) Lx [p] ;
+	}
+	CHOLMOD(ooc_free) (xs, sizeof (double), L->x, L->ooc, Common) ;
+	L->x = Lf ;
+	L->ooc = 0 ;
+    }
+    else
+    {
+	ooc = 0 ;
+	if (L->is_super)
+	{
+	    Lx = CHOLMOD(ooc_malloc) (xs, sizeof (double), &ooc, Common) ;
+	}
+	else
+	{
+	    Lx = CHOLMOD(malloc) (xs, sizeof (double), Common) ;
+	}
+	if (Common->status < CHOLMOD_OK)
+	{
+	    return (FALSE) ;	/* out of memory */
+	}
+	Lf = L->x ;
+	for (p = 0 ; p < xs ; p++)
+	{
+	    Lx [p] = Lf [p] ;
+	}
+	CHOLMOD(free) (xs, sizeof (float), L->x, Common) ;
+	L->x = Lx ;
+	L->ooc = ooc ;
+    }
+    L->dtype = to_dtype ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_ooc_malloc =================================================== */
+/* ========================================================================== */
+
+/* Allocate an array of n items of the given size for the numerical values of
+ * a supernodal factor.  If it is larger than Common->ooc_size bytes, it is
+ * held in a memory-mapped temporary file, which is unlinked as soon as it is
+ * created, so it disappears when the mapping is freed or the program exits.
+ * *ooc is returned as the size of the mapping in bytes, or 0 if the array
+ * was allocated with cholmod_malloc (also the fallback if the file cannot be
+ * created).  The mapping is not counted in Common->memory_inuse.
+ */
+
+void *CHOLMOD(ooc_malloc)
+(
+    /* ---- input ---- */
+    size_t n,		/* number of items */
+    size_t size,	/* size of each item */
+    /* ---- output --- */
+    size_t *ooc,	/* size of the mapping, or 0 if not mapped */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+#ifdef HAVE_MMAP
+    char path [4096] ;
+    const char *dir ;
+    void *p ;
+    size_t bytes ;
+    int ok = TRUE, fd ;
+#endif
+
+    *ooc = 0 ;
+
+#ifdef HAVE_MMAP
+    bytes = CHOLMOD(mult_size_t) (n, size, &ok) ;
+    if (ok && Common->ooc_size > 0 && ((double) bytes) > Common->ooc_size
+	&& Common->useGPU != 1)
+    {
+	dir = getenv ("TMPDIR") ;
+	if (dir == NULL || dir [0] == '\0' || strlen (dir) + 16 > sizeof (path))
+	{
+	    dir = "/tmp" ;
+	}
+	strcpy (path, dir) ;
+	strcat (path, "/cholmod_XXXXXX") ;
+	fd = mkstemp (path) ;
+	if (fd >= 0)
+	{
+	    unlink (path) ;
+	    p = MAP_FAILED ;
+	    /* reserve the disk space now, so that a full disk is reported here
+	     * rather than as a SIGBUS while L is being written */
+	    if (posix_fallocate (fd, 0, (off_t) bytes) == 0)
+	    {
+		p = mmap (NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+		    0) ;
+	    }
+	    close (fd) ;
+	    if (p != MAP_FAILED)
+	    {
+		*ooc = bytes ;
+		return (p) ;
+	    }
+	}
+	PRINT1 (("ooc: cannot map %g bytes, using malloc\n", (double) bytes)) ;
+    }
+#endif
+
+    return (CHOLMOD(malloc) (n, size, Common)) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_ooc_free ===================================================== */
+/* ========================================================================== */
+
+/* Free an array allocated by cholmod_ooc_malloc.  ooc is the size of the
+ * mapping it returned.  Always returns NULL. */
+
+void *CHOLMOD(ooc_free)
+(
+    /* ---- input ---- */
+    size_t n,		/* number of items */
+    size_t size,	/* size of each item */
+    /* ---- in/out --- */
+    void *p,		/* array to free */
+    /* ---- input ---- */
+    size_t ooc,		/* size of the mapping, or 0 if not mapped */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+#ifdef HAVE_MMAP
+    if (ooc > 0)
+    {
+	if (p != NULL)
+	{
+	    munmap (p, ooc) ;
+	}
+	return (NULL) ;
+    }
+#endif
+    return (CHOLMOD(free) (n, size, p, Common)) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_ooc_load ===================================================== */
+/* ========================================================================== */
+
+/* Move the numerical values of a supernodal L from its file into memory.
+ * Required before L->x is resized or handed over to another object.  Returns
+ * TRUE if successful, or FALSE if out of memory (L is then unchanged). */
+
+int CHOLMOD(ooc_load)
+(
+    /* ---- in/out --- */
+    cholmod_factor *L,
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double *Lx ;
+    size_t e ;
+
+    if (L->ooc == 0)
+    {
+	return (TRUE) ;	    /* nothing to do */
+    }
+    e = (L->xtype == CHOLMOD_COMPLEX ? 2 : 1) ;
+    Lx = CHOLMOD(malloc) (L->xsize, e * sizeof (double), Common) ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	return (FALSE) ;    /* out of memory */
+    }
+    memcpy (Lx, L->x, L->xsize * e * sizeof (double)) ;
+    CHOLMOD(ooc_free) (L->xsize, e * sizeof (double), L->x, L->ooc, Common) ;
+    L->x = Lx ;
+    L->ooc = 0 ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === cholmod_ooc_sweep ==================================================== */
+/* ========================================================================== */
+
+/* Called for each supernode s of a supernodal L held in a file, as s is
+ * reached in a sweep through L: forward (s = 0, 1, ...) for the numerical
+ * factorization and the forward solve, or backward for the backsolve.  The
+ * values of the next supernode are prefetched.  If Common->ooc_memory > 0,
+ * supernodes already passed beyond the last ooc_memory bytes are written
+ * back to the file and released from memory.  *mark is the boundary of the
+ * released part; it must be 0 before a forward sweep, and L->ooc before a
+ * backward sweep.  Nothing is done if L is in memory.
+ */
+
+void CHOLMOD(ooc_sweep)
+(
+    /* ---- input ---- */
+    cholmod_factor *L,
+    Int s,		/* supernode about to be used */
+    int forward,	/* TRUE if s is increasing, FALSE if decreasing */
+    /* ---- in/out --- */
+    size_t *mark,	/* boundary of the released part of L->x */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+#ifdef HAVE_MMAP
+    char *Lx ;
+    Int *Lpx ;
+    size_t e, page, keep, lo, hi ;
+    Int t ;
+
+    if (L->ooc == 0)
+    {
+	return ;
+    }
+    Lx = L->x ;
+    Lpx = L->px ;
+    e = (L->xtype == CHOLMOD_COMPLEX ? 2 : 1) * sizeof (double) ;
+    page = (size_t) sysconf (_SC_PAGESIZE) ;
+
+    /* prefetch the next supernode */
+    t = forward ? (s+1) : (s-1) ;
+    if (t >= 0 && t < (Int) (L->nsuper))
+    {
+	lo = (((size_t) Lpx [t]) * e / page) * page ;
+	hi = ((size_t) Lpx [t+1]) * e ;
+	if (hi > lo)
+	{
+	    madvise (Lx + lo, hi - lo, MADV_WILLNEED) ;
+	}
+    }
+
+    /* release the supernodes already passed, keeping the last ooc_memory
+     * bytes of them */
+    if (Common->ooc_memory <= 0)
+    {
+	return ;
+    }
+    keep = (size_t) Common->ooc_memory ;
+    if (forward)
+    {
+	hi = ((size_t) Lpx [s]) * e ;
+	if (hi <= keep)
+	{
+	    return ;
+	}
+	hi = ((hi - keep) / page) * page ;
+	lo = *mark ;
+	if (hi > lo)
+	{
+	    msync (Lx + lo, hi - lo, MS_SYNC) ;
+	    madvise (Lx + lo, hi - lo, MADV_DONTNEED) ;
+	    *mark = hi ;
+	}
+    }
+    else
+    {
+	lo = ((size_t) Lpx [s+1]) * e + keep ;
+	lo = ((lo + page - 1) / page) * page ;
+	hi = *mark ;
+	if (lo < hi)
+	{
+	    msync (Lx + lo, hi - lo, MS_SYNC) ;
+	    madvise (Lx + lo, hi - lo, MADV_DONTNEED) ;
+	    *mark = lo ;
+	}
+    }
+#endif
+}
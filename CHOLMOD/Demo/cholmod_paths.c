@@ -0,0 +1,554 @@
+/* ========================================================================== */
+/* === Demo/cholmod_paths =================================================== */
+/* ========================================================================== */
+
+/* -----------------------------------------------------------------------------
+ * CHOLMOD/Demo Module.  Copyright (C) 2005-2006, Timothy A. Davis
+ * -------------------------------------------------------------------------- */
+
+/* Checks the optional paths of CHOLMOD against the default ones, on the 2D
+ * Laplacians of 12-by-12 and 60-by-60 meshes.  Prints one line per check and
+ * returns 1 if any check fails.  Usage: cholmod_paths
+ */
+
+#include <math.h>
+#include "cholmod.h"
+
+#define NX 12
+#define NX2 60
+#define NTHREADS 4
+#define TOL 1e-10
+#define TMPFILE "cholmod_paths.tmp"
+#define TRUE 1
+#define FALSE 0
+
+static int nfail = 0 ;
+
+/* -------------------------------------------------------------------------- */
+/* report */
+/* -------------------------------------------------------------------------- */
+
+static void report (const char *what, double err)
+{
+    int ok = (err <= TOL) ;
+    printf ("%-48s err %8.1e %s\n", what, err, ok ? "ok" : "FAILED") ;
+    if (!ok) nfail++ ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* laplace */
+/* -------------------------------------------------------------------------- */
+
+/* Returns the 2D Laplacian of an nx-by-nx mesh.  If stype is nonzero, only the
+ * upper (stype > 0) or lower (stype < 0) part is stored, and the entries in
+ * row and column jchange are changed.  If stype is zero, the whole matrix is
+ * stored, and only the entries in row jchange are changed.  No entries are
+ * changed if jchange is negative. */
+
+static cholmod_sparse *laplace (int nx, int stype, int jchange,
+    cholmod_common *cm)
+{
+    cholmod_triplet *T ;
+    cholmod_sparse *A ;
+    int *Ti, *Tj, n = nx*nx, i, j, k, nz = 0, di [5] = {0,-1,1,0,0},
+	dj [5] = {0,0,0,-1,1} ;
+    double *Tx, x ;
+    T = cholmod_allocate_triplet (n, n, 5*n, stype, CHOLMOD_REAL, cm) ;
+    if (T == NULL) return (NULL) ;
+    Ti = T->i ;
+    Tj = T->j ;
+    Tx = T->x ;
+    for (j = 0 ; j < n ; j++)
+    {
+	for (k = 0 ; k < 5 ; k++)
+	{
+	    int r = (j / nx) + di [k], c = (j % nx) + dj [k] ;
+	    if (r < 0 || r >= nx || c < 0 || c >= nx) continue ;
+	    i = r * nx + c ;
+	    if ((stype > 0 && i > j) || (stype < 0 && i < j)) continue ;
+	    x = (i == j) ? 4 : -1 ;
+	    if (i == jchange || (stype != 0 && j == jchange))
+	    {
+		x = (i == j) ? 5 : -0.5 ;
+	    }
+	    Ti [nz] = i ;
+	    Tj [nz] = j ;
+	    Tx [nz] = x ;
+	    nz++ ;
+	}
+    }
+    T->nnz = nz ;
+    A = cholmod_triplet_to_sparse (T, nz, cm) ;
+    cholmod_free_triplet (&T, cm) ;
+    return (A) ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* dense_diff, sparse_diff */
+/* -------------------------------------------------------------------------- */
+
+/* Returns norm (X1-X2,inf) / norm (X2,inf) for real X1 and X2 of the same
+ * size, or HUGE_VAL if either is missing. */
+
+static double dense_diff (cholmod_dense *X1, cholmod_dense *X2)
+{
+    double *x1, *x2, err = 0, xmax = 0 ;
+    size_t i, k ;
+    if (X1 == NULL || X2 == NULL) return (HUGE_VAL) ;
+    x1 = X1->x ;
+    x2 = X2->x ;
+    for (k = 0 ; k < X2->ncol ; k++)
+    {
+	for (i = 0 ; i < X2->nrow ; i++)
+	{
+	    err = fmax (err, fabs (x1 [i+k*X1->d] - x2 [i+k*X2->d])) ;
+	    xmax = fmax (xmax, fabs (x2 [i+k*X2->d])) ;
+	}
+    }
+    return ((xmax > 0) ? (err / xmax) : err) ;
+}
+
+/* Returns norm (A1-A2,1) / norm (A2,1), or HUGE_VAL if either is missing. */
+
+static double sparse_diff (cholmod_sparse *A1, cholmod_sparse *A2,
+    cholmod_common *cm)
+{
+    cholmod_sparse *D ;
+    double one [2] = {1,0}, m1 [2] = {-1,0}, err, anorm ;
+    if (A1 == NULL || A2 == NULL) return (HUGE_VAL) ;
+    if (A1->nrow != A2->nrow || A1->ncol != A2->ncol
+	|| A1->stype != A2->stype) return (HUGE_VAL) ;
+    D = cholmod_add (A1, A2, one, m1, TRUE, TRUE, cm) ;
+    if (D == NULL) return (HUGE_VAL) ;
+    err = cholmod_norm_sparse (D, 1, cm) ;
+    anorm = cholmod_norm_sparse (A2, 1, cm) ;
+    cholmod_free_sparse (&D, cm) ;
+    return ((anorm > 0) ? (err / anorm) : err) ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* factor, solve */
+/* -------------------------------------------------------------------------- */
+
+static cholmod_factor *factor (cholmod_sparse *A, cholmod_common *cm)
+{
+    cholmod_factor *L = cholmod_analyze (A, cm) ;
+    if (L != NULL && !cholmod_factorize (A, L, cm))
+    {
+	cholmod_free_factor (&L, cm) ;
+    }
+    return (L) ;
+}
+
+/* returns the solution of sys with b = ones (n,1) */
+
+static cholmod_dense *solve (int sys, cholmod_factor *L, cholmod_common *cm)
+{
+    cholmod_dense *b, *x ;
+    if (L == NULL) return (NULL) ;
+    b = cholmod_ones (L->n, 1, CHOLMOD_REAL, cm) ;
+    x = cholmod_solve (sys, L, b, cm) ;
+    cholmod_free_dense (&b, cm) ;
+    return (x) ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* check_partial */
+/* -------------------------------------------------------------------------- */
+
+/* For each column j, changes row and column j of A, refactorizes on the path
+ * from cholmod_compute_path, and compares with a full factorization. */
+
+static void check_partial (int supernodal, int stype, cholmod_common *cm)
+{
+    cholmod_sparse *A0, *A1 ;
+    cholmod_factor *L, *L1 ;
+    cholmod_dense *x, *x1 ;
+    int Path [NX*NX], n = NX*NX, j, ok ;
+    long pathlen ;
+    double errmax = 0 ;
+    char what [80] ;
+    cm->supernodal = supernodal ;
+    A0 = laplace (NX, stype, -1, cm) ;
+    for (j = 0 ; j < n ; j++)
+    {
+	A1 = laplace (NX, stype, j, cm) ;
+	L = factor (A0, cm) ;
+	L1 = factor (A1, cm) ;
+	pathlen = (L == NULL) ? -1 :
+	    cholmod_compute_path (A1, &j, 1, L, Path, cm) ;
+	ok = (pathlen > 0) &&
+	    cholmod_factorize_partial (A1, Path, pathlen, L, cm) ;
+	x = ok ? solve (CHOLMOD_A, L, cm) : NULL ;
+	x1 = solve (CHOLMOD_A, L1, cm) ;
+	errmax = fmax (errmax, dense_diff (x, x1)) ;
+	cholmod_free_dense (&x, cm) ;
+	cholmod_free_dense (&x1, cm) ;
+	cholmod_free_factor (&L, cm) ;
+	cholmod_free_factor (&L1, cm) ;
+	cholmod_free_sparse (&A1, cm) ;
+    }
+    cholmod_free_sparse (&A0, cm) ;
+    snprintf (what, sizeof (what), "factorize_partial, %s, stype %d",
+	supernodal == CHOLMOD_SUPERNODAL ? "supernodal" : "simplicial", stype) ;
+    report (what, errmax) ;
+    cm->supernodal = CHOLMOD_AUTO ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* check_factor */
+/* -------------------------------------------------------------------------- */
+
+/* Compares the optional paths of the supernodal factorization (in parallel,
+ * out-of-core, with the small supernode kernels, and in single precision with
+ * iterative refinement), and the parallel solves, with the default ones. */
+
+static void check_factor (cholmod_common *cm)
+{
+    cholmod_sparse *A ;
+    cholmod_factor *L0, *L ;
+    cholmod_dense *x0, *x, *b ;
+    double berr ;
+
+    A = laplace (NX2, 1, -1, cm) ;
+    cm->supernodal = CHOLMOD_SUPERNODAL ;
+    L0 = factor (A, cm) ;
+    x0 = solve (CHOLMOD_A, L0, cm) ;
+
+    /* parallel subtrees of the supernodal factorization */
+    cm->nthreads_max = NTHREADS ;
+    L = factor (A, cm) ;
+    cm->nthreads_max = 1 ;
+    x = solve (CHOLMOD_A, L, cm) ;
+    report ("supernodal factorize, nthreads_max 4", dense_diff (x, x0)) ;
+    cholmod_free_dense (&x, cm) ;
+    cholmod_free_factor (&L, cm) ;
+
+    /* parallel supernodal solve */
+    cm->nthreads_max = NTHREADS ;
+    x = solve (CHOLMOD_A, L0, cm) ;
+    cm->nthreads_max = 1 ;
+    report ("supernodal solve, nthreads_max 4", dense_diff (x, x0)) ;
+    cholmod_free_dense (&x, cm) ;
+
+    /* factor held in a memory-mapped file */
+    cm->ooc_size = 1 ;
+    cm->ooc_memory = 1 ;
+    L = factor (A, cm) ;
+    x = solve (CHOLMOD_A, L, cm) ;
+    cm->ooc_size = 0 ;
+    cm->ooc_memory = 0 ;
+    report ("supernodal factorize and solve, ooc_size 1", dense_diff (x, x0)) ;
+    cholmod_free_dense (&x, cm) ;
+    cholmod_free_factor (&L, cm) ;
+
+    /* small supernode kernels */
+    cm->small_super = 16 ;
+    L = factor (A, cm) ;
+    cm->small_super = 0 ;
+    x = solve (CHOLMOD_A, L, cm) ;
+    report ("supernodal factorize, small_super 16", dense_diff (x, x0)) ;
+    cholmod_free_dense (&x, cm) ;
+    cholmod_free_factor (&L, cm) ;
+
+    /* single precision factor, refined in double precision */
+    cm->single_factor = TRUE ;
+    L = factor (A, cm) ;
+    cm->single_factor = FALSE ;
+    b = cholmod_ones (A->nrow, 1, CHOLMOD_REAL, cm) ;
+    x = (L == NULL) ? NULL : cholmod_solve_refine (A, L, b, 10, &berr, cm) ;
+    report ("single_factor, solve_refine", dense_diff (x, x0)) ;
+    cholmod_free_dense (&b, cm) ;
+    cholmod_free_dense (&x, cm) ;
+    cholmod_free_factor (&L, cm) ;
+
+    cholmod_free_dense (&x0, cm) ;
+    cholmod_free_factor (&L0, cm) ;
+
+    /* parallel simplicial solve */
+    cm->supernodal = CHOLMOD_SIMPLICIAL ;
+    L0 = factor (A, cm) ;
+    x0 = solve (CHOLMOD_A, L0, cm) ;
+    cm->nthreads_max = NTHREADS ;
+    x = solve (CHOLMOD_A, L0, cm) ;
+    cm->nthreads_max = 1 ;
+    report ("simplicial solve, nthreads_max 4", dense_diff (x, x0)) ;
+    cholmod_free_dense (&x, cm) ;
+    cholmod_free_dense (&x0, cm) ;
+    cholmod_free_factor (&L0, cm) ;
+    cm->supernodal = CHOLMOD_AUTO ;
+
+    cholmod_free_sparse (&A, cm) ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* check_updown */
+/* -------------------------------------------------------------------------- */
+
+/* Compares the parallel cholmod_updown, and cholmod_updown_batch, with
+ * cholmod_updown in a single thread, one column at a time. */
+
+static void check_updown (cholmod_common *cm)
+{
+    cholmod_sparse *A, *C, *Ck ;
+    cholmod_factor *L0, *L ;
+    cholmod_dense *x0, *x, *B, *X, *X0 ;
+    double *Cx ;
+    int *Cp, *Ci, n = NX2*NX2, m = 4, j, k ;
+
+    A = laplace (NX2, 1, -1, cm) ;
+    cm->supernodal = CHOLMOD_SIMPLICIAL ;
+    L0 = factor (A, cm) ;
+    cm->supernodal = CHOLMOD_AUTO ;
+
+    /* C = n-by-m, with 3 entries in each column, in the order of L */
+    C = cholmod_allocate_sparse (n, m, 3*m, TRUE, TRUE, 0, CHOLMOD_REAL, cm) ;
+    if (L0 == NULL || C == NULL)
+    {
+	report ("updown", HUGE_VAL) ;
+	cholmod_free_factor (&L0, cm) ;
+	cholmod_free_sparse (&C, cm) ;
+	cholmod_free_sparse (&A, cm) ;
+	return ;
+    }
+    Cp = C->p ;
+    Ci = C->i ;
+    Cx = C->x ;
+    for (k = 0 ; k < m ; k++)
+    {
+	Cp [k] = 3*k ;
+	for (j = 0 ; j < 3 ; j++)
+	{
+	    Ci [3*k+j] = k*(n/m) + j*(n/(4*m)) ;
+	    Cx [3*k+j] = 0.5 + j ;
+	}
+    }
+    Cp [m] = 3*m ;
+
+    /* all columns of C at once */
+    L = cholmod_copy_factor (L0, cm) ;
+    cholmod_updown (TRUE, C, L, cm) ;
+    x0 = solve (CHOLMOD_A, L, cm) ;
+    cholmod_free_factor (&L, cm) ;
+    L = cholmod_copy_factor (L0, cm) ;
+    cm->nthreads_max = NTHREADS ;
+    cholmod_updown (TRUE, C, L, cm) ;
+    cm->nthreads_max = 1 ;
+    x = solve (CHOLMOD_A, L, cm) ;
+    report ("updown, nthreads_max 4", dense_diff (x, x0)) ;
+    cholmod_free_dense (&x, cm) ;
+    cholmod_free_dense (&x0, cm) ;
+    cholmod_free_factor (&L, cm) ;
+
+    /* each column of C on its own */
+    X0 = cholmod_zeros (n, m, CHOLMOD_REAL, cm) ;
+    X = cholmod_zeros (n, m, CHOLMOD_REAL, cm) ;
+    B = cholmod_ones (n, 1, CHOLMOD_REAL, cm) ;
+    for (k = 0 ; X0 != NULL && k < m ; k++)
+    {
+	int cset = k ;
+	Ck = cholmod_submatrix (C, NULL, -1, &cset, 1, TRUE, TRUE, cm) ;
+	L = cholmod_copy_factor (L0, cm) ;
+	cholmod_updown (TRUE, Ck, L, cm) ;
+	x0 = solve (CHOLMOD_LDLt, L, cm) ;
+	if (x0 != NULL)
+	{
+	    for (j = 0 ; j < n ; j++)
+	    {
+		((double *) X0->x) [j + k*n] = ((double *) x0->x) [j] ;
+	    }
+	}
+	cholmod_free_dense (&x0, cm) ;
+	cholmod_free_factor (&L, cm) ;
+	cholmod_free_sparse (&Ck, cm) ;
+    }
+    cm->nthreads_max = NTHREADS ;
+    if (!cholmod_updown_batch (TRUE, C, L0, B, X, cm))
+    {
+	cholmod_free_dense (&X, cm) ;
+    }
+    cm->nthreads_max = 1 ;
+    report ("updown_batch, nthreads_max 4", dense_diff (X, X0)) ;
+    cholmod_free_dense (&B, cm) ;
+    cholmod_free_dense (&X, cm) ;
+    cholmod_free_dense (&X0, cm) ;
+
+    cholmod_free_sparse (&C, cm) ;
+    cholmod_free_factor (&L0, cm) ;
+    cholmod_free_sparse (&A, cm) ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* check_read */
+/* -------------------------------------------------------------------------- */
+
+/* Compares cholmod_read_sparse_file, in parallel, and the roundtrip through
+ * cholmod_write_sparse_binary and cholmod_read_sparse_binary, with
+ * cholmod_read_sparse. */
+
+static void check_read (cholmod_common *cm)
+{
+    cholmod_sparse *A, *A0, *A1 ;
+    FILE *f ;
+
+    A = laplace (NX2, 0, 0, cm) ;
+    f = fopen (TMPFILE, "w") ;
+    if (A == NULL || f == NULL || cholmod_write_sparse (f, A, NULL, NULL, cm)
+	< 0)
+    {
+	report ("read_sparse_file", HUGE_VAL) ;
+	if (f != NULL) fclose (f) ;
+	remove (TMPFILE) ;
+	cholmod_free_sparse (&A, cm) ;
+	return ;
+    }
+    fclose (f) ;
+
+    f = fopen (TMPFILE, "r") ;
+    A0 = (f == NULL) ? NULL : cholmod_read_sparse (f, cm) ;
+    if (f != NULL) fclose (f) ;
+    cm->nthreads_max = NTHREADS ;
+    A1 = cholmod_read_sparse_file (TMPFILE, cm) ;
+    cm->nthreads_max = 1 ;
+    report ("read_sparse_file, nthreads_max 4", sparse_diff (A1, A0, cm)) ;
+    cholmod_free_sparse (&A1, cm) ;
+
+    f = fopen (TMPFILE, "wb") ;
+    if (f != NULL && !cholmod_write_sparse_binary (f, A0, cm))
+    {
+	fclose (f) ;
+	f = NULL ;
+    }
+    if (f != NULL)
+    {
+	fclose (f) ;
+	f = fopen (TMPFILE, "rb") ;
+    }
+    A1 = (f == NULL) ? NULL : cholmod_read_sparse_binary (f, cm) ;
+    if (f != NULL) fclose (f) ;
+    report ("write_sparse_binary, read_sparse_binary",
+	sparse_diff (A1, A0, cm)) ;
+    cholmod_free_sparse (&A1, cm) ;
+
+    remove (TMPFILE) ;
+    cholmod_free_sparse (&A0, cm) ;
+    cholmod_free_sparse (&A, cm) ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* check_analyze */
+/* -------------------------------------------------------------------------- */
+
+/* Compares the ordering chosen by cholmod_analyze when it tries its methods
+ * concurrently with the one chosen when it tries them in turn. */
+
+static void check_analyze (cholmod_common *cm)
+{
+    cholmod_sparse *A ;
+    cholmod_factor *L0, *L ;
+    int *P0, *P, n = NX2*NX2, k, ndiff = 0 ;
+
+    A = laplace (NX2, 1, -1, cm) ;
+    cm->nmethods = 3 ;
+    cm->method [0].ordering = CHOLMOD_NATURAL ;
+    cm->method [1].ordering = CHOLMOD_AMD ;
+    cm->method [2].ordering = CHOLMOD_COLAMD ;
+    L0 = cholmod_analyze (A, cm) ;
+    cm->nthreads_max = NTHREADS ;
+    L = cholmod_analyze (A, cm) ;
+    if (L0 == NULL || L == NULL || L0->ordering != L->ordering)
+    {
+	ndiff = 1 ;
+    }
+    else
+    {
+	P0 = L0->Perm ;
+	P = L->Perm ;
+	for (k = 0 ; k < n ; k++)
+	{
+	    ndiff += (P0 [k] != P [k]) ;
+	}
+    }
+    report ("analyze, nmethods 3, nthreads_max 4", ndiff) ;
+    cholmod_free_factor (&L0, cm) ;
+    cholmod_free_factor (&L, cm) ;
+    cholmod_free_sparse (&A, cm) ;
+    cholmod_defaults (cm) ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* check_matrixops */
+/* -------------------------------------------------------------------------- */
+
+/* Compares the parallel cholmod_sdmult and cholmod_ssmult with the same
+ * functions in a single thread. */
+
+static void check_matrixops (cholmod_common *cm)
+{
+    cholmod_sparse *A, *C0, *C ;
+    cholmod_dense *X, *Y0, *Y ;
+    double one [2] = {1,0}, zero [2] = {0,0}, *Xx ;
+    int n = NX2*NX2, m = 4, i, transpose ;
+
+    A = laplace (NX2, 0, 0, cm) ;
+    X = cholmod_allocate_dense (n, m, n, CHOLMOD_REAL, cm) ;
+    Y0 = cholmod_zeros (n, m, CHOLMOD_REAL, cm) ;
+    Y = cholmod_zeros (n, m, CHOLMOD_REAL, cm) ;
+    if (A == NULL || X == NULL || Y0 == NULL || Y == NULL)
+    {
+	report ("sdmult", HUGE_VAL) ;
+    }
+    else
+    {
+	Xx = X->x ;
+	for (i = 0 ; i < n*m ; i++)
+	{
+	    Xx [i] = (double) (i % 7) - 3 ;
+	}
+	for (transpose = 0 ; transpose <= 1 ; transpose++)
+	{
+	    cholmod_sdmult (A, transpose, one, zero, X, Y0, cm) ;
+	    cm->nthreads_max = NTHREADS ;
+	    cholmod_sdmult (A, transpose, one, zero, X, Y, cm) ;
+	    cm->nthreads_max = 1 ;
+	    report (transpose ? "sdmult, transpose, nthreads_max 4" :
+		"sdmult, nthreads_max 4", dense_diff (Y, Y0)) ;
+	}
+    }
+    cholmod_free_dense (&X, cm) ;
+    cholmod_free_dense (&Y0, cm) ;
+    cholmod_free_dense (&Y, cm) ;
+
+    C0 = cholmod_ssmult (A, A, 0, TRUE, TRUE, cm) ;
+    cm->nthreads_max = NTHREADS ;
+    C = cholmod_ssmult (A, A, 0, TRUE, TRUE, cm) ;
+    cm->nthreads_max = 1 ;
+    report ("ssmult, nthreads_max 4", sparse_diff (C, C0, cm)) ;
+    cholmod_free_sparse (&C0, cm) ;
+    cholmod_free_sparse (&C, cm) ;
+    cholmod_free_sparse (&A, cm) ;
+}
+
+/* -------------------------------------------------------------------------- */
+/* main */
+/* -------------------------------------------------------------------------- */
+
+int main (void)
+{
+    cholmod_common c ;
+    int stype ;
+    cholmod_start (&c) ;
+    check_factor (&c) ;
+    for (stype = -1 ; stype <= 1 ; stype++)
+    {
+	check_partial (CHOLMOD_SUPERNODAL, stype, &c) ;
+	check_partial (CHOLMOD_SIMPLICIAL, stype, &c) ;
+    }
+    check_updown (&c) ;
+    check_read (&c) ;
+    check_analyze (&c) ;
+    check_matrixops (&c) ;
+    cholmod_finish (&c) ;
+    printf ("cholmod_paths: %s\n", nfail ? "FAILED" : "all tests passed") ;
+    return (nfail ? 1 : 0) ;
+}
@@ -43,13 +43,25 @@
  * cholmod_read_sparse	    read a matrix in sparse form (same file format as
  *			    cholmod_read_triplet).
  *
+ * cholmod_read_triplet_file   same as cholmod_read_triplet, for a named file
+ *			    that is mapped into memory and parsed in parallel.
+ *
+ * cholmod_read_sparse_file    same as cholmod_read_sparse, for a named file
+ *			    (uses cholmod_read_triplet_file).
+ *
  * cholmod_read_dense	    read a dense matrix (any Matrix Market "array"
  *			    format, or a generic dense format).
  *
+ * cholmod_read_sparse_binary  read a sparse matrix written by
+ *			    cholmod_write_sparse_binary.
+ *
  * cholmod_write_sparse	    write a sparse matrix to a Matrix Market file.
  *
  * cholmod_write_dense	    write a dense matrix to a Matrix Market file.
  *
+ * cholmod_write_sparse_binary	write a sparse matrix to a file in a binary
+ *			    compressed-column form.
+ *
  * cholmod_print_common and cholmod_check_common are the only two routines that
  * you may call after calling cholmod_finish.
  *
@@ -343,6 +355,48 @@ cholmod_triplet *cholmod_read_triplet
 
 cholmod_triplet *cholmod_l_read_triplet (FILE *, cholmod_common *) ;
 
+/* -------------------------------------------------------------------------- */
+/* cholmod_read_sparse_file: read a sparse matrix from a named file */
+/* -------------------------------------------------------------------------- */
+
+cholmod_sparse *cholmod_read_sparse_file
+(
+    /* ---- input ---- */
+    const char *filename,   /* name of the file to read */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+cholmod_sparse *cholmod_l_read_sparse_file (const char *, cholmod_common *) ;
+
+/* -------------------------------------------------------------------------- */
+/* cholmod_read_triplet_file: read a triplet matrix from a named file */
+/* -------------------------------------------------------------------------- */
+
+cholmod_triplet *cholmod_read_triplet_file
+(
+    /* ---- input ---- */
+    const char *filename,   /* name of the file to read */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+cholmod_triplet *cholmod_l_read_triplet_file (const char *, cholmod_common *) ;
+
+/* -------------------------------------------------------------------------- */
+/* cholmod_read_sparse_binary: read a binary sparse matrix from a file */
+/* -------------------------------------------------------------------------- */
+
+cholmod_sparse *cholmod_read_sparse_binary
+(
+    /* ---- input ---- */
+    FILE *f,		/* file to read from, must already be open */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+cholmod_sparse *cholmod_l_read_sparse_binary (FILE *, cholmod_common *) ;
+
 /* -------------------------------------------------------------------------- */
 /* cholmod_read_dense: read a dense matrix from a file */
 /* -------------------------------------------------------------------------- */
@@ -421,4 +475,20 @@ int cholmod_write_dense
 
 int cholmod_l_write_dense (FILE *, cholmod_dense *, const char *,
     cholmod_common *) ;
+
+/* -------------------------------------------------------------------------- */
+/* cholmod_write_sparse_binary: write a sparse matrix to a binary file */
+/* -------------------------------------------------------------------------- */
+
+int cholmod_write_sparse_binary
+(
+    /* ---- input ---- */
+    FILE *f,		    /* file to write to, must already be open */
+    cholmod_sparse *A,	    /* matrix to write */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+int cholmod_l_write_sparse_binary (FILE *, cholmod_sparse *,
+    cholmod_common *) ;
 #endif
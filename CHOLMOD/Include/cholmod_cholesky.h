@@ -25,6 +25,7 @@
  * cholmod_factorize		simplicial or supernodal Cholesky factorization
  * cholmod_solve		solve a linear system (simplicial or supernodal)
  * cholmod_solve2		like cholmod_solve, but reuse workspace
+ * cholmod_solve_refine	solve Ax=b with iterative refinement
  * cholmod_spsolve		solve a linear system (sparse x and b)
  *
  * Secondary routines:
@@ -32,6 +33,9 @@
  *
  * cholmod_analyze_p		analyze, with user-provided permutation or f set
  * cholmod_factorize_p		factorize, with user-provided permutation or f
+ * cholmod_compute_path		find the path for a partial refactorization
+ * cholmod_factorize_partial	refactorize only the columns of L on a path
+ * cholmod_factorize_partial_p	factorize_partial, with beta or fset
  * cholmod_analyze_ordering	analyze a fill-reducing ordering
  * cholmod_etree		find the elimination tree
  * cholmod_rowcolcounts		compute the row/column counts of L
@@ -168,6 +172,82 @@ int cholmod_factorize_p
 int cholmod_l_factorize_p (cholmod_sparse *, double *, SuiteSparse_long *,
     size_t, cholmod_factor *, cholmod_common *) ;
 
+/* -------------------------------------------------------------------------- */
+/* cholmod_compute_path:  find the columns of L that depend on given columns */
+/* -------------------------------------------------------------------------- */
+
+/* Returns the union of the etree paths to the roots from the columns of L
+ * that change when the columns Changed of A change (rows of A if A is
+ * unsymmetric).  This includes the paths from the other row and column indices
+ * of each changed entry, so the pattern of A is needed.  The path is in
+ * increasing order, for cholmod_factorize_partial.  Returns the path length,
+ * or EMPTY on error. */
+
+SuiteSparse_long cholmod_compute_path
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize, only its pattern is used */
+    int *Changed,	/* columns of A with changed values */
+    size_t nchanged,	/* size of Changed */
+    cholmod_factor *L,	/* factor from cholmod_analyze or cholmod_factorize */
+    /* ---- output --- */
+    int *Path,		/* size n, the factorization path */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+SuiteSparse_long cholmod_l_compute_path (cholmod_sparse *, SuiteSparse_long *,
+    size_t, cholmod_factor *, SuiteSparse_long *, cholmod_common *) ;
+
+/* -------------------------------------------------------------------------- */
+/* cholmod_factorize_partial:  refactorize the columns of L on a path */
+/* -------------------------------------------------------------------------- */
+
+/* Refactorizes only the columns of L on the path from cholmod_compute_path.
+ * L must be a numeric factor of a matrix with the same pattern as A, whose
+ * values differ only in the columns used to compute the path. */
+
+int cholmod_factorize_partial
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize */
+    int *Path,		/* from cholmod_compute_path */
+    size_t pathlen,	/* size of Path */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* resulting factorization */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+int cholmod_l_factorize_partial (cholmod_sparse *, SuiteSparse_long *, size_t,
+    cholmod_factor *, cholmod_common *) ;
+
+/* -------------------------------------------------------------------------- */
+/* cholmod_factorize_partial_p:  partial refactorization, with beta and fset */
+/* -------------------------------------------------------------------------- */
+
+/* Same as cholmod_factorize_partial, but with more options.  If Path is NULL,
+ * this is the same as cholmod_factorize_p. */
+
+int cholmod_factorize_partial_p
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize */
+    double beta [2],	/* factorize beta*I+A or beta*I+A'*A */
+    int *fset,		/* subset of 0:(A->ncol)-1 */
+    size_t fsize,	/* size of fset */
+    int *Path,		/* from cholmod_compute_path, or NULL */
+    size_t pathlen,	/* size of Path */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* resulting factorization */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+int cholmod_l_factorize_partial_p (cholmod_sparse *, double *,
+    SuiteSparse_long *, size_t, SuiteSparse_long *, size_t, cholmod_factor *,
+    cholmod_common *) ;
+
 /* -------------------------------------------------------------------------- */
 /* cholmod_solve:  solve a linear system (simplicial or supernodal) */
 /* -------------------------------------------------------------------------- */
@@ -224,6 +304,26 @@ int cholmod_l_solve2 (int, cholmod_factor *, cholmod_dense *, cholmod_sparse *,
     cholmod_dense **, cholmod_sparse **, cholmod_dense **, cholmod_dense **,
     cholmod_common *) ;
 
+/* -------------------------------------------------------------------------- */
+/* cholmod_solve_refine:  solve Ax=b with iterative refinement */
+/* -------------------------------------------------------------------------- */
+
+cholmod_dense *cholmod_solve_refine
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix that L is the factorization of */
+    cholmod_factor *L,	/* factorization to use, single or double */
+    cholmod_dense *B,	/* right-hand-side */
+    int maxiter,	/* maximum number of refinement steps per column */
+    /* ---- output --- */
+    double *berr,	/* largest backward error of the columns of X */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+cholmod_dense *cholmod_l_solve_refine (cholmod_sparse *, cholmod_factor *,
+    cholmod_dense *, int, double *, cholmod_common *) ;
+
 /* -------------------------------------------------------------------------- */
 /* cholmod_spsolve:  solve a linear system with a sparse right-hand-side */
 /* -------------------------------------------------------------------------- */
@@ -131,6 +131,7 @@
  * cholmod_factor_to_sparse	create a sparse matrix copy of a factor
  * cholmod_copy_factor		create a copy of a factor
  * cholmod_factor_xtype		change the xtype of a factor
+ * cholmod_factor_dtype		change a factor to single or double precision
  *
  * Note that there is no cholmod_sparse_to_factor routine to create a factor
  * as a copy of a sparse matrix.  It could be done, after a fashion, but a
@@ -243,11 +244,11 @@
 
 #define CHOLMOD_HAS_VERSION_FUNCTION
 
-#define CHOLMOD_DATE "Oct 22, 2019"
+#define CHOLMOD_DATE "Oct 19, 2026"
 #define CHOLMOD_VER_CODE(main,sub) ((main) * 1000 + (sub))
-#define CHOLMOD_MAIN_VERSION 3
+#define CHOLMOD_MAIN_VERSION 4
 #define CHOLMOD_SUB_VERSION 0
-#define CHOLMOD_SUBSUB_VERSION 14
+#define CHOLMOD_SUBSUB_VERSION 0
 #define CHOLMOD_VERSION \
     CHOLMOD_VER_CODE(CHOLMOD_MAIN_VERSION,CHOLMOD_SUB_VERSION)
 
@@ -321,7 +322,8 @@
  *
  * Scalar floating-point values are always passed as double arrays of size 2
  * (for the real and imaginary parts).  They are typecast to float as needed.
- * FUTURE WORK: the float case is not supported yet.
+ * FUTURE WORK: the float case is not supported yet, except that the values of
+ * a real factor can be held in single precision (see cholmod_factor_dtype).
  */
 
 /* xtype defines the kind of numerical values used: */
@@ -1021,6 +1023,73 @@ typedef struct cholmod_common_struct
     size_t cholmod_gpu_trsm_calls ;
     size_t cholmod_gpu_potrf_calls ;
 
+    /* ---------------------------------------------------------------------- */
+    /* added in version 4.0, kept last so that the offsets of the fields above
+     * are the same as in version 3 */
+    /* ---------------------------------------------------------------------- */
+
+    /* calls to, and time spent in, the small supernode kernels (see
+     * Common->small_super) */
+    size_t cholmod_cpu_small_calls ;
+    double cholmod_cpu_small_time ;
+
+    int nthreads_max ;	/* maximum number of OpenMP threads for the task-
+			 * parallel methods.  If greater than one, the
+	* supernodal numeric factorization splits the supernodal elimination
+	* tree into independent subtrees, and factorizes them concurrently,
+	* one thread per subtree, each with its own workspace.  The supernodes
+	* above the subtrees are then factorized one at a time, as usual, with
+	* the BLAS (which may be multithreaded itself).  The subtrees call the
+	* BLAS from inside an OpenMP parallel region, where a multithreaded
+	* BLAS should run in a single thread.  cholmod_updown modifies the
+	* independent parts of the paths of each column of C concurrently,
+	* and cholmod_updown_batch solves its problems concurrently.
+	* cholmod_solve splits the etree into independent subtrees for a real
+	* L and a single right-hand-side, and solves them concurrently.
+	* cholmod_read_triplet_file parses chunks of the file concurrently.
+	* cholmod_analyze tries its ordering methods concurrently when
+	* nmethods > 1 (METIS and NESDIS still run one at a time).
+	* cholmod_sdmult computes ranges of rows of Y concurrently, and
+	* cholmod_ssmult computes the columns of C concurrently.
+	* Ignored if CHOLMOD is compiled without OpenMP, or (for the
+	* factorization) if the GPU is used.  Default: 1. */
+
+    double ooc_size ;	/* if > 0, the numerical values of a supernodal
+			 * factor (L->x) larger than ooc_size bytes are kept in
+	* a memory-mapped temporary file instead of allocated memory, so that
+	* factors larger than main memory can be computed and used.  The file
+	* is created in $TMPDIR (or /tmp) and removed as soon as it is created.
+	* The supernodal factorization and cholmod_solve then sweep through L
+	* in supernode order, prefetching the next supernode and dropping the
+	* ones already done (see ooc_memory).  The mapping is not included in
+	* Common->memory_inuse.  Falls back to malloc if the file cannot be
+	* created, and if mmap is not available.  Not used with the GPU.
+	* Default: 0 (always use malloc). */
+
+    double ooc_memory ;	/* for a factor kept in a file: the number of bytes
+			 * of supernodes already processed in a sweep through
+	* L that may stay in memory.  Beyond that, they are written back to
+	* the file and released.  If zero, the operating system decides when
+	* to release them.  Default: 0. */
+
+    int small_super ;	/* the real supernodal numeric factorization uses
+			 * built-in kernels instead of dsyrk, dgemm, dpotrf and
+	* dtrsm for supernodes with at most small_super columns, where the
+	* overhead of calling the BLAS outweighs the work done.  The number of
+	* calls and the time spent in these kernels are reported in
+	* Common->cholmod_cpu_small_calls and cholmod_cpu_small_time (see
+	* cholmod_gpu_stats).  The complex cases always use the BLAS.  A value
+	* of about 16 suits the many tiny supernodes of 2D meshes and network
+	* matrices.  Default: 0 (always use the BLAS). */
+
+    int single_factor ;	/* if TRUE, cholmod_factorize converts a real
+			 * numerical factor (simplicial or supernodal) to
+	* single precision when it is done, which halves the memory it takes
+	* (see cholmod_factor_dtype).  A single precision factor can only be
+	* used to solve a system with cholmod_solve_refine, which refines the
+	* solution in double precision against the original matrix.
+	* Default: FALSE. */
+
 } cholmod_common ;
 
 /* size_t BLAS statistcs in Common: */
@@ -1032,6 +1101,7 @@ typedef struct cholmod_common_struct
 #define CHOLMOD_GPU_SYRK_CALLS      cholmod_gpu_syrk_calls
 #define CHOLMOD_GPU_TRSM_CALLS      cholmod_gpu_trsm_calls
 #define CHOLMOD_GPU_POTRF_CALLS     cholmod_gpu_potrf_calls
+#define CHOLMOD_CPU_SMALL_CALLS     cholmod_cpu_small_calls
 
 /* double BLAS statistics in Common: */
 #define CHOLMOD_CPU_GEMM_TIME       cholmod_cpu_gemm_time
@@ -1042,6 +1112,7 @@ typedef struct cholmod_common_struct
 #define CHOLMOD_GPU_SYRK_TIME       cholmod_gpu_syrk_time
 #define CHOLMOD_GPU_TRSM_TIME       cholmod_gpu_trsm_time
 #define CHOLMOD_GPU_POTRF_TIME      cholmod_gpu_potrf_time
+#define CHOLMOD_CPU_SMALL_TIME      cholmod_cpu_small_time
 #define CHOLMOD_ASSEMBLE_TIME       cholmod_assemble_time
 #define CHOLMOD_ASSEMBLE_TIME2      cholmod_assemble_time2
 
@@ -1731,6 +1802,19 @@ typedef struct cholmod_factor_struct
     int useGPU; /* Indicates the symbolic factorization supports
 		 * GPU acceleration */
 
+    /* ---------------------------------------------------------------------- */
+    /* added in version 4.0, kept last (see cholmod_common) */
+    /* ---------------------------------------------------------------------- */
+
+    void *tasks ;	/* size 2*nsuper+3, subtree schedule of the supernodes
+			 * for the parallel forward/backsolves.  Only created by
+			 * cholmod_super_lsolve and cholmod_super_ltsolve when
+			 * Common->nthreads_max > 1. */
+
+    size_t ooc ;	/* size in bytes of the memory-mapped file holding
+			 * L->x (see Common->ooc_size), or 0 if L->x is held in
+			 * memory from cholmod_malloc. */
+
 } cholmod_factor ;
 
 
@@ -1882,6 +1966,22 @@ int cholmod_factor_xtype
 
 int cholmod_l_factor_xtype (int, cholmod_factor *, cholmod_common *) ;
 
+/* -------------------------------------------------------------------------- */
+/* cholmod_factor_dtype: change a real factor to single or double precision */
+/* -------------------------------------------------------------------------- */
+
+int cholmod_factor_dtype
+(
+    /* ---- input ---- */
+    int to_dtype,	/* CHOLMOD_SINGLE or CHOLMOD_DOUBLE */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* factor to change */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+int cholmod_l_factor_dtype (int, cholmod_factor *, cholmod_common *) ;
+
 
 /* ========================================================================== */
 /* === Core/cholmod_dense =================================================== */
@@ -122,6 +122,17 @@
     } \
 }
 
+/* Return if L holds single precision values (see cholmod_factor_dtype), which
+ * only cholmod_solve_refine can use */
+#define RETURN_IF_SINGLE(L,result) \
+{ \
+    if ((L)->dtype == CHOLMOD_SINGLE) \
+    { \
+	ERROR (CHOLMOD_INVALID, "single precision factor not supported") ; \
+	return (result) ; \
+    } \
+}
+
 /* Return if Common is NULL or invalid */
 #define RETURN_IF_NULL_COMMON(result) \
 { \
@@ -212,6 +223,26 @@ size_t cholmod_mult_size_t (size_t a, size_t k, int *ok) ;
 size_t cholmod_l_add_size_t (size_t a, size_t b, int *ok) ;
 size_t cholmod_l_mult_size_t (size_t a, size_t k, int *ok) ;
 
+/* routines for a supernodal L->x held in a memory-mapped file */
+struct cholmod_factor_struct ;
+struct cholmod_common_struct ;
+void *cholmod_ooc_malloc (size_t n, size_t size, size_t *ooc,
+    struct cholmod_common_struct *Common) ;
+void *cholmod_ooc_free (size_t n, size_t size, void *p, size_t ooc,
+    struct cholmod_common_struct *Common) ;
+int cholmod_ooc_load (struct cholmod_factor_struct *L,
+    struct cholmod_common_struct *Common) ;
+void cholmod_ooc_sweep (struct cholmod_factor_struct *L, int s, int forward,
+    size_t *mark, struct cholmod_common_struct *Common) ;
+void *cholmod_l_ooc_malloc (size_t n, size_t size, size_t *ooc,
+    struct cholmod_common_struct *Common) ;
+void *cholmod_l_ooc_free (size_t n, size_t size, void *p, size_t ooc,
+    struct cholmod_common_struct *Common) ;
+int cholmod_l_ooc_load (struct cholmod_factor_struct *L,
+    struct cholmod_common_struct *Common) ;
+void cholmod_l_ooc_sweep (struct cholmod_factor_struct *L, SuiteSparse_long s,
+    int forward, size_t *mark, struct cholmod_common_struct *Common) ;
+
 /* -------------------------------------------------------------------------- */
 /* double (also complex double), SuiteSparse_long */
 /* -------------------------------------------------------------------------- */
@@ -31,6 +31,7 @@
  * cholmod_updown_mark	    update/downdate, and modify solution to partial Lx=b
  * cholmod_updown_mask	    update/downdate for LPDASA
  * cholmod_updown_mask2     update/downdate for LPDASA
+ * cholmod_updown_batch	    many independent rank-1 updates/downdates, and solves
  * cholmod_rowadd_solve	    add a row, and update solution to Lx=b
  * cholmod_rowadd_mark	    add a row, and update solution to partial Lx=b
  * cholmod_rowdel_solve	    delete a row, and downdate Lx=b
@@ -165,6 +166,31 @@ int cholmod_l_updown_mask2 (int, cholmod_sparse *, SuiteSparse_long *,
     SuiteSparse_long *, SuiteSparse_long, cholmod_factor *, cholmod_dense *,
     cholmod_dense *, cholmod_common *) ;
 
+/* -------------------------------------------------------------------------- */
+/* cholmod_updown_batch:  many independent rank-1 updates/downdates */
+/* -------------------------------------------------------------------------- */
+
+/* Solves (LDL'+ck*ck')x=b (an update) or (LDL'-ck*ck')x=b (a downdate) for
+ * each column ck of C, without changing L (other than converting it to a
+ * simplicial LDL' factorization).  B is n-by-1 or n-by-m, and X is n-by-m.
+ * The problems are solved concurrently if Common->nthreads_max > 1. */
+
+int cholmod_updown_batch
+(
+    /* ---- input ---- */
+    int update,		/* TRUE for update, FALSE for downdate */
+    cholmod_sparse *C,	/* n-by-m, the m rank-1 updates/downdates */
+    cholmod_factor *L,	/* factor to modify (a copy of it, that is) */
+    cholmod_dense *B,	/* n-by-1 or n-by-m right-hand-side */
+    /* ---- output --- */
+    cholmod_dense *X,	/* n-by-m solutions */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+int cholmod_l_updown_batch (int, cholmod_sparse *, cholmod_factor *,
+    cholmod_dense *, cholmod_dense *, cholmod_common *) ;
+
 /* -------------------------------------------------------------------------- */
 /* cholmod_rowadd:  add a row to an LDL' factorization (a rank-2 update) */
 /* -------------------------------------------------------------------------- */
@@ -19,6 +19,7 @@
  * -----------------
  * cholmod_super_symbolic	supernodal symbolic analysis
  * cholmod_super_numeric	supernodal numeric factorization
+ * cholmod_super_numeric_path	supernodal partial refactorization
  * cholmod_super_lsolve		supernodal Lx=b solve
  * cholmod_super_ltsolve	supernodal L'x=b solve
  *
@@ -120,6 +121,33 @@ int cholmod_super_numeric
 int cholmod_l_super_numeric (cholmod_sparse *, cholmod_sparse *, double *,
     cholmod_factor *, cholmod_common *) ;
 
+/* -------------------------------------------------------------------------- */
+/* cholmod_super_numeric_path */
+/* -------------------------------------------------------------------------- */
+
+/* Same as cholmod_super_numeric, except that only the supernodes containing
+ * the columns Path [0..pathlen-1] of L (from cholmod_compute_path) are
+ * factorized again, if Path is not NULL.  L must be numeric.  The user need
+ * not call this directly; cholmod_factorize_partial is a wrapper for it.
+ */
+
+int cholmod_super_numeric_path
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize */
+    cholmod_sparse *F,	/* F = A' or A(:,f)' */
+    double beta [2],	/* beta*I is added to diagonal of matrix to factorize */
+    int *Path,		/* columns of L to refactorize; NULL for all */
+    size_t pathlen,	/* size of Path */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* factorization */
+    /* --------------- */
+    cholmod_common *Common
+) ;
+
+int cholmod_l_super_numeric_path (cholmod_sparse *, cholmod_sparse *,
+    double *, SuiteSparse_long *, size_t, cholmod_factor *, cholmod_common *) ;
+
 /* -------------------------------------------------------------------------- */
 /* cholmod_super_lsolve */
 /* -------------------------------------------------------------------------- */
@@ -27,6 +27,12 @@
  *
  * Supports real, complex, and zomplex matrices, but the xtypes of A, X, and Y
  * must all match.
+ *
+ * If Common->nthreads_max > 1, the rows of Y are split into that many ranges,
+ * and computed concurrently.  This requires A to have sorted columns, unless
+ * A is unsymmetric and A' is used.  Each entry of Y is computed in the same
+ * order as the sequential method, so the result is the same for any number of
+ * threads.  Small problems are done sequentially.
  */
 
 #ifndef NGPL
@@ -35,6 +41,44 @@
 #include "cholmod_internal.h"
 #include "cholmod_matrixops.h"
 
+#ifdef _OPENMP
+
+/* minimum nnz(A)*ncol(X) for the parallel method */
+#define SDMULT_PAR_MIN 65536
+
+/* ========================================================================== */
+/* === sdmult_first_row ===================================================== */
+/* ========================================================================== */
+
+/* Return the position of the first entry in Ai [p ... pend-1] whose row index
+ * is >= ilo, or pend if there is none.  The row indices must be sorted. */
+
+static Int sdmult_first_row
+(
+    Int *Ai,
+    Int p,
+    Int pend,
+    Int ilo
+)
+{
+    Int pmid ;
+    while (p < pend)
+    {
+	pmid = p + (pend - p) / 2 ;
+	if (Ai [pmid] < ilo)
+	{
+	    p = pmid + 1 ;
+	}
+	else
+	{
+	    pend = pmid ;
+	}
+    }
+    return (p) ;
+}
+
+#endif
+
 
 /* ========================================================================== */
 /* === TEMPLATE ============================================================= */
@@ -68,6 +112,11 @@ int CHOLMOD(sdmult)
     double *w ;
     size_t nx, ny ;
     Int e ;
+#ifdef _OPENMP
+    double work ;
+    Int t ;
+    int nthreads ;
+#endif
 
     /* ---------------------------------------------------------------------- */
     /* check inputs */
@@ -95,6 +144,47 @@ int CHOLMOD(sdmult)
     }
     Common->status = CHOLMOD_OK ;
 
+#ifdef _OPENMP
+
+    /* ---------------------------------------------------------------------- */
+    /* Y = alpha*op(A)*X + beta*Y in parallel, each thread on its own rows */
+    /* ---------------------------------------------------------------------- */
+
+    nthreads = Common->nthreads_max ;
+    nthreads = (int) MIN ((size_t) nthreads, ny) ;
+    work = ((double) CHOLMOD(nnz) (A, Common)) * ((double) X->ncol) ;
+    if (nthreads > 1 && work >= SDMULT_PAR_MIN &&
+	(A->sorted || (A->stype == 0 && transpose)))
+    {
+	#pragma omp parallel for num_threads(nthreads) schedule(static,1)
+	for (t = 0 ; t < nthreads ; t++)
+	{
+	    Int ylo = (Int) ((ny * t) / nthreads) ;
+	    Int yhi = (Int) ((ny * (t+1)) / nthreads) ;
+	    switch (A->xtype)
+	    {
+
+		case CHOLMOD_REAL:
+		    r_cholmod_sdmult_rows (A, transpose, alpha, beta, X, ylo,
+			yhi, Y) ;
+		    break ;
+
+		case CHOLMOD_COMPLEX:
+		    c_cholmod_sdmult_rows (A, transpose, alpha, beta, X, ylo,
+			yhi, Y) ;
+		    break ;
+
+		case CHOLMOD_ZOMPLEX:
+		    z_cholmod_sdmult_rows (A, transpose, alpha, beta, X, ylo,
+			yhi, Y) ;
+		    break ;
+	    }
+	}
+	DEBUG (CHOLMOD(dump_dense) (Y, "Y", Common)) ;
+	return (TRUE) ;
+    }
+#endif
+
     /* ---------------------------------------------------------------------- */
     /* allocate workspace, if required */
     /* ---------------------------------------------------------------------- */
@@ -29,6 +29,12 @@
  * Only pattern and real matrices are supported.  Complex and zomplex matrices
  * are supported only when the numerical values are not computed ("values"
  * is FALSE).
+ *
+ * If Common->nthreads_max > 1, the columns of C are counted and then computed
+ * concurrently, each thread with its own Flag and W arrays, of size
+ * max (A->nrow, B->ncol) each.  Each column of C is computed in the same way as
+ * the sequential method, so the result is the same for any number of threads.
+ * The sequential method is used if this workspace cannot be allocated.
  */
 
 #ifndef NGPL
@@ -37,6 +43,202 @@
 #include "cholmod_internal.h"
 #include "cholmod_matrixops.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+
+
+/* ========================================================================== */
+/* === ssmult_count ========================================================= */
+/* ========================================================================== */
+
+/* Count the entries in each column of C=A*B, where A and B are unsymmetric.
+ * The columns are counted concurrently, each thread with its own Flag array
+ * of size A->nrow, in Tflag.  Cnz [j] is the number of entries in C(:,j).
+ * Returns the total, or -1 if it overflows Int. */
+
+static Int ssmult_count
+(
+    cholmod_sparse *A,
+    cholmod_sparse *B,
+    Int *Cnz,		/* size B->ncol */
+    Int *Tflag,		/* size nthreads*A->nrow */
+    int nthreads
+)
+{
+    Int *Ap, *Anz, *Ai, *Bp, *Bnz, *Bi ;
+    Int apacked, bpacked, nrow, ncol, j, k, cnz ;
+
+    Ap  = A->p ;
+    Anz = A->nz ;
+    Ai  = A->i ;
+    apacked = A->packed ;
+    Bp  = B->p ;
+    Bnz = B->nz ;
+    Bi  = B->i ;
+    bpacked = B->packed ;
+    nrow = A->nrow ;
+    ncol = B->ncol ;
+
+    for (k = 0 ; k < ((Int) nthreads) * nrow ; k++)
+    {
+	Tflag [k] = EMPTY ;
+    }
+
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic,64)
+    for (j = 0 ; j < ncol ; j++)
+    {
+	Int *Flag = Tflag + ((Int) omp_get_thread_num ()) * nrow ;
+	Int i, t, pa, paend, pb, pbend, count = 0 ;
+
+	/* for each nonzero B(t,j) in column j, do: */
+	pb = Bp [j] ;
+	pbend = (bpacked) ? (Bp [j+1]) : (pb + Bnz [j]) ;
+	for ( ; pb < pbend ; pb++)
+	{
+	    /* add the nonzero pattern of A(:,t) to the pattern of C(:,j) */
+	    t = Bi [pb] ;
+	    pa = Ap [t] ;
+	    paend = (apacked) ? (Ap [t+1]) : (pa + Anz [t]) ;
+	    for ( ; pa < paend ; pa++)
+	    {
+		i = Ai [pa] ;
+		if (Flag [i] != j)
+		{
+		    Flag [i] = j ;
+		    count++ ;
+		}
+	    }
+	}
+	Cnz [j] = count ;
+    }
+
+    cnz = 0 ;
+    for (j = 0 ; j < ncol ; j++)
+    {
+	cnz += Cnz [j] ;
+	if (cnz < 0)
+	{
+	    return (-1) ;	    /* integer overflow case */
+	}
+    }
+    return (cnz) ;
+}
+
+
+/* ========================================================================== */
+/* === ssmult_fill ========================================================== */
+/* ========================================================================== */
+
+/* Compute the pattern and (if values is TRUE) the values of C=A*B, where C->p
+ * has already been computed from the counts of ssmult_count.  The columns are
+ * computed concurrently, each thread with its own Flag and W arrays of size
+ * A->nrow, in Tflag and Tw. */
+
+static void ssmult_fill
+(
+    cholmod_sparse *A,
+    cholmod_sparse *B,
+    cholmod_sparse *C,
+    int values,
+    Int *Tflag,		/* size nthreads*A->nrow */
+    double *Tw,		/* size nthreads*A->nrow, unused if values is FALSE */
+    int nthreads
+)
+{
+    double *Ax, *Bx, *Cx ;
+    Int *Ap, *Anz, *Ai, *Bp, *Bnz, *Bi, *Cp, *Ci ;
+    Int apacked, bpacked, nrow, ncol, j, k ;
+
+    Ap  = A->p ;
+    Anz = A->nz ;
+    Ai  = A->i ;
+    Ax  = A->x ;
+    apacked = A->packed ;
+    Bp  = B->p ;
+    Bnz = B->nz ;
+    Bi  = B->i ;
+    Bx  = B->x ;
+    bpacked = B->packed ;
+    Cp  = C->p ;
+    Ci  = C->i ;
+    Cx  = C->x ;
+    nrow = A->nrow ;
+    ncol = B->ncol ;
+
+    for (k = 0 ; k < ((Int) nthreads) * nrow ; k++)
+    {
+	Tflag [k] = EMPTY ;
+    }
+    if (values)
+    {
+	for (k = 0 ; k < ((Int) nthreads) * nrow ; k++)
+	{
+	    Tw [k] = 0 ;
+	}
+    }
+
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic,64)
+    for (j = 0 ; j < ncol ; j++)
+    {
+	Int tid = omp_get_thread_num () ;
+	Int *Flag = Tflag + tid * nrow ;
+	double *W = values ? (Tw + tid * nrow) : NULL ;
+	double bjt ;
+	Int i, t, p, pa, paend, pb, pbend, cnz ;
+
+	/* for each nonzero B(t,j) in column j, do: */
+	cnz = Cp [j] ;
+	pb = Bp [j] ;
+	pbend = (bpacked) ? (Bp [j+1]) : (pb + Bnz [j]) ;
+	for ( ; pb < pbend ; pb++)
+	{
+	    /* B(t,j) is nonzero */
+	    t = Bi [pb] ;
+	    bjt = values ? Bx [pb] : 0 ;
+
+	    /* add the nonzero pattern of A(:,t) to the pattern of C(:,j)
+	     * and scatter the values into W */
+	    pa = Ap [t] ;
+	    paend = (apacked) ? (Ap [t+1]) : (pa + Anz [t]) ;
+	    for ( ; pa < paend ; pa++)
+	    {
+		i = Ai [pa] ;
+		if (Flag [i] != j)
+		{
+		    Flag [i] = j ;
+		    Ci [cnz++] = i ;
+		}
+		if (values)
+		{
+		    W [i] += Ax [pa] * bjt ;
+		}
+	    }
+	}
+	ASSERT (cnz == Cp [j+1]) ;
+
+	/* gather the values into C(:,j) */
+	if (values)
+	{
+	    for (p = Cp [j] ; p < cnz ; p++)
+	    {
+		i = Ci [p] ;
+		Cx [p] = W [i] ;
+		W [i] = 0 ;
+	    }
+	}
+    }
+}
+#endif
+
+
+/* free the workspace of the parallel method */
+#define FREE_TWORK \
+{ \
+    Cnz   = CHOLMOD(free) (n3, sizeof (Int), Cnz, Common) ; \
+    Tflag = CHOLMOD(free) (tsize, sizeof (Int), Tflag, Common) ; \
+    Tw    = CHOLMOD(free) (tsize, sizeof (double), Tw, Common) ; \
+}
+
 
 /* ========================================================================== */
 /* === cholmod_ssmult ======================================================= */
@@ -55,11 +257,13 @@ cholmod_sparse *CHOLMOD(ssmult)
 )
 {
     double bjt ;
-    double *Ax, *Bx, *Cx, *W ;
-    Int *Ap, *Anz, *Ai, *Bp, *Bnz, *Bi, *Cp, *Ci, *Flag ;
+    double *Ax, *Bx, *Cx, *W, *Tw ;
+    Int *Ap, *Anz, *Ai, *Bp, *Bnz, *Bi, *Cp, *Ci, *Flag, *Cnz, *Tflag ;
     cholmod_sparse *C, *A2, *B2, *A3, *B3, *C2 ;
     Int apacked, bpacked, j, i, pa, paend, pb, pbend, ncol, mark, cnz, t, p,
 	nrow, anz, bnz, do_swap_and_transpose, n1, n2 ;
+    size_t n3, tsize ;
+    int nthreads ;
 
     /* ---------------------------------------------------------------------- */
     /* check inputs */
@@ -170,42 +374,86 @@ cholmod_sparse *CHOLMOD(ssmult)
     W = Common->Xwork ;		/* size nrow, unused if values is FALSE */
     Flag = Common->Flag ;	/* size nrow, Flag [0..nrow-1] < mark on input*/
 
+    /* get workspace for the parallel method, if used.  C' may be computed
+     * instead of C, so the sizes must work for both */
+    nthreads = 1 ;
+    n3 = MAX (A->nrow, B->ncol) ;
+    tsize = 0 ;
+    Cnz = NULL ;
+    Tflag = NULL ;
+    Tw = NULL ;
+#ifdef _OPENMP
+    if (Common->nthreads_max > 1 && ncol > 1)
+    {
+	int ok = TRUE, try_catch = Common->try_catch ;
+	nthreads = (int) MIN ((size_t) Common->nthreads_max, n3) ;
+	tsize = CHOLMOD(mult_size_t) (n3, nthreads, &ok) ;
+	Common->try_catch = TRUE ;
+	if (ok)
+	{
+	    Cnz = CHOLMOD(malloc) (n3, sizeof (Int), Common) ;
+	    Tflag = CHOLMOD(malloc) (tsize, sizeof (Int), Common) ;
+	    if (values)
+	    {
+		Tw = CHOLMOD(malloc) (tsize, sizeof (double), Common) ;
+	    }
+	}
+	Common->try_catch = try_catch ;
+	if (!ok || Common->status < CHOLMOD_OK)
+	{
+	    /* out of memory: use the sequential method instead */
+	    FREE_TWORK ;
+	    Common->status = CHOLMOD_OK ;
+	    nthreads = 1 ;
+	}
+    }
+#endif
+
     /* ---------------------------------------------------------------------- */
     /* count the number of entries in the result C */
     /* ---------------------------------------------------------------------- */
 
     cnz = 0 ;
-    for (j = 0 ; j < ncol ; j++)
+    if (nthreads > 1)
     {
-	/* clear the Flag array */
-	/* mark = CHOLMOD(clear_flag) (Common) ; */
-	CHOLMOD_CLEAR_FLAG (Common) ;
-	mark = Common->mark ;
-
-	/* for each nonzero B(t,j) in column j, do: */
-	pb = Bp [j] ;
-	pbend = (bpacked) ? (Bp [j+1]) : (pb + Bnz [j]) ;
-	for ( ; pb < pbend ; pb++)
+#ifdef _OPENMP
+	cnz = ssmult_count (A, B, Cnz, Tflag, nthreads) ;
+#endif
+    }
+    else
+    {
+	for (j = 0 ; j < ncol ; j++)
 	{
-	    /* B(t,j) is nonzero */
-	    t = Bi [pb] ;
+	    /* clear the Flag array */
+	    /* mark = CHOLMOD(clear_flag) (Common) ; */
+	    CHOLMOD_CLEAR_FLAG (Common) ;
+	    mark = Common->mark ;
 
-	    /* add the nonzero pattern of A(:,t) to the pattern of C(:,j) */
-	    pa = Ap [t] ;
-	    paend = (apacked) ? (Ap [t+1]) : (pa + Anz [t]) ;
-	    for ( ; pa < paend ; pa++)
+	    /* for each nonzero B(t,j) in column j, do: */
+	    pb = Bp [j] ;
+	    pbend = (bpacked) ? (Bp [j+1]) : (pb + Bnz [j]) ;
+	    for ( ; pb < pbend ; pb++)
 	    {
-		i = Ai [pa] ;
-		if (Flag [i] != mark)
+		/* B(t,j) is nonzero */
+		t = Bi [pb] ;
+
+		/* add the nonzero pattern of A(:,t) to the pattern of C(:,j) */
+		pa = Ap [t] ;
+		paend = (apacked) ? (Ap [t+1]) : (pa + Anz [t]) ;
+		for ( ; pa < paend ; pa++)
 		{
-		    Flag [i] = mark ;
-		    cnz++ ;
+		    i = Ai [pa] ;
+		    if (Flag [i] != mark)
+		    {
+			Flag [i] = mark ;
+			cnz++ ;
+		    }
 		}
 	    }
-	}
-	if (cnz < 0)
-	{
-	    break ;	    /* integer overflow case */
+	    if (cnz < 0)
+	    {
+		break ;	    /* integer overflow case */
+	    }
 	}
     }
 
@@ -220,6 +468,7 @@ cholmod_sparse *CHOLMOD(ssmult)
     if (cnz < 0)
     {
 	ERROR (CHOLMOD_TOO_LARGE, "problem too large") ;
+	FREE_TWORK ;
 	CHOLMOD(free_sparse) (&A2, Common) ;
 	CHOLMOD(free_sparse) (&B2, Common) ;
 	ASSERT (CHOLMOD(dump_work) (TRUE, TRUE, values ? n1:0, Common)) ;
@@ -258,6 +507,7 @@ cholmod_sparse *CHOLMOD(ssmult)
 	    if (Common->status < CHOLMOD_OK)
 	    {
 		/* out of memory */
+		FREE_TWORK ;
 		CHOLMOD(free_sparse) (&A2, Common) ;
 		CHOLMOD(free_sparse) (&B2, Common) ;
 		ASSERT (CHOLMOD(dump_work) (TRUE, TRUE, values ? n1:0, Common));
@@ -270,6 +520,7 @@ cholmod_sparse *CHOLMOD(ssmult)
 	    if (Common->status < CHOLMOD_OK)
 	    {
 		/* out of memory */
+		FREE_TWORK ;
 		CHOLMOD(free_sparse) (&A2, Common) ;
 		CHOLMOD(free_sparse) (&B2, Common) ;
 		ASSERT (CHOLMOD(dump_work) (TRUE, TRUE, values ? n1:0, Common));
@@ -295,6 +546,14 @@ cholmod_sparse *CHOLMOD(ssmult)
 	    /* get the size of C' */
 	    nrow = A->nrow ;
 	    ncol = B->ncol ;
+
+#ifdef _OPENMP
+	    if (nthreads > 1)
+	    {
+		/* count the entries in each column of C' */
+		(void) ssmult_count (A, B, Cnz, Tflag, nthreads) ;
+	    }
+#endif
 	}
     }
 
@@ -307,6 +566,7 @@ cholmod_sparse *CHOLMOD(ssmult)
     if (Common->status < CHOLMOD_OK)
     {
 	/* out of memory */
+	FREE_TWORK ;
 	CHOLMOD(free_sparse) (&A2, Common) ;
 	CHOLMOD(free_sparse) (&B2, Common) ;
 	ASSERT (CHOLMOD(dump_work) (TRUE, TRUE, values ? n1:0, Common)) ;
@@ -323,7 +583,22 @@ cholmod_sparse *CHOLMOD(ssmult)
 
     cnz = 0 ;
 
-    if (values)
+    if (nthreads > 1)
+    {
+
+#ifdef _OPENMP
+	/* all columns of C in parallel */
+	for (j = 0 ; j < ncol ; j++)
+	{
+	    Cp [j] = cnz ;
+	    cnz += Cnz [j] ;
+	}
+	Cp [ncol] = cnz ;
+	ssmult_fill (A, B, C, values, Tflag, Tw, nthreads) ;
+#endif
+
+    }
+    else if (values)
     {
 
 	/* pattern and values */
@@ -417,6 +692,7 @@ cholmod_sparse *CHOLMOD(ssmult)
     /* clear workspace and free temporary matrices */
     /* ---------------------------------------------------------------------- */
 
+    FREE_TWORK ;
     CHOLMOD(free_sparse) (&A2, Common) ;
     CHOLMOD(free_sparse) (&B2, Common) ;
     /* CHOLMOD(clear_flag) (Common) ; */
@@ -717,6 +717,247 @@ static void TEMPLATE (cholmod_sdmult)
 }
 
 
+#ifdef _OPENMP
+
+/* ========================================================================== */
+/* === t_cholmod_sdmult_rows ================================================ */
+/* ========================================================================== */
+
+/* Computes rows ylo to yhi-1 of Y = alpha*op(A)*X + beta*Y, one column of X
+ * at a time.  Used by the parallel cholmod_sdmult, where each thread computes
+ * its own range of rows of Y.  Each y(i) is computed with the same operations,
+ * in the same order, as in t_cholmod_sdmult above, so the result does not
+ * depend on the number of threads.  The columns of A must be sorted, unless A
+ * is unsymmetric and A' is used.
+ */
+
+static void TEMPLATE (cholmod_sdmult_rows)
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* sparse matrix to multiply */
+    int transpose,	/* use A if 0, or A' otherwise */
+    double alpha [2],   /* scale factor for A */
+    double beta [2],    /* scale factor for Y */
+    cholmod_dense *X,	/* dense matrix to multiply */
+    Int ylo,		/* first row of Y to compute */
+    Int yhi,		/* one past the last row of Y to compute */
+    /* ---- in/out --- */
+    cholmod_dense *Y	/* resulting dense matrix */
+)
+{
+
+    double yx [2], xx [2], ax [2] ;
+#ifdef ZOMPLEX
+    double yz [1], xz [1], az [1] ;
+    double betaz [1], alphaz [1] ;
+#endif
+
+    double *Ax, *Az, *Xx, *Xz, *Yx, *Yz ;
+    Int *Ap, *Ai, *Anz ;
+    size_t dx, dy ;
+    Int packed, ncol, stype, j, k, p, pend, kcol, i ;
+
+    /* ---------------------------------------------------------------------- */
+    /* get inputs */
+    /* ---------------------------------------------------------------------- */
+
+#ifdef ZOMPLEX
+    betaz  [0] = beta  [1] ;
+    alphaz [0] = alpha [1] ;
+#endif
+
+    ncol = A->ncol ;
+    stype = A->stype ;
+    Ap  = A->p ;
+    Anz = A->nz ;
+    Ai  = A->i ;
+    Ax  = A->x ;
+    Az  = A->z ;
+    packed = A->packed ;
+    Xx = X->x ;
+    Xz = X->z ;
+    Yx = Y->x ;
+    Yz = Y->z ;
+    kcol = X->ncol ;
+    dy = Y->d ;
+    dx = X->d ;
+
+    /* ---------------------------------------------------------------------- */
+    /* Y (ylo:yhi-1,:) = beta * Y (ylo:yhi-1,:) */
+    /* ---------------------------------------------------------------------- */
+
+    if (ENTRY_IS_ZERO (beta, betaz, 0))
+    {
+	for (k = 0 ; k < kcol ; k++)
+	{
+	    for (i = ylo ; i < yhi ; i++)
+	    {
+		/* y [i] = 0. ; */
+		CLEAR (Yx, Yz, i) ;
+	    }
+	    /* y += dy ; */
+	    ADVANCE (Yx,Yz,dy) ;
+	}
+    }
+    else if (!ENTRY_IS_ONE (beta, betaz, 0))
+    {
+	for (k = 0 ; k < kcol ; k++)
+	{
+	    for (i = ylo ; i < yhi ; i++)
+	    {
+		/* y [i] *= beta [0] ; */
+		MULT (Yx,Yz,i, Yx,Yz,i, beta,betaz, 0) ;
+	    }
+	    /* y += dy ; */
+	    ADVANCE (Yx,Yz,dy) ;
+	}
+    }
+
+    if (ENTRY_IS_ZERO (alpha, alphaz, 0))
+    {
+	/* nothing else to do */
+	return ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* Y (ylo:yhi-1,:) += alpha * op(A) (ylo:yhi-1,:) * X */
+    /* ---------------------------------------------------------------------- */
+
+    Yx = Y->x ;
+    Yz = Y->z ;
+
+    for (k = 0 ; k < kcol ; k++)
+    {
+
+	if (stype == 0 && transpose)
+	{
+
+	    /* -------------------------------------------------------------- */
+	    /* y (j) += alpha * A (:,j)' * x for columns ylo:yhi-1 of A */
+	    /* -------------------------------------------------------------- */
+
+	    for (j = ylo ; j < yhi ; j++)
+	    {
+		/* yj = 0. ; */
+		CLEAR (yx, yz, 0) ;
+		p = Ap [j] ;
+		pend = (packed) ? (Ap [j+1]) : (p + Anz [j]) ;
+		for ( ; p < pend ; p++)
+		{
+		    /* yj += conj(Ax [p]) * x [Ai [p]] ; */
+		    i = Ai [p] ;
+		    ASSIGN_CONJ (ax,az,0, Ax,Az,p) ;
+		    MULTADD (yx,yz,0, ax,az,0, Xx,Xz,i) ;
+		}
+		/* y [j] += alpha [0] * yj ; */
+		MULTADD (Yx,Yz,j, alpha,alphaz,0, yx,yz,0) ;
+	    }
+
+	}
+	else if (stype == 0)
+	{
+
+	    /* -------------------------------------------------------------- */
+	    /* y += alpha * A (ylo:yhi-1,:) * x */
+	    /* -------------------------------------------------------------- */
+
+	    for (j = 0 ; j < ncol ; j++)
+	    {
+		p = Ap [j] ;
+		pend = (packed) ? (Ap [j+1]) : (p + Anz [j]) ;
+		p = sdmult_first_row (Ai, p, pend, ylo) ;
+		if (p >= pend || Ai [p] >= yhi)
+		{
+		    continue ;	/* no entries in rows ylo:yhi-1 */
+		}
+
+		/*  xj = alpha [0] * x [j] ; */
+		MULT (xx,xz,0, alpha,alphaz,0, Xx,Xz,j) ;
+
+		for ( ; p < pend && Ai [p] < yhi ; p++)
+		{
+		    /* y [Ai [p]] += Ax [p] * xj ; */
+		    i = Ai [p] ;
+		    MULTADD (Yx,Yz,i, Ax,Az,p, xx,xz,0) ;
+		}
+	    }
+
+	}
+	else
+	{
+
+	    /* -------------------------------------------------------------- */
+	    /* symmetric case (upper/lower) */
+	    /* -------------------------------------------------------------- */
+
+	    for (j = 0 ; j < ncol ; j++)
+	    {
+		/* xj = alpha [0] * x [j] ; */
+		MULT (xx,xz,0, alpha,alphaz,0, Xx,Xz,j) ;
+
+		p = Ap [j] ;
+		pend = (packed) ? (Ap [j+1]) : (p + Anz [j]) ;
+
+		if (j >= ylo && j < yhi)
+		{
+
+		    /* y [j] is computed here: use all of column j */
+
+		    /* yj = 0. ; */
+		    CLEAR (yx,yz,0) ;
+		    for ( ; p < pend ; p++)
+		    {
+			i = Ai [p] ;
+			if (i == j)
+			{
+			    /* y [i] += Ax [p] * xj ; */
+			    MULTADD (Yx,Yz,i, Ax,Az,p, xx,xz,0) ;
+			}
+			else if ((stype > 0 && i < j) || (stype < 0 && i > j))
+			{
+			    /* aij = Ax [p] ; */
+			    ASSIGN (ax,az,0, Ax,Az,p) ;
+
+			    /* y [i] += aij * xj ; */
+			    /* yj    += aij * x [i] ; */
+			    if (i >= ylo && i < yhi)
+			    {
+				MULTADD (Yx,Yz,i, ax,az,0, xx,xz,0) ;
+			    }
+			    MULTADDCONJ (yx,yz,0, ax,az,0, Xx,Xz,i) ;
+			}
+		    }
+		    /* y [j] += alpha [0] * yj ; */
+		    MULTADD (Yx,Yz,j, alpha,alphaz,0, yx,yz,0) ;
+
+		}
+		else
+		{
+
+		    /* only the entries in rows ylo:yhi-1 are needed */
+		    p = sdmult_first_row (Ai, p, pend, ylo) ;
+		    for ( ; p < pend && Ai [p] < yhi ; p++)
+		    {
+			i = Ai [p] ;
+			if ((stype > 0 && i < j) || (stype < 0 && i > j))
+			{
+			    /* y [i] += Ax [p] * xj ; */
+			    MULTADD (Yx,Yz,i, Ax,Az,p, xx,xz,0) ;
+			}
+		    }
+		}
+	    }
+	}
+
+	/* y += dy ; */
+	/* x += dx ; */
+	ADVANCE (Yx,Yz,dy) ;
+	ADVANCE (Xx,Xz,dx) ;
+    }
+}
+
+#endif
+
 #undef PATTERN
 #undef REAL
 #undef COMPLEX
@@ -63,6 +63,9 @@
 
 #include "cholmod_internal.h"
 #include "cholmod_modify.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 /* ========================================================================== */
@@ -284,6 +287,299 @@ static void dfs
 #include "t_cholmod_updown.c"
 
 
+/* ========================================================================== */
+/* === no_fill ============================================================== */
+/* ========================================================================== */
+
+/* Returns TRUE if a rank-1 update/downdate with the sorted column
+ * Ci [pp1 ... pp2-1] leaves the pattern of L unchanged.  This holds if the
+ * column is in the pattern of L(:,j), where j is its first row, since the
+ * pattern of the parent of each column contains that of the column (except
+ * for the parent itself).  All of w then stays within the pattern of L along
+ * the whole path from j to the root, and the path is the only part of L that
+ * changes. */
+
+static int no_fill (cholmod_factor *L, Int *Ci, Int pp1, Int pp2)
+{
+    Int *Li, *Lp, *Lnz, p, pend ;
+    if (pp2 <= pp1)
+    {
+	return (TRUE) ;
+    }
+    Li = L->i ;
+    Lp = L->p ;
+    Lnz = L->nz ;
+    p = Lp [Ci [pp1]] ;
+    pend = p + Lnz [Ci [pp1]] ;
+    for ( ; pp1 < pp2 ; pp1++)
+    {
+	while (p < pend && Li [p] < Ci [pp1])
+	{
+	    p++ ;
+	}
+	if (p == pend || Li [p] != Ci [pp1])
+	{
+	    return (FALSE) ;
+	}
+    }
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === updown_par =========================================================== */
+/* ========================================================================== */
+
+/* Multithreaded update/downdate, done as a sequence of rank-1 updates, one
+ * for each column of C, with up to Common->nthreads_max threads.  Each path
+ * from the first row of C(:,k) to the root of the etree starts with the
+ * columns of L that are on no other path.  These parts of the paths are
+ * independent, and are modified concurrently.  The rest of each path (which
+ * all the paths below it share) is then modified one column of C at a time,
+ * in order, starting from the part of w that is left from the first part.
+ *
+ * Returns TRUE if L has been updated/downdated, or FALSE if nothing was done:
+ * if a column of C would change the pattern of L, or if out of memory.  The
+ * caller then does the rank-k update/downdate instead.  The Common workspace
+ * is not used.
+ */
+
+static int updown_par
+(
+    /* ---- input ---- */
+    int update,		/* TRUE for update, FALSE for downdate */
+    cholmod_sparse *C,	/* the incoming sparse update */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* factor to modify */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double fl = 0, *Cx, *Ww, *W, *Save, *Alpha ;
+    Int *Ci, *Cp, *Cnz, *Li, *Lp, *Lnz, *Count, *Iw, *First, *Last, *Soff,
+	n, m, k, j, e, p, t, pp1, pp2, packed, nthreads, nsave ;
+    size_t wsize ;
+    int try_catch, ok = TRUE ;
+
+    n = L->n ;
+    m = C->ncol ;
+    Ci = C->i ;
+    Cx = C->x ;
+    Cp = C->p ;
+    Cnz = C->nz ;
+    packed = C->packed ;
+    Li = L->i ;
+    Lp = L->p ;
+    Lnz = L->nz ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check the patterns, and allocate workspace */
+    /* ---------------------------------------------------------------------- */
+
+    for (k = 0 ; k < m ; k++)
+    {
+	pp1 = Cp [k] ;
+	pp2 = (packed) ? (Cp [k+1]) : (pp1 + Cnz [k]) ;
+	if (!no_fill (L, Ci, pp1, pp2))
+	{
+	    return (FALSE) ;
+	}
+    }
+
+    nthreads = MIN (Common->nthreads_max, m) ;
+    wsize = CHOLMOD(mult_size_t) (n, nthreads, &ok) ;
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Count = CHOLMOD(malloc) (n, sizeof (Int), Common) ;
+    Iw = CHOLMOD(malloc) (3*((size_t) m) + 1, sizeof (Int), Common) ;
+    Alpha = CHOLMOD(malloc) (m, sizeof (double), Common) ;
+    Ww = (ok) ? CHOLMOD(calloc) (wsize, sizeof (double), Common) : NULL ;
+    Save = NULL ;
+    nsave = 0 ;
+    First = Iw ;			/* size m */
+    Last = Iw + m ;			/* size m */
+    Soff = Iw + 2*((size_t) m) ;	/* size m+1 */
+
+    /* ---------------------------------------------------------------------- */
+    /* find the part of each path that is on no other path */
+    /* ---------------------------------------------------------------------- */
+
+    if (Common->status == CHOLMOD_OK && ok)
+    {
+	for (j = 0 ; j < n ; j++)
+	{
+	    Count [j] = 0 ;
+	}
+	for (k = 0 ; k < m ; k++)
+	{
+	    pp1 = Cp [k] ;
+	    pp2 = (packed) ? (Cp [k+1]) : (pp1 + Cnz [k]) ;
+	    First [k] = (pp2 > pp1) ? Ci [pp1] : EMPTY ;
+	    Alpha [k] = 1 ;
+	    for (j = First [k] ; j != EMPTY ; )
+	    {
+		Count [j]++ ;
+		fl += 6 + 4 * (double) Lnz [j] ;
+		j = (Lnz [j] > 1) ? (Li [Lp [j] + 1]) : EMPTY ;
+	    }
+	}
+	for (k = 0 ; k < m ; k++)
+	{
+	    /* Last [k] is the last column of the first part of the path, and
+	     * the part of w still pending there is kept in Save [Soff [k]...] */
+	    Last [k] = EMPTY ;
+	    for (j = First [k] ; j != EMPTY && Count [j] == 1 ; )
+	    {
+		Last [k] = j ;
+		j = (Lnz [j] > 1) ? (Li [Lp [j] + 1]) : EMPTY ;
+	    }
+	    Soff [k] = nsave ;
+	    if (Last [k] != EMPTY)
+	    {
+		nsave += Lnz [Last [k]] - 1 ;
+	    }
+	}
+	Soff [m] = nsave ;
+	Save = CHOLMOD(malloc) (nsave, sizeof (double), Common) ;
+    }
+    Common->try_catch = try_catch ;
+
+    if (Common->status < CHOLMOD_OK || !ok)
+    {
+	Common->status = CHOLMOD_OK ;
+	CHOLMOD(free) (n, sizeof (Int), Count, Common) ;
+	CHOLMOD(free) (3*((size_t) m) + 1, sizeof (Int), Iw, Common) ;
+	CHOLMOD(free) (m, sizeof (double), Alpha, Common) ;
+	CHOLMOD(free) (wsize, sizeof (double), Ww, Common) ;
+	CHOLMOD(free) (nsave, sizeof (double), Save, Common) ;
+	return (FALSE) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* modify the first part of each path, in parallel */
+    /* ---------------------------------------------------------------------- */
+
+#pragma omp parallel for num_threads(nthreads) schedule (dynamic,1) \
+    private (W, j, e, p, t, pp1, pp2)
+
+    for (k = 0 ; k < m ; k++)
+    {
+	if (Last [k] == EMPTY)
+	{
+	    continue ;
+	}
+#ifdef _OPENMP
+	W = Ww + n * ((size_t) omp_get_thread_num ( )) ;
+#else
+	W = Ww ;
+#endif
+	pp1 = Cp [k] ;
+	pp2 = (packed) ? (Cp [k+1]) : (pp1 + Cnz [k]) ;
+	for (p = pp1 ; p < pp2 ; p++)
+	{
+	    W [Ci [p]] = Cx [p] ;
+	}
+	e = Last [k] ;
+	updown_1_1 (update, First [k], e, Alpha + k, W, L, Common) ;
+	/* save the rest of w, and clear W */
+	for (p = Lp [e] + 1, t = Soff [k] ; p < Lp [e] + Lnz [e] ; p++, t++)
+	{
+	    j = Li [p] ;
+	    Save [t] = W [j] ;
+	    W [j] = 0 ;
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* modify the rest of each path, one column of C at a time */
+    /* ---------------------------------------------------------------------- */
+
+    W = Ww ;
+    for (k = 0 ; k < m ; k++)
+    {
+	e = Last [k] ;
+	if (e == EMPTY)
+	{
+	    pp1 = Cp [k] ;
+	    pp2 = (packed) ? (Cp [k+1]) : (pp1 + Cnz [k]) ;
+	    for (p = pp1 ; p < pp2 ; p++)
+	    {
+		W [Ci [p]] = Cx [p] ;
+	    }
+	    j = First [k] ;
+	}
+	else
+	{
+	    for (p = Lp [e] + 1, t = Soff [k] ; p < Lp [e] + Lnz [e] ; p++, t++)
+	    {
+		W [Li [p]] = Save [t] ;
+	    }
+	    j = (Lnz [e] > 1) ? (Li [Lp [e] + 1]) : EMPTY ;
+	}
+	if (j != EMPTY)
+	{
+	    updown_1_1 (update, j, n-1, Alpha + k, W, L, Common) ;
+	}
+    }
+
+    Common->modfl = fl ;
+    CHOLMOD(free) (n, sizeof (Int), Count, Common) ;
+    CHOLMOD(free) (3*((size_t) m) + 1, sizeof (Int), Iw, Common) ;
+    CHOLMOD(free) (m, sizeof (double), Alpha, Common) ;
+    CHOLMOD(free) (wsize, sizeof (double), Ww, Common) ;
+    CHOLMOD(free) (nsave, sizeof (double), Save, Common) ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === ldl_solve ============================================================ */
+/* ========================================================================== */
+
+/* Solves LDL'x=b, where L is a simplicial LDL' factor with the numerical
+ * values Lx (which need not be L->x).  x is overwritten with the solution. */
+
+static void ldl_solve (cholmod_factor *L, double *Lx, double *X)
+{
+    double xj ;
+    Int *Li, *Lp, *Lnz, n, j, p, pend ;
+
+    n = L->n ;
+    Li = L->i ;
+    Lp = L->p ;
+    Lnz = L->nz ;
+
+    /* solve Lx=b */
+    for (j = 0 ; j < n ; j++)
+    {
+	xj = X [j] ;
+	pend = Lp [j] + Lnz [j] ;
+	for (p = Lp [j] + 1 ; p < pend ; p++)
+	{
+	    X [Li [p]] -= Lx [p] * xj ;
+	}
+    }
+
+    /* solve Dx=b */
+    for (j = 0 ; j < n ; j++)
+    {
+	X [j] /= Lx [Lp [j]] ;
+    }
+
+    /* solve L'x=b */
+    for (j = n-1 ; j >= 0 ; j--)
+    {
+	xj = X [j] ;
+	pend = Lp [j] + Lnz [j] ;
+	for (p = Lp [j] + 1 ; p < pend ; p++)
+	{
+	    xj -= Lx [p] * X [Li [p]] ;
+	}
+	X [j] = xj ;
+    }
+}
+
+
 /* ========================================================================== */
 /* === cholmod_updown_mark ================================================== */
 /* ========================================================================== */
@@ -449,6 +745,7 @@ int CHOLMOD(updown_mask2)
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (C, FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_PATTERN, CHOLMOD_REAL, FALSE) ;
     RETURN_IF_XTYPE_INVALID (C, CHOLMOD_REAL, CHOLMOD_REAL, FALSE) ;
     n = L->n ;
@@ -589,6 +886,22 @@ int CHOLMOD(updown_mask2)
     Iwork = Common->Iwork ;
     Stack = Iwork ;		/* size n, uninitialized (i/i/l) */
 
+    /* ---------------------------------------------------------------------- */
+    /* multithreaded update/downdate, if possible */
+    /* ---------------------------------------------------------------------- */
+
+    /* CHOLMOD(dbound) counts the modified entries in Common, so the parallel
+     * version is not used with dbound. */
+#ifdef _OPENMP
+    if (Common->nthreads_max > 1 && cncol > 1 && !do_solve && !use_colmark
+	&& mask == NULL && !IS_GT_ZERO (Common->dbound)
+	&& updown_par (update, C, L, Common))
+    {
+	DEBUG (CHOLMOD(dump_factor) (L, "output L for updown", Common)) ;
+	return (TRUE) ;
+    }
+#endif
+
     /* ---------------------------------------------------------------------- */
     /* entire rank-cncol update, done as a sequence of rank-k updates */
     /* ---------------------------------------------------------------------- */
@@ -1590,5 +1903,250 @@ int CHOLMOD(updown_mask2)
     DEBUG (CHOLMOD(dump_factor) (L, "output L for updown", Common)) ;
     return (TRUE) ;
 }
+
+
+/* ========================================================================== */
+/* === cholmod_updown_batch ================================================= */
+/* ========================================================================== */
+
+/* Computes the solutions of m independent problems (LDL'+ck*ck')x=b (an
+ * update) or (LDL'-ck*ck')x=b (a downdate), where ck = C(:,k), for k = 0 to
+ * m-1.  Each rank-1 update/downdate is applied to a copy of L, and L itself
+ * is unchanged (except that it is converted to a simplicial LDL' factor, if
+ * it isn't one already).  B is n-by-1 (the same right-hand-side for all
+ * problems) or n-by-m, and the solution of the kth problem is returned in
+ * X(:,k).  As in cholmod_updown, C, B, and X are in the permuted order of L.
+ *
+ * With Common->nthreads_max > 1, the problems are solved concurrently.  Each
+ * thread has its own copy of the numerical values of L, and all threads share
+ * the pattern of L.  Only the columns on the path of ck are modified, and
+ * these are restored from L afterwards, so the copy is made only once per
+ * thread.  If a column ck would change the pattern of L, that problem is
+ * solved afterwards with a copy of the whole factor and cholmod_updown.
+ */
+
+int CHOLMOD(updown_batch)
+(
+    /* ---- input ---- */
+    int update,		/* TRUE for update, FALSE for downdate */
+    cholmod_sparse *C,	/* n-by-m, the m rank-1 updates/downdates */
+    cholmod_factor *L,	/* factor to modify (a copy of it, that is) */
+    cholmod_dense *B,	/* n-by-1 or n-by-m right-hand-side */
+    /* ---- output --- */
+    cholmod_dense *X,	/* n-by-m solutions */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double fl = 0, alpha, *Bx, *Cx, *Lx, *Lxw, *Ww, *Xx, *Xk, *Bk, *Lkx, *W ;
+    cholmod_factor Lk, *L2 ;
+    cholmod_sparse *C2 ;
+    Int *Ci, *Cp, *Cnz, *Li, *Lp, *Lnz, *Fill, n, m, k, j, p, pp1, pp2, packed,
+	nthreads, bstride, tid ;
+    size_t lxsize, wsize ;
+    int ok = TRUE ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    RETURN_IF_NULL_COMMON (FALSE) ;
+    RETURN_IF_NULL (C, FALSE) ;
+    RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
+    RETURN_IF_NULL (B, FALSE) ;
+    RETURN_IF_NULL (X, FALSE) ;
+    RETURN_IF_XTYPE_INVALID (L, CHOLMOD_PATTERN, CHOLMOD_REAL, FALSE) ;
+    RETURN_IF_XTYPE_INVALID (C, CHOLMOD_REAL, CHOLMOD_REAL, FALSE) ;
+    RETURN_IF_XTYPE_INVALID (B, CHOLMOD_REAL, CHOLMOD_REAL, FALSE) ;
+    RETURN_IF_XTYPE_INVALID (X, CHOLMOD_REAL, CHOLMOD_REAL, FALSE) ;
+    n = L->n ;
+    m = C->ncol ;
+    if (!(C->sorted))
+    {
+	ERROR (CHOLMOD_INVALID, "C must have sorted columns") ;
+	return (FALSE) ;
+    }
+    if (n != (Int) (C->nrow))
+    {
+	ERROR (CHOLMOD_INVALID, "C and L dimensions do not match") ;
+	return (FALSE) ;
+    }
+    if (B->nrow != L->n || (B->ncol != 1 && B->ncol != C->ncol)
+	|| X->nrow != L->n || X->ncol != C->ncol)
+    {
+	ERROR (CHOLMOD_INVALID, "B and/or X invalid") ;
+	return (FALSE) ;
+    }
+    Common->status = CHOLMOD_OK ;
+    Common->modfl = 0 ;
+
+    if (m == 0 || n == 0)
+    {
+	/* nothing to do */
+	return (TRUE) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* convert to simplicial numeric LDL' factor, if not already */
+    /* ---------------------------------------------------------------------- */
+
+    if (L->xtype == CHOLMOD_PATTERN || L->is_super || L->is_ll) 
+    {
+	CHOLMOD(change_factor) (CHOLMOD_REAL, FALSE, FALSE, FALSE, FALSE, L,
+		Common) ;
+	if (Common->status < CHOLMOD_OK)
+	{
+	    /* out of memory, L is returned unchanged */
+	    return (FALSE) ;
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate workspace */
+    /* ---------------------------------------------------------------------- */
+
+    nthreads = 1 ;
+#ifdef _OPENMP
+    nthreads = MAX (1, MIN (Common->nthreads_max, m)) ;
+#endif
+
+    lxsize = CHOLMOD(mult_size_t) (L->nzmax, nthreads, &ok) ;
+    wsize = CHOLMOD(mult_size_t) (n, nthreads, &ok) ;
+    if (!ok)
+    {
+	ERROR (CHOLMOD_TOO_LARGE, "problem too large") ;
+	return (FALSE) ;
+    }
+    Lxw = CHOLMOD(malloc) (lxsize, sizeof (double), Common) ;
+    Ww = CHOLMOD(calloc) (wsize, sizeof (double), Common) ;
+    Fill = CHOLMOD(malloc) (m, sizeof (Int), Common) ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	CHOLMOD(free) (lxsize, sizeof (double), Lxw, Common) ;
+	CHOLMOD(free) (wsize, sizeof (double), Ww, Common) ;
+	CHOLMOD(free) (m, sizeof (Int), Fill, Common) ;
+	return (FALSE) ;
+    }
+
+    Ci = C->i ;
+    Cx = C->x ;
+    Cp = C->p ;
+    Cnz = C->nz ;
+    packed = C->packed ;
+    Li = L->i ;
+    Lx = L->x ;
+    Lp = L->p ;
+    Lnz = L->nz ;
+    Bx = B->x ;
+    Xx = X->x ;
+    bstride = (B->ncol > 1) ? B->d : 0 ;
+
+    /* ---------------------------------------------------------------------- */
+    /* solve the problems that do not change the pattern of L */
+    /* ---------------------------------------------------------------------- */
+
+#pragma omp parallel num_threads(nthreads) \
+    private (Lk, Lkx, W, Xk, Bk, alpha, tid, k, j, p, pp1, pp2)
+    {
+	tid = 0 ;
+#ifdef _OPENMP
+	tid = omp_get_thread_num ( ) ;
+#endif
+	/* a shallow copy of L, with its own numerical values */
+	Lk = *L ;
+	Lkx = Lxw + L->nzmax * ((size_t) tid) ;
+	Lk.x = Lkx ;
+	W = Ww + n * ((size_t) tid) ;
+	for (p = 0 ; p < (Int) L->nzmax ; p++)
+	{
+	    Lkx [p] = Lx [p] ;
+	}
+
+#pragma omp for schedule (dynamic,1) reduction (+:fl)
+	for (k = 0 ; k < m ; k++)
+	{
+	    pp1 = Cp [k] ;
+	    pp2 = (packed) ? (Cp [k+1]) : (pp1 + Cnz [k]) ;
+	    Xk = Xx + k * X->d ;
+	    Bk = Bx + k * bstride ;
+	    for (j = 0 ; j < n ; j++)
+	    {
+		Xk [j] = Bk [j] ;
+	    }
+	    Fill [k] = !no_fill (L, Ci, pp1, pp2) ;
+	    if (Fill [k])
+	    {
+		continue ;
+	    }
+	    if (pp2 > pp1)
+	    {
+		for (p = pp1 ; p < pp2 ; p++)
+		{
+		    W [Ci [p]] = Cx [p] ;
+		}
+		alpha = 1 ;
+		updown_1_1 (update, Ci [pp1], n-1, &alpha, W, &Lk, Common) ;
+	    }
+	    ldl_solve (&Lk, Lkx, Xk) ;
+	    /* restore the columns on the path */
+	    for (j = (pp2 > pp1) ? Ci [pp1] : EMPTY ; j != EMPTY ; )
+	    {
+		fl += 6 + 4 * (double) Lnz [j] ;
+		for (p = Lp [j] ; p < Lp [j] + Lnz [j] ; p++)
+		{
+		    Lkx [p] = Lx [p] ;
+		}
+		j = (Lnz [j] > 1) ? (Li [Lp [j] + 1]) : EMPTY ;
+	    }
+	}
+    }
+
+    CHOLMOD(free) (lxsize, sizeof (double), Lxw, Common) ;
+    CHOLMOD(free) (wsize, sizeof (double), Ww, Common) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* solve the rest with a copy of L and cholmod_updown */
+    /* ---------------------------------------------------------------------- */
+
+    for (k = 0 ; ok && k < m ; k++)
+    {
+	if (!Fill [k])
+	{
+	    continue ;
+	}
+	pp1 = Cp [k] ;
+	pp2 = (packed) ? (Cp [k+1]) : (pp1 + Cnz [k]) ;
+	C2 = CHOLMOD(allocate_sparse) (n, 1, pp2 - pp1, TRUE, TRUE, 0,
+		CHOLMOD_REAL, Common) ;
+	L2 = CHOLMOD(copy_factor) (L, Common) ;
+	if (Common->status == CHOLMOD_OK)
+	{
+	    ((Int *) C2->p) [0] = 0 ;
+	    ((Int *) C2->p) [1] = pp2 - pp1 ;
+	    for (p = pp1 ; p < pp2 ; p++)
+	    {
+		((Int *) C2->i) [p-pp1] = Ci [p] ;
+		((double *) C2->x) [p-pp1] = Cx [p] ;
+	    }
+	    ok = CHOLMOD(updown) (update, C2, L2, Common) ;
+	    fl += Common->modfl ;
+	    if (ok)
+	    {
+		ldl_solve (L2, L2->x, Xx + k * X->d) ;
+	    }
+	}
+	else
+	{
+	    ok = FALSE ;
+	}
+	CHOLMOD(free_sparse) (&C2, Common) ;
+	CHOLMOD(free_factor) (&L2, Common) ;
+    }
+
+    CHOLMOD(free) (m, sizeof (Int), Fill, Common) ;
+    Common->modfl = fl ;
+    return (ok) ;
+}
 #endif
 #endif
@@ -34,6 +34,8 @@
  * FUTURE WORK: perform a supernodal LDL' factorization if L->is_ll is FALSE.
  *
  * Uses BLAS routines dsyrk, dgemm, dtrsm, and the LAPACK routine dpotrf.
+ * In the real case, supernodes with at most Common->small_super columns use
+ * built-in kernels instead (see small_syrk, small_potrf, and small_trsm below).
  * The supernodal solver uses BLAS routines dtrsv, dgemv, dtrsm, and dgemm.
  *
  * If the matrix is not positive definite the routine returns TRUE, but sets
@@ -62,6 +64,416 @@
 #ifdef GPU_BLAS
 #include "cholmod_gpu.h"
 #endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* ========================================================================== */
+/* === super_subtrees ======================================================= */
+/* ========================================================================== */
+
+/* Splits the supernodal elimination tree into independent subtrees, for the
+ * task-parallel factorization.  The work in a subtree is estimated as the sum
+ * of nscol*nsrow^2 over its supernodes.  Starting at the roots, a subtree
+ * with more than 1/(4*nthreads) of the total work is split: its root is left
+ * to the top of the tree (factorized after all the subtrees) and each of its
+ * children is considered in turn.
+ *
+ * On output, Owner [s] is the subtree containing supernode s, or EMPTY if s
+ * is in the top of the tree, and the supernodes of subtree t are
+ * Tlist [Tstart [t] ... Tstart [t+1]-1], in increasing order.  Returns the
+ * number of subtrees, or zero if there are fewer than two.
+ *
+ * Workspace: Iwork of size 4*nsuper, W of size nsuper.
+ */
+
+static Int super_subtrees
+(
+    /* ---- input ---- */
+    Int nsuper,
+    Int *Super,
+    Int *Lpi,
+    Int *Ls,
+    Int *SuperMap,
+    Int nthreads,
+    /* ---- output --- */
+    Int *Owner,		/* size nsuper */
+    Int *Tstart,	/* size nsuper+1 */
+    Int *Tlist,		/* size nsuper */
+    /* -- workspace -- */
+    Int *Iwork,
+    double *W
+)
+{
+    double total, limit ;
+    Int *Sparent, *Child, *Sibling, *Stack, s, c, t, nscol, nsrow, ntasks,
+	top ;
+
+    Sparent = Iwork ;			/* size nsuper */
+    Child   = Iwork + nsuper ;		/* size nsuper */
+    Sibling = Iwork + 2*nsuper ;	/* size nsuper */
+    Stack   = Iwork + 3*nsuper ;	/* size nsuper */
+
+    /* ---------------------------------------------------------------------- */
+    /* find the supernodal etree and the work in each subtree */
+    /* ---------------------------------------------------------------------- */
+
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	W [s] = 0 ;
+	Child [s] = EMPTY ;
+    }
+    total = 0 ;
+    for (s = nsuper-1 ; s >= 0 ; s--)
+    {
+	nscol = Super [s+1] - Super [s] ;
+	nsrow = Lpi [s+1] - Lpi [s] ;
+	Sparent [s] = (nsrow > nscol) ? SuperMap [Ls [Lpi [s] + nscol]] : EMPTY;
+	ASSERT (Sparent [s] == EMPTY || Sparent [s] > s) ;
+	if (Sparent [s] != EMPTY)
+	{
+	    Sibling [s] = Child [Sparent [s]] ;
+	    Child [Sparent [s]] = s ;
+	}
+    }
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	/* the children of s come before s */
+	nscol = Super [s+1] - Super [s] ;
+	nsrow = Lpi [s+1] - Lpi [s] ;
+	W [s] += ((double) nscol) * ((double) nsrow) * ((double) nsrow) ;
+	total += ((double) nscol) * ((double) nsrow) * ((double) nsrow) ;
+	if (Sparent [s] != EMPTY)
+	{
+	    W [Sparent [s]] += W [s] ;
+	}
+    }
+    limit = total / (4 * (double) nthreads) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* split the large subtrees, starting at the roots */
+    /* ---------------------------------------------------------------------- */
+
+    top = 0 ;
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	Owner [s] = EMPTY ;
+	if (Sparent [s] == EMPTY)
+	{
+	    Stack [top++] = s ;
+	}
+    }
+    ntasks = 0 ;
+    while (top > 0)
+    {
+	s = Stack [--top] ;
+	if (W [s] > limit && Child [s] != EMPTY)
+	{
+	    /* s goes to the top of the tree; consider its children */
+	    for (c = Child [s] ; c != EMPTY ; c = Sibling [c])
+	    {
+		Stack [top++] = c ;
+	    }
+	}
+	else
+	{
+	    /* s is the root of a subtree */
+	    Owner [s] = ntasks++ ;
+	}
+    }
+    if (ntasks < 2)
+    {
+	return (0) ;
+    }
+
+    /* every other supernode belongs to the subtree of its parent */
+    for (s = nsuper-1 ; s >= 0 ; s--)
+    {
+	if (Owner [s] == EMPTY && Sparent [s] != EMPTY)
+	{
+	    Owner [s] = Owner [Sparent [s]] ;
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* list the supernodes of each subtree */
+    /* ---------------------------------------------------------------------- */
+
+    for (t = 0 ; t <= ntasks ; t++)
+    {
+	Tstart [t] = 0 ;
+    }
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	if (Owner [s] != EMPTY)
+	{
+	    Tstart [Owner [s] + 1]++ ;
+	}
+    }
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	Tstart [t+1] += Tstart [t] ;
+	Stack [t] = Tstart [t] ;
+    }
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	if (Owner [s] != EMPTY)
+	{
+	    Tlist [Stack [Owner [s]]++] = s ;
+	}
+    }
+    return (ntasks) ;
+}
+
+/* ========================================================================== */
+/* === super_path =========================================================== */
+/* ========================================================================== */
+
+/* For a partial refactorization, finds the supernodes that contain the columns
+ * Path [0..pathlen-1] (see cholmod_compute_path), and places each of the other
+ * supernodes in the link list of the first supernode on the path that it
+ * updates.  The other supernodes are not factorized again.  Returns Owner, of
+ * size nsuper, where Owner [s] is EMPTY if supernode s is on the path, or NULL
+ * if out of memory (this is not an error; the whole matrix is then factorized
+ * instead).
+ */
+
+static Int *super_path
+(
+    /* ---- input ---- */
+    Int *Path,
+    Int pathlen,
+    cholmod_factor *L,
+    Int *SuperMap,
+    /* ---- in/out --- */
+    Int *Head,
+    Int *Next,
+    Int *Lpos,
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    Int *Owner, *Super, *Ls, *Lpi, nsuper, d, s, t, p, psi, nsrow ;
+    int try_catch ;
+
+    nsuper = L->nsuper ;
+    Super = L->super ;
+    Ls = L->s ;
+    Lpi = L->pi ;
+
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Owner = CHOLMOD(malloc) (nsuper, sizeof (Int), Common) ;
+    Common->try_catch = try_catch ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	Common->status = CHOLMOD_OK ;
+	return (NULL) ;
+    }
+
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	Owner [s] = 0 ;
+    }
+    for (t = 0 ; t < pathlen ; t++)
+    {
+	Owner [SuperMap [Path [t]]] = EMPTY ;
+    }
+
+    /* the path is closed under ancestors, so the rows of d that are in
+     * supernodes on the path come after all of its other rows */
+    for (d = 0 ; d < nsuper ; d++)
+    {
+	if (Owner [d] != EMPTY)
+	{
+	    psi = Lpi [d] ;
+	    nsrow = Lpi [d+1] - psi ;
+	    for (p = Super [d+1] - Super [d] ;
+		 p < nsrow && Owner [SuperMap [Ls [psi + p]]] != EMPTY ; p++) ;
+	    Lpos [d] = p ;
+	    if (p < nsrow)
+	    {
+		s = SuperMap [Ls [psi + p]] ;
+		Next [d] = Head [s] ;
+		Head [s] = d ;
+	    }
+	}
+    }
+    return (Owner) ;
+}
+
+/* ========================================================================== */
+/* === small supernode kernels ============================================== */
+/* ========================================================================== */
+
+/* For a supernode with only a few columns, the cost of calling the BLAS and
+ * LAPACK dominates the few flops each call does.  These kernels replace
+ * dsyrk/dgemm, dpotrf, and dtrsm in the real case, for supernodes with at most
+ * Common->small_super columns.  The innermost loops run down contiguous columns
+ * and combine four columns at a time, so the compiler can vectorize them and
+ * keep the partial sums in registers.
+ */
+
+/* C = A*A(0:n1-1,:)', where A is n2-by-k with leading dimension lda.  Only the
+ * lower triangular part C(i,j), i >= j, is computed.  Replaces dsyrk for
+ * C1 = L1*L1' and dgemm for C2 = L2*L1'. */
+
+static void small_syrk
+(
+    Int n1,
+    Int n2,
+    Int k,
+    double *A,
+    Int lda,
+    double *C,	    /* output, leading dimension ldc */
+    Int ldc
+)
+{
+    double *a0, *a1, *a2, *a3, *c, b0, b1, b2, b3 ;
+    Int i, j, t ;
+
+    for (j = 0 ; j < n1 ; j++)
+    {
+	c = C + j*ldc ;
+	for (i = j ; i < n2 ; i++)
+	{
+	    c [i] = 0 ;
+	}
+	for (t = 0 ; t + 4 <= k ; t += 4)
+	{
+	    a0 = A + t*lda ;
+	    a1 = a0 + lda ;
+	    a2 = a1 + lda ;
+	    a3 = a2 + lda ;
+	    b0 = a0 [j] ;
+	    b1 = a1 [j] ;
+	    b2 = a2 [j] ;
+	    b3 = a3 [j] ;
+	    for (i = j ; i < n2 ; i++)
+	    {
+		c [i] += a0 [i] * b0 + a1 [i] * b1 + a2 [i] * b2 + a3 [i] * b3 ;
+	    }
+	}
+	for ( ; t < k ; t++)
+	{
+	    a0 = A + t*lda ;
+	    b0 = a0 [j] ;
+	    for (i = j ; i < n2 ; i++)
+	    {
+		c [i] += a0 [i] * b0 ;
+	    }
+	}
+    }
+}
+
+/* B (:,j) -= A (:,0:j-1) * L (j,0:j-1)', for rows i1 to m-1 of B and A, where
+ * B is column j of A itself (small_potrf) or of a separate matrix (small_trsm).
+ */
+
+static void small_cmod
+(
+    Int i1,
+    Int m,
+    Int j,
+    double *A,	    /* columns 0 to j-1, leading dimension lda */
+    Int lda,
+    double *L,	    /* row j of L is L [j], L [j+ldl], ... */
+    Int ldl,
+    double *b	    /* column to update */
+)
+{
+    double *a0, *a1, *a2, *a3, l0, l1, l2, l3 ;
+    Int i, t ;
+
+    for (t = 0 ; t + 4 <= j ; t += 4)
+    {
+	a0 = A + t*lda ;
+	a1 = a0 + lda ;
+	a2 = a1 + lda ;
+	a3 = a2 + lda ;
+	l0 = L [j + t*ldl] ;
+	l1 = L [j + (t+1)*ldl] ;
+	l2 = L [j + (t+2)*ldl] ;
+	l3 = L [j + (t+3)*ldl] ;
+	for (i = i1 ; i < m ; i++)
+	{
+	    b [i] -= a0 [i] * l0 + a1 [i] * l1 + a2 [i] * l2 + a3 [i] * l3 ;
+	}
+    }
+    for ( ; t < j ; t++)
+    {
+	a0 = A + t*lda ;
+	l0 = L [j + t*ldl] ;
+	for (i = i1 ; i < m ; i++)
+	{
+	    b [i] -= a0 [i] * l0 ;
+	}
+    }
+}
+
+/* Cholesky factorization of the n-by-n lower triangular part of A (leading
+ * dimension lda), in place.  Returns zero if successful.  Otherwise, as
+ * dpotrf, returns j+1 if the jth pivot is not positive, with the factorization
+ * incomplete.  Replaces dpotrf. */
+
+static Int small_potrf
+(
+    Int n,
+    double *A,
+    Int lda
+)
+{
+    double *c, d ;
+    Int i, j ;
+
+    for (j = 0 ; j < n ; j++)
+    {
+	c = A + j*lda ;
+	small_cmod (j, n, j, A, lda, A, lda, c) ;
+	d = c [j] ;
+	if (!(d > 0))
+	{
+	    return (j+1) ;	/* not positive definite, or NaN */
+	}
+	d = sqrt (d) ;
+	c [j] = d ;
+	d = 1 / d ;
+	for (i = j+1 ; i < n ; i++)
+	{
+	    c [i] *= d ;
+	}
+    }
+    return (0) ;
+}
+
+/* Solve X*L' = B, where B is m-by-n with leading dimension ldb, and L is n-by-n
+ * lower triangular with leading dimension ldl.  B is overwritten with X.
+ * Replaces dtrsm ("R", "L", "C", "N"). */
+
+static void small_trsm
+(
+    Int m,
+    Int n,
+    double *L,
+    Int ldl,
+    double *B,
+    Int ldb
+)
+{
+    double *c, d ;
+    Int i, j ;
+
+    for (j = 0 ; j < n ; j++)
+    {
+	c = B + j*ldb ;
+	small_cmod (0, m, j, B, ldb, L, ldl, c) ;
+	d = 1 / L [j + j*ldl] ;
+	for (i = 0 ; i < m ; i++)
+	{
+	    c [i] *= d ;
+	}
+    }
+}
 
 /* ========================================================================== */
 /* === TEMPLATE codes for GPU and regular numeric factorization ============= */
@@ -105,6 +517,36 @@ int CHOLMOD(super_numeric)
     /* --------------- */
     cholmod_common *Common
 )
+{
+    return (CHOLMOD(super_numeric_path) (A, F, beta, NULL, 0, L, Common)) ;
+}
+
+/* ========================================================================== */
+/* === cholmod_super_numeric_path =========================================== */
+/* ========================================================================== */
+
+/* Same as cholmod_super_numeric, except that if Path is not NULL, only the
+ * supernodes that contain the columns Path [0..pathlen-1] of L are factorized
+ * again.  Path must be closed under ancestors in the elimination tree, as
+ * computed by cholmod_compute_path, L must be a numeric factor of a matrix
+ * with the same pattern as A (with L->minor = n), and only the columns of A
+ * (or rows of F) on the path may differ from that matrix.  The GPU is not
+ * used for a partial refactorization.
+ */
+
+int CHOLMOD(super_numeric_path)
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,	/* matrix to factorize */
+    cholmod_sparse *F,	/* F = A' or A(:,f)' */
+    double beta [2],	/* beta*I is added to diagonal of matrix to factorize */
+    Int *Path,		/* columns of L to refactorize; NULL for all */
+    size_t pathlen,	/* size of Path */
+    /* ---- in/out --- */
+    cholmod_factor *L,	/* factorization */
+    /* --------------- */
+    cholmod_common *Common
+)
 {
     cholmod_dense *C ;
     Int *Super, *Map, *SuperMap ;
@@ -119,6 +561,7 @@ int CHOLMOD(super_numeric)
 
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_NULL (A, FALSE) ;
     RETURN_IF_XTYPE_INVALID (A, CHOLMOD_REAL, CHOLMOD_ZOMPLEX, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_PATTERN, CHOLMOD_COMPLEX, FALSE) ;
@@ -162,6 +605,12 @@ int CHOLMOD(super_numeric)
 	ERROR (CHOLMOD_INVALID, "L not supernodal") ;
 	return (FALSE) ;
     }
+    if (Path != NULL && (L->xtype == CHOLMOD_PATTERN || L->minor < L->n
+	|| pathlen > L->n))
+    {
+	ERROR (CHOLMOD_INVALID, "L or path invalid for partial factorization");
+	return (FALSE) ;
+    }
     if (L->xtype != CHOLMOD_PATTERN)
     {
 	if (! ((A->xtype == CHOLMOD_REAL    && L->xtype == CHOLMOD_REAL)
@@ -281,16 +730,19 @@ int CHOLMOD(super_numeric)
     switch (A->xtype)
     {
 	case CHOLMOD_REAL:
-	    ok = r_cholmod_super_numeric (A, F, beta, L, C, Common) ;
+	    ok = r_cholmod_super_numeric (A, F, beta, Path, pathlen, L, C,
+		Common) ;
 	    break ;
 
 	case CHOLMOD_COMPLEX:
-	    ok = c_cholmod_super_numeric (A, F, beta, L, C, Common) ;
+	    ok = c_cholmod_super_numeric (A, F, beta, Path, pathlen, L, C,
+		Common) ;
 	    break ;
 
 	case CHOLMOD_ZOMPLEX:
 	    /* This operates on complex L, not zomplex */
-	    ok = z_cholmod_super_numeric (A, F, beta, L, C, Common) ;
+	    ok = z_cholmod_super_numeric (A, F, beta, Path, pathlen, L, C,
+		Common) ;
 	    break ;
     }
 
@@ -17,6 +17,9 @@
 
 #include "cholmod_internal.h"
 #include "cholmod_supernodal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /* ========================================================================== */
 /* === TEMPLATE ============================================================= */
@@ -27,6 +30,566 @@
 #define COMPLEX
 #include "t_cholmod_super_solve.c"
 
+#ifdef _OPENMP
+
+/* ========================================================================== */
+/* === super_tasks ========================================================== */
+/* ========================================================================== */
+
+/* Returns the subtree schedule of the supernodes for the parallel solves,
+ * L->tasks, creating it if it does not exist or if it was created for another
+ * number of threads.  As in the parallel supernodal numeric factorization, the
+ * supernodal etree is split into independent subtrees: starting at the roots,
+ * a subtree with more than 1/(4*nthreads) of the total work (the sum of
+ * nscol*nsrow over its supernodes) is split, its root is left to the top of
+ * the tree, and each of its children is considered in turn.  L->tasks has
+ * size 2*nsuper+3, and holds:
+ *
+ *	Tasks [0]	    the number of subtrees, ntasks (zero if fewer than 2)
+ *	Tasks [1]	    the number of threads the schedule is for
+ *	Tstart [0..ntasks]  the supernodes of subtree t are Tlist [Tstart [t] ...
+ *			    Tstart [t+1]-1], in increasing order, where
+ *			    Tstart = Tasks + 2.  The root of t is the last one.
+ *	Tlist [0..nsuper-1] followed by the supernodes of the top of the tree,
+ *			    Tlist [Tstart [ntasks] ... nsuper-1], in increasing
+ *			    order.
+ *
+ * L->tasks depends only on the supernodal pattern of L, which does not change
+ * until L is converted to a simplicial factor (which frees L->tasks).  Returns
+ * NULL if out of memory, without setting Common->status.
+ */
+
+static Int *super_tasks (cholmod_factor *L, Int nthreads,
+    cholmod_common *Common)
+{
+    double total, limit, *W ;
+    Int *Tasks, *Tstart, *Tlist, *Iw, *Sparent, *Child, *Sibling, *Stack,
+	*Owner, *SuperMap, *Super, *Lpi, *Ls, n, nsuper, s, c, k, t, nscol,
+	nsrow, ntasks, top ;
+    size_t iwsize ;
+    int ok = TRUE, try_catch ;
+
+    nsuper = L->nsuper ;
+    Tasks = L->tasks ;
+    if (Tasks != NULL && Tasks [1] == nthreads)
+    {
+	return (Tasks) ;
+    }
+    L->tasks = CHOLMOD(free) (2*nsuper+3, sizeof (Int), L->tasks, Common) ;
+
+    n = L->n ;
+    Super = L->super ;
+    Lpi = L->pi ;
+    Ls = L->s ;
+
+    iwsize = CHOLMOD(mult_size_t) (nsuper, 5, &ok) ;
+    iwsize = CHOLMOD(add_size_t) (iwsize, n, &ok) ;
+    if (!ok)
+    {
+	return (NULL) ;
+    }
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Tasks = CHOLMOD(malloc) (2*nsuper+3, sizeof (Int), Common) ;
+    Iw = CHOLMOD(malloc) (iwsize, sizeof (Int), Common) ;
+    W = CHOLMOD(malloc) (nsuper, sizeof (double), Common) ;
+    Common->try_catch = try_catch ;
+    if (Common->status < CHOLMOD_OK)
+    {
+	Common->status = CHOLMOD_OK ;
+	CHOLMOD(free) (2*nsuper+3, sizeof (Int), Tasks, Common) ;
+	CHOLMOD(free) (iwsize, sizeof (Int), Iw, Common) ;
+	CHOLMOD(free) (nsuper, sizeof (double), W, Common) ;
+	return (NULL) ;
+    }
+
+    Tstart = Tasks + 2 ;		/* size nsuper+1 */
+    Tlist = Tasks + nsuper + 3 ;	/* size nsuper */
+    Sparent = Iw ;			/* size nsuper */
+    Child = Iw + nsuper ;		/* size nsuper */
+    Sibling = Iw + 2*nsuper ;		/* size nsuper */
+    Stack = Iw + 3*nsuper ;		/* size nsuper */
+    Owner = Iw + 4*nsuper ;		/* size nsuper */
+    SuperMap = Iw + 5*nsuper ;		/* size n */
+
+    /* ---------------------------------------------------------------------- */
+    /* find the supernodal etree and the work in each subtree */
+    /* ---------------------------------------------------------------------- */
+
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	for (k = Super [s] ; k < Super [s+1] ; k++)
+	{
+	    SuperMap [k] = s ;
+	}
+	W [s] = 0 ;
+	Child [s] = EMPTY ;
+    }
+    total = 0 ;
+    for (s = nsuper-1 ; s >= 0 ; s--)
+    {
+	nscol = Super [s+1] - Super [s] ;
+	nsrow = Lpi [s+1] - Lpi [s] ;
+	Sparent [s] = (nsrow > nscol) ? SuperMap [Ls [Lpi [s] + nscol]] : EMPTY;
+	ASSERT (Sparent [s] == EMPTY || Sparent [s] > s) ;
+	if (Sparent [s] != EMPTY)
+	{
+	    Sibling [s] = Child [Sparent [s]] ;
+	    Child [Sparent [s]] = s ;
+	}
+    }
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	/* the children of s come before s */
+	nscol = Super [s+1] - Super [s] ;
+	nsrow = Lpi [s+1] - Lpi [s] ;
+	W [s] += ((double) nscol) * ((double) nsrow) ;
+	total += ((double) nscol) * ((double) nsrow) ;
+	if (Sparent [s] != EMPTY)
+	{
+	    W [Sparent [s]] += W [s] ;
+	}
+    }
+    limit = total / (4 * (double) nthreads) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* split the large subtrees, starting at the roots */
+    /* ---------------------------------------------------------------------- */
+
+    top = 0 ;
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	Owner [s] = EMPTY ;
+	if (Sparent [s] == EMPTY)
+	{
+	    Stack [top++] = s ;
+	}
+    }
+    ntasks = 0 ;
+    while (top > 0)
+    {
+	s = Stack [--top] ;
+	if (W [s] > limit && Child [s] != EMPTY)
+	{
+	    /* s goes to the top of the tree; consider its children */
+	    for (c = Child [s] ; c != EMPTY ; c = Sibling [c])
+	    {
+		Stack [top++] = c ;
+	    }
+	}
+	else
+	{
+	    /* s is the root of a subtree */
+	    Owner [s] = ntasks++ ;
+	}
+    }
+    if (ntasks < 2)
+    {
+	ntasks = 0 ;
+    }
+
+    /* every other supernode belongs to the subtree of its parent */
+    for (s = nsuper-1 ; s >= 0 ; s--)
+    {
+	if (ntasks == 0)
+	{
+	    Owner [s] = EMPTY ;
+	}
+	else if (Owner [s] == EMPTY && Sparent [s] != EMPTY)
+	{
+	    Owner [s] = Owner [Sparent [s]] ;
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* list the supernodes of each subtree, and then the top of the tree */
+    /* ---------------------------------------------------------------------- */
+
+    for (t = 0 ; t <= ntasks ; t++)
+    {
+	Tstart [t] = 0 ;
+    }
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	if (Owner [s] != EMPTY)
+	{
+	    Tstart [Owner [s] + 1]++ ;
+	}
+    }
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	Tstart [t+1] += Tstart [t] ;
+	Stack [t] = Tstart [t] ;
+    }
+    k = Tstart [ntasks] ;
+    for (s = 0 ; s < nsuper ; s++)
+    {
+	if (Owner [s] != EMPTY)
+	{
+	    Tlist [Stack [Owner [s]]++] = s ;
+	}
+	else
+	{
+	    Tlist [k++] = s ;
+	}
+    }
+    Tasks [0] = ntasks ;
+    Tasks [1] = nthreads ;
+
+    CHOLMOD(free) (iwsize, sizeof (Int), Iw, Common) ;
+    CHOLMOD(free) (nsuper, sizeof (double), W, Common) ;
+    L->tasks = Tasks ;
+    return (Tasks) ;
+}
+
+
+/* ========================================================================== */
+/* === super_lsolve1 ======================================================== */
+/* ========================================================================== */
+
+/* Solves L1*x1 = x1 for a single supernode s of a real L, and updates x at the
+ * rows below, as the sequential forward solve does.  Rows i >= klast are
+ * updated in Wx instead of Xx. */
+
+static void super_lsolve1
+(
+    cholmod_factor *L,
+    Int s,
+    double *Xx,
+    double *Wx,
+    Int klast,
+    double *Ex,
+    cholmod_common *Common
+)
+{
+    double minus_one [2], one [2], *Lx ;
+    Int *Lpi, *Lpx, *Ls, *Super ;
+    Int k1, k2, psi, psend, psx, nsrow, nscol, nsrow2, ps2, ii, i ;
+
+    Lpi = L->pi ;
+    Lpx = L->px ;
+    Ls = L->s ;
+    Super = L->super ;
+    Lx = L->x ;
+    minus_one [0] = -1.0 ;
+    minus_one [1] = 0 ;
+    one [0] = 1.0 ;
+    one [1] = 0 ;
+
+    k1 = Super [s] ;
+    k2 = Super [s+1] ;
+    psi = Lpi [s] ;
+    psend = Lpi [s+1] ;
+    psx = Lpx [s] ;
+    nsrow = psend - psi ;
+    nscol = k2 - k1 ;
+    nsrow2 = nsrow - nscol ;
+    ps2 = psi + nscol ;
+
+    /* gather X into E */
+    for (ii = 0 ; ii < nsrow2 ; ii++)
+    {
+	i = Ls [ps2 + ii] ;
+	Ex [ii] = (i < klast) ? Xx [i] : Wx [i] ;
+    }
+
+    /* solve L1*x1 (that is, x1 = L1\x1) */
+    BLAS_dtrsv ("L", "N", "N",
+	nscol,			    /* N:       L1 is nscol-by-nscol */
+	Lx + psx, nsrow,	    /* A, LDA:  L1 */
+	Xx + k1, 1) ;		    /* X, INCX: x1 */
+
+    /* E = E - L2*x1 */
+    BLAS_dgemv ("N",
+	nsrow2, nscol,		    /* M, N:    L2 is nsrow2-by-nscol */
+	minus_one,		    /* ALPHA:   -1 */
+	Lx + psx + nscol,	    /* A, LDA:  L2 */
+	nsrow,
+	Xx + k1, 1,		    /* X, INCX: x1 */
+	one,			    /* BETA:    1 */
+	Ex, 1) ;		    /* Y, INCY: E */
+
+    /* scatter E back into X */
+    for (ii = 0 ; ii < nsrow2 ; ii++)
+    {
+	i = Ls [ps2 + ii] ;
+	if (i < klast)
+	{
+	    Xx [i] = Ex [ii] ;
+	}
+	else
+	{
+	    Wx [i] = Ex [ii] ;
+	}
+    }
+}
+
+
+/* ========================================================================== */
+/* === super_ltsolve1 ======================================================= */
+/* ========================================================================== */
+
+/* Solves L1'*x1 = x1 - L2'*x2 for a single supernode s of a real L, as the
+ * sequential backsolve does. */
+
+static void super_ltsolve1
+(
+    cholmod_factor *L,
+    Int s,
+    double *Xx,
+    double *Ex,
+    cholmod_common *Common
+)
+{
+    double minus_one [2], one [2], *Lx ;
+    Int *Lpi, *Lpx, *Ls, *Super ;
+    Int k1, k2, psi, psend, psx, nsrow, nscol, nsrow2, ps2, ii ;
+
+    Lpi = L->pi ;
+    Lpx = L->px ;
+    Ls = L->s ;
+    Super = L->super ;
+    Lx = L->x ;
+    minus_one [0] = -1.0 ;
+    minus_one [1] = 0 ;
+    one [0] = 1.0 ;
+    one [1] = 0 ;
+
+    k1 = Super [s] ;
+    k2 = Super [s+1] ;
+    psi = Lpi [s] ;
+    psend = Lpi [s+1] ;
+    psx = Lpx [s] ;
+    nsrow = psend - psi ;
+    nscol = k2 - k1 ;
+    nsrow2 = nsrow - nscol ;
+    ps2 = psi + nscol ;
+
+    /* gather X into E */
+    for (ii = 0 ; ii < nsrow2 ; ii++)
+    {
+	Ex [ii] = Xx [Ls [ps2 + ii]] ;
+    }
+
+    /* x1 = x1 - L2'*E */
+    BLAS_dgemv ("C",
+	nsrow2, nscol,		    /* M, N:    L2 is nsrow2-by-nscol */
+	minus_one,		    /* ALPHA:   -1 */
+	Lx + psx + nscol,	    /* A, LDA:  L2 */
+	nsrow,
+	Ex, 1,			    /* X, INCX: Ex */
+	one,			    /* BETA:    1 */
+	Xx + k1, 1) ;		    /* Y, INCY: x1 */
+
+    /* solve L1'*x1 */
+    BLAS_dtrsv ("L", "C", "N",
+	nscol,			    /* N:       L1 is nscol-by-nscol */
+	Lx + psx, nsrow,	    /* A, LDA:  L1 */
+	Xx + k1, 1) ;		    /* X, INCX: x1 */
+}
+
+
+/* ========================================================================== */
+/* === super_plsolve ======================================================== */
+/* ========================================================================== */
+
+/* Solves Lx=b for a real supernodal L and a single right-hand-side, with up to
+ * Common->nthreads_max threads.  The subtrees of L->tasks are solved in
+ * parallel, and then the top of the tree.  Each thread keeps the updates of
+ * its subtree to the rows above the subtree in its own Wx; these rows are in
+ * the pattern of the root of the subtree.  When the subtree is done, they
+ * are saved in Eb and added into x (in the order of the subtrees, so the
+ * result does not depend on the number of threads that are used).  Returns
+ * FALSE if nothing was done (if out of memory, or if L has no independent
+ * subtrees).
+ */
+
+static int super_plsolve
+(
+    cholmod_factor *L,
+    cholmod_dense *X,
+    cholmod_common *Common
+)
+{
+    double *Xx, *Ww, *Wx, *Ew, *Ex, *Eb ;
+    Int *Tasks, *Tstart, *Tlist, *Eoff, *Super, *Lpi, *Ls ;
+    Int n, nsuper, nthreads, ntasks, t, r, kk, ii, p, ps2, nsrow2 ;
+    size_t wsize, ewsize, ebsize ;
+    int ok = TRUE, try_catch ;
+
+    n = L->n ;
+    nsuper = L->nsuper ;
+    nthreads = Common->nthreads_max ;
+    Tasks = super_tasks (L, nthreads, Common) ;
+    if (Tasks == NULL || Tasks [0] == 0)
+    {
+	return (FALSE) ;
+    }
+    ntasks = Tasks [0] ;
+    Tstart = Tasks + 2 ;
+    Tlist = Tasks + nsuper + 3 ;
+    Super = L->super ;
+    Lpi = L->pi ;
+    Ls = L->s ;
+    Xx = X->x ;
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate workspace */
+    /* ---------------------------------------------------------------------- */
+
+    wsize = CHOLMOD(mult_size_t) (n, nthreads, &ok) ;
+    ewsize = CHOLMOD(mult_size_t) (L->maxesize, nthreads, &ok) ;
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Eoff = CHOLMOD(malloc) (ntasks+1, sizeof (Int), Common) ;
+    Ww = (ok) ? CHOLMOD(calloc) (wsize, sizeof (double), Common) : NULL ;
+    Ew = (ok) ? CHOLMOD(malloc) (ewsize, sizeof (double), Common) : NULL ;
+    ebsize = 0 ;
+    if (Common->status == CHOLMOD_OK && ok)
+    {
+	/* Eb [Eoff [t] ...] holds the updates of subtree t to the rows of its
+	 * root r below the diagonal block */
+	for (t = 0 ; t < ntasks ; t++)
+	{
+	    r = Tlist [Tstart [t+1] - 1] ;
+	    Eoff [t] = ebsize ;
+	    ebsize += (Lpi [r+1] - Lpi [r]) - (Super [r+1] - Super [r]) ;
+	}
+	Eoff [ntasks] = ebsize ;
+    }
+    Eb = CHOLMOD(malloc) (ebsize, sizeof (double), Common) ;
+    Common->try_catch = try_catch ;
+    if (Common->status < CHOLMOD_OK || !ok)
+    {
+	Common->status = CHOLMOD_OK ;
+	CHOLMOD(free) (ntasks+1, sizeof (Int), Eoff, Common) ;
+	CHOLMOD(free) (wsize, sizeof (double), Ww, Common) ;
+	CHOLMOD(free) (ewsize, sizeof (double), Ew, Common) ;
+	CHOLMOD(free) (ebsize, sizeof (double), Eb, Common) ;
+	return (FALSE) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* solve the subtrees in parallel */
+    /* ---------------------------------------------------------------------- */
+
+#pragma omp parallel for num_threads(nthreads) schedule (dynamic,1) \
+    private (Wx, Ex, r, kk, ii, p, ps2, nsrow2)
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	Wx = Ww + n * ((size_t) omp_get_thread_num ( )) ;
+	Ex = Ew + L->maxesize * ((size_t) omp_get_thread_num ( )) ;
+	r = Tlist [Tstart [t+1] - 1] ;
+	for (kk = Tstart [t] ; kk < Tstart [t+1] ; kk++)
+	{
+	    super_lsolve1 (L, Tlist [kk], Xx, Wx, Super [r+1], Ex, Common) ;
+	}
+	/* save the updates to the rows above the subtree, and clear Wx */
+	ps2 = Lpi [r] + Super [r+1] - Super [r] ;
+	nsrow2 = Lpi [r+1] - ps2 ;
+	for (ii = 0, p = Eoff [t] ; ii < nsrow2 ; ii++, p++)
+	{
+	    Eb [p] = Wx [Ls [ps2 + ii]] ;
+	    Wx [Ls [ps2 + ii]] = 0 ;
+	}
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* add the updates into x, and solve the top of the tree */
+    /* ---------------------------------------------------------------------- */
+
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	r = Tlist [Tstart [t+1] - 1] ;
+	ps2 = Lpi [r] + Super [r+1] - Super [r] ;
+	nsrow2 = Lpi [r+1] - ps2 ;
+	for (ii = 0, p = Eoff [t] ; ii < nsrow2 ; ii++, p++)
+	{
+	    Xx [Ls [ps2 + ii]] += Eb [p] ;
+	}
+    }
+    for (kk = Tstart [ntasks] ; kk < nsuper ; kk++)
+    {
+	super_lsolve1 (L, Tlist [kk], Xx, NULL, n, Ew, Common) ;
+    }
+
+    CHOLMOD(free) (ntasks+1, sizeof (Int), Eoff, Common) ;
+    CHOLMOD(free) (wsize, sizeof (double), Ww, Common) ;
+    CHOLMOD(free) (ewsize, sizeof (double), Ew, Common) ;
+    CHOLMOD(free) (ebsize, sizeof (double), Eb, Common) ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === super_pltsolve ======================================================= */
+/* ========================================================================== */
+
+/* Solves L'x=b for a real supernodal L and a single right-hand-side, with up
+ * to Common->nthreads_max threads.  The top of the tree is solved first, and
+ * then the subtrees of L->tasks in parallel.  Each supernode only reads x at
+ * the rows of its ancestors, which are already known, so the result is the
+ * same as the sequential backsolve.  Returns FALSE if nothing was done.
+ */
+
+static int super_pltsolve
+(
+    cholmod_factor *L,
+    cholmod_dense *X,
+    cholmod_common *Common
+)
+{
+    double *Xx, *Ew ;
+    Int *Tasks, *Tstart, *Tlist ;
+    Int nsuper, nthreads, ntasks, t, kk ;
+    size_t ewsize ;
+    int ok = TRUE, try_catch ;
+
+    nsuper = L->nsuper ;
+    nthreads = Common->nthreads_max ;
+    Tasks = super_tasks (L, nthreads, Common) ;
+    if (Tasks == NULL || Tasks [0] == 0)
+    {
+	return (FALSE) ;
+    }
+    ntasks = Tasks [0] ;
+    Tstart = Tasks + 2 ;
+    Tlist = Tasks + nsuper + 3 ;
+    Xx = X->x ;
+
+    /* each thread gathers x into its own part of Ew */
+    ewsize = CHOLMOD(mult_size_t) (L->maxesize, nthreads, &ok) ;
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Ew = (ok) ? CHOLMOD(malloc) (ewsize, sizeof (double), Common) : NULL ;
+    Common->try_catch = try_catch ;
+    if (Common->status < CHOLMOD_OK || !ok)
+    {
+	Common->status = CHOLMOD_OK ;
+	return (FALSE) ;
+    }
+
+    for (kk = nsuper-1 ; kk >= Tstart [ntasks] ; kk--)
+    {
+	super_ltsolve1 (L, Tlist [kk], Xx, Ew, Common) ;
+    }
+
+#pragma omp parallel for num_threads(nthreads) schedule (dynamic,1) \
+    private (kk)
+    for (t = 0 ; t < ntasks ; t++)
+    {
+	for (kk = Tstart [t+1] - 1 ; kk >= Tstart [t] ; kk--)
+	{
+	    super_ltsolve1 (L, Tlist [kk], Xx,
+		Ew + L->maxesize * ((size_t) omp_get_thread_num ( )), Common) ;
+	}
+    }
+
+    CHOLMOD(free) (ewsize, sizeof (double), Ew, Common) ;
+    return (TRUE) ;
+}
+#endif
+
 /* ========================================================================== */
 /* === cholmod_super_lsolve ================================================= */
 /* ========================================================================== */
@@ -37,6 +600,11 @@
  *
  * The contents of the workspace E are undefined on both input and output.
  *
+ * If L is real, b has a single column, and Common->nthreads_max > 1, the
+ * independent supernodes are solved in parallel (see super_plsolve above).
+ * If L->x is held in a file (L->ooc > 0), the supernodes are instead solved
+ * in order, streaming L->x from the file.
+ *
  * workspace: none
  */
 
@@ -58,6 +626,7 @@ int CHOLMOD(super_lsolve)   /* TRUE if OK, FALSE if BLAS overflow occured */
 
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_NULL (X, FALSE) ;
     RETURN_IF_NULL (E, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_COMPLEX, FALSE) ;
@@ -104,6 +673,13 @@ int CHOLMOD(super_lsolve)   /* TRUE if OK, FALSE if BLAS overflow occured */
     {
 
 	case CHOLMOD_REAL:
+#ifdef _OPENMP
+	    if (Common->nthreads_max > 1 && X->ncol == 1 && L->ooc == 0 &&
+		super_plsolve (L, X, Common))
+	    {
+		break ;
+	    }
+#endif
 	    r_cholmod_super_lsolve (L, X, E, Common) ;
 	    break ;
 
@@ -130,6 +706,11 @@ int CHOLMOD(super_lsolve)   /* TRUE if OK, FALSE if BLAS overflow occured */
  *
  * The contents of the workspace E are undefined on both input and output.
  *
+ * If L is real, b has a single column, and Common->nthreads_max > 1, the
+ * independent supernodes are solved in parallel (see super_pltsolve above).
+ * If L->x is held in a file (L->ooc > 0), the supernodes are instead solved
+ * in order, streaming L->x from the file.
+ *
  * workspace: none
  */
 
@@ -151,6 +732,7 @@ int CHOLMOD(super_ltsolve)  /* TRUE if OK, FALSE if BLAS overflow occured */
 
     RETURN_IF_NULL_COMMON (FALSE) ;
     RETURN_IF_NULL (L, FALSE) ;
+    RETURN_IF_SINGLE (L, FALSE) ;
     RETURN_IF_NULL (X, FALSE) ;
     RETURN_IF_NULL (E, FALSE) ;
     RETURN_IF_XTYPE_INVALID (L, CHOLMOD_REAL, CHOLMOD_COMPLEX, FALSE) ;
@@ -197,6 +779,13 @@ int CHOLMOD(super_ltsolve)  /* TRUE if OK, FALSE if BLAS overflow occured */
     {
 
 	case CHOLMOD_REAL:
+#ifdef _OPENMP
+	    if (Common->nthreads_max > 1 && X->ncol == 1 && L->ooc == 0 &&
+		super_pltsolve (L, X, Common))
+	    {
+		break ;
+	    }
+#endif
 	    r_cholmod_super_ltsolve (L, X, E, Common) ;
 	    break ;
 
@@ -83,6 +83,504 @@
 #endif
 
 
+#ifdef _OPENMP
+
+/* ========================================================================== */
+/* === t_cholmod_super_subtree ============================================== */
+/* ========================================================================== */
+
+/* Factorizes the supernodes Slist [0..nslist-1] of one independent subtree,
+ * in increasing order, for the task-parallel factorization.  This is the CPU
+ * code of t_cholmod_super_numeric below, except that Map, RelativeMap, and C
+ * are private to the subtree, and that a supernode is not placed in the link
+ * list of an ancestor outside the subtree (Lpos is still updated, and
+ * t_cholmod_super_tasks links it once all the subtrees are done).  Head,
+ * Next, and Lpos are shared by all the subtrees, but each subtree modifies
+ * only the entries of its own supernodes.  The BLAS call counts and times in
+ * Common are not updated.
+ *
+ * Returns zero if successful, or the info from *potrf if a supernode is not
+ * positive definite. */
+
+static Int TEMPLATE (cholmod_super_subtree)
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,  /* matrix to factorize */
+    cholmod_sparse *F,  /* F = A' or A(:,f)' */
+    double beta [2],    /* beta*I is added to diagonal of matrix to factorize */
+    Int *Slist,         /* the supernodes of the subtree */
+    Int nslist,
+    Int task,           /* Owner [s] == task for all s in the subtree */
+    Int *Owner,         /* size nsuper */
+    Int *SuperMap,      /* size n */
+    /* ---- in/out --- */
+    cholmod_factor *L,  /* factorization */
+    Int *Head,          /* size nsuper, link lists of pending descendants */
+    Int *Next,          /* size nsuper */
+    Int *Lpos,          /* size nsuper */
+    /* -- workspace -- */
+    Int *Map,           /* size n */
+    Int *RelativeMap,   /* size n */
+    double *C,          /* size L->maxcsize */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double one [2], zero [2], fjk [2] ;
+    double *Lx, *Ax, *Fx, *Az, *Fz ;
+    Int *Super, *Ls, *Lpi, *Lpx, *Ap, *Ai, *Anz, *Fp, *Fi, *Fnz ;
+    Int i, j, k, p, pend, pf, pfend, q, imap, px, s, t, d, dnext, dancestor,
+        sparent, k1, k2, nscol, nsrow, nsrow2, psi, psx, kd1, kd2, ndcol,
+        ndrow, pdi, pdx, pdend, pdi1, pdi2, pdx1, ndrow1, ndrow2, ndrow3,
+        stype, Apacked, Fpacked, info ;
+
+    one [0] =  1.0 ;    /* ALPHA for *syrk, *herk, *gemm, and *trsm */
+    one [1] =  0. ;
+    zero [0] = 0. ;     /* BETA for *syrk, *herk, and *gemm */
+    zero [1] = 0. ;
+
+    Super = L->super ;
+    Ls = L->s ;
+    Lpi = L->pi ;
+    Lpx = L->px ;
+    Lx = L->x ;
+
+    stype = A->stype ;
+    Ap = A->p ;
+    Ai = A->i ;
+    Ax = A->x ;
+    Az = A->z ;
+    Anz = A->nz ;
+    Apacked = A->packed ;
+    if (stype != 0)
+    {
+        /* F not accessed */
+        Fp = NULL ;
+        Fi = NULL ;
+        Fx = NULL ;
+        Fz = NULL ;
+        Fnz = NULL ;
+        Fpacked = TRUE ;
+    }
+    else
+    {
+        Fp = F->p ;
+        Fi = F->i ;
+        Fx = F->x ;
+        Fz = F->z ;
+        Fnz = F->nz ;
+        Fpacked = F->packed ;
+    }
+
+    for (t = 0 ; t < nslist ; t++)
+    {
+
+        /* ------------------------------------------------------------------ */
+        /* get the size of supernode s, zero it, and construct its Map */
+        /* ------------------------------------------------------------------ */
+
+        s = Slist [t] ;
+        ASSERT (Owner [s] == task) ;
+        k1 = Super [s] ;
+        k2 = Super [s+1] ;
+        nscol = k2 - k1 ;
+        psi = Lpi [s] ;
+        psx = Lpx [s] ;
+        nsrow = Lpi [s+1] - psi ;
+
+        pend = psx + nsrow * nscol ;
+        for (p = psx ; p < pend ; p++)
+        {
+            L_CLEAR (Lx,p) ;
+        }
+        for (k = 0 ; k < nsrow ; k++)
+        {
+            Map [Ls [psi + k]] = k ;
+        }
+
+        /* ------------------------------------------------------------------ */
+        /* copy matrix into supernode s (lower triangular part only) */
+        /* ------------------------------------------------------------------ */
+
+        for (k = k1 ; k < k2 ; k++)
+        {
+            px = psx + (k-k1) * nsrow ;
+            if (stype != 0)
+            {
+                /* copy the kth column of A into the supernode */
+                p = Ap [k] ;
+                pend = (Apacked) ? (Ap [k+1]) : (p + Anz [k]) ;
+                for ( ; p < pend ; p++)
+                {
+                    i = Ai [p] ;
+                    imap = (i >= k) ? Map [i] : EMPTY ;
+                    if (imap >= 0 && imap < nsrow)
+                    {
+                        L_ASSIGN (Lx,(imap+px), Ax,Az,p) ;
+                    }
+                }
+            }
+            else
+            {
+                /* copy the kth column of A*F into the supernode */
+                pf = Fp [k] ;
+                pfend = (Fpacked) ? (Fp [k+1]) : (pf + Fnz [k]) ;
+                for ( ; pf < pfend ; pf++)
+                {
+                    j = Fi [pf] ;
+                    L_ASSIGN (fjk,0, Fx,Fz,pf) ;
+                    p = Ap [j] ;
+                    pend = (Apacked) ? (Ap [j+1]) : (p + Anz [j]) ;
+                    for ( ; p < pend ; p++)
+                    {
+                        i = Ai [p] ;
+                        imap = (i >= k) ? Map [i] : EMPTY ;
+                        if (imap >= 0 && imap < nsrow)
+                        {
+                            L_MULTADD (Lx,(imap+px), Ax,Az,p, fjk) ;
+                        }
+                    }
+                }
+            }
+        }
+
+        /* add beta to the diagonal of the supernode, if nonzero */
+        if (beta [0] != 0.0)
+        {
+            px = psx ;
+            for (k = k1 ; k < k2 ; k++)
+            {
+                L_ASSEMBLE (Lx,px, beta) ;
+                px += nsrow + 1 ;
+            }
+        }
+
+        /* ------------------------------------------------------------------ */
+        /* update supernode s with each pending descendant d */
+        /* ------------------------------------------------------------------ */
+
+        for (d = Head [s] ; d != EMPTY ; d = dnext)
+        {
+            ASSERT (Owner [d] == task) ;
+            kd1 = Super [d] ;
+            kd2 = Super [d+1] ;
+            ndcol = kd2 - kd1 ;
+            pdi = Lpi [d] ;
+            pdx = Lpx [d] ;
+            pdend = Lpi [d+1] ;
+            ndrow = pdend - pdi ;
+
+            /* rows Ls [pdi1 ... pdi2-1] of d are in the range k1 to k2-1 */
+            pdi1 = pdi + Lpos [d] ;
+            pdx1 = pdx + Lpos [d] ;
+            for (pdi2 = pdi1 ; pdi2 < pdend && Ls [pdi2] < k2 ; pdi2++) ;
+            ndrow1 = pdi2 - pdi1 ;
+            ndrow2 = pdend - pdi1 ;
+            ndrow3 = ndrow2 - ndrow1 ;
+
+            /* C1 = L1*L1' and C2 = L2*L1' */
+#ifdef REAL
+            if (ndcol <= Common->small_super)
+            {
+                small_syrk (ndrow1, ndrow2, ndcol, Lx + pdx1, ndrow,
+                    C, ndrow2) ;
+            }
+            else
+            {
+                BLAS_dsyrk ("L", "N",
+                    ndrow1, ndcol,              /* N, K: L1 is ndrow1-by-ndcol*/
+                    one,                        /* ALPHA:  1 */
+                    Lx + L_ENTRY*pdx1, ndrow,   /* A, LDA: L1, ndrow */
+                    zero,                       /* BETA:   0 */
+                    C, ndrow2) ;                /* C, LDC: C1 */
+                if (ndrow3 > 0)
+                {
+                    BLAS_dgemm ("N", "C",
+                        ndrow3, ndrow1, ndcol,          /* M, N, K */
+                        one,                            /* ALPHA:  1 */
+                        Lx + L_ENTRY*(pdx1 + ndrow1),   /* A, LDA: L2 */
+                        ndrow,                          /* ndrow */
+                        Lx + L_ENTRY*pdx1,              /* B, LDB: L1 */
+                        ndrow,                          /* ndrow */
+                        zero,                           /* BETA:   0 */
+                        C + L_ENTRY*ndrow1,             /* C, LDC: C2 */
+                        ndrow2) ;
+                }
+            }
+#else
+            BLAS_zherk ("L", "N",
+                ndrow1, ndcol,              /* N, K: L1 is ndrow1-by-ndcol*/
+                one,                        /* ALPHA:  1 */
+                Lx + L_ENTRY*pdx1, ndrow,   /* A, LDA: L1, ndrow */
+                zero,                       /* BETA:   0 */
+                C, ndrow2) ;                /* C, LDC: C1 */
+            if (ndrow3 > 0)
+            {
+                BLAS_zgemm ("N", "C",
+                    ndrow3, ndrow1, ndcol,          /* M, N, K */
+                    one,                            /* ALPHA:  1 */
+                    Lx + L_ENTRY*(pdx1 + ndrow1),   /* A, LDA: L2 */
+                    ndrow,                          /* ndrow */
+                    Lx + L_ENTRY*pdx1,              /* B, LDB: L1, ndrow */
+                    ndrow,
+                    zero,                           /* BETA:   0 */
+                    C + L_ENTRY*ndrow1,             /* C, LDC: C2 */
+                    ndrow2) ;
+            }
+#endif
+
+            /* assemble C into supernode s using the relative map */
+            for (i = 0 ; i < ndrow2 ; i++)
+            {
+                RelativeMap [i] = Map [Ls [pdi1 + i]] ;
+                ASSERT (RelativeMap [i] >= 0 && RelativeMap [i] < nsrow) ;
+            }
+            for (j = 0 ; j < ndrow1 ; j++)              /* cols k1:k2-1 */
+            {
+                px = psx + RelativeMap [j] * nsrow ;
+                for (i = j ; i < ndrow2 ; i++)          /* rows k1:n-1 */
+                {
+                    q = px + RelativeMap [i] ;
+                    L_ASSEMBLESUB (Lx,q, C, i+ndrow2*j) ;
+                }
+            }
+
+            /* prepare d for its next ancestor, if it is in this subtree */
+            dnext = Next [d] ;
+            Lpos [d] = pdi2 - pdi ;
+            if (Lpos [d] < ndrow)
+            {
+                dancestor = SuperMap [Ls [pdi2]] ;
+                if (Owner [dancestor] == task)
+                {
+                    Next [d] = Head [dancestor] ;
+                    Head [dancestor] = d ;
+                }
+            }
+        }
+        Head [s] = EMPTY ;
+
+        /* ------------------------------------------------------------------ */
+        /* factorize the diagonal block of s, and compute the subdiagonal */
+        /* ------------------------------------------------------------------ */
+
+#ifdef REAL
+        if (nscol <= Common->small_super)
+        {
+            info = small_potrf (nscol, Lx + psx, nsrow) ;
+        }
+        else
+        {
+            LAPACK_dpotrf ("L",
+                nscol,                      /* N: nscol */
+                Lx + L_ENTRY*psx, nsrow,    /* A, LDA: S1, nsrow */
+                info) ;                     /* INFO */
+        }
+#else
+        LAPACK_zpotrf ("L",
+            nscol,                      /* N: nscol */
+            Lx + L_ENTRY*psx, nsrow,    /* A, LDA: S1, nsrow */
+            info) ;                     /* INFO */
+#endif
+        if (info != 0)
+        {
+            return (info) ;
+        }
+
+        nsrow2 = nsrow - nscol ;
+        Lpos [s] = nscol ;
+        if (nsrow2 > 0)
+        {
+#ifdef REAL
+            if (nscol <= Common->small_super)
+            {
+                small_trsm (nsrow2, nscol, Lx + psx, nsrow,
+                    Lx + psx + nscol, nsrow) ;
+            }
+            else
+            {
+                BLAS_dtrsm ("R", "L", "C", "N",
+                    nsrow2, nscol,                  /* M, N */
+                    one,                            /* ALPHA: 1 */
+                    Lx + L_ENTRY*psx, nsrow,        /* A, LDA: L1, nsrow */
+                    Lx + L_ENTRY*(psx + nscol),     /* B, LDB, L2, nsrow */
+                    nsrow) ;
+            }
+#else
+            BLAS_ztrsm ("R", "L", "C", "N",
+                nsrow2, nscol,                  /* M, N */
+                one,                            /* ALPHA: 1 */
+                Lx + L_ENTRY*psx, nsrow,        /* A, LDA: L1, nsrow */
+                Lx + L_ENTRY*(psx + nscol),     /* B, LDB, L2, nsrow */
+                nsrow) ;
+#endif
+
+            /* place s in the link list of its parent, if in this subtree */
+            sparent = SuperMap [Ls [psi + nscol]] ;
+            ASSERT (sparent > s && sparent < L->nsuper) ;
+            if (Owner [sparent] == task)
+            {
+                Next [s] = Head [sparent] ;
+                Head [sparent] = s ;
+            }
+        }
+    }
+    return (0) ;
+}
+
+
+/* ========================================================================== */
+/* === t_cholmod_super_tasks ================================================ */
+/* ========================================================================== */
+
+/* Factorizes the independent subtrees of the supernodal elimination tree (see
+ * super_subtrees) concurrently, with up to Common->nthreads_max threads, and
+ * then places each of their supernodes in the link list of its next ancestor
+ * in the top of the tree.  Returns Owner, of size nsuper, where Owner [s] is
+ * EMPTY if supernode s is in the top of the tree and still has to be
+ * factorized.
+ *
+ * Returns NULL if nothing was done: if there are fewer than two subtrees, if
+ * out of memory (this is not an error), or if a supernode in a subtree is not
+ * positive definite.  In the last case the Head lists are cleared, and the
+ * whole matrix must be factorized one supernode at a time, which finds
+ * L->minor in the usual way. */
+
+static Int *TEMPLATE (cholmod_super_tasks)
+(
+    /* ---- input ---- */
+    cholmod_sparse *A,  /* matrix to factorize */
+    cholmod_sparse *F,  /* F = A' or A(:,f)' */
+    double beta [2],    /* beta*I is added to diagonal of matrix to factorize */
+    Int *SuperMap,      /* size n */
+    /* ---- in/out --- */
+    cholmod_factor *L,  /* factorization */
+    Int *Head,          /* size nsuper, link lists of pending descendants */
+    Int *Next,          /* size nsuper */
+    Int *Lpos,          /* size nsuper */
+    /* --------------- */
+    cholmod_common *Common
+)
+{
+    double *W, *Cw ;
+    Int *Owner, *Tw, *Tstart, *Tlist, *Mw, *Ls, *Lpi, nsuper, n, ntasks,
+        nthreads, nfail, d, s, t ;
+    size_t maxcsize, mwsize, cwsize, i ;
+    int ok = TRUE, try_catch ;
+
+    nsuper = L->nsuper ;
+    n = L->n ;
+    Ls = L->s ;
+    Lpi = L->pi ;
+    maxcsize = L->maxcsize ;
+    nthreads = Common->nthreads_max ;
+
+    /* ---------------------------------------------------------------------- */
+    /* find the subtrees and allocate their workspace */
+    /* ---------------------------------------------------------------------- */
+
+    /* If out of memory, the factorization is done one supernode at a time
+     * instead, without calling the error handler. */
+    try_catch = Common->try_catch ;
+    Common->try_catch = TRUE ;
+    Mw = NULL ;
+    Cw = NULL ;
+    ntasks = 0 ;
+    Owner = CHOLMOD(malloc) (nsuper, sizeof (Int), Common) ;
+    Tw = CHOLMOD(malloc) (6*((size_t) nsuper) + 1, sizeof (Int), Common) ;
+    W = CHOLMOD(malloc) (nsuper, sizeof (double), Common) ;
+    Tstart = Tw ;                               /* size nsuper+1 */
+    Tlist = Tw + nsuper + 1 ;                   /* size nsuper */
+    if (Common->status == CHOLMOD_OK)
+    {
+        ntasks = super_subtrees (nsuper, L->super, Lpi, Ls, SuperMap,
+            nthreads, Owner, Tstart, Tlist, Tw + 2*((size_t) nsuper) + 1, W) ;
+    }
+    nthreads = MIN (nthreads, ntasks) ;
+    mwsize = CHOLMOD(mult_size_t) (n, 2*nthreads, &ok) ;
+    cwsize = CHOLMOD(mult_size_t) (maxcsize, L_ENTRY*nthreads, &ok) ;
+    if (ntasks > 0 && ok)
+    {
+        Mw = CHOLMOD(malloc) (mwsize, sizeof (Int), Common) ;
+        Cw = CHOLMOD(malloc) (cwsize, sizeof (double), Common) ;
+    }
+    Common->try_catch = try_catch ;
+    if (ntasks == 0 || !ok || Common->status < CHOLMOD_OK)
+    {
+        Common->status = CHOLMOD_OK ;
+        CHOLMOD(free) (nsuper, sizeof (Int), Owner, Common) ;
+        CHOLMOD(free) (6*((size_t) nsuper) + 1, sizeof (Int), Tw, Common) ;
+        CHOLMOD(free) (nsuper, sizeof (double), W, Common) ;
+        CHOLMOD(free) (mwsize, sizeof (Int), Mw, Common) ;
+        CHOLMOD(free) (cwsize, sizeof (double), Cw, Common) ;
+        return (NULL) ;
+    }
+    PRINT1 (("super_tasks: "ID" subtrees, "ID" threads\n", ntasks, nthreads)) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* factorize the subtrees */
+    /* ---------------------------------------------------------------------- */
+
+    for (i = 0 ; i < mwsize ; i++)
+    {
+        Mw [i] = EMPTY ;
+    }
+    nfail = 0 ;
+
+#pragma omp parallel for num_threads(nthreads) schedule (dynamic,1) \
+    reduction (+:nfail)
+
+    for (t = 0 ; t < ntasks ; t++)
+    {
+        Int *Map, tid ;
+        tid = omp_get_thread_num ( ) ;
+        Map = Mw + 2*((size_t) n) * tid ;
+        nfail += (TEMPLATE (cholmod_super_subtree) (A, F, beta,
+            Tlist + Tstart [t], Tstart [t+1] - Tstart [t], t, Owner, SuperMap,
+            L, Head, Next, Lpos, Map, Map + n, Cw + maxcsize*L_ENTRY*tid,
+            Common) != 0) ;
+    }
+
+    if (CHECK_BLAS_INT && !Common->blas_ok)
+    {
+        ERROR (CHOLMOD_TOO_LARGE, "problem too large for the BLAS") ;
+    }
+
+    if (nfail > 0)
+    {
+        /* start over, one supernode at a time */
+        for (s = 0 ; s < nsuper ; s++)
+        {
+            Head [s] = EMPTY ;
+        }
+        Owner = CHOLMOD(free) (nsuper, sizeof (Int), Owner, Common) ;
+    }
+    else
+    {
+        /* place each supernode d of the subtrees in the link list of its next
+         * ancestor, which is in the top of the tree */
+        for (d = 0 ; d < nsuper ; d++)
+        {
+            if (Owner [d] != EMPTY && Lpos [d] < Lpi [d+1] - Lpi [d])
+            {
+                s = SuperMap [Ls [Lpi [d] + Lpos [d]]] ;
+                ASSERT (Owner [s] == EMPTY) ;
+                Next [d] = Head [s] ;
+                Head [s] = d ;
+            }
+        }
+    }
+
+    CHOLMOD(free) (6*((size_t) nsuper) + 1, sizeof (Int), Tw, Common) ;
+    CHOLMOD(free) (nsuper, sizeof (double), W, Common) ;
+    CHOLMOD(free) (mwsize, sizeof (Int), Mw, Common) ;
+    CHOLMOD(free) (cwsize, sizeof (double), Cw, Common) ;
+    return (Owner) ;
+}
+
+#endif
+
+
 /* ========================================================================== */
 /* === t_cholmod_super_numeric ============================================== */
 /* ========================================================================== */
@@ -96,6 +594,8 @@ static int TEMPLATE (cholmod_super_numeric)
     cholmod_sparse *A,  /* matrix to factorize */
     cholmod_sparse *F,  /* F = A' or A(:,f)' */
     double beta [2],    /* beta*I is added to diagonal of matrix to factorize */
+    Int *Path,          /* columns to refactorize, NULL for all */
+    Int pathlen,        /* size of Path */
     /* ---- in/out --- */
     cholmod_factor *L,  /* factorization */
     /* -- workspace -- */
@@ -108,12 +608,13 @@ static int TEMPLATE (cholmod_super_numeric)
     double *Lx, *Ax, *Fx, *Az, *Fz, *C ;
     Int *Super, *Head, *Ls, *Lpi, *Lpx, *Map, *SuperMap, *RelativeMap, *Next,
         *Lpos, *Fp, *Fi, *Fnz, *Ap, *Ai, *Anz, *Iwork, *Next_save, *Lpos_save,
-        *Previous;
+        *Previous, *Owner ;
     Int nsuper, n, j, i, k, s, p, pend, k1, k2, nscol, psi, psx, psend, nsrow,
         pj, d, kd1, kd2, info, ndcol, ndrow, pdi, pdx, pdend, pdi1, pdi2, pdx1,
         ndrow1, ndrow2, px, dancestor, sparent, dnext, nsrow2, ndrow3, pk, pf,
         pfend, stype, Apacked, Fpacked, q, imap, repeat_supernode, nscol2, ss,
         tail, nscol_new = 0;
+    size_t ooc_mark ;
 
     /* ---------------------------------------------------------------------- */
     /* declarations for the GPU */
@@ -180,7 +681,7 @@ static int TEMPLATE (cholmod_super_numeric)
 
 #ifdef GPU_BLAS
     /* local copy of useGPU */
-    if ( (Common->useGPU == 1) && L->useGPU)
+    if ( (Common->useGPU == 1) && L->useGPU && Path == NULL)
     {
         /* Initialize the GPU.  If not found, don't use it. */
         useGPU = TEMPLATE2 (CHOLMOD (gpu_init))
@@ -203,6 +704,7 @@ static int TEMPLATE (cholmod_super_numeric)
     Common->CHOLMOD_GPU_SYRK_CALLS  = 0 ;
     Common->CHOLMOD_GPU_TRSM_CALLS  = 0 ;
     Common->CHOLMOD_GPU_POTRF_CALLS = 0 ;
+    Common->CHOLMOD_CPU_SMALL_CALLS = 0 ;
     Common->CHOLMOD_CPU_GEMM_TIME   = 0 ;
     Common->CHOLMOD_CPU_SYRK_TIME   = 0 ;
     Common->CHOLMOD_CPU_TRSM_TIME   = 0 ;
@@ -211,6 +713,7 @@ static int TEMPLATE (cholmod_super_numeric)
     Common->CHOLMOD_GPU_SYRK_TIME   = 0 ;
     Common->CHOLMOD_GPU_TRSM_TIME   = 0 ;
     Common->CHOLMOD_GPU_POTRF_TIME  = 0 ;
+    Common->CHOLMOD_CPU_SMALL_TIME  = 0 ;
     Common->CHOLMOD_ASSEMBLE_TIME   = 0 ;
     Common->CHOLMOD_ASSEMBLE_TIME2  = 0 ;
 #endif
@@ -263,6 +766,31 @@ static int TEMPLATE (cholmod_super_numeric)
      * Once supernode s is repeated, the factorization is terminated. */
     repeat_supernode = FALSE ;
 
+    /* ---------------------------------------------------------------------- */
+    /* partial refactorization, or factorization of independent subtrees */
+    /* ---------------------------------------------------------------------- */
+
+    /* If Owner is not NULL, the supernodes s with Owner [s] != EMPTY are
+     * already factorized (they are not on the path, or have been factorized
+     * in their subtrees), and are in the link lists of the rest. */
+    Owner = NULL ;
+    if (Path != NULL)
+    {
+        Owner = super_path (Path, pathlen, L, SuperMap, Head, Next, Lpos,
+            Common) ;
+    }
+#ifdef _OPENMP
+    if (Owner == NULL && Common->nthreads_max > 1
+#ifdef GPU_BLAS
+        && !useGPU
+#endif
+        )
+    {
+        Owner = TEMPLATE (cholmod_super_tasks) (A, F, beta, SuperMap, L, Head,
+            Next, Lpos, Common) ;
+    }
+#endif
+
 #ifdef GPU_BLAS
     if ( useGPU )
     {
@@ -276,9 +804,16 @@ static int TEMPLATE (cholmod_super_numeric)
     /* supernodal numerical factorization */
     /* ---------------------------------------------------------------------- */
 
+    ooc_mark = 0 ;
     for (s = 0 ; s < nsuper ; s++)
     {
 
+        if (Owner != NULL && Owner [s] != EMPTY)
+        {
+            /* s is not on the path, or was factorized in its subtree */
+            continue ;
+        }
+
         /* ------------------------------------------------------------------ */
         /* get the size of supernode s */
         /* ------------------------------------------------------------------ */
@@ -294,6 +829,10 @@ static int TEMPLATE (cholmod_super_numeric)
         PRINT1 (("====================================================\n"
                  "S "ID" k1 "ID" k2 "ID" nsrow "ID" nscol "ID" psi "ID" psend "
                  ""ID" psx "ID"\n", s, k1, k2, nsrow, nscol, psi, psend, psx)) ;
+
+        /* if L->x is held in a file, prefetch s+1 and release old supernodes */
+        CHOLMOD(ooc_sweep) (L, s, TRUE, &ooc_mark, Common) ;
+
         /* ------------------------------------------------------------------ */
         /* zero the supernode s */
         /* ------------------------------------------------------------------ */
@@ -673,64 +1212,85 @@ static int TEMPLATE (cholmod_super_numeric)
 #endif
             {
                 /* GPU not installed, or not used */
-#ifndef NTIMER
-
-                Common->CHOLMOD_CPU_SYRK_CALLS++ ;
-                tstart = SuiteSparse_time () ;
-#endif
 #ifdef REAL
-                BLAS_dsyrk ("L", "N",
-                    ndrow1, ndcol,              /* N, K: L1 is ndrow1-by-ndcol*/
-                    one,                        /* ALPHA:  1 */
-                    Lx + L_ENTRY*pdx1, ndrow,   /* A, LDA: L1, ndrow */
-                    zero,                       /* BETA:   0 */
-                    C, ndrow2) ;                /* C, LDC: C1 */
-#else
-                BLAS_zherk ("L", "N",
-                    ndrow1, ndcol,              /* N, K: L1 is ndrow1-by-ndcol*/
-                    one,                        /* ALPHA:  1 */
-                    Lx + L_ENTRY*pdx1, ndrow,   /* A, LDA: L1, ndrow */
-                    zero,                       /* BETA:   0 */
-                    C, ndrow2) ;                /* C, LDC: C1 */
+                if (ndcol <= Common->small_super)
+                {
+                    /* C1 = L1*L1' and C2 = L2*L1', without the BLAS */
+#ifndef NTIMER
+                    Common->CHOLMOD_CPU_SMALL_CALLS++ ;
+                    tstart = SuiteSparse_time () ;
 #endif
+                    small_syrk (ndrow1, ndrow2, ndcol, Lx + pdx1, ndrow,
+                        C, ndrow2) ;
 #ifndef NTIMER
-                Common->CHOLMOD_CPU_SYRK_TIME += SuiteSparse_time () - tstart ;
+                    Common->CHOLMOD_CPU_SMALL_TIME +=
+                        SuiteSparse_time () - tstart ;
+#endif
+                }
+                else
 #endif
-                /* compute remaining (ndrow2-ndrow1)-by-ndrow1 block of C,
-                 * C2 = L2*L1' */
-                if (ndrow3 > 0)
                 {
 #ifndef NTIMER
-                    Common->CHOLMOD_CPU_GEMM_CALLS++ ;
+                    Common->CHOLMOD_CPU_SYRK_CALLS++ ;
                     tstart = SuiteSparse_time () ;
 #endif
 #ifdef REAL
-                    BLAS_dgemm ("N", "C",
-                        ndrow3, ndrow1, ndcol,          /* M, N, K */
-                        one,                            /* ALPHA:  1 */
-                        Lx + L_ENTRY*(pdx1 + ndrow1),   /* A, LDA: L2 */
-                        ndrow,                          /* ndrow */
-                        Lx + L_ENTRY*pdx1,              /* B, LDB: L1 */
-                        ndrow,                          /* ndrow */
-                        zero,                           /* BETA:   0 */
-                        C + L_ENTRY*ndrow1,             /* C, LDC: C2 */
-                        ndrow2) ;
+                    BLAS_dsyrk ("L", "N",
+                        ndrow1, ndcol,          /* N, K: L1 is ndrow1-by-ndcol*/
+                        one,                    /* ALPHA:  1 */
+                        Lx + L_ENTRY*pdx1,      /* A, LDA: L1, ndrow */
+                        ndrow,
+                        zero,                   /* BETA:   0 */
+                        C, ndrow2) ;            /* C, LDC: C1 */
 #else
-                    BLAS_zgemm ("N", "C",
-                        ndrow3, ndrow1, ndcol,          /* M, N, K */
-                        one,                            /* ALPHA:  1 */
-                        Lx + L_ENTRY*(pdx1 + ndrow1),   /* A, LDA: L2 */
-                        ndrow,                          /* ndrow */
-                        Lx + L_ENTRY*pdx1,              /* B, LDB: L1, ndrow */
+                    BLAS_zherk ("L", "N",
+                        ndrow1, ndcol,          /* N, K: L1 is ndrow1-by-ndcol*/
+                        one,                    /* ALPHA:  1 */
+                        Lx + L_ENTRY*pdx1,      /* A, LDA: L1, ndrow */
                         ndrow,
-                        zero,                           /* BETA:   0 */
-                        C + L_ENTRY*ndrow1,             /* C, LDC: C2 */
-                        ndrow2) ;
+                        zero,                   /* BETA:   0 */
+                        C, ndrow2) ;            /* C, LDC: C1 */
 #endif
 #ifndef NTIMER
-                    Common->CHOLMOD_CPU_GEMM_TIME +=
+                    Common->CHOLMOD_CPU_SYRK_TIME +=
                         SuiteSparse_time () - tstart ;
 #endif
+                    /* compute remaining (ndrow2-ndrow1)-by-ndrow1 block of C,
+                     * C2 = L2*L1' */
+                    if (ndrow3 > 0)
+                    {
+#ifndef NTIMER
+                        Common->CHOLMOD_CPU_GEMM_CALLS++ ;
+                        tstart = SuiteSparse_time () ;
+#endif
+#ifdef REAL
+                        BLAS_dgemm ("N", "C",
+                            ndrow3, ndrow1, ndcol,          /* M, N, K */
+                            one,                            /* ALPHA:  1 */
+                            Lx + L_ENTRY*(pdx1 + ndrow1),   /* A, LDA: L2 */
+                            ndrow,                          /* ndrow */
+                            Lx + L_ENTRY*pdx1,              /* B, LDB: L1 */
+                            ndrow,                          /* ndrow */
+                            zero,                           /* BETA:   0 */
+                            C + L_ENTRY*ndrow1,             /* C, LDC: C2 */
+                            ndrow2) ;
+#else
+                        BLAS_zgemm ("N", "C",
+                            ndrow3, ndrow1, ndcol,          /* M, N, K */
+                            one,                            /* ALPHA:  1 */
+                            Lx + L_ENTRY*(pdx1 + ndrow1),   /* A, LDA: L2 */
+                            ndrow,                          /* ndrow */
+                            Lx + L_ENTRY*pdx1,              /* B, LDB: L1 */
+                            ndrow,
+                            zero,                           /* BETA:   0 */
+                            C + L_ENTRY*ndrow1,             /* C, LDC: C2 */
+                            ndrow2) ;
+#endif
+#ifndef NTIMER
+                        Common->CHOLMOD_CPU_GEMM_TIME +=
+                            SuiteSparse_time () - tstart ;
+#endif
+                    }
                 }
 
                 /* ---------------------------------------------------------- */
@@ -856,24 +1416,40 @@ static int TEMPLATE (cholmod_super_numeric)
 #ifdef GPU_BLAS
             supernodeUsedGPU = 0;
 #endif
+#ifdef REAL
+            if (nscol2 <= Common->small_super)
+            {
+#ifndef NTIMER
+                Common->CHOLMOD_CPU_SMALL_CALLS++ ;
+                tstart = SuiteSparse_time () ;
+#endif
+                info = small_potrf (nscol2, Lx + psx, nsrow) ;
 #ifndef NTIMER
-            Common->CHOLMOD_CPU_POTRF_CALLS++ ;
-            tstart = SuiteSparse_time () ;
+                Common->CHOLMOD_CPU_SMALL_TIME += SuiteSparse_time () - tstart ;
+#endif
+            }
+            else
+#endif
+            {
+#ifndef NTIMER
+                Common->CHOLMOD_CPU_POTRF_CALLS++ ;
+                tstart = SuiteSparse_time () ;
 #endif
 #ifdef REAL
-            LAPACK_dpotrf ("L",
-                nscol2,                     /* N: nscol2 */
-                Lx + L_ENTRY*psx, nsrow,    /* A, LDA: S1, nsrow */
-                info) ;                     /* INFO */
+                LAPACK_dpotrf ("L",
+                    nscol2,                     /* N: nscol2 */
+                    Lx + L_ENTRY*psx, nsrow,    /* A, LDA: S1, nsrow */
+                    info) ;                     /* INFO */
 #else
-            LAPACK_zpotrf ("L",
-                nscol2,                     /* N: nscol2 */
-                Lx + L_ENTRY*psx, nsrow,    /* A, LDA: S1, nsrow */
-                info) ;                     /* INFO */
+                LAPACK_zpotrf ("L",
+                    nscol2,                     /* N: nscol2 */
+                    Lx + L_ENTRY*psx, nsrow,    /* A, LDA: S1, nsrow */
+                    info) ;                     /* INFO */
 #endif
 #ifndef NTIMER
-            Common->CHOLMOD_CPU_POTRF_TIME += SuiteSparse_time ()- tstart ;
+                Common->CHOLMOD_CPU_POTRF_TIME += SuiteSparse_time ()- tstart ;
 #endif
+            }
         }
 
         /* ------------------------------------------------------------------ */
@@ -953,6 +1529,7 @@ static int TEMPLATE (cholmod_super_numeric)
                     CHOLMOD (gpu_end) (Common) ;
                 }
 #endif
+                CHOLMOD(free) (nsuper, sizeof (Int), Owner, Common) ;
                 return (Common->status >= CHOLMOD_OK) ;
             }
             else
@@ -989,28 +1566,47 @@ static int TEMPLATE (cholmod_super_numeric)
                         (nsrow2, nscol2, nsrow, psx, Lx, Common, gpu_p))
 #endif
             {
+#ifdef REAL
+                if (nscol2 <= Common->small_super)
+                {
 #ifndef NTIMER
-                Common->CHOLMOD_CPU_TRSM_CALLS++ ;
-                tstart = SuiteSparse_time () ;
+                    Common->CHOLMOD_CPU_SMALL_CALLS++ ;
+                    tstart = SuiteSparse_time () ;
+#endif
+                    small_trsm (nsrow2, nscol2, Lx + psx, nsrow,
+                        Lx + psx + nscol2, nsrow) ;
+#ifndef NTIMER
+                    Common->CHOLMOD_CPU_SMALL_TIME +=
+                        SuiteSparse_time () - tstart ;
+#endif
+                }
+                else
+#endif
+                {
+#ifndef NTIMER
+                    Common->CHOLMOD_CPU_TRSM_CALLS++ ;
+                    tstart = SuiteSparse_time () ;
 #endif
 #ifdef REAL
-                BLAS_dtrsm ("R", "L", "C", "N",
-                    nsrow2, nscol2,                 /* M, N */
-                    one,                            /* ALPHA: 1 */
-                    Lx + L_ENTRY*psx, nsrow,        /* A, LDA: L1, nsrow */
-                    Lx + L_ENTRY*(psx + nscol2),    /* B, LDB, L2, nsrow */
-                    nsrow) ;
+                    BLAS_dtrsm ("R", "L", "C", "N",
+                        nsrow2, nscol2,                 /* M, N */
+                        one,                            /* ALPHA: 1 */
+                        Lx + L_ENTRY*psx, nsrow,        /* A, LDA: L1, nsrow */
+                        Lx + L_ENTRY*(psx + nscol2),    /* B, LDB, L2, nsrow */
+                        nsrow) ;
 #else
-                BLAS_ztrsm ("R", "L", "C", "N",
-                    nsrow2, nscol2,                 /* M, N */
-                    one,                            /* ALPHA: 1 */
-                    Lx + L_ENTRY*psx, nsrow,        /* A, LDA: L1, nsrow */
-                    Lx + L_ENTRY*(psx + nscol2),    /* B, LDB, L2, nsrow */
-                    nsrow) ;
+                    BLAS_ztrsm ("R", "L", "C", "N",
+                        nsrow2, nscol2,                 /* M, N */
+                        one,                            /* ALPHA: 1 */
+                        Lx + L_ENTRY*psx, nsrow,        /* A, LDA: L1, nsrow */
+                        Lx + L_ENTRY*(psx + nscol2),    /* B, LDB, L2, nsrow */
+                        nsrow) ;
 #endif
 #ifndef NTIMER
-                Common->CHOLMOD_CPU_TRSM_TIME += SuiteSparse_time () - tstart ;
+                    Common->CHOLMOD_CPU_TRSM_TIME +=
+                        SuiteSparse_time () - tstart ;
 #endif
+                }
             }
 
             if (CHECK_BLAS_INT && !Common->blas_ok)
@@ -1060,6 +1656,7 @@ static int TEMPLATE (cholmod_super_numeric)
                 CHOLMOD (gpu_end) (Common) ;
             }
 #endif
+            CHOLMOD(free) (nsuper, sizeof (Int), Owner, Common) ;
             return (Common->status >= CHOLMOD_OK) ;
         }
     }
@@ -1074,6 +1671,7 @@ static int TEMPLATE (cholmod_super_numeric)
     }
 #endif
 
+    CHOLMOD(free) (nsuper, sizeof (Int), Owner, Common) ;
     return (Common->status >= CHOLMOD_OK) ;
 
 }
@@ -28,6 +28,7 @@ static void TEMPLATE (cholmod_super_lsolve)
     Int *Lpi, *Lpx, *Ls, *Super ;
     Int nsuper, k1, k2, psi, psend, psx, nsrow, nscol, ii, s,
 	nsrow2, n, ps2, j, i, d, nrhs ;
+    size_t ooc_mark ;
 
     /* ---------------------------------------------------------------------- */
     /* get inputs */
@@ -45,6 +46,7 @@ static void TEMPLATE (cholmod_super_lsolve)
     Ls = L->s ;
     Super = L->super ;
     Lx = L->x ;
+    ooc_mark = 0 ;
     minus_one [0] = -1.0 ;
     minus_one [1] = 0 ;
     one [0] = 1.0 ;
@@ -59,6 +61,7 @@ static void TEMPLATE (cholmod_super_lsolve)
 
 	for (s = 0 ; s < nsuper ; s++)
 	{
+	    CHOLMOD(ooc_sweep) (L, s, TRUE, &ooc_mark, Common) ;
 	    k1 = Super [s] ;
 	    k2 = Super [s+1] ;
 	    psi = Lpi [s] ;
@@ -134,6 +137,7 @@ static void TEMPLATE (cholmod_super_lsolve)
 
 	for (s = 0 ; s < nsuper ; s++)
 	{
+	    CHOLMOD(ooc_sweep) (L, s, TRUE, &ooc_mark, Common) ;
 	    k1 = Super [s] ;
 	    k2 = Super [s+1] ;
 	    psi = Lpi [s] ;
@@ -236,6 +240,7 @@ static void TEMPLATE (cholmod_super_ltsolve)
     Int *Lpi, *Lpx, *Ls, *Super ;
     Int nsuper, k1, k2, psi, psend, psx, nsrow, nscol, ii, s,
 	nsrow2, n, ps2, j, i, d, nrhs ;
+    size_t ooc_mark ;
 
     /* ---------------------------------------------------------------------- */
     /* get inputs */
@@ -253,6 +258,7 @@ static void TEMPLATE (cholmod_super_ltsolve)
     Ls = L->s ;
     Super = L->super ;
     Lx = L->x ;
+    ooc_mark = L->ooc ;
     minus_one [0] = -1.0 ;
     minus_one [1] = 0 ;
     one [0] = 1.0 ;
@@ -267,6 +273,7 @@ static void TEMPLATE (cholmod_super_ltsolve)
 
 	for (s = nsuper-1 ; s >= 0 ; s--)
 	{
+	    CHOLMOD(ooc_sweep) (L, s, FALSE, &ooc_mark, Common) ;
 	    k1 = Super [s] ;
 	    k2 = Super [s+1] ;
 	    psi = Lpi [s] ;
@@ -336,6 +343,7 @@ static void TEMPLATE (cholmod_super_ltsolve)
 
 	for (s = nsuper-1 ; s >= 0 ; s--)
 	{
+	    CHOLMOD(ooc_sweep) (L, s, FALSE, &ooc_mark, Common) ;
 	    k1 = Super [s] ;
 	    k2 = Super [s+1] ;
 	    psi = Lpi [s] ;
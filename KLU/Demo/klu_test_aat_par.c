@@ -0,0 +1,385 @@
+/* klu_test_aat_par: A+A' built in parallel by amd_order and camd_order, and
+ * parallel block extraction in klu_analyze, for large matrices, for testing */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "klu.h"
+
+/* the fill per node of the large grid may exceed that of the small grid
+ * (ordered with the sequential A+A') by this factor */
+#define FILL_TOLERANCE 1.25
+
+#define NX 110
+#define NY 100
+#define N (NX*NY)
+#define NX0 99
+#define N0 (NX0*NY)
+
+/* unsymmetric 9-point grid of nx-by-NY nodes, with a third of the (x+1,y+1)
+ * neighbours left out, and a dominant diagonal.  The nodes are numbered in a
+ * scrambled order. */
+static int grid (int nx, int *Gp, int *Gi, double *Gx)
+{
+    int x, y, dx, dy, i, j, k, p, q, m, nz = 0, *Q, *Qinv, *Cp, *Ci ;
+    double *Cx ;
+    unsigned seed = 1 ;
+    m = nx * NY ;
+    Q = malloc (m * sizeof (int)) ;
+    Qinv = malloc (m * sizeof (int)) ;
+    Cp = malloc ((m+1) * sizeof (int)) ;
+    Ci = malloc (m * 9 * sizeof (int)) ;
+    Cx = malloc (m * 9 * sizeof (double)) ;
+    if(!Q || !Qinv || !Cp || !Ci || !Cx)
+    {
+        free (Q) ;
+        free (Qinv) ;
+        free (Cp) ;
+        free (Ci) ;
+        free (Cx) ;
+        return (0) ;
+    }
+    for (x = 0 ; x < nx ; x++)
+    {
+        for (y = 0 ; y < NY ; y++)
+        {
+            j = x*NY + y ;
+            Cp [j] = nz ;
+            for (dx = -1 ; dx <= 1 ; dx++)
+            {
+                for (dy = -1 ; dy <= 1 ; dy++)
+                {
+                    i = (x+dx)*NY + y+dy ;
+                    if (x+dx < 0 || x+dx >= nx || y+dy < 0 || y+dy >= NY ||
+                       (dx == 1 && dy == 1 && (i+j) % 3 == 0))
+                    {
+                        continue ;
+                    }
+                    Ci [nz] = i ;
+                    Cx [nz++] = (i == j) ? 10 : -1 ;
+                }
+            }
+        }
+    }
+    Cp [m] = nz ;
+
+    /* G = C (Q,Q), for a pseudo-random permutation Q */
+    for (k = 0 ; k < m ; k++)
+    {
+        Q [k] = k ;
+    }
+    for (k = m-1 ; k > 0 ; k--)
+    {
+        seed = seed * 1103515245 + 12345 ;
+        i = (seed / 65536) % (k+1) ;
+        j = Q [k] ;
+        Q [k] = Q [i] ;
+        Q [i] = j ;
+    }
+    for (k = 0 ; k < m ; k++)
+    {
+        Qinv [Q [k]] = k ;
+    }
+    nz = 0 ;
+    for (k = 0 ; k < m ; k++)
+    {
+        Gp [k] = nz ;
+        for (p = Cp [Q [k]] ; p < Cp [Q [k] + 1] ; p++)
+        {
+            /* insert the row in order */
+            i = Qinv [Ci [p]] ;
+            for (q = nz++ ; q > Gp [k] && Gi [q-1] > i ; q--)
+            {
+                Gi [q] = Gi [q-1] ;
+                Gx [q] = Gx [q-1] ;
+            }
+            Gi [q] = i ;
+            Gx [q] = Cx [p] ;
+        }
+    }
+    Gp [m] = nz ;
+    free (Q) ;
+    free (Qinv) ;
+    free (Cp) ;
+    free (Ci) ;
+    free (Cx) ;
+    return (nz) ;
+}
+
+/* nnz (A+A') without the diagonal, the nonzeros on the diagonal, and the
+ * number of matched off-diagonal pairs */
+static void count_aat (int m, int *Gp, int *Gi, double *nzaat, double *nzdiag,
+    double *nzboth)
+{
+    int i, j, p, q ;
+    *nzaat = 0 ;
+    *nzdiag = 0 ;
+    *nzboth = 0 ;
+    for (j = 0 ; j < m ; j++)
+    {
+        for (p = Gp [j] ; p < Gp [j+1] ; p++)
+        {
+            i = Gi [p] ;
+            if (i == j)
+            {
+                (*nzdiag)++ ;
+                continue ;
+            }
+            /* A (i,j) is counted in columns i and j, unless A (j,i) is also
+             * present, in which case it is counted once here */
+            for (q = Gp [i] ; q < Gp [i+1] && Gi [q] != j ; q++) ;
+            if (q < Gp [i+1])
+            {
+                (*nzboth) += 0.5 ;
+                (*nzaat)++ ;
+            }
+            else
+            {
+                (*nzaat) += 2 ;
+            }
+        }
+    }
+}
+
+/* adds the pair {i,j} to A+A', or counts it in Sp if Iw is NULL */
+static void add_pair (int i, int j, int *Sp, int *Iw)
+{
+    if(Iw)
+    {
+        Iw [Sp [i]] = j ;
+        Iw [Sp [j]] = i ;
+    }
+    Sp [i]++ ;
+    Sp [j]++ ;
+}
+
+/* scans A in the same order as the sequential A+A' of amd_order */
+static void scan_aat (int m, int *Gp, int *Gi, int *Sp, int *Tp, int *Iw)
+{
+    int j, k, p, pj ;
+    for (k = 0 ; k < m ; k++)
+    {
+        for (p = Gp [k] ; p < Gp [k+1] && Gi [p] < k ; p++)
+        {
+            j = Gi [p] ;
+            add_pair (j, k, Sp, Iw) ;
+            for (pj = Tp [j] ; pj < Gp [j+1] && Gi [pj] < k ; pj++)
+            {
+                add_pair (Gi [pj], j, Sp, Iw) ;
+            }
+            Tp [j] = (pj < Gp [j+1] && Gi [pj] == k) ? pj+1 : pj ;
+        }
+        Tp [k] = (p < Gp [k+1] && Gi [p] == k) ? p+1 : p ;
+    }
+    for (j = 0 ; j < m ; j++)
+    {
+        for (pj = Tp [j] ; pj < Gp [j+1] ; pj++)
+        {
+            add_pair (Gi [pj], j, Sp, Iw) ;
+        }
+    }
+}
+
+/* P = the ordering of amd_2 on A+A', with A+A' constructed as amd_order does
+ * for small matrices.  Returns 0 if out of memory. */
+static int amd_seq (int m, int *Gp, int *Gi, int *P)
+{
+    int j, pfree, iwlen, *Len, *Pe, *Sp, *Tp, *Iw, *Nv, *Pinv, *Head, *Elen,
+        *Degree, *W, ok ;
+    Len = malloc (m * sizeof (int)) ;
+    Pe = malloc (m * sizeof (int)) ;
+    Sp = calloc (m, sizeof (int)) ;
+    Tp = malloc (m * sizeof (int)) ;
+    Nv = malloc (m * sizeof (int)) ;
+    Pinv = malloc (m * sizeof (int)) ;
+    Head = malloc (m * sizeof (int)) ;
+    Elen = malloc (m * sizeof (int)) ;
+    Degree = malloc (m * sizeof (int)) ;
+    W = malloc (m * sizeof (int)) ;
+    Iw = NULL ;
+    ok = (Len && Pe && Sp && Tp && Nv && Pinv && Head && Elen && Degree && W) ;
+    if(ok)
+    {
+        scan_aat (m, Gp, Gi, Sp, Tp, NULL) ;
+        pfree = 0 ;
+        for (j = 0 ; j < m ; j++)
+        {
+            Len [j] = Sp [j] ;
+            Pe [j] = pfree ;
+            Sp [j] = pfree ;
+            pfree += Len [j] ;
+        }
+        iwlen = pfree + pfree / 5 + m ;
+        Iw = malloc (iwlen * sizeof (int)) ;
+        ok = (Iw != NULL) ;
+    }
+    if(ok)
+    {
+        scan_aat (m, Gp, Gi, Sp, Tp, Iw) ;
+        amd_2 (m, Pe, Iw, Len, iwlen, pfree, Nv, Pinv, P, Head, Elen, Degree,
+            W, NULL, NULL) ;
+    }
+    free (Len) ;
+    free (Pe) ;
+    free (Sp) ;
+    free (Tp) ;
+    free (Iw) ;
+    free (Nv) ;
+    free (Pinv) ;
+    free (Head) ;
+    free (Elen) ;
+    free (Degree) ;
+    free (W) ;
+    return (ok) ;
+}
+
+/* returns 1 if P is a permutation of 0..n-1 */
+static int is_perm (int *P, int m)
+{
+    int k, ok = 1, *Mark = calloc (m, sizeof (int)) ;
+    for (k = 0 ; k < m && ok ; k++)
+    {
+        ok = (P [k] >= 0 && P [k] < m && !Mark [P [k]]) ;
+        if (ok) Mark [P [k]] = 1 ;
+    }
+    free (Mark) ;
+    return (ok) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    int *Gp, *Gi, *P, *Pseq, *Cmember, nz, k, RET, ok = 0 ;
+    double *Gx, *B, Info [AMD_INFO], CInfo [CAMD_INFO], nzaat, nzdiag, nzboth,
+        lnz0, err, e ;
+
+    Gp = malloc ((N+1) * sizeof (int)) ;
+    Gi = malloc (N * 9 * sizeof (int)) ;
+    Gx = malloc (N * 9 * sizeof (double)) ;
+    P = malloc (N * sizeof (int)) ;
+    Pseq = malloc (N * sizeof (int)) ;
+    Cmember = malloc (N * sizeof (int)) ;
+    B = malloc (N * sizeof (double)) ;
+    klu_defaults (&Common) ;
+    if(!Gp || !Gi || !Gx || !P || !Pseq || !Cmember || !B)
+    {
+        goto FAIL;
+    }
+
+    /* the small grid is ordered with the sequential A+A' */
+    if(!grid (NX0, Gp, Gi, Gx))
+    {
+        goto FAIL;
+    }
+    RET = amd_order (N0, Gp, Gi, P, NULL, Info) ;
+    if(RET < (AMD_OK))
+    {
+        goto FAIL;
+    }
+    lnz0 = Info [AMD_LNZ] / N0 ;
+
+    /* the large grid, with the parallel A+A' */
+    nz = grid (NX, Gp, Gi, Gx) ;
+    if(!nz)
+    {
+        goto FAIL;
+    }
+    count_aat (N, Gp, Gi, &nzaat, &nzdiag, &nzboth) ;
+    RET = amd_order (N, Gp, Gi, P, NULL, Info) ;
+    if(RET < (AMD_OK) || !is_perm (P, N))
+    {
+        goto FAIL;
+    }
+
+    /* the ordering is the same as with the sequential A+A' */
+    if(!amd_seq (N, Gp, Gi, Pseq))
+    {
+        goto FAIL;
+    }
+    for (k = 0 ; k < N ; k++)
+    {
+        if(P [k] != Pseq [k])
+        {
+            goto FAIL;
+        }
+    }
+    printf("amd: nnz(A+A') %g, symmetry %g, nnz(L) per node %g, small grid "
+        "%g\n", Info [AMD_NZ_A_PLUS_AT], Info [AMD_SYMMETRY],
+        Info [AMD_LNZ] / N, lnz0);
+    if(Info [AMD_NZ_A_PLUS_AT] != nzaat || Info [AMD_NZDIAG] != nzdiag ||
+       Info [AMD_SYMMETRY] != (2 * nzboth) / (nz - nzdiag) ||
+       Info [AMD_SYMMETRY] >= 1 ||
+       Info [AMD_LNZ] / N > FILL_TOLERANCE * lnz0)
+    {
+        goto FAIL;
+    }
+
+    /* camd, with a third of the nodes in a set ordered last */
+    for (k = 0 ; k < N ; k++)
+    {
+        Cmember [k] = (k % 3 == 0) ;
+    }
+    RET = camd_order (N, Gp, Gi, P, NULL, CInfo, Cmember) ;
+    if(RET < (CAMD_OK) || !is_perm (P, N))
+    {
+        goto FAIL;
+    }
+    printf("camd: nnz(A+A') %g, nnz(L) per node %g\n",
+        CInfo [CAMD_NZ_A_PLUS_AT], CInfo [CAMD_LNZ] / N);
+    if(CInfo [CAMD_NZ_A_PLUS_AT] != nzaat)
+    {
+        goto FAIL;
+    }
+    for (k = 0 ; k < N ; k++)
+    {
+        if(k > 0 && Cmember [P [k-1]] > Cmember [P [k]])
+        {
+            goto FAIL;
+        }
+    }
+
+    /* klu_analyze extracts the one large block in parallel */
+    Symbolic = klu_analyze (N, Gp, Gi, &Common) ;
+    Numeric = Symbolic ? klu_factor (Gp, Gi, Gx, Symbolic, &Common) : NULL ;
+    if(!Numeric || Symbolic->nblocks != 1 || Symbolic->nzoff != 0)
+    {
+        goto FAIL;
+    }
+    for (k = 0 ; k < N ; k++)
+    {
+        B [k] = 0 ;
+    }
+    for (k = 0 ; k < nz ; k++)
+    {
+        B [Gi [k]] += Gx [k] ;
+    }
+    if(!klu_solve (Symbolic, Numeric, N, 1, B, &Common))
+    {
+        goto FAIL;
+    }
+    err = 0 ;
+    for (k = 0 ; k < N ; k++)
+    {
+        e = (B [k] > 1) ? B [k] - 1 : 1 - B [k] ;
+        err = (e > err) ? e : err ;
+    }
+    printf("klu: nnz(L) %g, error %g\n", Symbolic->lnz, err);
+    if(err > 1e-12)
+    {
+        goto FAIL;
+    }
+    ok = 1 ;
+
+FAIL:
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    free (Gp) ;
+    free (Gi) ;
+    free (Gx) ;
+    free (P) ;
+    free (Pseq) ;
+    free (Cmember) ;
+    free (B) ;
+    return (!ok) ;
+}
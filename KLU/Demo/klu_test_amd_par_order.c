@@ -0,0 +1,189 @@
+/* klu_test_amd_par_order: multithreaded AMD ordering, for testing */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "klu.h"
+
+/* the fill of amd_par_order may exceed that of amd_order by this factor */
+#define FILL_TOLERANCE 1.10
+
+#define NX 80
+#define NY 60
+#define N (NX*NY)
+
+int    n = 10 ;
+int    Ap [ ] = { 0,  2,  3,  6,  9, 12, 15, 20, 21, 27, 31 } ;
+int    Ai [ ] = { 0, 8, 1, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+
+/* 9-point grid of NX-by-NY nodes, and one node per column of the grid that
+ * is connected to the whole column, like a bus with many branches.  The
+ * nodes are numbered in a scrambled order, since amd_order is unusually good
+ * on a grid in its natural order. */
+static int grid (int *Gp, int *Gi)
+{
+    int x, y, dx, dy, i, j, k, p, nz = 0, *Q, *Qinv, *Cp, *Ci ;
+    unsigned seed = 1 ;
+    Q = malloc (N * sizeof (int)) ;
+    Qinv = malloc (N * sizeof (int)) ;
+    Cp = malloc ((N+1) * sizeof (int)) ;
+    Ci = malloc (N * (9 + NY) * sizeof (int)) ;
+    if(!Q || !Qinv || !Cp || !Ci)
+    {
+        free (Q) ;
+        free (Qinv) ;
+        free (Cp) ;
+        free (Ci) ;
+        return (0) ;
+    }
+    for (x = 0 ; x < NX ; x++)
+    {
+        for (y = 0 ; y < NY ; y++)
+        {
+            Cp [x*NY + y] = nz ;
+            for (dx = -1 ; dx <= 1 ; dx++)
+            {
+                for (dy = -1 ; dy <= 1 ; dy++)
+                {
+                    if (x+dx >= 0 && x+dx < NX && y+dy >= 0 && y+dy < NY)
+                    {
+                        Ci [nz++] = (x+dx)*NY + y+dy ;
+                    }
+                }
+                if (dx == 0 && y == 0)
+                {
+                    for (j = 2 ; j < NY ; j++)
+                    {
+                        Ci [nz++] = x*NY + j ;
+                    }
+                }
+            }
+        }
+    }
+    Cp [N] = nz ;
+
+    /* G = C (Q,Q), for a pseudo-random permutation Q */
+    for (k = 0 ; k < N ; k++)
+    {
+        Q [k] = k ;
+    }
+    for (k = N-1 ; k > 0 ; k--)
+    {
+        seed = seed * 1103515245 + 12345 ;
+        i = (seed / 65536) % (k+1) ;
+        j = Q [k] ;
+        Q [k] = Q [i] ;
+        Q [i] = j ;
+    }
+    for (k = 0 ; k < N ; k++)
+    {
+        Qinv [Q [k]] = k ;
+    }
+    nz = 0 ;
+    for (k = 0 ; k < N ; k++)
+    {
+        Gp [k] = nz ;
+        for (p = Cp [Q [k]] ; p < Cp [Q [k] + 1] ; p++)
+        {
+            Gi [nz++] = Qinv [Ci [p]] ;
+        }
+    }
+    Gp [N] = nz ;
+    free (Q) ;
+    free (Qinv) ;
+    free (Cp) ;
+    free (Ci) ;
+    return (nz) ;
+}
+
+/* returns 1 if P is a permutation of 0..n-1 */
+static int is_perm (int *P, int m)
+{
+    int k, ok = 1, *Mark = calloc (m, sizeof (int)) ;
+    for (k = 0 ; k < m && ok ; k++)
+    {
+        ok = (P [k] >= 0 && P [k] < m && !Mark [P [k]]) ;
+        if (ok) Mark [P [k]] = 1 ;
+    }
+    free (Mark) ;
+    return (ok) ;
+}
+
+int main (void)
+{
+    int *Gp, *Gi, *P1, *P2, *P3, k, RET, ok = 0 ;
+    double Info1 [AMD_INFO], Info2 [AMD_INFO], Info3 [AMD_INFO] ;
+
+    Gp = malloc ((N+1) * sizeof (int)) ;
+    Gi = malloc (N * (9 + NY) * sizeof (int)) ;
+    P1 = malloc (N * sizeof (int)) ;
+    P2 = malloc (N * sizeof (int)) ;
+    P3 = malloc (N * sizeof (int)) ;
+    if(!Gp || !Gi || !P1 || !P2 || !P3)
+    {
+        goto FAIL;
+    }
+    if(!grid (Gp, Gi))
+    {
+        goto FAIL;
+    }
+
+    /* the grid, with amd_order and with 4 threads */
+    RET = amd_order (N, Gp, Gi, P1, NULL, Info1) ;
+    if(RET < (AMD_OK))
+    {
+        goto FAIL;
+    }
+    RET = amd_par_order (N, Gp, Gi, P2, NULL, Info2, 4) ;
+    if(RET < (AMD_OK) || !is_perm (P2, N))
+    {
+        goto FAIL;
+    }
+    printf("nnz(L): amd_order %g, amd_par_order %g\n", Info1 [AMD_LNZ],
+        Info2 [AMD_LNZ]);
+    if(Info2 [AMD_LNZ] > FILL_TOLERANCE * Info1 [AMD_LNZ])
+    {
+        goto FAIL;
+    }
+
+    /* another number of threads gives the same permutation */
+    RET = amd_par_order (N, Gp, Gi, P3, NULL, Info3, 2) ;
+    if(RET < (AMD_OK))
+    {
+        goto FAIL;
+    }
+    for (k = 0 ; k < N ; k++)
+    {
+        if(P2 [k] != P3 [k])
+        {
+            goto FAIL;
+        }
+    }
+    if(Info2 [AMD_LNZ] != Info3 [AMD_LNZ])
+    {
+        goto FAIL;
+    }
+
+    /* a small matrix is ordered by amd_order */
+    RET = amd_order (n, Ap, Ai, P1, NULL, Info1) ;
+    RET = RET || amd_par_order (n, Ap, Ai, P2, NULL, Info2, 4) ;
+    if(RET != (AMD_OK))
+    {
+        goto FAIL;
+    }
+    for (k = 0 ; k < n ; k++)
+    {
+        if(P1 [k] != P2 [k])
+        {
+            goto FAIL;
+        }
+    }
+    ok = 1 ;
+
+FAIL:
+    free (Gp) ;
+    free (Gi) ;
+    free (P1) ;
+    free (P2) ;
+    free (P3) ;
+    return (!ok) ;
+}
@@ -0,0 +1,226 @@
+/* klu_test_btf_pf: multithreaded Pothen-Fan maximum matching for the BTF
+ * ordering (Common.btf_match = 1), for testing */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "klu.h"
+
+#define N 2000
+#define NZCOL 4
+
+int    n = 10 ;
+int    Ap [ ] = { 0,  2,  3,  6,  9, 12, 15, 20, 21, 27, 31 } ;
+int    Ai [ ] = { 0, 8, 1, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+double Ax [ ] = { 1, 1, 2, 3, 1, 1, 4, 5, 1, 6, 1, 1, 1, 7, 1, 1, 1, 8, 1, 1, 9, 1, 1, 1, 1, 10, 1, 1, 1, 1, 11 } ;
+
+/* random N-by-N matrix with at most NZCOL entries per column, with a hidden
+ * diagonal: A(:,q) has a zero-free diagonal for a random permutation q.  If
+ * nempty > 0, the last nempty rows are left empty, so the structural rank is
+ * at most N-nempty. */
+static int random_matrix (int *Bp, int *Bi, double *Bx, int *Perm, int nempty)
+{
+    int i, j, k, p, t, nz = 0, nrow = N - nempty ;
+    for (k = 0 ; k < N ; k++)
+    {
+        Perm [k] = k ;
+    }
+    for (k = N-1 ; k > 0 ; k--)
+    {
+        t = rand ( ) % (k+1) ;
+        j = Perm [k] ; Perm [k] = Perm [t] ; Perm [t] = j ;
+    }
+    for (j = 0 ; j < N ; j++)
+    {
+        Bp [j] = nz ;
+        for (k = 0 ; k < NZCOL ; k++)
+        {
+            /* random entries, then the entry of the hidden diagonal, so
+             * that the cheap match leaves many columns unmatched */
+            i = (k == NZCOL-1) ? Perm [j] : rand ( ) % N ;
+            if (i >= nrow)
+            {
+                continue ;
+            }
+            for (p = Bp [j] ; p < nz && Bi [p] != i ; p++) ;
+            if (p == nz)
+            {
+                Bx [nz] = 0 ;
+                Bi [nz++] = i ;
+            }
+            /* A(:,q) is diagonally dominant */
+            Bx [p] += (k == NZCOL-1) ? 10 : 1 ;
+        }
+    }
+    Bp [N] = nz ;
+    return (nz) ;
+}
+
+/* returns the size of the matching, or -1 if it is not a valid matching */
+static int check_matching (int nrow, int ncol, int *Bp, int *Bi, int *Match,
+    int *Flag)
+{
+    int i, j, p, found, nmatch = 0 ;
+    for (j = 0 ; j < ncol ; j++)
+    {
+        Flag [j] = 0 ;
+    }
+    for (i = 0 ; i < nrow ; i++)
+    {
+        j = Match [i] ;
+        if (j == -1)
+        {
+            continue ;
+        }
+        if (j < 0 || j >= ncol || Flag [j])
+        {
+            return (-1) ;
+        }
+        Flag [j] = 1 ;
+        found = 0 ;
+        for (p = Bp [j] ; p < Bp [j+1] ; p++)
+        {
+            found = found || (Bi [p] == i) ;
+        }
+        if (!found)
+        {
+            return (-1) ;
+        }
+        nmatch++ ;
+    }
+    return (nmatch) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    int *Bp = NULL, *Bi = NULL, *Match = NULL, *Work = NULL, *Perm = NULL,
+        nempty, nthreads, nmatch, nmatch_pf, ok = 0 ;
+    int i ;
+    double *Bx = NULL, *b = NULL, work, err ;
+
+    klu_defaults (&Common) ;
+    Common.btf_match = 1 ;
+    /* the diagonal found by the matching is not the hidden one, so use
+     * partial pivoting */
+    Common.tol = 1 ;
+
+    Bp = malloc ((N+1) * sizeof (int)) ;
+    Bi = malloc (NZCOL * N * sizeof (int)) ;
+    Bx = malloc (NZCOL * N * sizeof (double)) ;
+    Match = malloc (N * sizeof (int)) ;
+    Perm = malloc (N * sizeof (int)) ;
+    Work = malloc (6 * N * sizeof (int)) ;
+    b = malloc (N * sizeof (double)) ;
+    if(!Bp || !Bi || !Bx || !Match || !Perm || !Work || !b)
+    {
+        goto FAIL;
+    }
+
+    /* the same structural rank as btf_maxtrans, for any # of threads, on
+     * matrices with full and deficient structural rank */
+    srand (1) ;
+    for (nempty = 0 ; nempty <= 50 ; nempty += 25)
+    {
+        random_matrix (Bp, Bi, Bx, Perm, nempty) ;
+        nmatch = btf_maxtrans (N, N, Bp, Bi, 0, &work, Match, Work) ;
+        for (nthreads = 1 ; nthreads <= 4 ; nthreads *= 2)
+        {
+            nmatch_pf = btf_maxtrans_pf (N, N, Bp, Bi, nthreads, &work, Match,
+                Work) ;
+            printf("empty rows %d, threads %d: maxtrans %d, maxtrans_pf %d, "
+                "work %g\n", nempty, nthreads, nmatch, nmatch_pf, work);
+            if(nmatch_pf != nmatch ||
+                check_matching (N, N, Bp, Bi, Match, Work) != nmatch)
+            {
+                goto FAIL;
+            }
+        }
+    }
+
+    /* a rectangular matrix: the first N/2 columns */
+    nmatch = btf_maxtrans (N, N/2, Bp, Bi, 0, &work, Match, Work) ;
+    nmatch_pf = btf_maxtrans_pf (N, N/2, Bp, Bi, 0, &work, Match, Work) ;
+    if(nmatch_pf != nmatch || check_matching (N, N/2, Bp, Bi, Match, Work)
+        != nmatch)
+    {
+        goto FAIL;
+    }
+
+    /* klu_analyze finds the hidden diagonal, and the factorization solves
+     * A*x = A*1 */
+    random_matrix (Bp, Bi, Bx, Perm, 0) ;
+    Symbolic = klu_analyze (N, Bp, Bi, &Common) ;
+    if(!Symbolic || Symbolic->structural_rank != N)
+    {
+        goto FAIL;
+    }
+    printf("blocks %d, structural rank %d\n", Symbolic->nblocks,
+        Symbolic->structural_rank);
+    Numeric = klu_factor (Bp, Bi, Bx, Symbolic, &Common) ;
+    if(!Numeric)
+    {
+        goto FAIL;
+    }
+    for (i = 0 ; i < N ; i++)
+    {
+        b [i] = 0 ;
+    }
+    for (i = 0 ; i < Bp [N] ; i++)
+    {
+        b [Bi [i]] += Bx [i] ;
+    }
+    if(!klu_solve (Symbolic, Numeric, N, 1, b, &Common))
+    {
+        goto FAIL;
+    }
+    err = 0 ;
+    for (i = 0 ; i < N ; i++)
+    {
+        err = (b [i] - 1 > err) ? b [i] - 1 : (1 - b [i] > err) ? 1 - b [i] : err ;
+    }
+    printf("max error %g\n", err);
+    if(err > 1e-10)
+    {
+        goto FAIL;
+    }
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* a structurally singular matrix: the rank is found */
+    random_matrix (Bp, Bi, Bx, Perm, 25) ;
+    nmatch = btf_maxtrans (N, N, Bp, Bi, 0, &work, Match, Work) ;
+    Symbolic = klu_analyze (N, Bp, Bi, &Common) ;
+    if(!Symbolic || Symbolic->structural_rank != nmatch ||
+        Common.structural_rank != nmatch)
+    {
+        goto FAIL;
+    }
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* the example matrix */
+    Symbolic = klu_analyze (n, Ap, Ai, &Common) ;
+    if(!Symbolic || Symbolic->structural_rank != n)
+    {
+        goto FAIL;
+    }
+    Numeric = klu_factor (Ap, Ai, Ax, Symbolic, &Common) ;
+    if(!Numeric)
+    {
+        goto FAIL;
+    }
+    ok = 1 ;
+
+FAIL:
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    free (Bp) ;
+    free (Bi) ;
+    free (Bx) ;
+    free (Match) ;
+    free (Perm) ;
+    free (Work) ;
+    free (b) ;
+    return (!ok) ;
+}
@@ -0,0 +1,100 @@
+/* klu_test_btf_update: updates the BTF ordering of a KLU Symbolic object
+ * after a change of the pattern, for testing */
+
+#include <stdio.h>
+#include "klu.h"
+
+int    n = 10 ;
+int    Ap [ ] = { 0,  2,  3,  6,  9, 12, 15, 20, 21, 27, 31 } ;
+int    Ai [ ] = { 0, 8, 1, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+
+/* A with A(7,1) and A(1,7) added, which merges the 1-by-1 blocks of
+ * columns 1 and 7 */
+int    Ap_add [ ] = { 0,  2,  4,  7, 10, 13, 16, 21, 23, 29, 33 } ;
+int    Ai_add [ ] = { 0, 8, 1, 7, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 1, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+int    Ci_add [ ] = { 7, 1 } ;
+int    Cj_add [ ] = { 1, 7 } ;
+
+/* A with A(3,3) removed, which must be rematched */
+int    Ap_del [ ] = { 0,  2,  3,  6,  8, 11, 14, 19, 20, 26, 30 } ;
+int    Ai_del [ ] = { 0, 8, 1, 2, 6, 9, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+int    Ci_del [ ] = { 3 } ;
+int    Cj_del [ ] = { 3 } ;
+
+/* returns 1 if the diagonal of A(P,Q) has nmatch entries, 0 otherwise */
+static int check_diagonal (int *Bp, int *Bi, int *P, int *Q, int nmatch)
+{
+    int k, p, found, count = 0 ;
+    for (k = 0 ; k < n ; k++)
+    {
+        found = 0 ;
+        for (p = Bp [BTF_UNFLIP (Q [k])] ; p < Bp [BTF_UNFLIP (Q [k]) + 1] ; p++)
+        {
+            found = found || (Bi [p] == P [k]) ;
+        }
+        count += found ;
+    }
+    return (count == nmatch) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_common Common ;
+    int P [10], Q [10], R [11], P2 [10], Q2 [10], R2 [11], Bold [10],
+        Work [60], nblocks, nblocks2, nmatch, nmatch2, b ;
+    double work ;
+
+    klu_defaults (&Common) ;
+    Symbolic = klu_analyze (n, Ap, Ai, &Common) ;
+    if(!Symbolic)
+    {
+        goto FAIL;
+    }
+    printf("blocks before update %d\n", Symbolic->nblocks);
+
+    /* added entries: same blocks as btf_order, and the large block is kept */
+    nblocks = btf_order_update (n, Ap_add, Ai_add, 0, Symbolic->P,
+        Symbolic->Q, Symbolic->R, Symbolic->nblocks, 2, Ci_add, Cj_add,
+        &work, P, Q, R, &nmatch, Bold, Work) ;
+    nblocks2 = btf_order (n, Ap_add, Ai_add, 0, &work, P2, Q2, R2, &nmatch2,
+        Work) ;
+    printf("blocks after adding entries %d, btf_order %d\n", nblocks,
+        nblocks2);
+    if(nblocks != nblocks2 || nmatch != nmatch2 ||
+        !check_diagonal (Ap_add, Ai_add, P, Q, nmatch))
+    {
+        goto FAIL;
+    }
+    for (b = 0 ; b < nblocks ; b++)
+    {
+        printf("block %d size %d earlier block %d\n", b, R [b+1] - R [b],
+            Bold [b]);
+        /* only the merged 2-by-2 block is new */
+        if((R [b+1] - R [b] == 2) != (Bold [b] == -1))
+        {
+            goto FAIL;
+        }
+    }
+
+    /* removed entry: the matching is repaired */
+    nblocks = btf_order_update (n, Ap_del, Ai_del, 0, Symbolic->P,
+        Symbolic->Q, Symbolic->R, Symbolic->nblocks, 1, Ci_del, Cj_del,
+        &work, P, Q, R, &nmatch, Bold, Work) ;
+    nblocks2 = btf_order (n, Ap_del, Ai_del, 0, &work, P2, Q2, R2, &nmatch2,
+        Work) ;
+    printf("blocks after removing an entry %d, btf_order %d\n", nblocks,
+        nblocks2);
+    if(nblocks != nblocks2 || nmatch != nmatch2 ||
+        !check_diagonal (Ap_del, Ai_del, P, Q, nmatch))
+    {
+        goto FAIL;
+    }
+
+    klu_free_symbolic (&Symbolic, &Common) ;
+    return (0) ;
+
+FAIL:
+    klu_free_symbolic (&Symbolic, &Common) ;
+    return (1) ;
+}
@@ -0,0 +1,162 @@
+/* klu_test_cache: caching of klu_analyze results, for testing */
+
+#include <stdio.h>
+#include <math.h>
+#include "klu.h"
+
+#define TOLERANCE 1e-8
+
+int    n = 10 ;
+int    Ap [ ] = { 0,  2,  3,  6,  9, 12, 15, 20, 21, 27, 31 } ;
+int    Ai [ ] = { 0, 8, 1, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+double Ax [ ] = {8.18413247, 0.31910091, 0.95960852, 7.9683539 , 3.27076739,
+       9.3203983 , 2.94765012, 0.41596915, 8.55865174, 3.26336244,
+       2.56358029, 7.29705002, 9.42558416, 6.80016439, 5.82804034,
+       9.39211732, 9.31241378, 0.35525264, 7.68775477, 5.48634592,
+       2.80075036, 2.36812029, 1.13390547, 9.71284119, 6.02692506,
+       4.03715243, 4.36857613, 0.54369597, 6.86482384, 6.46735381,
+       4.76819917 } ;
+
+/* a different pattern: the diagonal of A */
+int    Ap_diag [ ] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 } ;
+int    Ai_diag [ ] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 } ;
+
+int varying_cols [ ] = { 3, 8 } ;
+int varying_rows [ ] = { 4, 6 } ;
+int n_variable_entries = 2 ;
+
+/* returns TRUE if both Symbolic objects have the same ordering */
+static int same_symbolic (klu_symbolic *S1, klu_symbolic *S2)
+{
+    int k ;
+    if (S1->n != S2->n || S1->nblocks != S2->nblocks || S1->nzoff != S2->nzoff)
+    {
+        return (0) ;
+    }
+    for (k = 0 ; k < S1->n ; k++)
+    {
+        if (S1->P [k] != S2->P [k] || S1->Q [k] != S2->Q [k])
+        {
+            return (0) ;
+        }
+    }
+    for (k = 0 ; k <= S1->nblocks ; k++)
+    {
+        if (S1->R [k] != S2->R [k])
+        {
+            return (0) ;
+        }
+    }
+    return (1) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL, *S1 = NULL, *S2 = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_cache *Cache = NULL ;
+    klu_common Common ;
+    double b [10], c [10], max_error, error ;
+    int i, ok = 1 ;
+
+    klu_defaults (&Common) ;
+    Cache = klu_alloc_cache (2, &Common) ;
+    if(!Cache)
+    {
+        goto FAIL;
+    }
+
+    /* the second call with the same pattern is a cache hit */
+    S1 = klu_analyze_cached (n, Ap, Ai, 0, Cache, &Common) ;
+    S2 = klu_analyze_cached (n, Ap, Ai, 0, Cache, &Common) ;
+    if(!S1 || !S2 || Cache->hits != 1 || Cache->misses != 1 ||
+        !same_symbolic (S1, S2))
+    {
+        goto FAIL;
+    }
+    klu_free_symbolic (&S1, &Common) ;
+    klu_free_symbolic (&S2, &Common) ;
+
+    /* klu_analyze_partial results are cached separately, and pinned */
+    S1 = klu_analyze_partial_cached (n, Ap, Ai, varying_cols, varying_rows,
+        n_variable_entries, AMD_ORDERING, 1, Cache, &Common) ;
+    S2 = klu_analyze_partial_cached (n, Ap, Ai, varying_cols, varying_rows,
+        n_variable_entries, AMD_ORDERING, 0, Cache, &Common) ;
+    if(!S1 || !S2 || Cache->hits != 2 || Cache->misses != 2 ||
+        !same_symbolic (S1, S2) || S1->est_pathlen != S2->est_pathlen)
+    {
+        goto FAIL;
+    }
+    klu_free_symbolic (&S1, &Common) ;
+    klu_free_symbolic (&S2, &Common) ;
+
+    /* a new pattern replaces the klu_analyze entry, not the pinned one */
+    S1 = klu_analyze_cached (n, Ap_diag, Ai_diag, 0, Cache, &Common) ;
+    klu_free_symbolic (&S1, &Common) ;
+    S1 = klu_analyze_partial_cached (n, Ap, Ai, varying_cols, varying_rows,
+        n_variable_entries, AMD_ORDERING, 0, Cache, &Common) ;
+    klu_free_symbolic (&S1, &Common) ;
+    if(Cache->nentries != 2 || Cache->hits != 3 || Cache->misses != 3)
+    {
+        goto FAIL;
+    }
+    printf("cache hits %d misses %d\n", Cache->hits, Cache->misses);
+
+    /* factorize and solve with a cached Symbolic object */
+    Symbolic = klu_analyze_cached (n, Ap, Ai, 0, Cache, &Common) ;
+    if(!Symbolic)
+    {
+        goto FAIL;
+    }
+    Numeric = klu_factor (Ap, Ai, Ax, Symbolic, &Common) ;
+    if(!Numeric)
+    {
+        goto FAIL;
+    }
+    for (i = 0 ; i < n ; i++)
+    {
+        b [i] = 1 ;
+    }
+    klu_solve (Symbolic, Numeric, n, 1, b, &Common) ;
+
+    /* check the residual, c = A*b - 1 */
+    for (i = 0 ; i < n ; i++)
+    {
+        c [i] = -1 ;
+    }
+    for (i = 0 ; i < n ; i++)
+    {
+        int p ;
+        for (p = Ap [i] ; p < Ap [i+1] ; p++)
+        {
+            c [Ai [p]] += Ax [p] * b [i] ;
+        }
+    }
+    max_error = 0 ;
+    for(i = 0 ; i < n ; i++)
+    {
+        error = fabs(c[i]);
+        if(error > max_error)
+        {
+            max_error = error;
+        }
+    }
+    printf("residual %g\n", max_error);
+    if(max_error > TOLERANCE)
+    {
+        ok = 0 ;
+    }
+
+    klu_free_symbolic (&Symbolic, &Common) ;
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_cache (&Cache, &Common) ;
+    return (!ok || Common.memusage != 0) ;
+
+FAIL:
+    klu_free_symbolic (&S1, &Common) ;
+    klu_free_symbolic (&S2, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_cache (&Cache, &Common) ;
+    return (1) ;
+}
@@ -0,0 +1,248 @@
+/* klu_test_constrained: CAMD ordering of each block with given constraint
+ * sets (klu_analyze_constrained), for testing */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "klu.h"
+
+#define NX 20
+#define NY 20
+#define N (NX*NY)
+#define NB 300
+
+int    Gp [N+1] ;
+int    Gi [5*N] ;
+double Gx [5*N] ;
+int    Bp [NB+1] ;
+int    Bi [4*NB] ;
+double Bx [4*NB] ;
+int    Cmember [N] ;
+
+/* 5-point grid of NX-by-NY nodes */
+static void grid (void)
+{
+    int x, y, nz = 0 ;
+    for (x = 0 ; x < NX ; x++)
+    {
+        for (y = 0 ; y < NY ; y++)
+        {
+            Gp [x*NY + y] = nz ;
+            if (x > 0)
+            {
+                Gx [nz] = -1 ;
+                Gi [nz++] = (x-1)*NY + y ;
+            }
+            if (y > 0)
+            {
+                Gx [nz] = -1.5 ;
+                Gi [nz++] = x*NY + y-1 ;
+            }
+            Gx [nz] = 8 ;
+            Gi [nz++] = x*NY + y ;
+            if (y < NY-1)
+            {
+                Gx [nz] = -0.5 ;
+                Gi [nz++] = x*NY + y+1 ;
+            }
+            if (x < NX-1)
+            {
+                Gx [nz] = -2 ;
+                Gi [nz++] = (x+1)*NY + y ;
+            }
+        }
+    }
+    Gp [N] = nz ;
+}
+
+/* block upper triangular matrix of NB columns, with cycles of 1 to 8 columns
+ * as its diagonal blocks, and one entry above the diagonal in each column */
+static void blocks (void)
+{
+    int j, start, len, nz = 0 ;
+    for (start = 0 ; start < NB ; start += len)
+    {
+        len = 1 + rand ( ) % 8 ;
+        len = (start + len > NB) ? NB - start : len ;
+        for (j = start ; j < start + len ; j++)
+        {
+            Bp [j] = nz ;
+            if (start > 0)
+            {
+                Bx [nz] = 1 ;
+                Bi [nz++] = rand ( ) % start ;
+            }
+            Bx [nz] = 1 ;
+            Bi [nz++] = (j == start) ? start + len - 1 : j - 1 ;
+            if (len > 1)
+            {
+                Bx [nz] = 4 ;
+                Bi [nz++] = j ;
+            }
+            else
+            {
+                Bx [nz-1] = 4 ;
+            }
+        }
+    }
+    Bp [NB] = nz ;
+}
+
+/* returns 1 if the columns of each block are in increasing order of set */
+static int check_sets (klu_symbolic *Symbolic)
+{
+    int block, k ;
+    for (block = 0 ; block < Symbolic->nblocks ; block++)
+    {
+        for (k = Symbolic->R [block] + 1 ; k < Symbolic->R [block+1] ; k++)
+        {
+            if(Cmember [Symbolic->Q [k-1]] > Cmember [Symbolic->Q [k]])
+            {
+                return (0) ;
+            }
+        }
+    }
+    return (Symbolic->ordering == 6) ;
+}
+
+/* solves A*x = A*1 and returns the max error in x, or -1 on failure */
+static double solve_error (int n, int *Ap, int *Ai, double *Ax,
+    klu_symbolic *Symbolic, klu_common *Common)
+{
+    klu_numeric *Numeric ;
+    double b [N], err = 0 ;
+    int i, p ;
+    Numeric = klu_factor (Ap, Ai, Ax, Symbolic, Common) ;
+    if(!Numeric)
+    {
+        return (-1) ;
+    }
+    for (i = 0 ; i < n ; i++)
+    {
+        b [i] = 0 ;
+    }
+    for (p = 0 ; p < Ap [n] ; p++)
+    {
+        b [Ai [p]] += Ax [p] ;
+    }
+    if(!klu_solve (Symbolic, Numeric, n, 1, b, Common))
+    {
+        err = -1 ;
+    }
+    for (i = 0 ; err >= 0 && i < n ; i++)
+    {
+        err = (b [i] - 1 > err) ? b [i] - 1 : (1 - b [i] > err) ? 1 - b [i] : err ;
+    }
+    klu_free_numeric (&Numeric, Common) ;
+    return (err) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    int varying_cols [NY], varying_rows [NY], j, y, pathlen, ok = 0 ;
+    double err ;
+
+    klu_defaults (&Common) ;
+    grid ( ) ;
+    srand (1) ;
+    blocks ( ) ;
+
+    /* the interface nodes x = NX/2 vary, and are ordered last */
+    for (j = 0 ; j < N ; j++)
+    {
+        Cmember [j] = 0 ;
+    }
+    for (y = 0 ; y < NY ; y++)
+    {
+        j = (NX/2)*NY + y ;
+        Cmember [j] = 1 ;
+        varying_cols [y] = j ;
+        varying_rows [y] = j ;
+    }
+    Symbolic = klu_analyze_constrained (N, Gp, Gi, Cmember, &Common) ;
+    if(!Symbolic || !check_sets (Symbolic))
+    {
+        goto FAIL;
+    }
+    err = solve_error (N, Gp, Gi, Gx, Symbolic, &Common) ;
+    Numeric = klu_factor (Gp, Gi, Gx, Symbolic, &Common) ;
+    if(err < 0 || err > 1e-12 || !Numeric ||
+       !klu_compute_path (Symbolic, Numeric, &Common, Gp, Gi, varying_cols,
+        varying_rows, NY))
+    {
+        goto FAIL;
+    }
+    pathlen = Numeric->pathLen ;
+    printf("grid, interface last: nnz(L) %g, path length %d, error %g\n",
+        Symbolic->lnz, pathlen, err);
+
+    /* with AMD, the path is longer */
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    Symbolic = klu_analyze (N, Gp, Gi, &Common) ;
+    Numeric = Symbolic ? klu_factor (Gp, Gi, Gx, Symbolic, &Common) : NULL ;
+    if(!Numeric || !klu_compute_path (Symbolic, Numeric, &Common, Gp, Gi,
+        varying_cols, varying_rows, NY))
+    {
+        goto FAIL;
+    }
+    printf("grid, AMD: nnz(L) %g, path length %d\n", Symbolic->lnz,
+        Numeric->pathLen);
+    if(pathlen != NY || Numeric->pathLen <= pathlen)
+    {
+        goto FAIL;
+    }
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* many blocks, small and large, with sets spread over 0 to NB-1 */
+    for (j = 0 ; j < NB ; j++)
+    {
+        Cmember [j] = (rand ( ) % 3) * (NB/3) ;
+    }
+    Symbolic = klu_analyze_constrained (NB, Bp, Bi, Cmember, &Common) ;
+    if(!Symbolic || Symbolic->nblocks < 10 || !check_sets (Symbolic))
+    {
+        goto FAIL;
+    }
+    err = solve_error (NB, Bp, Bi, Bx, Symbolic, &Common) ;
+    printf("%d blocks: error %g\n", Symbolic->nblocks, err);
+    if(err < 0 || err > 1e-12)
+    {
+        goto FAIL;
+    }
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* and without BTF */
+    Common.btf = 0 ;
+    Symbolic = klu_analyze_constrained (NB, Bp, Bi, Cmember, &Common) ;
+    if(!Symbolic || Symbolic->nblocks != 1 || !check_sets (Symbolic))
+    {
+        goto FAIL;
+    }
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* sets out of range are rejected */
+    Cmember [0] = NB ;
+    Symbolic = klu_analyze_constrained (NB, Bp, Bi, Cmember, &Common) ;
+    if(Symbolic || Common.status != KLU_INVALID)
+    {
+        goto FAIL;
+    }
+
+    /* ordering 6 needs the constraint sets, so klu_analyze rejects it */
+    Common.ordering = 6 ;
+    Symbolic = klu_analyze (NB, Bp, Bi, &Common) ;
+    if(Symbolic || Common.status != KLU_INVALID)
+    {
+        goto FAIL;
+    }
+    ok = 1 ;
+
+FAIL:
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    return (!ok) ;
+}
@@ -0,0 +1,229 @@
+/* klu_test_factor_reuse: refactorization with the old pivots, and partial
+ * pivoting only in the blocks where they fail (klu_factor_reuse), for
+ * testing */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "klu.h"
+
+#define N 300
+#define NZCOL 6
+
+int    Gp [N+1] ;
+int    Gi [NZCOL*N] ;
+double Gx [NZCOL*N] ;
+int    Gdiag [N] ;
+double B [N] ;
+
+/* random block upper triangular matrix, with diagonal blocks of size 1 to 8
+ * (cycles), entries above the diagonal blocks, and a dominant diagonal whose
+ * positions are returned in Gdiag.  The rows and columns are scrambled so
+ * that BTF has to find the blocks. */
+static void random_matrix (void)
+{
+    int i, j, k, p, t, start, len, nz = 0 ;
+    int Start [N], Perm [N], Pinv [N] ;
+    for (k = 0 ; k < N ; k++)
+    {
+        Perm [k] = k ;
+    }
+    for (k = N-1 ; k > 0 ; k--)
+    {
+        t = rand ( ) % (k+1) ;
+        j = Perm [k] ; Perm [k] = Perm [t] ; Perm [t] = j ;
+    }
+    for (start = 0 ; start < N ; start += len)
+    {
+        len = 1 + rand ( ) % 8 ;
+        len = (start + len > N) ? N - start : len ;
+        for (k = start ; k < start + len ; k++)
+        {
+            Start [k] = start ;
+        }
+    }
+    for (k = 0 ; k < N ; k++)
+    {
+        Pinv [Perm [k]] = k ;
+    }
+    for (j = 0 ; j < N ; j++)
+    {
+        k = Pinv [j] ;
+        Gp [j] = nz ;
+        Gdiag [j] = nz ;
+        Gi [nz] = Perm [k] ;
+        Gx [nz++] = 10 ;
+        if (k > Start [k])
+        {
+            Gi [nz] = Perm [k-1] ;
+            Gx [nz++] = 1 ;
+        }
+        else if (k + 1 < N && Start [k+1] == Start [k])
+        {
+            for (i = k+1 ; i+1 < N && Start [i+1] == Start [k] ; i++) ;
+            Gi [nz] = Perm [i] ;
+            Gx [nz++] = 1 ;
+        }
+        else
+        {
+            /* singleton */
+            Gdiag [j] = -1 ;
+        }
+        for (t = 0 ; t < NZCOL-2 && Start [k] > 0 ; t++)
+        {
+            i = Perm [rand ( ) % Start [k]] ;
+            for (p = Gp [j] ; p < nz && Gi [p] != i ; p++) ;
+            if (p == nz)
+            {
+                Gi [nz] = i ;
+                Gx [nz++] = -0.1 + 0.01 * (rand ( ) % 7) ;
+            }
+        }
+    }
+    Gp [N] = nz ;
+}
+
+/* solves A*x = A*1 and returns the max error in x, or -1 on failure */
+static double solve_error (klu_symbolic *Symbolic, klu_numeric *Numeric,
+    klu_common *Common)
+{
+    int i, p ;
+    double err = 0, e ;
+    for (i = 0 ; i < N ; i++)
+    {
+        B [i] = 0 ;
+    }
+    for (p = 0 ; p < Gp [N] ; p++)
+    {
+        B [Gi [p]] += Gx [p] ;
+    }
+    if(!klu_solve (Symbolic, Numeric, N, 1, B, Common))
+    {
+        return (-1) ;
+    }
+    for (i = 0 ; i < N ; i++)
+    {
+        e = B [i] - 1 ;
+        e = (e < 0) ? -e : e ;
+        err = (e > err) ? e : err ;
+    }
+    return (err) ;
+}
+
+/* the diagonal of the blocks that are not singletons is set to d */
+static void set_diagonal (double d)
+{
+    int j ;
+    for (j = 0 ; j < N ; j++)
+    {
+        if (Gdiag [j] >= 0)
+        {
+            Gx [Gdiag [j]] = d ;
+        }
+    }
+}
+
+/* returns 1 if Pnum has changed */
+static int pivots_changed (int *Pnum, klu_numeric *Numeric)
+{
+    int k, changed = 0 ;
+    for (k = 0 ; k < N ; k++)
+    {
+        changed |= (Pnum [k] != Numeric->Pnum [k]) ;
+        Pnum [k] = Numeric->Pnum [k] ;
+    }
+    return (changed) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    int Pnum [N], vary_cols [1], vary_rows [1], scale, ok = 0 ;
+    double err ;
+
+    srand (1) ;
+    random_matrix ( ) ;
+    klu_defaults (&Common) ;
+    Common.tol = 0.5 ;
+    Symbolic = klu_analyze (N, Gp, Gi, &Common) ;
+    if(!Symbolic || Symbolic->nblocks < 10)
+    {
+        goto FAIL;
+    }
+
+    for (scale = 2 ; scale >= 0 ; scale -= 2)
+    {
+        Common.scale = scale ;
+        Common.offdiag_rows = (scale == 0) ;
+        set_diagonal (10) ;
+        Numeric = klu_factor (Gp, Gi, Gx, Symbolic, &Common) ;
+        if(!Numeric)
+        {
+            goto FAIL;
+        }
+        pivots_changed (Pnum, Numeric) ;
+
+        /* small changes keep every pivot */
+        set_diagonal (9) ;
+        err = klu_factor_reuse (Gp, Gi, Gx, Symbolic, Numeric, &Common) ?
+            solve_error (Symbolic, Numeric, &Common) : -1 ;
+        printf("scale %d, same pivots: blocks repivoted %d, error %g\n",
+            scale, Common.nrepivot, err);
+        if(err < 0 || err > 1e-12 || Common.nrepivot != 0 ||
+           pivots_changed (Pnum, Numeric))
+        {
+            goto FAIL;
+        }
+
+        /* tiny diagonals fail the threshold test */
+        set_diagonal (1e-6) ;
+        err = klu_factor_reuse (Gp, Gi, Gx, Symbolic, Numeric, &Common) ?
+            solve_error (Symbolic, Numeric, &Common) : -1 ;
+        printf("scale %d, tiny diagonal: blocks repivoted %d, error %g\n",
+            scale, Common.nrepivot, err);
+        if(err < 0 || err > 1e-10 || Common.nrepivot == 0 ||
+           !pivots_changed (Pnum, Numeric))
+        {
+            goto FAIL;
+        }
+
+        /* and the large ones bring the old pivots back */
+        set_diagonal (10) ;
+        err = klu_factor_reuse (Gp, Gi, Gx, Symbolic, Numeric, &Common) ?
+            solve_error (Symbolic, Numeric, &Common) : -1 ;
+        printf("scale %d, diagonal restored: blocks repivoted %d, error %g\n",
+            scale, Common.nrepivot, err);
+        if(err < 0 || err > 1e-12 || Common.nrepivot == 0 ||
+           !pivots_changed (Pnum, Numeric))
+        {
+            goto FAIL;
+        }
+
+        /* the factorization path is computed again after new pivots */
+        vary_cols [0] = 0 ;
+        vary_rows [0] = Gi [Gp [0]] ;
+        Gx [Gp [0]] = 12 ;
+        if(!klu_compute_path (Symbolic, Numeric, &Common, Gp, Gi, vary_cols,
+            vary_rows, 1) ||
+           !klu_partial_factorization_path (Gp, Gi, Gx, Symbolic, Numeric,
+            &Common))
+        {
+            goto FAIL;
+        }
+        err = solve_error (Symbolic, Numeric, &Common) ;
+        printf("scale %d, partial: error %g\n", scale, err);
+        Gx [Gp [0]] = 10 ;
+        if(err < 0 || err > 1e-12)
+        {
+            goto FAIL;
+        }
+        klu_free_numeric (&Numeric, &Common) ;
+    }
+    ok = 1 ;
+
+FAIL:
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    return (!ok) ;
+}
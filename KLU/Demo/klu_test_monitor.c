@@ -0,0 +1,180 @@
+/* klu_test_monitor: incremental rcond and rgrowth monitor during partial
+ * refactorization (Common.monitor = 1), for testing */
+
+#include <stdio.h>
+#include <math.h>
+#include "klu.h"
+
+#define NX 20
+#define NY 20
+#define N (NX*NY)
+
+int    Gp [N+1] ;
+int    Gi [5*N] ;
+double Gx [5*N] ;
+
+/* 5-point grid of NX-by-NY nodes, with a small diagonal in every 7th column
+ * so that the pivots grow; returns the position of A(c,c) */
+static int grid (int c)
+{
+    int x, y, nz = 0, pc = -1 ;
+    for (x = 0 ; x < NX ; x++)
+    {
+        for (y = 0 ; y < NY ; y++)
+        {
+            Gp [x*NY + y] = nz ;
+            if (x > 0)
+            {
+                Gx [nz] = -1 ;
+                Gi [nz++] = (x-1)*NY + y ;
+            }
+            if (y > 0)
+            {
+                Gx [nz] = -1.5 ;
+                Gi [nz++] = x*NY + y-1 ;
+            }
+            if (x*NY + y == c)
+            {
+                pc = nz ;
+            }
+            Gx [nz] = ((x*NY + y) % 7 == 0) ? 0.05 : 6 + (x*NY + y) % 3 ;
+            Gi [nz++] = x*NY + y ;
+            if (y < NY-1)
+            {
+                Gx [nz] = -0.5 ;
+                Gi [nz++] = x*NY + y+1 ;
+            }
+            if (x < NX-1)
+            {
+                Gx [nz] = -2 ;
+                Gi [nz++] = (x+1)*NY + y ;
+            }
+        }
+    }
+    Gp [N] = nz ;
+    return (pc) ;
+}
+
+/* returns 1 if the monitor agrees with klu_rcond and klu_rgrowth */
+static int check_monitor (const char *what, klu_symbolic *Symbolic,
+    klu_numeric *Numeric, klu_common *Common)
+{
+    double rcond = Common->rcond, rgrowth = Common->rgrowth ;
+    int flag = Common->monitor_flag ;
+    if(!klu_rcond (Symbolic, Numeric, Common) ||
+       !klu_rgrowth (Gp, Gi, Gx, Symbolic, Numeric, Common))
+    {
+        return (0) ;
+    }
+    printf("%s: rcond %g (klu_rcond %g), rgrowth %g (klu_rgrowth %g), "
+        "flag %d\n", what, rcond, Common->rcond, rgrowth, Common->rgrowth,
+        flag);
+    return (fabs (rcond - Common->rcond) <= 1e-14 * Common->rcond &&
+        fabs (rgrowth - Common->rgrowth) <= 1e-14 * Common->rgrowth) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    int c = N/2 + 4, pc, scale, ok = 0 ;
+    int varying_cols [1], varying_rows [1] ;
+    double diag ;
+
+    varying_cols [0] = c ;
+    varying_rows [0] = c ;
+    pc = grid (c) ;
+    diag = Gx [pc] ;
+
+    klu_defaults (&Common) ;
+    Common.monitor = 1 ;
+    Symbolic = klu_analyze_partial (N, Gp, Gi, varying_cols, varying_rows, 1,
+        AMD_ORDERING, &Common) ;
+    if(!Symbolic)
+    {
+        goto FAIL;
+    }
+
+    /* the monitor matches the full estimates after each kind of
+     * factorization, scaled and not */
+    for (scale = 2 ; scale >= 0 ; scale -= 2)
+    {
+        Common.scale = scale ;
+        Gx [pc] = diag ;
+        Numeric = klu_factor (Gp, Gi, Gx, Symbolic, &Common) ;
+        if(!Numeric || Common.monitor_flag != 0 ||
+           !check_monitor ("factor", Symbolic, Numeric, &Common))
+        {
+            goto FAIL;
+        }
+        if(!klu_compute_path (Symbolic, Numeric, &Common, Gp, Gi,
+            varying_cols, varying_rows, 1))
+        {
+            goto FAIL;
+        }
+        Gx [pc] = 3 * diag ;
+        if(!klu_partial_factorization_path (Gp, Gi, Gx, Symbolic, Numeric,
+            &Common) || !check_monitor ("partial", Symbolic, Numeric, &Common))
+        {
+            goto FAIL;
+        }
+        Gx [pc] = 0.5 * diag ;
+        if(!klu_refactor (Gp, Gi, Gx, Symbolic, Numeric, &Common) ||
+           !check_monitor ("refactor", Symbolic, Numeric, &Common))
+        {
+            goto FAIL;
+        }
+        if(!klu_determine_start (Symbolic, Numeric, &Common, Gp, Gi,
+            varying_cols, varying_rows, 1))
+        {
+            goto FAIL;
+        }
+        Gx [pc] = 2 * diag ;
+        if(!klu_partial_refactorization_restart (Gp, Gi, Gx, Symbolic,
+            Numeric, &Common) ||
+           !check_monitor ("restart", Symbolic, Numeric, &Common))
+        {
+            goto FAIL;
+        }
+        if(scale > 0)
+        {
+            klu_free_numeric (&Numeric, &Common) ;
+        }
+    }
+
+    /* a huge diagonal entry raises the rcond flag, and clearing it lowers
+     * the flag again */
+    if(!klu_compute_path (Symbolic, Numeric, &Common, Gp, Gi,
+        varying_cols, varying_rows, 1))
+    {
+        goto FAIL;
+    }
+    Gx [pc] = 1e15 ;
+    if(!klu_partial_factorization_path (Gp, Gi, Gx, Symbolic, Numeric,
+        &Common) || Common.monitor_flag != KLU_MONITOR_RCOND ||
+       !check_monitor ("huge entry", Symbolic, Numeric, &Common))
+    {
+        goto FAIL;
+    }
+    Gx [pc] = diag ;
+    if(!klu_partial_factorization_path (Gp, Gi, Gx, Symbolic, Numeric,
+        &Common) || Common.monitor_flag != 0)
+    {
+        goto FAIL;
+    }
+
+    /* so does a pivot growth threshold that cannot be met */
+    Common.monitor_rgrowth_tol = 2 ;
+    if(!klu_partial_factorization_path (Gp, Gi, Gx, Symbolic, Numeric,
+        &Common) || Common.monitor_flag != KLU_MONITOR_RGROWTH)
+    {
+        goto FAIL;
+    }
+    ok = 1 ;
+
+FAIL:
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    return (!ok) ;
+}
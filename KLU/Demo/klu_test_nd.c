@@ -0,0 +1,209 @@
+/* klu_test_nd: nested dissection ordering, with the subtrees factorized in
+ * parallel (Common.ordering = 5), for testing */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "klu.h"
+
+#define NX 40
+#define NY 40
+#define N (NX*NY)
+
+int    n = 10 ;
+int    Ap [ ] = { 0,  2,  3,  6,  9, 12, 15, 20, 21, 27, 31 } ;
+int    Ai [ ] = { 0, 8, 1, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+double Ax [ ] = { 1, 1, 2, 3, 1, 1, 4, 5, 1, 6, 1, 1, 1, 7, 1, 1, 1, 8, 1, 1, 9, 1, 1, 1, 1, 10, 1, 1, 1, 1, 11 } ;
+
+/* 5-point grid of NX-by-NY nodes, with unsymmetric values, and a small
+ * diagonal in every 7th column */
+static int grid (int *Gp, int *Gi, double *Gx)
+{
+    int x, y, nz = 0 ;
+    for (x = 0 ; x < NX ; x++)
+    {
+        for (y = 0 ; y < NY ; y++)
+        {
+            Gp [x*NY + y] = nz ;
+            if (x > 0)
+            {
+                Gx [nz] = -1 ;
+                Gi [nz++] = (x-1)*NY + y ;
+            }
+            if (y > 0)
+            {
+                Gx [nz] = -2 ;
+                Gi [nz++] = x*NY + y-1 ;
+            }
+            Gx [nz] = ((x*NY + y) % 7 == 0) ? 1e-4 : 6 ;
+            Gi [nz++] = x*NY + y ;
+            if (y < NY-1)
+            {
+                Gx [nz] = -0.5 ;
+                Gi [nz++] = x*NY + y+1 ;
+            }
+            if (x < NX-1)
+            {
+                Gx [nz] = -1.5 ;
+                Gi [nz++] = (x+1)*NY + y ;
+            }
+        }
+    }
+    Gp [N] = nz ;
+    return (nz) ;
+}
+
+/* solves A*x = A*1 and returns the max error in x, or -1 on failure */
+static double solve_error (int m, int *Bp, int *Bi, double *Bx, double *b,
+    klu_symbolic *Symbolic, klu_numeric *Numeric, klu_common *Common)
+{
+    int i, j, p ;
+    double err = 0 ;
+    for (i = 0 ; i < m ; i++)
+    {
+        b [i] = 0 ;
+    }
+    for (j = 0 ; j < m ; j++)
+    {
+        for (p = Bp [j] ; p < Bp [j+1] ; p++)
+        {
+            b [Bi [p]] += Bx [p] ;
+        }
+    }
+    if(!klu_solve (Symbolic, Numeric, m, 1, b, Common))
+    {
+        return (-1) ;
+    }
+    for (i = 0 ; i < m ; i++)
+    {
+        err = (b [i] - 1 > err) ? b [i] - 1 : (1 - b [i] > err) ? 1 - b [i] : err ;
+    }
+    return (err) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    int *Gp = NULL, *Gi = NULL, k, ndom, ok = 0 ;
+    double *Gx = NULL, *b = NULL, err ;
+
+    klu_defaults (&Common) ;
+    Common.ordering = 5 ;
+    Common.nd_min = 100 ;
+    Common.nd_domains = 8 ;
+
+    Gp = malloc ((N+1) * sizeof (int)) ;
+    Gi = malloc (5 * N * sizeof (int)) ;
+    Gx = malloc (5 * N * sizeof (double)) ;
+    b = malloc (N * sizeof (double)) ;
+    if(!Gp || !Gi || !Gx || !b)
+    {
+        goto FAIL;
+    }
+    grid (Gp, Gi, Gx) ;
+
+    /* the grid is one block, split into domains.  Domain [k] is one past
+     * the end of the domain of column k, or -1 for the separators */
+    Symbolic = klu_analyze (N, Gp, Gi, &Common) ;
+    if(!Symbolic || Symbolic->nblocks != 1 || !Symbolic->Domain)
+    {
+        goto FAIL;
+    }
+    ndom = 0 ;
+    for (k = 0 ; k < N && Symbolic->Domain [k] != -1 ; k = Symbolic->Domain [k])
+    {
+        if(Symbolic->Domain [k] <= k)
+        {
+            goto FAIL;
+        }
+        ndom++ ;
+    }
+    printf("grid: %d domains, %d separator columns, nnz(L) %g\n", ndom, N-k,
+        Symbolic->lnz);
+    if(ndom < 2 || N-k > N/2)
+    {
+        goto FAIL;
+    }
+
+    /* factorize and solve A*x = A*1 */
+    Numeric = klu_factor (Gp, Gi, Gx, Symbolic, &Common) ;
+    if(!Numeric)
+    {
+        goto FAIL;
+    }
+    err = solve_error (N, Gp, Gi, Gx, b, Symbolic, Numeric, &Common) ;
+    printf("factor: max error %g, nnz(L) %d, off-diagonal pivots %d\n", err,
+        Numeric->lnz, Common.noffdiag);
+    if(err < 0 || err > 1e-8)
+    {
+        goto FAIL;
+    }
+
+    /* refactorize with new values, scaled and not */
+    for (k = 0 ; k < Gp [N] ; k++)
+    {
+        Gx [k] *= 1 + (k % 5) * 0.1 ;
+    }
+    if(!klu_refactor (Gp, Gi, Gx, Symbolic, Numeric, &Common))
+    {
+        goto FAIL;
+    }
+    err = solve_error (N, Gp, Gi, Gx, b, Symbolic, Numeric, &Common) ;
+    printf("refactor: max error %g\n", err);
+    if(err < 0 || err > 1e-8)
+    {
+        goto FAIL;
+    }
+    Common.scale = 0 ;
+    for (k = 0 ; k < Gp [N] ; k++)
+    {
+        Gx [k] *= 1 + (k % 3) * 0.2 ;
+    }
+    if(!klu_refactor (Gp, Gi, Gx, Symbolic, Numeric, &Common))
+    {
+        goto FAIL;
+    }
+    err = solve_error (N, Gp, Gi, Gx, b, Symbolic, Numeric, &Common) ;
+    printf("refactor without scaling: max error %g\n", err);
+    if(err < 0 || err > 1e-8)
+    {
+        goto FAIL;
+    }
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* small blocks are ordered with AMD, and are not split */
+    Symbolic = klu_analyze (n, Ap, Ai, &Common) ;
+    if(!Symbolic || !Symbolic->Domain)
+    {
+        goto FAIL;
+    }
+    for (k = 0 ; k < n ; k++)
+    {
+        if(Symbolic->Domain [k] != -1)
+        {
+            goto FAIL;
+        }
+    }
+    Numeric = klu_factor (Ap, Ai, Ax, Symbolic, &Common) ;
+    if(!Numeric)
+    {
+        goto FAIL;
+    }
+    err = solve_error (n, Ap, Ai, Ax, b, Symbolic, Numeric, &Common) ;
+    if(err < 0 || err > 1e-10)
+    {
+        goto FAIL;
+    }
+    ok = 1 ;
+
+FAIL:
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    free (Gp) ;
+    free (Gi) ;
+    free (Gx) ;
+    free (b) ;
+    return (!ok) ;
+}
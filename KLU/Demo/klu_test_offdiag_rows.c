@@ -0,0 +1,281 @@
+/* klu_test_offdiag_rows: off-diagonal blocks stored by rows, with the varying
+ * entries contiguous (Common.offdiag_rows = 1), for testing */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "klu.h"
+
+#define N 300
+#define NZCOL 6
+#define NVARY 200
+
+int    Gp [N+1] ;
+int    Gi [NZCOL*N] ;
+double Gx [NZCOL*N] ;
+int    vary_cols [NVARY], vary_rows [NVARY], vary_pos [NVARY] ;
+double B [3*N] ;
+
+/* random block upper triangular matrix, with diagonal blocks of size 1 to 5
+ * (cycles), entries above the diagonal blocks, and a dominant diagonal.  The
+ * rows and columns are scrambled so that BTF has to find the blocks. */
+static int random_matrix (int *Perm)
+{
+    int i, j, k, p, t, start, len, nz = 0 ;
+    int Start [N], Pinv [N] ;
+    for (k = 0 ; k < N ; k++)
+    {
+        Perm [k] = k ;
+    }
+    for (k = N-1 ; k > 0 ; k--)
+    {
+        t = rand ( ) % (k+1) ;
+        j = Perm [k] ; Perm [k] = Perm [t] ; Perm [t] = j ;
+    }
+    for (start = 0 ; start < N ; start += len)
+    {
+        len = 1 + rand ( ) % 5 ;
+        len = (start + len > N) ? N - start : len ;
+        for (k = start ; k < start + len ; k++)
+        {
+            Start [k] = start ;
+        }
+    }
+    for (k = 0 ; k < N ; k++)
+    {
+        Pinv [Perm [k]] = k ;
+    }
+    for (j = 0 ; j < N ; j++)
+    {
+        /* column j of A is column k of the block triangular form, and row
+         * Perm [i] of A is its row i */
+        k = Pinv [j] ;
+        Gp [j] = nz ;
+        Gi [nz] = Perm [k] ;
+        Gx [nz++] = 10 ;
+        if (k > Start [k])
+        {
+            /* cycle within the block */
+            Gi [nz] = Perm [k-1] ;
+            Gx [nz++] = 1 ;
+        }
+        else if (k + 1 < N && Start [k+1] == Start [k])
+        {
+            /* close the cycle: the first column has the last row */
+            for (i = k+1 ; i+1 < N && Start [i+1] == Start [k] ; i++) ;
+            Gi [nz] = Perm [i] ;
+            Gx [nz++] = 1 ;
+        }
+        for (t = 0 ; t < NZCOL-2 && Start [k] > 0 ; t++)
+        {
+            i = Perm [rand ( ) % Start [k]] ;
+            for (p = Gp [j] ; p < nz && Gi [p] != i ; p++) ;
+            if (p == nz)
+            {
+                Gi [nz] = i ;
+                Gx [nz++] = -1 + 0.1 * (rand ( ) % 7) ;
+            }
+        }
+    }
+    Gp [N] = nz ;
+    return (nz) ;
+}
+
+/* solves A*X = A*[1 2 3] and returns the max error in X, or -1 on failure */
+static double solve_error (int nrhs, klu_symbolic *Symbolic,
+    klu_numeric *Numeric, klu_common *Common)
+{
+    int i, j, p, r ;
+    double err = 0, e ;
+    for (i = 0 ; i < nrhs*N ; i++)
+    {
+        B [i] = 0 ;
+    }
+    for (j = 0 ; j < N ; j++)
+    {
+        for (p = Gp [j] ; p < Gp [j+1] ; p++)
+        {
+            for (r = 0 ; r < nrhs ; r++)
+            {
+                B [r*N + Gi [p]] += (r+1) * Gx [p] ;
+            }
+        }
+    }
+    if(!klu_solve (Symbolic, Numeric, N, nrhs, B, Common))
+    {
+        return (-1) ;
+    }
+    for (r = 0 ; r < nrhs ; r++)
+    {
+        for (i = 0 ; i < N ; i++)
+        {
+            e = B [r*N + i] - (r+1) ;
+            e = (e < 0) ? -e : e ;
+            err = (e > err) ? e : err ;
+        }
+    }
+    return (err) ;
+}
+
+/* solve with 1 and 3 right-hand sides */
+static int check (const char *what, klu_symbolic *Symbolic,
+    klu_numeric *Numeric, klu_common *Common)
+{
+    double err1 = solve_error (1, Symbolic, Numeric, Common) ;
+    double err3 = solve_error (3, Symbolic, Numeric, Common) ;
+    printf("%s: max error %g (1 rhs), %g (3 rhs)\n", what, err1, err3);
+    return (err1 >= 0 && err1 < 1e-12 && err3 >= 0 && err3 < 1e-12) ;
+}
+
+/* the rows of the off-diagonal blocks hold the same entries as Offp/Offi/Offx,
+ * and the varying entries are the last ones, in the order of the list */
+static int check_layout (klu_numeric *Numeric)
+{
+    int i, p, q, nzoff = Numeric->nzoff, nfixed ;
+    double *Offx = Numeric->Offx, *Rowx = Numeric->Rowx ;
+    nfixed = nzoff - Numeric->variable_offdiag_length ;
+    if(Numeric->Rowvar [0] != nfixed || Numeric->Rowp [N] != nfixed ||
+       Numeric->Rowvar [Numeric->nblocks] != nzoff)
+    {
+        return (0) ;
+    }
+    for (q = 0 ; q < nzoff ; q++)
+    {
+        p = Numeric->Rowoff [q] ;
+        if(Numeric->Offi [p] != Numeric->Rowi [q] || Rowx [q] != Offx [p] ||
+           Numeric->Offp [Numeric->Rowj [q]] > p ||
+           Numeric->Offp [Numeric->Rowj [q] + 1] <= p)
+        {
+            return (0) ;
+        }
+    }
+    for (i = 0 ; i < Numeric->variable_offdiag_length ; i++)
+    {
+        if(Numeric->Rowoff [nfixed + i] !=
+           Numeric->variable_offdiag_perm_entry [i])
+        {
+            return (0) ;
+        }
+    }
+    return (1) ;
+}
+
+/* new values for the varying entries */
+static void vary (double f)
+{
+    int t ;
+    for (t = 0 ; t < NVARY ; t++)
+    {
+        Gx [vary_pos [t]] *= (vary_cols [t] == vary_rows [t]) ? f : -f ;
+    }
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    int *Perm = NULL, nz, t, p, ok = 0 ;
+
+    srand (1) ;
+    Perm = malloc (N * sizeof (int)) ;
+    if(!Perm)
+    {
+        goto FAIL;
+    }
+    nz = random_matrix (Perm) ;
+
+    /* every 7th entry varies, diagonal or not */
+    for (t = 0 ; t < NVARY ; t++)
+    {
+        p = (7*t) % nz ;
+        vary_pos [t] = p ;
+        vary_rows [t] = Gi [p] ;
+        for (vary_cols [t] = 0 ; Gp [vary_cols [t] + 1] <= p ; vary_cols [t]++);
+    }
+
+    klu_defaults (&Common) ;
+    Common.offdiag_rows = 1 ;
+    Symbolic = klu_analyze (N, Gp, Gi, &Common) ;
+    if(!Symbolic)
+    {
+        goto FAIL;
+    }
+    printf("blocks %d, off-diagonal entries %d\n", Symbolic->nblocks,
+        Symbolic->nzoff);
+    if(Symbolic->nblocks < 10 || Symbolic->nzoff < N)
+    {
+        goto FAIL;
+    }
+
+    Numeric = klu_factor (Gp, Gi, Gx, Symbolic, &Common) ;
+    if(!Numeric || !Numeric->Rowp || !check_layout (Numeric) ||
+       !check ("factor", Symbolic, Numeric, &Common))
+    {
+        goto FAIL;
+    }
+
+    /* the varying entries are moved to the end; until the values are moved
+     * too, klu_solve uses the columns */
+    if(!klu_compute_path (Symbolic, Numeric, &Common, Gp, Gi, vary_cols,
+        vary_rows, NVARY) || !Numeric->rows_stale ||
+       Numeric->variable_offdiag_length == 0 ||
+       !check ("compute path", Symbolic, Numeric, &Common))
+    {
+        goto FAIL;
+    }
+    printf("varying off-diagonal entries %d\n",
+        Numeric->variable_offdiag_length);
+
+    for (t = 0 ; t < 2 ; t++)
+    {
+        vary (1.5) ;
+        if(!klu_partial_factorization_path (Gp, Gi, Gx, Symbolic, Numeric,
+            &Common) || Numeric->rows_stale || !check_layout (Numeric) ||
+           !check ("partial", Symbolic, Numeric, &Common))
+        {
+            goto FAIL;
+        }
+    }
+
+    vary (0.5) ;
+    if(!klu_refactor (Gp, Gi, Gx, Symbolic, Numeric, &Common) ||
+       !check_layout (Numeric) ||
+       !check ("refactor", Symbolic, Numeric, &Common))
+    {
+        goto FAIL;
+    }
+
+    /* restart */
+    if(!klu_determine_start (Symbolic, Numeric, &Common, Gp, Gi, vary_cols,
+        vary_rows, NVARY))
+    {
+        goto FAIL;
+    }
+    for (t = 0 ; t < 2 ; t++)
+    {
+        vary (1.25) ;
+        if(!klu_partial_refactorization_restart (Gp, Gi, Gx, Symbolic,
+            Numeric, &Common) || !check_layout (Numeric) ||
+           !check ("restart", Symbolic, Numeric, &Common))
+        {
+            goto FAIL;
+        }
+    }
+
+    /* without Common.offdiag_rows, only the columns are kept */
+    klu_free_numeric (&Numeric, &Common) ;
+    Common.offdiag_rows = 0 ;
+    Numeric = klu_factor (Gp, Gi, Gx, Symbolic, &Common) ;
+    if(!Numeric || Numeric->Rowp ||
+       !check ("factor by columns", Symbolic, Numeric, &Common))
+    {
+        goto FAIL;
+    }
+    ok = 1 ;
+
+FAIL:
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    free (Perm) ;
+    return (!ok) ;
+}
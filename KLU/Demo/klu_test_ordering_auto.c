@@ -0,0 +1,222 @@
+/* klu_test_ordering_auto: orders each block with the best of AMD, COLAMD and
+ * the user ordering function (Common.ordering = 4), for testing */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "klu.h"
+
+#define NX 30
+#define NY 20
+#define N (NX*NY)
+
+int    n = 10 ;
+int    Ap [ ] = { 0,  2,  3,  6,  9, 12, 15, 20, 21, 27, 31 } ;
+int    Ai [ ] = { 0, 8, 1, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+double Ax [ ] = { 1, 1, 2, 3, 1, 1, 4, 5, 1, 6, 1, 1, 1, 7, 1, 1, 1, 8, 1, 1, 9, 1, 1, 1, 1, 10, 1, 1, 1, 1, 11 } ;
+
+/* the natural ordering, which is poor on the grid, and an ordering that
+ * fails */
+static int user_calls = 0 ;
+
+static int natural (int nk, int *Cp, int *Ci, int *Perm, klu_common *Common)
+{
+    int k ;
+    (void) Cp ;
+    (void) Ci ;
+    (void) Common ;
+    user_calls++ ;
+    for (k = 0 ; k < nk ; k++)
+    {
+        Perm [k] = k ;
+    }
+    return (1) ;
+}
+
+static int failing (int nk, int *Cp, int *Ci, int *Perm, klu_common *Common)
+{
+    (void) nk ;
+    (void) Cp ;
+    (void) Ci ;
+    (void) Perm ;
+    (void) Common ;
+    user_calls++ ;
+    return (0) ;
+}
+
+/* 5-point grid of NX-by-NY nodes, with a nonzero diagonal */
+static int grid (int *Gp, int *Gi, double *Gx)
+{
+    int x, y, nz = 0 ;
+    for (x = 0 ; x < NX ; x++)
+    {
+        for (y = 0 ; y < NY ; y++)
+        {
+            Gp [x*NY + y] = nz ;
+            if (x > 0)
+            {
+                Gx [nz] = -1 ;
+                Gi [nz++] = (x-1)*NY + y ;
+            }
+            if (y > 0)
+            {
+                Gx [nz] = -1 ;
+                Gi [nz++] = x*NY + y-1 ;
+            }
+            Gx [nz] = 5 ;
+            Gi [nz++] = x*NY + y ;
+            if (y < NY-1)
+            {
+                Gx [nz] = -1 ;
+                Gi [nz++] = x*NY + y+1 ;
+            }
+            if (x < NX-1)
+            {
+                Gx [nz] = -1 ;
+                Gi [nz++] = (x+1)*NY + y ;
+            }
+        }
+    }
+    Gp [N] = nz ;
+    return (nz) ;
+}
+
+/* analyzes A with the given ordering, and returns nnz(L) or -1 */
+static double analyze_lnz (int m, int *Bp, int *Bi, int ordering)
+{
+    klu_symbolic *Symbolic ;
+    klu_common Common ;
+    double lnz ;
+    klu_defaults (&Common) ;
+    Common.ordering = ordering ;
+    Symbolic = klu_analyze (m, Bp, Bi, &Common) ;
+    if(!Symbolic)
+    {
+        return (-1) ;
+    }
+    lnz = Symbolic->lnz ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    return (lnz) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    int *Gp = NULL, *Gi = NULL, block, nk, ok = 0 ;
+    double *Gx = NULL, *b = NULL, lnz_amd, err ;
+    int i ;
+
+    klu_defaults (&Common) ;
+    Common.ordering = 4 ;
+    Common.user_order = natural ;
+
+    /* the example matrix: every block gets a method */
+    Symbolic = klu_analyze (n, Ap, Ai, &Common) ;
+    if(!Symbolic || !Symbolic->Method)
+    {
+        goto FAIL;
+    }
+    for (block = 0 ; block < Symbolic->nblocks ; block++)
+    {
+        nk = Symbolic->R [block+1] - Symbolic->R [block] ;
+        printf("block %d size %d method %d\n", block, nk,
+            Symbolic->Method [block]);
+        if(nk <= 3 ? Symbolic->Method [block] != 2 :
+            (Symbolic->Method [block] < 0 || Symbolic->Method [block] > 3))
+        {
+            goto FAIL;
+        }
+    }
+    Numeric = klu_factor (Ap, Ai, Ax, Symbolic, &Common) ;
+    if(!Numeric)
+    {
+        goto FAIL;
+    }
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* a grid: never worse than AMD, and never the natural order.  COLAMD
+     * does not report nnz(L), so it is not compared here. */
+    Gp = malloc ((N+1) * sizeof (int)) ;
+    Gi = malloc (5 * N * sizeof (int)) ;
+    Gx = malloc (5 * N * sizeof (double)) ;
+    b = malloc (N * sizeof (double)) ;
+    if(!Gp || !Gi || !Gx || !b)
+    {
+        goto FAIL;
+    }
+    grid (Gp, Gi, Gx) ;
+    user_calls = 0 ;
+    Symbolic = klu_analyze (N, Gp, Gi, &Common) ;
+    if(!Symbolic || Symbolic->nblocks != 1 || user_calls != 1)
+    {
+        goto FAIL;
+    }
+    lnz_amd = analyze_lnz (N, Gp, Gi, 0) ;
+    printf("grid nnz(L): auto %g (method %d), AMD %g\n",
+        Symbolic->lnz, Symbolic->Method [0], lnz_amd);
+    if(Symbolic->Method [0] == 3 || Symbolic->lnz > lnz_amd)
+    {
+        goto FAIL;
+    }
+
+    /* the factorization solves A*x = A*1 */
+    Numeric = klu_factor (Gp, Gi, Gx, Symbolic, &Common) ;
+    if(!Numeric)
+    {
+        goto FAIL;
+    }
+    for (i = 0 ; i < N ; i++)
+    {
+        b [i] = 0 ;
+    }
+    for (i = 0 ; i < Gp [N] ; i++)
+    {
+        b [Gi [i]] += Gx [i] ;
+    }
+    if(!klu_solve (Symbolic, Numeric, N, 1, b, &Common))
+    {
+        goto FAIL;
+    }
+    err = 0 ;
+    for (i = 0 ; i < N ; i++)
+    {
+        err = (b [i] - 1 > err) ? b [i] - 1 : (1 - b [i] > err) ? 1 - b [i] : err ;
+    }
+    printf("max error %g\n", err);
+    if(err > 1e-10)
+    {
+        goto FAIL;
+    }
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* a failing user ordering is skipped */
+    Common.user_order = failing ;
+    user_calls = 0 ;
+    Symbolic = klu_analyze (N, Gp, Gi, &Common) ;
+    if(!Symbolic || user_calls != 1 || Symbolic->Method [0] == 3)
+    {
+        goto FAIL;
+    }
+    klu_free_symbolic (&Symbolic, &Common) ;
+
+    /* and so is a missing one */
+    Common.user_order = NULL ;
+    Symbolic = klu_analyze (N, Gp, Gi, &Common) ;
+    if(!Symbolic || Symbolic->Method [0] == 3)
+    {
+        goto FAIL;
+    }
+    ok = 1 ;
+
+FAIL:
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_symbolic (&Symbolic, &Common) ;
+    free (Gp) ;
+    free (Gi) ;
+    free (Gx) ;
+    free (b) ;
+    return (!ok) ;
+}
@@ -50,6 +50,15 @@ int main (void)
         goto FAIL;
     }
 
+    /* the estimated path must be nonempty, and no more work than a refactor */
+    printf("estimated path length %g, path flops %g, total flops %g\n",
+        Symbolic->est_pathlen, Symbolic->est_path_flops, Symbolic->est_flops);
+    if(Symbolic->est_pathlen < 1 || Symbolic->est_pathlen > n ||
+       Symbolic->est_path_flops > Symbolic->est_flops)
+    {
+        goto FAIL;
+    }
+
     /* numerically factor the matrix */
     Numeric = klu_factor (Ap, Ai, Ax, Symbolic, &Common) ;
     if(!Numeric)
@@ -63,6 +72,7 @@ int main (void)
     {
         goto FAIL;
     }
+    printf("actual path length %d\n", Numeric->pathLen);
     printf("------------------\n");
     printf("------------------\n");
     
@@ -0,0 +1,131 @@
+/* klu_test_path_ordering: compares the partial orderings of KLU, for testing */
+
+#include <stdio.h>
+#include <math.h>
+#include "klu.h"
+
+#define TOLERANCE 1e-8
+
+int    n = 10 ;
+int    Ap [ ] = { 0,  2,  3,  6,  9, 12, 15, 20, 21, 27, 31 } ;
+int    Ai [ ] = { 0, 8, 1, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+double Ax [ ] = {8.18413247, 0.31910091, 0.95960852, 7.9683539 , 3.27076739,
+       9.3203983 , 2.94765012, 0.41596915, 8.55865174, 3.26336244,
+       2.56358029, 7.29705002, 9.42558416, 6.80016439, 5.82804034,
+       9.39211732, 9.31241378, 0.35525264, 7.68775477, 5.48634592,
+       2.80075036, 2.36812029, 1.13390547, 9.71284119, 6.02692506,
+       4.03715243, 4.36857613, 0.54369597, 6.86482384, 6.46735381,
+       4.76819917 } ;
+double Ax_new [ ] = {8.18413247, 0.31910091, 0.95960852, 7.9683539 , 3.27076739,
+       9.3203983 , 2.94765012, 1.41596915, 8.55865174, 3.26336244,
+       2.56358029, 7.29705002, 9.42558416, 6.80016439, 5.82804034,
+       9.39211732, 9.31241378, 0.35525264, 7.68775477, 5.48634592,
+       2.80075036, 2.36812029, 1.13390547, 9.71284119, 7.02692506,
+       4.03715243, 4.36857613, 0.54369597, 6.86482384, 6.46735381,
+       4.76819917 } ;
+double b [ ] = {1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, 1.0, 1.0, 0.0} ;
+double c [ ] = {1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, 1.0, 1.0, 0.0} ;
+
+int varying_cols [ ] = { 3, 8 } ;
+int varying_rows [ ] = { 4, 6 } ;
+int n_variable_entries = 2 ;
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL ;
+    klu_common Common ;
+    double max_error, error, pathlen [4] ;
+    char *names [ ] = { "AMD", "AMD-NV", "AMD-RA", "CAMD" } ;
+    int i, method, RET ;
+
+    klu_defaults (&Common) ;
+
+    /* compare the estimated factorization path of each ordering */
+    for (method = AMD_ORDERING ; method <= AMD_ORDERING_CAMD ; method++)
+    {
+        Symbolic = klu_analyze_partial (n, Ap, Ai, varying_cols, varying_rows,
+            n_variable_entries, method, &Common) ;
+        if(!Symbolic)
+        {
+            goto FAIL;
+        }
+        pathlen [method] = Symbolic->est_pathlen ;
+        printf("%-7s lnz %g flops %g est. path length %g path flops %g\n",
+            names [method], Symbolic->lnz, Symbolic->est_flops,
+            Symbolic->est_pathlen, Symbolic->est_path_flops);
+        klu_free_symbolic (&Symbolic, &Common) ;
+    }
+
+    /* CAMD orders the varying columns last, giving the shortest path */
+    for (method = AMD_ORDERING ; method < AMD_ORDERING_CAMD ; method++)
+    {
+        if(pathlen [AMD_ORDERING_CAMD] > pathlen [method])
+        {
+            goto FAIL;
+        }
+    }
+
+    /* partially refactor with the CAMD ordering */
+    Symbolic = klu_analyze_partial (n, Ap, Ai, varying_cols, varying_rows,
+        n_variable_entries, AMD_ORDERING_CAMD, &Common) ;
+    if(!Symbolic)
+    {
+        goto FAIL;
+    }
+    Numeric = klu_factor (Ap, Ai, Ax, Symbolic, &Common) ;
+    if(!Numeric)
+    {
+        goto FAIL;
+    }
+    RET = klu_compute_path(Symbolic, Numeric, &Common, Ap, Ai, varying_cols, varying_rows, n_variable_entries);
+    if(RET != (1))
+    {
+        goto FAIL;
+    }
+    printf("actual path length %d\n", Numeric->pathLen);
+
+    RET = klu_partial_factorization_path(Ap, Ai, Ax_new, Symbolic, Numeric, &Common);
+    if(RET != (1))
+    {
+        goto FAIL;
+    }
+    klu_solve (Symbolic, Numeric, 10, 1, b, &Common) ;
+
+    /* compare against a full refactorization */
+    RET = klu_refactor(Ap, Ai, Ax_new, Symbolic, Numeric, &Common);
+    if(RET != (1))
+    {
+        goto FAIL;
+    }
+    RET = klu_solve (Symbolic, Numeric, 10, 1, c, &Common) ;
+    if(RET != (1))
+    {
+        goto FAIL;
+    }
+
+    max_error = 0 ;
+    for(i = 0 ; i < n ; i++)
+    {
+        error = fabs(b[i]-c[i]);
+        if(error > max_error)
+        {
+            max_error = error;
+        }
+    }
+    printf("max. difference to refactor %g\n", max_error);
+
+    if(max_error > TOLERANCE)
+    {
+        goto FAIL;
+    }
+
+    klu_free_symbolic (&Symbolic, &Common) ;
+    klu_free_numeric (&Numeric, &Common) ;
+    return (0) ;
+
+FAIL:
+    klu_free_symbolic (&Symbolic, &Common) ;
+    klu_free_numeric (&Numeric, &Common) ;
+    return (1) ;
+}
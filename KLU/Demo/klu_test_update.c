@@ -0,0 +1,158 @@
+/* klu_test_update: rank-1 updates of a KLU factorization, for testing */
+
+#include <stdio.h>
+#include <math.h>
+#include "klu.h"
+
+#define TOLERANCE 1e-8
+
+int    n = 10 ;
+int    Ap [ ] = { 0,  2,  3,  6,  9, 12, 15, 20, 21, 27, 31 } ;
+int    Ai [ ] = { 0, 8, 1, 2, 6, 9, 3, 4, 6, 4, 5, 8, 4, 5, 8, 2, 3, 6, 8, 9, 7, 0, 4, 5, 6, 8, 9, 2, 6, 8, 9 } ;
+double Ax [ ] = {8.18413247, 0.31910091, 0.95960852, 7.9683539 , 3.27076739,
+       9.3203983 , 2.94765012, 0.41596915, 8.55865174, 3.26336244,
+       2.56358029, 7.29705002, 9.42558416, 6.80016439, 5.82804034,
+       9.39211732, 9.31241378, 0.35525264, 7.68775477, 5.48634592,
+       2.80075036, 2.36812029, 1.13390547, 9.71284119, 6.02692506,
+       4.03715243, 4.36857613, 0.54369597, 6.86482384, 6.46735381,
+       4.76819917 } ;
+
+/* Ax_new = Ax + e4*e3' + e6*e8', i.e. A(4,3) and A(6,8) are increased by 1 */
+double Ax_new [ ] = {8.18413247, 0.31910091, 0.95960852, 7.9683539 , 3.27076739,
+       9.3203983 , 2.94765012, 1.41596915, 8.55865174, 3.26336244,
+       2.56358029, 7.29705002, 9.42558416, 6.80016439, 5.82804034,
+       9.39211732, 9.31241378, 0.35525264, 7.68775477, 5.48634592,
+       2.80075036, 2.36812029, 1.13390547, 9.71284119, 7.02692506,
+       4.03715243, 4.36857613, 0.54369597, 6.86482384, 6.46735381,
+       4.76819917 } ;
+
+double rhs [ ] = {1.0, 0.0, 0.0, 1.0, 1.0, 0.0, 0.0, 1.0, 1.0, 0.0} ;
+
+/* compare A\rhs and A'\rhs of the updated factorization with the reference */
+static double compare (klu_symbolic *Symbolic, klu_numeric *Numeric,
+    klu_numeric *Reference, klu_common *Common)
+{
+    double b [10], c [10], error, max_error ;
+    int i, trans ;
+
+    max_error = 0 ;
+    for (trans = 0 ; trans <= 1 ; trans++)
+    {
+        for (i = 0 ; i < n ; i++)
+        {
+            b [i] = rhs [i] ;
+            c [i] = rhs [i] ;
+        }
+        if (trans)
+        {
+            klu_tsolve (Symbolic, Numeric, n, 1, b, Common) ;
+            klu_tsolve (Symbolic, Reference, n, 1, c, Common) ;
+        }
+        else
+        {
+            klu_solve (Symbolic, Numeric, n, 1, b, Common) ;
+            klu_solve (Symbolic, Reference, n, 1, c, Common) ;
+        }
+        for (i = 0 ; i < n ; i++)
+        {
+            error = fabs (b [i] - c [i]) ;
+            if (error > max_error)
+            {
+                max_error = error ;
+            }
+        }
+    }
+    return (max_error) ;
+}
+
+int main (void)
+{
+    klu_symbolic *Symbolic = NULL ;
+    klu_numeric *Numeric = NULL, *Reference = NULL ;
+    klu_common Common ;
+    double u [10], v [10], zero [10], max_error ;
+    int i, RET ;
+
+    klu_defaults (&Common) ;
+    Common.max_updates = 2 ;
+
+    for (i = 0 ; i < n ; i++)
+    {
+        zero [i] = 0 ;
+    }
+
+    Symbolic = klu_analyze (n, Ap, Ai, &Common) ;
+    if(!Symbolic)
+    {
+        goto FAIL;
+    }
+    Numeric = klu_factor (Ap, Ai, Ax, Symbolic, &Common) ;
+    Reference = klu_factor (Ap, Ai, Ax_new, Symbolic, &Common) ;
+    if(!Numeric || !Reference)
+    {
+        goto FAIL;
+    }
+
+    /* apply the rank-2 change as two rank-1 updates */
+    for (i = 0 ; i < n ; i++)
+    {
+        u [i] = (i == 4) ;
+        v [i] = (i == 3) ;
+    }
+    RET = klu_update (NULL, NULL, NULL, u, v, Symbolic, Numeric, &Common) ;
+    if(RET != (1))
+    {
+        goto FAIL;
+    }
+    for (i = 0 ; i < n ; i++)
+    {
+        u [i] = (i == 6) ;
+        v [i] = (i == 8) ;
+    }
+    RET = klu_update (NULL, NULL, NULL, u, v, Symbolic, Numeric, &Common) ;
+    if(RET != (1) || Numeric->nupdates != 2)
+    {
+        goto FAIL;
+    }
+
+    max_error = compare (Symbolic, Numeric, Reference, &Common) ;
+    printf("max. difference with 2 updates %g\n", max_error);
+    if(max_error > TOLERANCE)
+    {
+        goto FAIL;
+    }
+
+    /* a third update exceeds Common.max_updates */
+    RET = klu_update (NULL, NULL, NULL, zero, zero, Symbolic, Numeric,
+        &Common) ;
+    if(RET != (0) || Common.status != KLU_UPDATE_LIMIT)
+    {
+        goto FAIL;
+    }
+
+    /* the same, with the updated matrix given: refactorizes */
+    RET = klu_update (Ap, Ai, Ax_new, zero, zero, Symbolic, Numeric,
+        &Common) ;
+    if(RET != (1) || Numeric->nupdates != 0)
+    {
+        goto FAIL;
+    }
+
+    max_error = compare (Symbolic, Numeric, Reference, &Common) ;
+    printf("max. difference after refactorization %g\n", max_error);
+    if(max_error > TOLERANCE)
+    {
+        goto FAIL;
+    }
+
+    klu_free_symbolic (&Symbolic, &Common) ;
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_numeric (&Reference, &Common) ;
+    return (Common.memusage != 0) ;
+
+FAIL:
+    klu_free_symbolic (&Symbolic, &Common) ;
+    klu_free_numeric (&Numeric, &Common) ;
+    klu_free_numeric (&Reference, &Common) ;
+    return (1) ;
+}
@@ -13,6 +13,7 @@ extern "C" {
 #endif
 
 #include "amd.h"
+#include "camd.h"
 #include "colamd.h"
 #include "btf.h"
 
@@ -43,7 +44,8 @@ typedef struct
         nzoff,          /* nz in off-diagonal blocks */
         nblocks,        /* number of blocks */
         maxblock,       /* size of largest block */
-        ordering,       /* ordering used (AMD, COLAMD, or GIVEN) */
+        ordering,       /* ordering used (AMD, COLAMD, GIVEN, AUTO, ND, or
+                         * 6 for CAMD, from klu_analyze_constrained) */
         do_btf ;        /* whether or not BTF preordering was requested */
 
     /* only computed if BTF preordering requested */
@@ -51,6 +53,29 @@ typedef struct
                         * deficient.  -1 if not computed.  n if the matrix has
                         * full structural rank */
 
+    /* only computed by klu_analyze_partial.  Estimates of the factorization
+     * path and of the cost of klu_partial_factorization_path, from the
+     * elimination tree of C+C' of each block C.  The pointers are NULL and
+     * the totals EMPTY if not computed. */
+    double est_pathlen ;    /* est. # of columns on the factorization path */
+    double est_path_flops ; /* est. flop count of a partial refactorization */
+    double *Pathlen ;       /* size n, but only Pathlen [0..nblocks-1] used */
+    double *Pathflops ;     /* size n, but only Pathflops [0..nblocks-1] used */
+
+    /* only computed if ordering = 4 (AUTO): the ordering that won for each
+     * block, 0: AMD, 1: COLAMD, 2: natural (blocks of size 3 or less), 3: the
+     * user function.  NULL otherwise. */
+    int *Method ;           /* size n, but only Method [0..nblocks-1] used */
+
+    /* only computed if ordering = 5 (ND): the independent subtrees of the
+     * nested dissection of each block, which klu_factor and klu_refactor
+     * factorize in parallel.  Each subtree is a contiguous range of columns
+     * of A (P,Q).  Domain [k] is one past the last column of the subtree
+     * that contains column k, or EMPTY if column k is in a separator (these
+     * are factorized last) or in a block that was not split.  NULL
+     * otherwise. */
+    int *Domain ;           /* size n */
+
 } klu_symbolic ;
 
 typedef struct          /* 64-bit version (otherwise same as above) */
@@ -59,9 +84,35 @@ typedef struct          /* 64-bit version (otherwise same as above) */
     double *Lnz ;
     SuiteSparse_long n, nz, *P, *Q, *R, nzoff, nblocks, maxblock, ordering,
         do_btf, structural_rank ;
+    double est_pathlen, est_path_flops ;
+    double *Pathlen, *Pathflops ;
+    SuiteSparse_long *Method ;
+    SuiteSparse_long *Domain ;
 
 } klu_l_symbolic ;
 
+/* -------------------------------------------------------------------------- */
+/* Symbolic cache - Symbolic objects of previously analyzed patterns */
+/* -------------------------------------------------------------------------- */
+
+typedef struct
+{
+    int max_entries ;   /* max # of Symbolic objects in the cache */
+    int nentries ;      /* # of Symbolic objects in the cache */
+    int hits ;          /* # of klu_analyze*_cached calls found in the cache */
+    int misses ;        /* # of klu_analyze*_cached calls not in the cache */
+    int stamp ;         /* # of lookups, for LRU replacement */
+    void *Entries ;     /* size max_entries, the cached objects */
+
+} klu_cache ;
+
+typedef struct          /* 64-bit version (otherwise same as above) */
+{
+    SuiteSparse_long max_entries, nentries, hits, misses, stamp ;
+    void *Entries ;
+
+} klu_l_cache ;
+
 /* -------------------------------------------------------------------------- */
 /* Numeric object - contains the factors computed by klu_factor */
 /* -------------------------------------------------------------------------- */
@@ -111,6 +162,34 @@ typedef struct
     int *variable_offdiag_orig_entry;
     int *variable_offdiag_perm_entry;
     int variable_offdiag_length;
+
+    /* rank-1 updates applied by klu_update since the last (re)factorization.
+     * The update arrays are allocated by the first klu_update, with room for
+     * maxupdates vectors of size n each. */
+    int nupdates ;      /* # of updates in use */
+    int maxupdates ;    /* # of updates allocated, 0 if none */
+    void *Updu ;        /* u of each update */
+    void *Updv ;        /* v of each update */
+    void *Updw ;        /* w = A\u, A the matrix before the update */
+    void *Updz ;        /* z = A.'\v */
+    void *Updg ;        /* size maxupdates, -1/(1+v.'*w) */
+
+    /* trees of the rcond and rgrowth monitor, size 6n, NULL if
+     * Common->monitor was never set (see klu_monitor.c) */
+    double *Monitor ;
+
+    /* the off-diagonal entries again, by rows, if Common->offdiag_rows is
+     * TRUE (see klu_offdiag_rows.c).  Row i holds its entries that do not
+     * vary in Rowj/Rowx [Rowp [i] ... Rowp [i+1]-1]; the varying entries
+     * follow all of those, grouped by the block of their row. */
+    int *Rowp ;         /* size n+1, row pointers, NULL if not used */
+    int *Rowj ;         /* size nzoff+1, column indices */
+    int *Rowi ;         /* size nzoff+1, row indices */
+    int *Rowoff ;       /* size nzoff+1, position of the entry in Offx */
+    void *Rowx ;        /* size nzoff+1, numerical values */
+    int *Rowvar ;       /* size nblocks+1, varying entries of rows in block k
+                         * are Rowvar [k] ... Rowvar [k+1]-1 */
+    int rows_stale ;    /* TRUE if Rowx is not yet in the current layout */
 } klu_numeric ;
 
 typedef struct          /* 64-bit version (otherwise same as above) */
@@ -135,6 +214,12 @@ typedef struct          /* 64-bit version (otherwise same as above) */
     SuiteSparse_long *variable_offdiag_orig_entry;
     SuiteSparse_long *variable_offdiag_perm_entry;
     SuiteSparse_long variable_offdiag_length;
+    SuiteSparse_long nupdates, maxupdates ;
+    void *Updu, *Updv, *Updw, *Updz, *Updg ;
+    double *Monitor ;
+    SuiteSparse_long *Rowp, *Rowj, *Rowi, *Rowoff ;
+    void *Rowx ;
+    SuiteSparse_long *Rowvar, rows_stale ;
 } klu_l_numeric ;
 
 /* -------------------------------------------------------------------------- */
@@ -149,6 +234,11 @@ typedef struct          /* 64-bit version (otherwise same as above) */
 #define KLU_TOO_LARGE (-4)          /* integer overflow has occured */
 #define KLU_PIVOT_FAULT (-5)        /* pivot became too small during (partial) refactorization */
 #define KLU_PATH_INVALID (-6)       /* path is NULL. klu_compute_path wasn't called properly. */
+#define KLU_UPDATE_LIMIT (-7)       /* klu_update needs a refactorization */
+
+/* Common->monitor_flag bits */
+#define KLU_MONITOR_RCOND (1)       /* rcond below Common->monitor_rcond_tol */
+#define KLU_MONITOR_RGROWTH (2)     /* rgrowth below monitor_rgrowth_tol */
 
 #define KLU_MAX_METHOD (3)
 #define KLU_MIN_METHOD (0)
@@ -168,7 +258,14 @@ typedef struct klu_common_struct
 
     int btf ;               /* use BTF pre-ordering, or not */
     int ordering ;          /* 0: AMD, 1: COLAMD, 2: user P and Q,
-                             * 3: user function */
+                             * 3: user function, 4: AUTO, the best of AMD,
+                             * COLAMD and the user function (if not NULL)
+                             * for each block, tried concurrently,
+                             * 5: ND, nested dissection (METIS_NodeND) of
+                             * the large blocks, factorized in parallel with
+                             * the pivots of each subtree restricted to its
+                             * own rows, so a block can be found singular
+                             * where ordering 0 would find it nonsingular */
     int scale ;             /* row scaling: -1: none (and no error check),
                              * 0: none, 1: sum, 2: max */
 
@@ -231,6 +328,45 @@ typedef struct klu_common_struct
     size_t memusage ;   /* current memory usage, in bytes */
     size_t mempeak ;    /* peak memory usage, in bytes */
 
+    /* ---------------------------------------------------------------------- */
+    /* added in version 2.0, kept last so that the offsets of the fields above
+     * are the same as in version 1 */
+    /* ---------------------------------------------------------------------- */
+
+    int max_updates ;       /* max # of klu_update calls before the matrix
+                             * must be refactorized */
+    double update_tol ;     /* klu_update refactorizes if |1+v.'*(A\u)| is
+                             * smaller than update_tol*norm(A\u)*norm(v) */
+
+    int nd_min ;            /* ordering 5: blocks of this size or larger are
+                             * split by nested dissection, smaller blocks are
+                             * ordered with AMD */
+    int nd_domains ;        /* ordering 5: # of independent subtrees to aim
+                             * for in each split block */
+
+    int btf_match ;         /* maximum matching for BTF: 0: btf_maxtrans,
+                             * limited by maxwork, 1: btf_maxtrans_pf,
+                             * multithreaded Pothen-Fan, with no limit */
+
+    int monitor ;           /* if TRUE, klu_factor, klu_refactor and the
+                             * partial refactorizations keep rcond and rgrowth
+                             * up to date, recomputing only the columns they
+                             * factorize, and set monitor_flag */
+    double monitor_rcond_tol ;      /* flag if rcond is smaller */
+    double monitor_rgrowth_tol ;    /* flag if rgrowth is smaller */
+
+    int offdiag_rows ;      /* if TRUE, klu_factor also stores the
+                             * off-diagonal blocks by rows, with the varying
+                             * entries contiguous, for klu_solve and the
+                             * partial refactorizations */
+
+    int nrepivot ;      /* # of blocks factorized again with partial
+                         * pivoting by klu_factor_reuse */
+
+    int monitor_flag ;  /* KLU_MONITOR_RCOND and/or KLU_MONITOR_RGROWTH if
+                         * the estimate crossed its threshold, 0 otherwise.
+                         * Set only if Common->monitor is TRUE. */
+
 } klu_common ;
 
 typedef struct klu_l_common_struct /* 64-bit version (otherwise same as above)*/
@@ -250,6 +386,15 @@ typedef struct klu_l_common_struct /* 64-bit version (otherwise same as above)*/
         singular_col, noffdiag ;
     double flops, rcond, condest, rgrowth, work ;
     size_t memusage, mempeak ;
+    SuiteSparse_long max_updates ;
+    double update_tol ;
+    SuiteSparse_long nd_min, nd_domains ;
+    SuiteSparse_long btf_match ;
+    SuiteSparse_long monitor ;
+    double monitor_rcond_tol, monitor_rgrowth_tol ;
+    SuiteSparse_long offdiag_rows ;
+    SuiteSparse_long nrepivot ;
+    SuiteSparse_long monitor_flag ;
 
 } klu_l_common ;
 
@@ -283,12 +428,37 @@ klu_symbolic *klu_analyze
 klu_l_symbolic *klu_l_analyze (SuiteSparse_long, SuiteSparse_long *,
     SuiteSparse_long *, klu_l_common *Common) ;
 
+/* -------------------------------------------------------------------------- */
+/* klu_analyze_constrained:  orders a matrix with given constraint sets */
+/* -------------------------------------------------------------------------- */
+
+/* Order the matrix with BTF (or not), then order each block with CAMD, so that
+ * the columns j of each block are in increasing order of Cmember [j]: set 0
+ * first, then set 1, and so on.  Use it to keep interface or varying columns
+ * at the end of the factors. */
+
+klu_symbolic *klu_analyze_constrained
+(
+    /* inputs, not modified */
+    int n,              /* A is n-by-n */
+    int Ap [ ],         /* size n+1, column pointers */
+    int Ai [ ],         /* size nz, row indices */
+    int Cmember [ ],    /* size n, constraint set of each column, 0 to n-1 */
+    klu_common *Common
+) ;
+
+klu_l_symbolic *klu_l_analyze_constrained (SuiteSparse_long,
+    SuiteSparse_long *, SuiteSparse_long *, SuiteSparse_long *,
+    klu_l_common *Common) ;
+
 /* ------------------------------------------------------------------------------ */
 /* klu_analyze_partial:  orders and analyzes a matrix for partial refactorization */
 /* ------------------------------------------------------------------------------ */
 
 /* Order the matrix with BTF (or not), then order each block with AMD, AMD-NV,
- * or with AMD-BRA */
+ * AMD-BRA, or with CAMD (AMD_ORDERING_CAMD) constrained to order the varying
+ * columns last.  Symbolic->est_pathlen and est_path_flops can be used to
+ * compare the orderings. */
 
 klu_symbolic *klu_analyze_partial
 (
@@ -307,6 +477,70 @@ klu_l_symbolic *klu_l_analyze_partial (SuiteSparse_long, SuiteSparse_long *,
     SuiteSparse_long *, SuiteSparse_long *, SuiteSparse_long* , SuiteSparse_long, SuiteSparse_long, klu_l_common *Common) ;
 
 
+/* -------------------------------------------------------------------------- */
+/* klu_analyze_cached: klu_analyze, with a cache of previous results */
+/* -------------------------------------------------------------------------- */
+
+/* Returns a copy of the Symbolic object of a previous call with the same
+ * pattern (and the same ordering options in Common), or calls klu_analyze and
+ * caches the result.  Free the result with klu_free_symbolic, and the cache
+ * with klu_free_cache.  When the cache is full, the least recently used entry
+ * that is not pinned is replaced.  Common->user_data is compared by address
+ * only; free the cache if the data it points to changes. */
+
+klu_cache *klu_alloc_cache
+(
+    int max_entries,    /* max # of Symbolic objects in the cache */
+    klu_common *Common
+) ;
+
+klu_l_cache *klu_l_alloc_cache (SuiteSparse_long, klu_l_common *) ;
+
+int klu_free_cache
+(
+    klu_cache **Cache,
+    klu_common *Common
+) ;
+
+SuiteSparse_long klu_l_free_cache (klu_l_cache **, klu_l_common *) ;
+
+klu_symbolic *klu_analyze_cached
+(
+    /* inputs, not modified */
+    int n,              /* A is n-by-n */
+    int Ap [ ],         /* size n+1, column pointers */
+    int Ai [ ],         /* size nz, row indices */
+    int pin,            /* > 0: pin the cache entry, < 0: unpin it, 0: neither */
+    /* input/output */
+    klu_cache *Cache,   /* if NULL, same as klu_analyze */
+    klu_common *Common
+) ;
+
+klu_l_symbolic *klu_l_analyze_cached (SuiteSparse_long, SuiteSparse_long *,
+    SuiteSparse_long *, SuiteSparse_long, klu_l_cache *, klu_l_common *) ;
+
+klu_symbolic *klu_analyze_partial_cached
+(
+    /* inputs, not modified */
+    int n,              /* A is n-by-n */
+    int Ap [ ],         /* size n+1, column pointers */
+    int Ai [ ],         /* size nz, row indices */
+    int varyingColumns [ ],
+    int varyingRows [ ],
+    int n_varyingEntries,
+    int orderingMethod,
+    int pin,            /* > 0: pin the cache entry, < 0: unpin it, 0: neither */
+    /* input/output */
+    klu_cache *Cache,   /* if NULL, same as klu_analyze_partial */
+    klu_common *Common
+) ;
+
+klu_l_symbolic *klu_l_analyze_partial_cached (SuiteSparse_long,
+    SuiteSparse_long *, SuiteSparse_long *, SuiteSparse_long *,
+    SuiteSparse_long *, SuiteSparse_long, SuiteSparse_long, SuiteSparse_long,
+    klu_l_cache *, klu_l_common *) ;
+
+
 /* -------------------------------------------------------------------------- */
 /* klu_analyze_given: analyzes a matrix using given P and Q */
 /* -------------------------------------------------------------------------- */
@@ -475,6 +709,40 @@ SuiteSparse_long klu_l_refactor (SuiteSparse_long *, SuiteSparse_long *,
 SuiteSparse_long klu_zl_refactor (SuiteSparse_long *, SuiteSparse_long *,
     double *, klu_l_symbolic *, klu_l_numeric *, klu_l_common *) ;
 
+/* -------------------------------------------------------------------------- */
+/* klu_factor_reuse: klu_refactor, with pivoting where the old pivots fail */
+/* -------------------------------------------------------------------------- */
+
+int klu_factor_reuse        /* return TRUE if successful, FALSE otherwise */
+(
+    /* inputs, not modified */
+    int Ap [ ],         /* size n+1, column pointers */
+    int Ai [ ],         /* size nz, row indices */
+    double Ax [ ],      /* size nz, numerical values */
+    klu_symbolic *Symbolic,
+    /* input, and pivots and numerical values modified on output */
+    klu_numeric *Numeric,
+    klu_common *Common
+) ;
+
+int klu_z_factor_reuse      /* return TRUE if successful, FALSE otherwise */
+(
+     /* inputs, not modified */
+     int Ap [ ],        /* size n+1, column pointers */
+     int Ai [ ],        /* size nz, row indices */
+     double Ax [ ],     /* size 2*nz, numerical values */
+     klu_symbolic *Symbolic,
+     /* input, and pivots and numerical values modified on output */
+     klu_numeric *Numeric,
+     klu_common *Common
+) ;
+
+SuiteSparse_long klu_l_factor_reuse (SuiteSparse_long *, SuiteSparse_long *,
+    double *, klu_l_symbolic *, klu_l_numeric *, klu_l_common *) ;
+
+SuiteSparse_long klu_zl_factor_reuse (SuiteSparse_long *, SuiteSparse_long *,
+    double *, klu_l_symbolic *, klu_l_numeric *, klu_l_common *) ;
+
 /* -------------------------------------------------------------------------- */
 /* klu_compute_path: computes factorization path for partial refactorization  */
 /* -------------------------------------------------------------------------- */
@@ -579,6 +847,54 @@ int klu_z_partial_refactorization_restart     /* return TRUE if successful, FALS
 SuiteSparse_long klu_l_partial_refactorization_restart(SuiteSparse_long*, SuiteSparse_long*, double*, klu_l_symbolic*, klu_l_numeric*, klu_l_common*);
 SuiteSparse_long klu_zl_partial_refactorization_restart(SuiteSparse_long*, SuiteSparse_long*, double*, klu_l_symbolic*, klu_l_numeric*, klu_l_common*);
 
+/* -------------------------------------------------------------------------- */
+/* klu_update: rank-1 update of the factorization, A = A + u*v.' */
+/* -------------------------------------------------------------------------- */
+
+/* The LU factors are not modified; klu_solve and klu_tsolve apply the updates
+ * on top of them.  If Common->max_updates updates are in use, or the update
+ * is ill-conditioned, the matrix is refactorized with klu_refactor instead,
+ * using Ap, Ai, and Ax (which must already include the update).  If Ap is NULL
+ * in that case, FALSE is returned with Common->status = KLU_UPDATE_LIMIT. */
+
+int klu_update              /* return TRUE if successful, FALSE otherwise */
+(
+    /* inputs, not modified */
+    int Ap [ ],         /* size n+1, column pointers of A+u*v.' (may be NULL) */
+    int Ai [ ],         /* size nz, row indices of A+u*v.' (may be NULL) */
+    double Ax [ ],      /* size nz, numerical values of A+u*v.' (may be NULL) */
+    double u [ ],       /* size n */
+    double v [ ],       /* size n */
+    klu_symbolic *Symbolic,
+
+    /* input, and updates modified on output */
+    klu_numeric *Numeric,
+    klu_common *Common
+) ;
+
+int klu_z_update            /* return TRUE if successful, FALSE otherwise */
+(
+    /* inputs, not modified */
+    int Ap [ ],         /* size n+1, column pointers of A+u*v.' (may be NULL) */
+    int Ai [ ],         /* size nz, row indices of A+u*v.' (may be NULL) */
+    double Ax [ ],      /* size 2*nz, numerical values (may be NULL) */
+    double u [ ],       /* size 2*n */
+    double v [ ],       /* size 2*n */
+    klu_symbolic *Symbolic,
+
+    /* input, and updates modified on output */
+    klu_numeric *Numeric,
+    klu_common *Common
+) ;
+
+SuiteSparse_long klu_l_update (SuiteSparse_long *, SuiteSparse_long *,
+    double *, double *, double *, klu_l_symbolic *, klu_l_numeric *,
+    klu_l_common *) ;
+
+SuiteSparse_long klu_zl_update (SuiteSparse_long *, SuiteSparse_long *,
+    double *, double *, double *, klu_l_symbolic *, klu_l_numeric *,
+    klu_l_common *) ;
+
 /* -------------------------------------------------------------------------- */
 /* klu_free_symbolic: destroys the Symbolic object */
 /* -------------------------------------------------------------------------- */
@@ -975,10 +1291,10 @@ void *klu_l_realloc (size_t, size_t, size_t, void *, klu_l_common *) ;
  *      #endif
  */
 
-#define KLU_DATE "Feb 23, 2023"
+#define KLU_DATE "Oct 19, 2026"
 #define KLU_VERSION_CODE(main,sub) ((main) * 1000 + (sub))
-#define KLU_MAIN_VERSION 1
-#define KLU_SUB_VERSION 4
+#define KLU_MAIN_VERSION 2
+#define KLU_SUB_VERSION 0
 #define KLU_SUBSUB_VERSION 0
 #define KLU_VERSION KLU_VERSION_CODE(KLU_MAIN_VERSION,KLU_SUB_VERSION)
 
@@ -160,6 +160,44 @@ size_t KLU_kernel_factor            /* 0 if failure, size of LU if OK */
     KLU_common *Common  /* the control input/output structure */
 ) ;
 
+size_t KLU_kernel_nd                /* 0 if failure, size of LU if OK */
+(
+    /* inputs, not modified */
+    Int n,          /* A is n-by-n. n must be > 0. */
+    Int Ap [ ],     /* size n+1, column pointers for A */
+    Int Ai [ ],     /* size nz = Ap [n], row indices for A */
+    Entry Ax [ ],   /* size nz, values of A */
+    Int Q [ ],      /* size n, optional column permutation */
+    double Lsize,   /* initial size of L and U */
+    Int Domain [ ], /* size n, the nested dissection subtrees of the block */
+
+    /* outputs, not defined on input */
+    Unit **p_LU,        /* row indices and values of L and U */
+    Entry Udiag [ ],    /* size n, diagonal of U */
+    Int Llen [ ],       /* size n, column length of L */
+    Int Ulen [ ],       /* size n, column length of U */
+    Int Lip [ ],        /* size n+1, column pointers of L */
+    Int Uip [ ],        /* size n+1, column pointers of U */
+    Int P [ ],          /* row permutation, size n */
+    Int *lnz,           /* size of L */
+    Int *unz,           /* size of U */
+
+    /* workspace, undefined on input */
+    Entry *X,       /* size n entries.  Zero on output */
+    Int *Work,      /* size 5n Int's */
+
+    /* inputs, not modified on output */
+    Int k1,             /* the block of A is from k1 to k2-1 */
+    Int PSinv [ ],      /* inverse of P from symbolic factorization */
+    double Rs [ ],      /* scale factors for A */
+
+    /* inputs, modified on output */
+    Int Offp [ ],   /* off-diagonal matrix (modified by this routine) */
+    Int Offi [ ],
+    Entry Offx [ ],
+    KLU_common *Common  /* the control input/output structure */
+) ;
+
 void KLU_lsolve
 (
     /* inputs, not modified: */
@@ -312,4 +350,31 @@ size_t KLU_mult_size_t (size_t a, size_t k, Int *ok) ;
 
 KLU_symbolic *KLU_alloc_symbolic (Int n, Int *Ap, Int *Ai, KLU_common *Common) ;
 
+Int KLU_path_estimate (Int nk, Int Cp [ ], Int Ci [ ], Int Pblk [ ],
+    Int Varying [ ], double *lnz, double *flops, double *pathlen,
+    double *pathflops, Int Work [ ]) ;
+
+Int KLU_nd_order (Int nk, Int Cp [ ], Int Ci [ ], Int Pblk [ ],
+    Int Dom [ ], double *lnz, double *flops, KLU_common *Common) ;
+
+void KLU_apply_updates (KLU_numeric *Numeric, Int d, Int nrhs, Int trans,
+    Entry B [ ]) ;
+
+Int KLU_monitor_all (Int Ap [ ], Int Ai [ ], double Ax [ ],
+    KLU_symbolic *Symbolic, KLU_numeric *Numeric, KLU_common *Common) ;
+
+void KLU_monitor_path (Int Ap [ ], Int Ai [ ], double Ax [ ],
+    KLU_symbolic *Symbolic, KLU_numeric *Numeric, Int restart,
+    KLU_common *Common) ;
+
+Int KLU_offdiag_rows (KLU_symbolic *Symbolic, KLU_numeric *Numeric,
+    KLU_common *Common) ;
+
+void KLU_offdiag_rows_pattern (KLU_symbolic *Symbolic, KLU_numeric *Numeric) ;
+
+void KLU_offdiag_rows_values (KLU_numeric *Numeric) ;
+
+void KLU_offdiag_rows_solve (Int block, Int k1, Int k2, Int nr, Entry X [ ],
+    KLU_numeric *Numeric) ;
+
 #endif
@@ -47,6 +47,14 @@
 #define KLU_free_numeric klu_zl_free_numeric
 #define KLU_factor klu_zl_factor
 #define KLU_refactor klu_zl_refactor
+#define KLU_factor_reuse klu_zl_factor_reuse
+#define KLU_update klu_zl_update
+#define KLU_apply_updates klu_zl_apply_updates
+#define KLU_monitor_all klu_zl_monitor_all
+#define KLU_monitor_path klu_zl_monitor_path
+#define KLU_offdiag_rows klu_zl_offdiag_rows
+#define KLU_offdiag_rows_values klu_zl_offdiag_rows_values
+#define KLU_offdiag_rows_solve klu_zl_offdiag_rows_solve
 #define KLU_partial_factorization_path klu_zl_partial_factorization_path
 #define KLU_partial_refactorization_restart klu_zl_partial_refactorization_restart
 #define KLU_dumpPerm klu_zl_dumpPerm
@@ -62,6 +70,7 @@
 #define KLU_usolve klu_zl_usolve
 #define KLU_utsolve klu_zl_utsolve
 #define KLU_kernel klu_zl_kernel
+#define KLU_kernel_nd klu_zl_kernel_nd
 #define KLU_valid klu_zl_valid
 #define KLU_valid_LU klu_zl_valid_LU
 #define KLU_sort klu_zl_sort
@@ -79,6 +88,14 @@
 #define KLU_free_numeric klu_z_free_numeric
 #define KLU_factor klu_z_factor
 #define KLU_refactor klu_z_refactor
+#define KLU_factor_reuse klu_z_factor_reuse
+#define KLU_update klu_z_update
+#define KLU_apply_updates klu_z_apply_updates
+#define KLU_monitor_all klu_z_monitor_all
+#define KLU_monitor_path klu_z_monitor_path
+#define KLU_offdiag_rows klu_z_offdiag_rows
+#define KLU_offdiag_rows_values klu_z_offdiag_rows_values
+#define KLU_offdiag_rows_solve klu_z_offdiag_rows_solve
 #define KLU_partial_factorization_path klu_z_partial_factorization_path
 #define KLU_partial_refactorization_restart klu_z_partial_refactorization_restart
 #define KLU_dumpPerm klu_z_dumpPerm
@@ -94,6 +111,7 @@
 #define KLU_usolve klu_z_usolve
 #define KLU_utsolve klu_z_utsolve
 #define KLU_kernel klu_z_kernel
+#define KLU_kernel_nd klu_z_kernel_nd
 #define KLU_valid klu_z_valid
 #define KLU_valid_LU klu_z_valid_LU
 #define KLU_sort klu_z_sort
@@ -115,6 +133,14 @@
 #define KLU_free_numeric klu_l_free_numeric
 #define KLU_factor klu_l_factor
 #define KLU_refactor klu_l_refactor
+#define KLU_factor_reuse klu_l_factor_reuse
+#define KLU_update klu_l_update
+#define KLU_apply_updates klu_l_apply_updates
+#define KLU_monitor_all klu_l_monitor_all
+#define KLU_monitor_path klu_l_monitor_path
+#define KLU_offdiag_rows klu_l_offdiag_rows
+#define KLU_offdiag_rows_values klu_l_offdiag_rows_values
+#define KLU_offdiag_rows_solve klu_l_offdiag_rows_solve
 #define KLU_partial_factorization_path klu_l_partial_factorization_path
 #define KLU_partial_refactorization_restart klu_l_partial_refactorization_restart
 #define KLU_dumpPerm klu_l_dumpPerm
@@ -130,6 +156,7 @@
 #define KLU_usolve klu_l_usolve
 #define KLU_utsolve klu_l_utsolve
 #define KLU_kernel klu_l_kernel
+#define KLU_kernel_nd klu_l_kernel_nd
 #define KLU_valid klu_l_valid
 #define KLU_valid_LU klu_l_valid_LU
 #define KLU_sort klu_l_sort
@@ -147,6 +174,14 @@
 #define KLU_free_numeric klu_free_numeric
 #define KLU_factor klu_factor
 #define KLU_refactor klu_refactor
+#define KLU_factor_reuse klu_factor_reuse
+#define KLU_update klu_update
+#define KLU_apply_updates klu_apply_updates
+#define KLU_monitor_all klu_monitor_all
+#define KLU_monitor_path klu_monitor_path
+#define KLU_offdiag_rows klu_offdiag_rows
+#define KLU_offdiag_rows_values klu_offdiag_rows_values
+#define KLU_offdiag_rows_solve klu_offdiag_rows_solve
 #define KLU_partial_factorization_path klu_partial_factorization_path
 #define KLU_partial_refactorization_restart klu_partial_refactorization_restart
 #define KLU_dumpPerm klu_dumpPerm
@@ -163,6 +198,7 @@
 #define KLU_usolve klu_usolve
 #define KLU_utsolve klu_utsolve
 #define KLU_kernel klu_kernel
+#define KLU_kernel_nd klu_kernel_nd
 #define KLU_valid klu_valid
 #define KLU_valid_LU klu_valid_LU
 #define KLU_sort klu_sort
@@ -181,10 +217,18 @@
 
 #define KLU_analyze klu_l_analyze
 #define KLU_analyze_partial klu_l_analyze_partial
+#define KLU_analyze_constrained klu_l_analyze_constrained
 #define KLU_analyze_given klu_l_analyze_given
+#define KLU_analyze_cached klu_l_analyze_cached
+#define KLU_analyze_partial_cached klu_l_analyze_partial_cached
+#define KLU_alloc_cache klu_l_alloc_cache
+#define KLU_free_cache klu_l_free_cache
 #define KLU_compute_path klu_l_compute_path
 #define KLU_determine_start klu_l_determine_start
+#define KLU_offdiag_rows_pattern klu_l_offdiag_rows_pattern
 #define KLU_alloc_symbolic klu_l_alloc_symbolic
+#define KLU_path_estimate klu_l_path_estimate
+#define KLU_nd_order klu_l_nd_order
 #define KLU_free_symbolic klu_l_free_symbolic
 #define KLU_defaults klu_l_defaults
 #define KLU_free klu_l_free
@@ -196,12 +240,15 @@
 #define KLU_symbolic klu_l_symbolic
 #define KLU_numeric klu_l_numeric
 #define KLU_common klu_l_common
+#define KLU_cache klu_l_cache
 
 #define BTF_order btf_l_order
+#define BTF_order_pf btf_l_order_pf
 #define BTF_strongcomp btf_l_strongcomp
 
 #define AMD_order amd_l_order
 #define AMD_order_partial amd_l_order_partial
+#define CAMD_order camd_l_order
 #define COLAMD colamd_l
 #define COLAMD_recommended colamd_l_recommended
 
@@ -209,10 +256,18 @@
 
 #define KLU_analyze klu_analyze
 #define KLU_analyze_partial klu_analyze_partial
+#define KLU_analyze_constrained klu_analyze_constrained
 #define KLU_analyze_given klu_analyze_given
+#define KLU_analyze_cached klu_analyze_cached
+#define KLU_analyze_partial_cached klu_analyze_partial_cached
+#define KLU_alloc_cache klu_alloc_cache
+#define KLU_free_cache klu_free_cache
 #define KLU_compute_path klu_compute_path
 #define KLU_determine_start klu_determine_start
+#define KLU_offdiag_rows_pattern klu_offdiag_rows_pattern
 #define KLU_alloc_symbolic klu_alloc_symbolic
+#define KLU_path_estimate klu_path_estimate
+#define KLU_nd_order klu_nd_order
 #define KLU_free_symbolic klu_free_symbolic
 #define KLU_defaults klu_defaults
 #define KLU_free klu_free
@@ -224,12 +279,15 @@
 #define KLU_symbolic klu_symbolic
 #define KLU_numeric klu_numeric
 #define KLU_common klu_common
+#define KLU_cache klu_cache
 
 #define BTF_order btf_order
+#define BTF_order_pf btf_order_pf
 #define BTF_strongcomp btf_strongcomp
 
 #define AMD_order amd_order
 #define AMD_order_partial amd_order_partial
+#define CAMD_order camd_order
 #define COLAMD colamd
 #define COLAMD_recommended colamd_recommended
 
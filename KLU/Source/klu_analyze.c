@@ -8,6 +8,235 @@
 
 #include "klu_internal.h"
 
+/* ========================================================================== */
+/* === order_auto =========================================================== */
+/* ========================================================================== */
+
+/* Orders a block C with AMD, COLAMD, and the user ordering function (if not
+ * NULL), concurrently if KLU is compiled with OpenMP, and keeps the ordering
+ * with the fewest nonzeros in L, and then the fewest flops.  The three are
+ * compared with KLU_path_estimate, which gives the exact nnz(L) and flop
+ * count of each ordering if KLU picks diagonal pivots, rather than with the
+ * estimates of each method, which are not comparable.  The user function is
+ * called while AMD and COLAMD run in other threads, so it must not modify
+ * Cp and Ci (it gets copies) and must be safe to call from any thread.
+ *
+ * Returns the AMD status: AMD_OK or AMD_OK_BUT_JUMBLED if successful, or
+ * AMD_OUT_OF_MEMORY or AMD_INVALID if AMD failed, in which case Pblk, lnz and
+ * flops are not defined and method is 0.  COLAMD cannot fail, and a failing
+ * user function is just not considered. */
+
+static Int order_auto           /* returns the AMD status */
+(
+    /* inputs, not modified */
+    Int nk,             /* C is nk-by-nk */
+    Int Cp [ ],         /* size nk+1, column pointers of C */
+    Int Ci [ ],         /* size nz, row indices of C */
+    Int nz,             /* nz in A, at least nnz (C) */
+    Int Cilen,          /* COLAMD_recommended (nz, n, n) */
+    Int maxblock,       /* size of the largest block */
+
+    /* outputs, not defined on input */
+    Int Pblk [ ],       /* size nk, the best ordering */
+    double *lnz,        /* nz in L of the best ordering, with the diagonal */
+    double *flops,      /* flop count of the best ordering */
+    Int *method,        /* 0: AMD, 1: COLAMD, 3: user function */
+    double amd_Info [ ],    /* AMD statistics */
+
+    /* workspace, not defined on input or output */
+    Int Awork [ ],      /* size 26*maxblock+Cilen+4*nz+6, see below */
+    KLU_common *Common
+)
+{
+    double Lnz3 [3], Flops3 [3] ;
+    Int *Pm [3], *Ew [3], Ok [3], *Cp2, *Ci2, *Cp3, *Ci3, cstats [COLAMD_STATS],
+        ewlen, result, k, m, p ;
+
+    /* Pm [m] is the ordering of method m, and Ew [m] the workspace for its
+     * KLU_path_estimate */
+    ewlen = 7*maxblock + 1 + nz ;
+    Pm [0] = Awork ;
+    Pm [1] = Awork + maxblock ;
+    Pm [2] = Awork + 2*maxblock ;
+    Ew [0] = Awork + 3*maxblock ;
+    Ew [1] = Ew [0] + ewlen ;
+    Ew [2] = Ew [1] + ewlen ;
+    Cp2 = Ew [2] + ewlen ;          /* size maxblock+1, for COLAMD */
+    Ci2 = Cp2 + maxblock + 1 ;      /* size Cilen, for COLAMD */
+    Cp3 = Ci2 + Cilen ;             /* size maxblock+1, for user_order */
+    Ci3 = Cp3 + maxblock + 1 ;      /* size nz+1, for user_order */
+    result = AMD_OK ;
+    *method = 0 ;
+
+#ifdef _OPENMP
+    #pragma omp parallel sections private(k, p)
+#endif
+    {
+
+#ifdef _OPENMP
+        #pragma omp section
+#endif
+        {
+            /* AMD on C+C' */
+            result = AMD_order (nk, Cp, Ci, Pm [0], NULL, amd_Info) ;
+            Ok [0] = (result >= AMD_OK) && KLU_path_estimate (nk, Cp, Ci,
+                Pm [0], NULL, &Lnz3 [0], &Flops3 [0], NULL, NULL, Ew [0]) ;
+        }
+
+#ifdef _OPENMP
+        #pragma omp section
+#endif
+        {
+            /* COLAMD on C, which it destroys, so it gets a copy */
+            for (k = 0 ; k <= nk ; k++)
+            {
+                Cp2 [k] = Cp [k] ;
+            }
+            for (p = 0 ; p < Cp [nk] ; p++)
+            {
+                Ci2 [p] = Ci [p] ;
+            }
+            Ok [1] = COLAMD (nk, nk, Cilen, Ci2, Cp2, NULL, cstats) ;
+            for (k = 0 ; k < nk ; k++)
+            {
+                Pm [1] [k] = Cp2 [k] ;
+            }
+            Ok [1] = Ok [1] && KLU_path_estimate (nk, Cp, Ci, Pm [1], NULL,
+                &Lnz3 [1], &Flops3 [1], NULL, NULL, Ew [1]) ;
+        }
+
+#ifdef _OPENMP
+        #pragma omp section
+#endif
+        {
+            /* the user function, if any, also on a copy of C */
+            Ok [2] = (Common->user_order != NULL) ;
+            if (Ok [2])
+            {
+                for (k = 0 ; k <= nk ; k++)
+                {
+                    Cp3 [k] = Cp [k] ;
+                }
+                for (p = 0 ; p < Cp [nk] ; p++)
+                {
+                    Ci3 [p] = Ci [p] ;
+                }
+                Ok [2] = ((Common->user_order) (nk, Cp3, Ci3, Pm [2], Common)
+                    != 0) && KLU_path_estimate (nk, Cp, Ci, Pm [2], NULL,
+                    &Lnz3 [2], &Flops3 [2], NULL, NULL, Ew [2]) ;
+            }
+        }
+    }
+
+    /* account for memory usage in AMD */
+    Common->mempeak = MAX (Common->mempeak,
+        Common->memusage + amd_Info [AMD_MEMORY]) ;
+    if (!Ok [0])
+    {
+        /* AMD failed, or its ordering could not be evaluated */
+        return ((result < AMD_OK) ? result : AMD_INVALID) ;
+    }
+
+    /* keep the best ordering; ties go to AMD, then COLAMD */
+    m = 0 ;
+    for (k = 1 ; k < 3 ; k++)
+    {
+        if (Ok [k] && (Lnz3 [k] < Lnz3 [m] ||
+            (Lnz3 [k] == Lnz3 [m] && Flops3 [k] < Flops3 [m])))
+        {
+            m = k ;
+        }
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        Pblk [k] = Pm [m] [k] ;
+    }
+    *lnz = Lnz3 [m] ;
+    *flops = Flops3 [m] ;
+    *method = (m == 2) ? 3 : m ;
+    PRINTF (("auto: lnz AMD %g COLAMD %g user %g, method %d\n", Lnz3 [0],
+        Ok [1] ? Lnz3 [1] : -1, Ok [2] ? Lnz3 [2] : -1, *method)) ;
+    return (result) ;
+}
+
+/* ========================================================================== */
+/* === extract_block ======================================================== */
+/* ========================================================================== */
+
+/* Blocks of this size or larger are extracted in parallel */
+#define KLU_EXTRACT_PAR_MIN 10000
+
+/* Constructs C = A (Pbtf (k1:k2-1), Qbtf (k1:k2-1)), with rows and columns
+ * from 0 to nk-1, and returns the number of entries of these columns of A
+ * that are above the block.  The entries of each column are counted, in
+ * parallel for large blocks, then Cp is found by a prefix sum, and the
+ * entries are scattered into Ci, in the same order as a single pass
+ * over the columns would leave them. */
+
+static Int extract_block        /* returns # of entries above the block */
+(
+    /* inputs, not modified */
+    Int k1,             /* the block is from rows/columns k1 to k2-1 */
+    Int k2,
+    Int Ap [ ],
+    Int Ai [ ],
+    Int Qbtf [ ],
+    Int Pinv [ ],       /* inverse of Pbtf */
+
+    /* output only, not defined on input */
+    Int Cp [ ],         /* size nk+1 */
+    Int Ci [ ]          /* size nnz (C) */
+)
+{
+    Int nk, newcol, nza ;
+
+    nk = k2 - k1 ;
+    nza = 0 ;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) reduction(+:nza) \
+        if (nk >= KLU_EXTRACT_PAR_MIN)
+#endif
+    for (newcol = 0 ; newcol < nk ; newcol++)
+    {
+        Int oldcol, p, pend, cnt = 0 ;
+        oldcol = Qbtf [k1 + newcol] ;
+        pend = Ap [oldcol+1] ;
+        for (p = Ap [oldcol] ; p < pend ; p++)
+        {
+            cnt += (Pinv [Ai [p]] >= k1) ;
+        }
+        Cp [newcol+1] = cnt ;
+        nza += pend - Ap [oldcol] ;
+    }
+    Cp [0] = 0 ;
+    for (newcol = 0 ; newcol < nk ; newcol++)
+    {
+        Cp [newcol+1] += Cp [newcol] ;
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if (nk >= KLU_EXTRACT_PAR_MIN)
+#endif
+    for (newcol = 0 ; newcol < nk ; newcol++)
+    {
+        Int oldcol, p, pend, newrow, pc2 ;
+        oldcol = Qbtf [k1 + newcol] ;
+        pend = Ap [oldcol+1] ;
+        pc2 = Cp [newcol] ;
+        for (p = Ap [oldcol] ; p < pend ; p++)
+        {
+            newrow = Pinv [Ai [p]] ;
+            if (newrow >= k1)
+            {
+                /* (newrow,newcol) is an entry in the block */
+                ASSERT (newrow < k2) ;
+                Ci [pc2++] = newrow - k1 ;
+            }
+        }
+        ASSERT (pc2 == Cp [newcol+1]) ;
+    }
+    return (nza - Cp [nk]) ;
+}
+
 /* ========================================================================== */
 /* === analyze_worker ======================================================= */
 /* ========================================================================== */
@@ -22,7 +251,8 @@ static Int analyze_worker       /* returns KLU_OK or < 0 if error */
     Int Pbtf [ ],       /* BTF row permutation */
     Int Qbtf [ ],       /* BTF col permutation */
     Int R [ ],          /* size n+1, but only Rbtf [0..nblocks] is used */
-    Int ordering,       /* what ordering to use (0, 1, or 3 for this routine) */
+    Int ordering,       /* what ordering to use (0, 1, 3, 4, 5, or 6 for
+                         * this routine) */
 
     /* output only, not defined on input */
     Int P [ ],          /* size n */
@@ -33,8 +263,14 @@ static Int analyze_worker       /* returns KLU_OK or < 0 if error */
     Int Pblk [ ],       /* size maxblock */
     Int Cp [ ],         /* size maxblock+1 */
     Int Ci [ ],         /* size MAX (nz+1, Cilen) */
-    Int Cilen,          /* nz+1, or COLAMD_recommend(nz,n,n) for COLAMD */
+    Int Cilen,          /* nz+1, or COLAMD_recommend(nz,n,n) for COLAMD and
+                         * AUTO */
     Int Pinv [ ],       /* size maxblock */
+    Int Awork [ ],      /* size 26*maxblock+Cilen+4*nz+6 for AUTO,
+                         * NULL otherwise */
+    Int Cset [ ],       /* size n for CAMD: Cset [k1 ... k2-1] are the
+                         * constraint sets of the block, 0 to nk-1.
+                         * NULL otherwise */
 
     /* input/output */
     KLU_symbolic *Symbolic,
@@ -42,8 +278,8 @@ static Int analyze_worker       /* returns KLU_OK or < 0 if error */
 )
 {
     double amd_Info [AMD_INFO], lnz, lnz1, flops, flops1 ;
-    Int k1, k2, nk, k, block, oldcol, pend, newcol, result, pc, p, newrow,
-        maxnz, nzoff, cstats [COLAMD_STATS], ok, err = KLU_INVALID ;
+    Int k1, k2, nk, k, i, block, result, pc, p, maxnz, nzoff,
+        cstats [COLAMD_STATS], ok, method, err = KLU_INVALID ;
 
     /* ---------------------------------------------------------------------- */
     /* initializations */
@@ -93,30 +329,8 @@ static Int analyze_worker       /* returns KLU_OK or < 0 if error */
         /* ------------------------------------------------------------------ */
 
         Lnz [block] = EMPTY ;
-        pc = 0 ;
-        for (k = k1 ; k < k2 ; k++)
-        {
-            newcol = k-k1 ;
-            Cp [newcol] = pc ;
-            oldcol = Qbtf [k] ;
-            pend = Ap [oldcol+1] ;
-            for (p = Ap [oldcol] ; p < pend ; p++)
-            {
-                newrow = Pinv [Ai [p]] ;
-                if (newrow < k1)
-                {
-                    nzoff++ ;
-                }
-                else
-                {
-                    /* (newrow,newcol) is an entry in the block */
-                    ASSERT (newrow < k2) ;
-                    newrow -= k1 ;
-                    Ci [pc++] = newrow ;
-                }
-            }
-        }
-        Cp [nk] = pc ;
+        nzoff += extract_block (k1, k2, Ap, Ai, Qbtf, Pinv, Cp, Ci) ;
+        pc = Cp [nk] ;
         maxnz = MAX (maxnz, pc) ;
         ASSERT (KLU_valid (nk, Cp, Ci, NULL)) ;
 
@@ -135,19 +349,89 @@ static Int analyze_worker       /* returns KLU_OK or < 0 if error */
             {
                 Pblk [k] = k ;
             }
+            if (Cset != NULL)
+            {
+                /* the natural ordering, sorted by constraint set */
+                for (k = 1 ; k < nk ; k++)
+                {
+                    for (i = k ; i > 0 &&
+                        Cset [k1 + Pblk [i-1]] > Cset [k1 + Pblk [i]] ; i--)
+                    {
+                        p = Pblk [i] ;
+                        Pblk [i] = Pblk [i-1] ;
+                        Pblk [i-1] = p ;
+                    }
+                }
+            }
             lnz1 = nk * (nk + 1) / 2 ;
             flops1 = nk * (nk - 1) / 2 + (nk-1)*nk*(2*nk-1) / 6 ;
             ok = TRUE ;
+            if (Symbolic->Method != NULL)
+            {
+                Symbolic->Method [block] = 2 ;
+            }
 
         }
-        else if (ordering == 0)
+        else if (ordering == 4)
         {
 
             /* -------------------------------------------------------------- */
-            /* order the block with AMD (C+C') */
+            /* order the block with the best of AMD, COLAMD and the user */
             /* -------------------------------------------------------------- */
 
-            result = AMD_order (nk, Cp, Ci, Pblk, NULL, amd_Info) ;
+            result = order_auto (nk, Cp, Ci, Ap [n], Cilen,
+                Symbolic->maxblock, Pblk, &lnz1, &flops1, &method, amd_Info,
+                Awork, Common) ;
+            ok = (result >= AMD_OK) ;
+            if (result == AMD_OUT_OF_MEMORY)
+            {
+                err = KLU_OUT_OF_MEMORY ;
+            }
+            Symbolic->Method [block] = method ;
+            if (pc == maxnz)
+            {
+                /* get the symmetry of the biggest block */
+                Symbolic->symmetry = amd_Info [AMD_SYMMETRY] ;
+            }
+
+        }
+        else if (ordering == 5 && nk >= Common->nd_min)
+        {
+
+            /* -------------------------------------------------------------- */
+            /* order the block with nested dissection, and find its domains */
+            /* -------------------------------------------------------------- */
+
+            ok = KLU_nd_order (nk, Cp, Ci, Pblk, Symbolic->Domain + k1, &lnz1,
+                &flops1, Common) ;
+            err = Common->status ;
+            for (k = k1 ; k < k2 ; k++)
+            {
+                if (Symbolic->Domain [k] != EMPTY)
+                {
+                    /* one past the end of the domain, in A (P,Q) */
+                    Symbolic->Domain [k] += k1 ;
+                }
+            }
+
+        }
+        else if (ordering == 0 || ordering == 5 || ordering == 6)
+        {
+
+            /* -------------------------------------------------------------- */
+            /* order the block with AMD or CAMD (C+C') */
+            /* -------------------------------------------------------------- */
+
+            if (ordering == 6)
+            {
+                /* CAMD and AMD share the layout of the Info array */
+                result = CAMD_order (nk, Cp, Ci, Pblk, NULL, amd_Info,
+                    Cset + k1) ;
+            }
+            else
+            {
+                result = AMD_order (nk, Cp, Ci, Pblk, NULL, amd_Info) ;
+            }
             ok = (result >= AMD_OK) ;
             if (result == AMD_OUT_OF_MEMORY)
             {
@@ -276,11 +560,15 @@ static Int analyze_worker_partial    /* returns KLU_OK or < 0 if error */
     Int varyingColumns [ ],
     Int varyingRows [ ],
     Int n_varyingEntries,
-    Int orderingMethod
+    Int orderingMethod,
+
+    /* workspace for KLU_path_estimate */
+    Int Ework [ ]       /* size 7*maxblock + 1 + nz */
 )
 {
-    double amd_Info [AMD_INFO], lnz, lnz1, flops, flops1 ;
-    Int k1, k2, nk, k, block, oldcol, pend, newcol, result, pc, p, newrow,
+    double amd_Info [AMD_INFO], lnz, lnz1, flops, flops1, pathlen, pathlen1,
+        pathflops, pathflops1 ;
+    Int k1, k2, nk, k, block, oldcol, pend, result, pc, p, newrow,
         maxnz, nzoff, ok, err = KLU_INVALID, i, n_varyingEntries_new = n_varyingEntries;
 
 
@@ -315,6 +603,8 @@ static Int analyze_worker_partial    /* returns KLU_OK or < 0 if error */
     lnz = 0 ;
     maxnz = 0 ;
     flops = 0 ;
+    pathlen = 0 ;
+    pathflops = 0 ;
     Symbolic->symmetry = EMPTY ;        /* only computed by AMD */
 
 
@@ -410,30 +700,8 @@ static Int analyze_worker_partial    /* returns KLU_OK or < 0 if error */
         /* ------------------------------------------------------------------ */
 
         Lnz [block] = EMPTY ;
-        pc = 0 ;
-        for (k = k1 ; k < k2 ; k++)
-        {
-            newcol = k-k1 ;
-            Cp [newcol] = pc ;
-            oldcol = Qbtf [k] ;
-            pend = Ap [oldcol+1] ;
-            for (p = Ap [oldcol] ; p < pend ; p++)
-            {
-                newrow = Pinv [Ai [p]] ;
-                if (newrow < k1)
-                {
-                    nzoff++ ;
-                }
-                else
-                {
-                    /* (newrow,newcol) is an entry in the block */
-                    ASSERT (newrow < k2) ;
-                    newrow -= k1 ;
-                    Ci [pc++] = newrow ;
-                }
-            }
-        }
-        Cp [nk] = pc ;
+        nzoff += extract_block (k1, k2, Ap, Ai, Qbtf, Pinv, Cp, Ci) ;
+        pc = Cp [nk] ;
         maxnz = MAX (maxnz, pc) ;
         ASSERT (KLU_valid (nk, Cp, Ci, NULL)) ;
 
@@ -470,6 +738,19 @@ static Int analyze_worker_partial    /* returns KLU_OK or < 0 if error */
             {
                 result = AMD_order_partial (nk, Cp, Ci, Pblk, NULL, amd_Info, k1, Varying, orderingMethod);
             }
+            else if (orderingMethod == AMD_ORDERING_CAMD)
+            {
+                /* Order the varying columns last in the block, with CAMD.
+                 * Every etree ancestor of a varying column then is varying
+                 * itself, so the factorization path of the block is just
+                 * its varying columns.  CAMD and AMD share the layout of
+                 * the Info array.  Ework is free until KLU_path_estimate. */
+                for (k = 0 ; k < nk ; k++)
+                {
+                    Ework [k] = Varying [k + k1] ? 1 : 0 ;
+                }
+                result = CAMD_order (nk, Cp, Ci, Pblk, NULL, amd_Info, Ework) ;
+            }
             else
             {
                 result = AMD_order (nk, Cp, Ci, Pblk, NULL, amd_Info) ;
@@ -514,6 +795,17 @@ static Int analyze_worker_partial    /* returns KLU_OK or < 0 if error */
         lnz = (lnz == EMPTY || lnz1 == EMPTY) ? EMPTY : (lnz + lnz1) ;
         flops = (flops == EMPTY || flops1 == EMPTY) ? EMPTY : (flops + flops1) ;
 
+        /* ------------------------------------------------------------------ */
+        /* estimate the factorization path of the block */
+        /* ------------------------------------------------------------------ */
+
+        KLU_path_estimate (nk, Cp, Ci, Pblk, Varying + k1, NULL, NULL,
+            &pathlen1, &pathflops1, Ework) ;
+        Symbolic->Pathlen [block] = pathlen1 ;
+        Symbolic->Pathflops [block] = pathflops1 ;
+        pathlen += pathlen1 ;
+        pathflops += pathflops1 ;
+
         /* ------------------------------------------------------------------ */
         /* combine the preordering with the BTF ordering */
         /* ------------------------------------------------------------------ */
@@ -541,6 +833,8 @@ static Int analyze_worker_partial    /* returns KLU_OK or < 0 if error */
     Symbolic->unz = lnz ;
     Symbolic->nzoff = nzoff ;
     Symbolic->est_flops = flops ;   /* EMPTY if COLAMD or user-ordering used */
+    Symbolic->est_pathlen = pathlen ;
+    Symbolic->est_path_flops = pathflops ;
 
     free(varyingColumns_in_PAQ);
     free(varyingRows_in_PAQ);
@@ -551,13 +845,93 @@ static Int analyze_worker_partial    /* returns KLU_OK or < 0 if error */
 }
 
 
+/* ========================================================================== */
+/* === constraint_sets ====================================================== */
+/* ========================================================================== */
+
+/* Maps the constraint sets of the columns of A through the BTF permutation.
+ * Cset [k] is the set of column Qbtf [k], renumbered within its block as 0,
+ * 1, ... in increasing order of Cmember, as CAMD requires.  Takes O(n) time,
+ * with a counting sort of all the columns by set.  Common->status is
+ * KLU_OUT_OF_MEMORY if out of memory. */
+
+static void constraint_sets
+(
+    Int n,
+    Int Cmember [ ],    /* size n, the constraint set of each column of A */
+    Int Qbtf [ ],       /* BTF col permutation */
+    Int R [ ],          /* BTF blocks */
+    Int nblocks,
+    Int Cset [ ],       /* output, size n */
+    KLU_common *Common
+)
+{
+    Int *Work, *Count, *Order, *Blk, *Last, *Rank ;
+    Int block, k, c, b, t ;
+
+    Work = KLU_malloc (4*n + 1, sizeof (Int), Common) ;
+    if (Common->status < KLU_OK)
+    {
+        return ;
+    }
+    Count = Work ;              /* size n+1 */
+    Order = Work + n + 1 ;      /* size n, the columns sorted by set */
+    Blk = Order + n ;           /* size n, the block of each column */
+    Last = Blk + n ;            /* size nblocks <= n, last set seen */
+
+    for (c = 0 ; c <= n ; c++)
+    {
+        Count [c] = 0 ;
+    }
+    for (k = 0 ; k < n ; k++)
+    {
+        Count [Cmember [Qbtf [k]] + 1]++ ;
+    }
+    for (c = 0 ; c < n ; c++)
+    {
+        Count [c+1] += Count [c] ;
+    }
+    for (k = 0 ; k < n ; k++)
+    {
+        Order [Count [Cmember [Qbtf [k]]]++] = k ;
+    }
+
+    /* number the sets of each block in the order they appear in Order */
+    Rank = Count ;              /* size nblocks, last number used */
+    for (block = 0 ; block < nblocks ; block++)
+    {
+        for (k = R [block] ; k < R [block+1] ; k++)
+        {
+            Blk [k] = block ;
+        }
+        Last [block] = EMPTY ;
+        Rank [block] = EMPTY ;
+    }
+    for (t = 0 ; t < n ; t++)
+    {
+        k = Order [t] ;
+        b = Blk [k] ;
+        c = Cmember [Qbtf [k]] ;
+        if (c != Last [b])
+        {
+            Last [b] = c ;
+            Rank [b]++ ;
+        }
+        Cset [k] = Rank [b] ;
+    }
+
+    KLU_free (Work, 4*n + 1, sizeof (Int), Common) ;
+}
+
+
 /* ========================================================================== */
 /* === order_and_analyze ==================================================== */
 /* ========================================================================== */
 
 /* Orders the matrix with or with BTF, then orders each block with AMD, COLAMD,
- * or the user ordering function.  Does not handle the natural or given
- * ordering cases. */
+ * the user ordering function, the best of them (AUTO), nested dissection
+ * (ND), or CAMD with the given constraint sets.  Does not handle the natural
+ * or given ordering cases. */
 
 static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
                                            KLU_symbolic object if successful */
@@ -566,6 +940,7 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
     Int n,              /* A is n-by-n */
     Int Ap [ ],         /* size n+1, column pointers */
     Int Ai [ ],         /* size nz, row indices */
+    Int Cmember [ ],    /* size n, constraint sets for CAMD, or NULL */
     /* --------------------- */
     KLU_common *Common
 )
@@ -573,9 +948,10 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
     double work ;
     KLU_symbolic *Symbolic ;
     double *Lnz ;
-    Int *Qbtf, *Cp, *Ci, *Pinv, *Pblk, *Pbtf, *P, *Q, *R ;
+    Int *Qbtf, *Cp, *Ci, *Pinv, *Pblk, *Pbtf, *P, *Q, *R, *Cset ;
     Int nblocks, nz, block, maxblock, k1, k2, nk, do_btf, ordering, k, Cilen,
-        *Work ;
+        nwork, *Work, *Awork ;
+    size_t awlen ;
 
     /* ---------------------------------------------------------------------- */
     /* allocate the Symbolic object, and check input matrix */
@@ -592,15 +968,18 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
     Lnz = Symbolic->Lnz ;
     nz = Symbolic->nz ;
 
-    ordering = Common->ordering ;
-    if (ordering == 1)
+    ordering = (Cmember != NULL) ? 6 : Common->ordering ;
+    if (ordering == 1 || ordering == 4)
     {
-        /* COLAMD */
+        /* COLAMD, or AUTO, which also tries COLAMD */
         Cilen = COLAMD_recommended (nz, n, n) ;
     }
-    else if (ordering == 0 || (ordering == 3 && Common->user_order != NULL))
+    else if (ordering == 0 || ordering == 5
+        || (ordering == 6 && Cmember != NULL)
+        || (ordering == 3 && Common->user_order != NULL))
     {
-        /* AMD or user ordering function */
+        /* AMD, nested dissection, CAMD, or user ordering function.  CAMD is
+         * only used by KLU_analyze_constrained, which provides Cmember. */
         Cilen = nz+1 ;
     }
     else
@@ -643,7 +1022,9 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
 
     if (do_btf)
     {
-        Work = KLU_malloc (5*n, sizeof (Int), Common) ;
+        /* btf_order_pf needs one more size-n workspace for the matching */
+        nwork = (Common->btf_match == 1) ? 6*n : 5*n ;
+        Work = KLU_malloc (nwork, sizeof (Int), Common) ;
         if (Common->status < KLU_OK)
         {
             /* out of memory */
@@ -653,12 +1034,21 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
             return (NULL) ;
         }
 
-        nblocks = BTF_order (n, Ap, Ai, Common->maxwork, &work, Pbtf, Qbtf, R,
+        if (Common->btf_match == 1)
+        {
+            /* multithreaded Pothen-Fan matching, with no work limit */
+            nblocks = BTF_order_pf (n, Ap, Ai, 0, &work, Pbtf, Qbtf, R,
                 &(Symbolic->structural_rank), Work) ;
+        }
+        else
+        {
+            nblocks = BTF_order (n, Ap, Ai, Common->maxwork, &work, Pbtf, Qbtf,
+                R, &(Symbolic->structural_rank), Work) ;
+        }
         Common->structural_rank = Symbolic->structural_rank ;
         Common->work += work ;
 
-        KLU_free (Work, 5*n, sizeof (Int), Common) ;
+        KLU_free (Work, nwork, sizeof (Int), Common) ;
 
         /* unflip Qbtf if the matrix does not have full structural rank */
         if (Symbolic->structural_rank < n)
@@ -707,6 +1097,37 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
     Cp   = KLU_malloc (maxblock + 1, sizeof (Int), Common) ;
     Ci   = KLU_malloc (MAX (Cilen, nz+1), sizeof (Int), Common) ;
     Pinv = KLU_malloc (n, sizeof (Int), Common) ;
+    Awork = NULL ;
+    awlen = 0 ;
+    Cset = NULL ;
+    if (ordering == 6)
+    {
+        Cset = KLU_malloc (n, sizeof (Int), Common) ;
+        if (Common->status == KLU_OK)
+        {
+            constraint_sets (n, Cmember, Qbtf, R, nblocks, Cset, Common) ;
+        }
+    }
+    else if (ordering == 4)
+    {
+        /* the orderings and path estimates of the three methods, and copies
+         * of the block for COLAMD and the user function */
+        awlen = 3 * ((size_t) maxblock) + 3 * (7 * (size_t) maxblock + 1 + nz)
+            + 2 * ((size_t) maxblock + 1) + Cilen + nz + 1 ;
+        Awork = KLU_malloc (awlen, sizeof (Int), Common) ;
+        Symbolic->Method = KLU_malloc (n, sizeof (Int), Common) ;
+    }
+    else if (ordering == 5)
+    {
+        Symbolic->Domain = KLU_malloc (n, sizeof (Int), Common) ;
+        if (Symbolic->Domain != NULL)
+        {
+            for (k = 0 ; k < n ; k++)
+            {
+                Symbolic->Domain [k] = EMPTY ;
+            }
+        }
+    }
 
     /* ---------------------------------------------------------------------- */
     /* order each block of the BTF ordering, and a fill-reducing ordering */
@@ -716,7 +1137,8 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
     {
         PRINTF (("calling analyze_worker\n")) ;
         Common->status = analyze_worker (n, Ap, Ai, nblocks, Pbtf, Qbtf, R,
-            ordering, P, Q, Lnz, Pblk, Cp, Ci, Cilen, Pinv, Symbolic, Common) ;
+            ordering, P, Q, Lnz, Pblk, Cp, Ci, Cilen, Pinv, Awork, Cset,
+            Symbolic, Common) ;
         PRINTF (("analyze_worker done\n")) ;
     }
 
@@ -728,6 +1150,8 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
     KLU_free (Cp, maxblock+1, sizeof (Int), Common) ;
     KLU_free (Ci, MAX (Cilen, nz+1), sizeof (Int), Common) ;
     KLU_free (Pinv, n, sizeof (Int), Common) ;
+    KLU_free (Awork, awlen, sizeof (Int), Common) ;
+    KLU_free (Cset, n, sizeof (Int), Common) ;
     KLU_free (Pbtf, n, sizeof (Int), Common) ;
     KLU_free (Qbtf, n, sizeof (Int), Common) ;
 
@@ -747,7 +1171,7 @@ static KLU_symbolic *order_and_analyze  /* returns NULL if error, or a valid
 /* ========================================================================== */
 
 /* Orders the matrix with or with BTF, then orders each block with AMD, AMD-BRA,
- * or AMD-NV.  Does not handle the natural or given ordering cases. */
+ * AMD-NV, or CAMD.  Does not handle the natural or given ordering cases. */
 
 static KLU_symbolic *order_and_analyze_partial  /* returns NULL if error, or a valid
                                            KLU_symbolic object if successful */
@@ -769,7 +1193,7 @@ static KLU_symbolic *order_and_analyze_partial  /* returns NULL if error, or a v
     double *Lnz ;
     Int *Qbtf, *Cp, *Ci, *Pinv, *Pblk, *Pbtf, *P, *Q, *R ;
     Int nblocks, nz, block, maxblock, k1, k2, nk, do_btf, ordering, k, Cilen,
-        *Work ;
+        nwork, *Work, *Ework ;
 
     /* ---------------------------------------------------------------------- */
     /* allocate the Symbolic object, and check input matrix */
@@ -822,7 +1246,9 @@ static KLU_symbolic *order_and_analyze_partial  /* returns NULL if error, or a v
 
     if (do_btf)
     {
-        Work = KLU_malloc (5*n, sizeof (Int), Common) ;
+        /* btf_order_pf needs one more size-n workspace for the matching */
+        nwork = (Common->btf_match == 1) ? 6*n : 5*n ;
+        Work = KLU_malloc (nwork, sizeof (Int), Common) ;
         if (Common->status < KLU_OK)
         {
             /* out of memory */
@@ -832,12 +1258,21 @@ static KLU_symbolic *order_and_analyze_partial  /* returns NULL if error, or a v
             return (NULL) ;
         }
 
-        nblocks = BTF_order (n, Ap, Ai, Common->maxwork, &work, Pbtf, Qbtf, R,
+        if (Common->btf_match == 1)
+        {
+            /* multithreaded Pothen-Fan matching, with no work limit */
+            nblocks = BTF_order_pf (n, Ap, Ai, 0, &work, Pbtf, Qbtf, R,
                 &(Symbolic->structural_rank), Work) ;
+        }
+        else
+        {
+            nblocks = BTF_order (n, Ap, Ai, Common->maxwork, &work, Pbtf, Qbtf,
+                R, &(Symbolic->structural_rank), Work) ;
+        }
         Common->structural_rank = Symbolic->structural_rank ;
         Common->work += work ;
 
-        KLU_free (Work, 5*n, sizeof (Int), Common) ;
+        KLU_free (Work, nwork, sizeof (Int), Common) ;
 
         /* unflip Qbtf if the matrix does not have full structural rank */
         if (Symbolic->structural_rank < n)
@@ -886,6 +1321,9 @@ static KLU_symbolic *order_and_analyze_partial  /* returns NULL if error, or a v
     Cp   = KLU_malloc (maxblock + 1, sizeof (Int), Common) ;
     Ci   = KLU_malloc (MAX (Cilen, nz+1), sizeof (Int), Common) ;
     Pinv = KLU_malloc (n, sizeof (Int), Common) ;
+    Ework = KLU_malloc (7*maxblock + 1 + nz, sizeof (Int), Common) ;
+    Symbolic->Pathlen = KLU_malloc (n, sizeof (double), Common) ;
+    Symbolic->Pathflops = KLU_malloc (n, sizeof (double), Common) ;
 
     /* ---------------------------------------------------------------------- */
     /* order each block of the BTF ordering, and a fill-reducing ordering */
@@ -895,7 +1333,8 @@ static KLU_symbolic *order_and_analyze_partial  /* returns NULL if error, or a v
     {
         PRINTF (("calling analyze_worker\n")) ;
         Common->status = analyze_worker_partial (n, Ap, Ai, nblocks, Pbtf, Qbtf, R,
-            ordering, P, Q, Lnz, Pblk, Cp, Ci, Cilen, Pinv, Symbolic, Common, varyingColumns, varyingRows, n_varyingEntries, orderingMethod) ;
+            ordering, P, Q, Lnz, Pblk, Cp, Ci, Cilen, Pinv, Symbolic, Common, varyingColumns, varyingRows, n_varyingEntries, orderingMethod,
+            Ework) ;
         PRINTF (("analyze_worker done\n")) ;
     }
 
@@ -907,6 +1346,7 @@ static KLU_symbolic *order_and_analyze_partial  /* returns NULL if error, or a v
     KLU_free (Cp, maxblock+1, sizeof (Int), Common) ;
     KLU_free (Ci, MAX (Cilen, nz+1), sizeof (Int), Common) ;
     KLU_free (Pinv, n, sizeof (Int), Common) ;
+    KLU_free (Ework, 7*maxblock + 1 + nz, sizeof (Int), Common) ;
     KLU_free (Pbtf, n, sizeof (Int), Common) ;
     KLU_free (Qbtf, n, sizeof (Int), Common) ;
 
@@ -961,10 +1401,60 @@ KLU_symbolic *KLU_analyze       /* returns NULL if error, or a valid
     else
     {
         /* order with P and Q */
-        return (order_and_analyze (n, Ap, Ai, Common)) ;
+        return (order_and_analyze (n, Ap, Ai, NULL, Common)) ;
     }
 }
 
+/* ========================================================================== */
+/* === KLU_analyze_constrained ============================================== */
+/* ========================================================================== */
+
+/* Orders each block with CAMD, so that within each block the columns of A in
+ * constraint set Cmember [j] = 0 come first, then set 1, and so on.  For
+ * example, with Cmember [j] = 1 for the interface or varying columns and 0
+ * for the others, those columns are factorized last, and so is the
+ * factorization path of a partial refactorization that starts at them.  The
+ * BTF ordering is not affected by Cmember.  Symbolic->ordering is 6. */
+
+KLU_symbolic *KLU_analyze_constrained   /* returns NULL if error, or a valid
+                                           KLU_symbolic object if successful */
+(
+    /* inputs, not modified */
+    Int n,              /* A is n-by-n */
+    Int Ap [ ],         /* size n+1, column pointers */
+    Int Ai [ ],         /* size nz, row indices */
+    Int Cmember [ ],    /* size n, Cmember [j] in 0 to n-1 is the constraint
+                         * set of column j */
+    /* -------------------- */
+    KLU_common *Common
+)
+{
+    Int j ;
+
+    if (Common == NULL)
+    {
+        return (NULL) ;
+    }
+    Common->status = KLU_OK ;
+    Common->structural_rank = EMPTY ;
+
+    if (Cmember == NULL)
+    {
+        Common->status = KLU_INVALID ;
+        return (NULL) ;
+    }
+    for (j = 0 ; j < n ; j++)
+    {
+        if (Cmember [j] < 0 || Cmember [j] >= n)
+        {
+            Common->status = KLU_INVALID ;
+            return (NULL) ;
+        }
+    }
+
+    return (order_and_analyze (n, Ap, Ai, Cmember, Common)) ;
+}
+
 /* ========================================================================== */
 /* === KLU_analyze ========================================================== */
 /* ========================================================================== */
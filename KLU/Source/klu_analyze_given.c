@@ -115,6 +115,12 @@ KLU_symbolic *KLU_alloc_symbolic
     Symbolic->Q = Q ;
     Symbolic->R = R ;
     Symbolic->Lnz = Lnz ;
+    Symbolic->est_pathlen = EMPTY ;
+    Symbolic->est_path_flops = EMPTY ;
+    Symbolic->Pathlen = NULL ;
+    Symbolic->Pathflops = NULL ;
+    Symbolic->Method = NULL ;
+    Symbolic->Domain = NULL ;
 
     if (Common->status < KLU_OK)
     {
@@ -0,0 +1,560 @@
+/* ========================================================================== */
+/* === KLU_cache ============================================================ */
+/* ========================================================================== */
+
+/* A cache of Symbolic objects, keyed by the sparsity pattern of A (and the
+ * varying entries, for KLU_analyze_partial_cached).  KLU_analyze_cached and
+ * KLU_analyze_partial_cached return a copy of the cached Symbolic object if
+ * the same pattern has been analyzed before with the same ordering options,
+ * and skip BTF and the fill-reducing ordering entirely.  Otherwise they call
+ * KLU_analyze or KLU_analyze_partial and add a copy of the result to the
+ * cache.  In both cases the caller owns the returned object, and frees it
+ * with KLU_free_symbolic as usual.
+ *
+ * The key is a hash of n, Ap, Ai, the varying entries (in the order given),
+ * and the ordering options in Common (btf, btf_match, ordering, maxwork,
+ * user_order, user_data, nd_min and nd_domains).  Only the user_data pointer is
+ * compared, not what it points to: if the user ordering depends on data that
+ * changes in place, free the cache and allocate a new one.
+ * A hit is confirmed by comparing the full pattern, so hash collisions are
+ * harmless.  Comparing the pattern takes O(n+nz) time, much less than the
+ * ordering.  Each entry keeps a copy of Ap and Ai for this.
+ *
+ * The cache holds at most Cache->max_entries entries.  When it is full, the
+ * least recently used entry that is not pinned is replaced.  If all entries
+ * are pinned, the new Symbolic object is returned but not cached.
+ */
+
+#include "klu_internal.h"
+
+/* one entry of the cache */
+typedef struct
+{
+    size_t hash ;           /* hash of the key */
+    Int n, nz, nv ;         /* size of A, nz in A, # of varying entries */
+    Int btf, ordering ;     /* Common->btf and Common->ordering */
+    Int btf_match ;         /* Common->btf_match */
+    Int method ;            /* orderingMethod, EMPTY for KLU_analyze */
+    double maxwork ;        /* Common->maxwork */
+    Int nd_min, nd_domains ;    /* Common->nd_min and Common->nd_domains */
+    Int (*user_order) (Int, Int *, Int *, Int *, KLU_common *) ;
+    void *user_data ;       /* Common->user_data */
+    Int *Ap ;               /* size n+1, copy of the pattern of A */
+    Int *Ai ;               /* size nz */
+    Int *Vc ;               /* size nv, copy of the varying columns */
+    Int *Vr ;               /* size nv, copy of the varying rows */
+    Int pinned ;            /* TRUE if the entry is never replaced */
+    Int stamp ;             /* time of the last use, for LRU replacement */
+    KLU_symbolic *Symbolic ;    /* NULL if the entry is not in use */
+
+} KLU_cache_entry ;
+
+
+/* ========================================================================== */
+/* === hash_key ============================================================= */
+/* ========================================================================== */
+
+/* FNV-1a hash of an array of Int's */
+
+#define FNV_OFFSET ((size_t) 2166136261u)
+#define FNV_PRIME ((size_t) 16777619u)
+
+static size_t hash_ints (size_t h, Int X [ ], Int len)
+{
+    Int k ;
+    if (X == NULL)
+    {
+        return (h) ;
+    }
+    for (k = 0 ; k < len ; k++)
+    {
+        h ^= (size_t) X [k] ;
+        h *= FNV_PRIME ;
+    }
+    return (h) ;
+}
+
+static size_t hash_key
+(
+    Int n, Int Ap [ ], Int Ai [ ], Int Vc [ ], Int Vr [ ], Int nv, Int method,
+    KLU_common *Common
+)
+{
+    Int opts [4] ;
+    size_t h ;
+    opts [0] = n ;
+    opts [1] = Common->btf ;
+    opts [2] = Common->ordering ;
+    opts [3] = method ;
+    h = hash_ints (FNV_OFFSET, opts, 4) ;
+    h = hash_ints (h, Ap, n+1) ;
+    h = hash_ints (h, Ai, Ap [n]) ;
+    h = hash_ints (h, Vc, nv) ;
+    h = hash_ints (h, Vr, nv) ;
+    return (h) ;
+}
+
+
+/* ========================================================================== */
+/* === same_ints ============================================================ */
+/* ========================================================================== */
+
+static Int same_ints (Int X [ ], Int Y [ ], Int len)
+{
+    Int k ;
+    for (k = 0 ; k < len ; k++)
+    {
+        if (X [k] != Y [k])
+        {
+            return (FALSE) ;
+        }
+    }
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === copy_symbolic ======================================================== */
+/* ========================================================================== */
+
+/* Returns a copy of a Symbolic object, or NULL if out of memory */
+
+static KLU_symbolic *copy_symbolic
+(
+    KLU_symbolic *Symbolic,
+    KLU_common *Common
+)
+{
+    KLU_symbolic *S2 ;
+    Int n, k ;
+
+    n = Symbolic->n ;
+    S2 = KLU_malloc (1, sizeof (KLU_symbolic), Common) ;
+    if (Common->status < KLU_OK)
+    {
+        return (NULL) ;
+    }
+    *S2 = *Symbolic ;
+    S2->P = KLU_malloc (n, sizeof (Int), Common) ;
+    S2->Q = KLU_malloc (n, sizeof (Int), Common) ;
+    S2->R = KLU_malloc (n+1, sizeof (Int), Common) ;
+    S2->Lnz = KLU_malloc (n, sizeof (double), Common) ;
+    S2->Pathlen = NULL ;
+    S2->Pathflops = NULL ;
+    S2->Method = NULL ;
+    S2->Domain = NULL ;
+    if (Symbolic->Pathlen != NULL)
+    {
+        S2->Pathlen = KLU_malloc (n, sizeof (double), Common) ;
+        S2->Pathflops = KLU_malloc (n, sizeof (double), Common) ;
+    }
+    if (Symbolic->Method != NULL)
+    {
+        S2->Method = KLU_malloc (n, sizeof (Int), Common) ;
+    }
+    if (Symbolic->Domain != NULL)
+    {
+        S2->Domain = KLU_malloc (n, sizeof (Int), Common) ;
+    }
+    if (Common->status < KLU_OK)
+    {
+        KLU_free_symbolic (&S2, Common) ;
+        Common->status = KLU_OUT_OF_MEMORY ;
+        return (NULL) ;
+    }
+
+    for (k = 0 ; k < n ; k++)
+    {
+        S2->P [k] = Symbolic->P [k] ;
+        S2->Q [k] = Symbolic->Q [k] ;
+        S2->R [k] = Symbolic->R [k] ;
+        S2->Lnz [k] = Symbolic->Lnz [k] ;
+    }
+    S2->R [n] = Symbolic->R [n] ;
+    if (Symbolic->Pathlen != NULL)
+    {
+        for (k = 0 ; k < n ; k++)
+        {
+            S2->Pathlen [k] = Symbolic->Pathlen [k] ;
+            S2->Pathflops [k] = Symbolic->Pathflops [k] ;
+        }
+    }
+    if (Symbolic->Method != NULL)
+    {
+        for (k = 0 ; k < n ; k++)
+        {
+            S2->Method [k] = Symbolic->Method [k] ;
+        }
+    }
+    if (Symbolic->Domain != NULL)
+    {
+        for (k = 0 ; k < n ; k++)
+        {
+            S2->Domain [k] = Symbolic->Domain [k] ;
+        }
+    }
+    return (S2) ;
+}
+
+
+/* ========================================================================== */
+/* === free_entry =========================================================== */
+/* ========================================================================== */
+
+static void free_entry
+(
+    KLU_cache_entry *E,
+    KLU_common *Common
+)
+{
+    if (E->Symbolic == NULL)
+    {
+        return ;
+    }
+    KLU_free (E->Ap, E->n+1, sizeof (Int), Common) ;
+    KLU_free (E->Ai, E->nz, sizeof (Int), Common) ;
+    KLU_free (E->Vc, E->nv, sizeof (Int), Common) ;
+    KLU_free (E->Vr, E->nv, sizeof (Int), Common) ;
+    KLU_free_symbolic (&(E->Symbolic), Common) ;
+    E->Ap = NULL ;
+    E->Ai = NULL ;
+    E->Vc = NULL ;
+    E->Vr = NULL ;
+    E->pinned = FALSE ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_alloc_cache ====================================================== */
+/* ========================================================================== */
+
+/* Allocate an empty cache for up to max_entries Symbolic objects */
+
+KLU_cache *KLU_alloc_cache
+(
+    Int max_entries,
+    KLU_common *Common
+)
+{
+    KLU_cache *Cache ;
+    KLU_cache_entry *Entries ;
+    Int k ;
+
+    if (Common == NULL)
+    {
+        return (NULL) ;
+    }
+    Common->status = KLU_OK ;
+    if (max_entries <= 0)
+    {
+        Common->status = KLU_INVALID ;
+        return (NULL) ;
+    }
+
+    Cache = KLU_malloc (1, sizeof (KLU_cache), Common) ;
+    Entries = KLU_malloc (max_entries, sizeof (KLU_cache_entry), Common) ;
+    if (Common->status < KLU_OK)
+    {
+        KLU_free (Cache, 1, sizeof (KLU_cache), Common) ;
+        KLU_free (Entries, max_entries, sizeof (KLU_cache_entry), Common) ;
+        Common->status = KLU_OUT_OF_MEMORY ;
+        return (NULL) ;
+    }
+    for (k = 0 ; k < max_entries ; k++)
+    {
+        Entries [k].Symbolic = NULL ;
+        Entries [k].pinned = FALSE ;
+    }
+    Cache->max_entries = max_entries ;
+    Cache->nentries = 0 ;
+    Cache->hits = 0 ;
+    Cache->misses = 0 ;
+    Cache->stamp = 0 ;
+    Cache->Entries = Entries ;
+    return (Cache) ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_free_cache ======================================================= */
+/* ========================================================================== */
+
+/* Free the cache and all Symbolic objects in it.  Copies returned by
+ * KLU_analyze_cached are not affected. */
+
+Int KLU_free_cache
+(
+    KLU_cache **CacheHandle,
+    KLU_common *Common
+)
+{
+    KLU_cache *Cache ;
+    KLU_cache_entry *Entries ;
+    Int k ;
+
+    if (Common == NULL)
+    {
+        return (FALSE) ;
+    }
+    if (CacheHandle == NULL || *CacheHandle == NULL)
+    {
+        return (TRUE) ;
+    }
+    Cache = *CacheHandle ;
+    Entries = (KLU_cache_entry *) Cache->Entries ;
+    for (k = 0 ; k < Cache->max_entries ; k++)
+    {
+        free_entry (&Entries [k], Common) ;
+    }
+    KLU_free (Entries, Cache->max_entries, sizeof (KLU_cache_entry), Common) ;
+    KLU_free (Cache, 1, sizeof (KLU_cache), Common) ;
+    *CacheHandle = NULL ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === analyze_cached ======================================================= */
+/* ========================================================================== */
+
+/* Look up the pattern in the cache, or analyze it and cache the result.
+ * method is EMPTY for KLU_analyze, or the orderingMethod of
+ * KLU_analyze_partial. */
+
+static KLU_symbolic *analyze_cached
+(
+    Int n,
+    Int Ap [ ],
+    Int Ai [ ],
+    Int Vc [ ],
+    Int Vr [ ],
+    Int nv,
+    Int method,
+    Int pin,
+    KLU_cache *Cache,
+    KLU_common *Common
+)
+{
+    KLU_symbolic *Symbolic ;
+    KLU_cache_entry *Entries, *E ;
+    size_t h ;
+    Int k, nz, victim ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    if (Common == NULL)
+    {
+        return (NULL) ;
+    }
+    Common->status = KLU_OK ;
+    if (Cache == NULL)
+    {
+        /* no cache: just analyze the matrix */
+        return ((method == EMPTY) ? KLU_analyze (n, Ap, Ai, Common) :
+            KLU_analyze_partial (n, Ap, Ai, Vc, Vr, nv, method, Common)) ;
+    }
+    if (n <= 0 || Ap == NULL || Ai == NULL || Ap [n] < 0 || nv < 0 ||
+        (nv > 0 && (Vc == NULL || Vr == NULL)))
+    {
+        Common->status = KLU_INVALID ;
+        return (NULL) ;
+    }
+    nz = Ap [n] ;
+    Entries = (KLU_cache_entry *) Cache->Entries ;
+    Cache->stamp++ ;
+
+    /* ---------------------------------------------------------------------- */
+    /* look for the pattern in the cache */
+    /* ---------------------------------------------------------------------- */
+
+    h = hash_key (n, Ap, Ai, Vc, Vr, nv, method, Common) ;
+    for (k = 0 ; k < Cache->max_entries ; k++)
+    {
+        E = &Entries [k] ;
+        if (E->Symbolic != NULL && E->hash == h && E->n == n && E->nz == nz
+            && E->nv == nv && E->method == method
+            && E->btf == Common->btf && E->ordering == Common->ordering
+            && E->btf_match == Common->btf_match
+            && E->maxwork == Common->maxwork
+            && (Common->ordering < 3 || Common->ordering > 4
+                || (E->user_order == Common->user_order
+                    && E->user_data == Common->user_data))
+            && (Common->ordering != 5 || (E->nd_min == Common->nd_min
+                && E->nd_domains == Common->nd_domains))
+            && same_ints (E->Ap, Ap, n+1) && same_ints (E->Ai, Ai, nz)
+            && same_ints (E->Vc, Vc, nv) && same_ints (E->Vr, Vr, nv))
+        {
+            /* cache hit */
+            Cache->hits++ ;
+            E->stamp = Cache->stamp ;
+            if (pin != 0)
+            {
+                E->pinned = (pin > 0) ;
+            }
+            Common->structural_rank = E->Symbolic->structural_rank ;
+            return (copy_symbolic (E->Symbolic, Common)) ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* cache miss: analyze the matrix */
+    /* ---------------------------------------------------------------------- */
+
+    Cache->misses++ ;
+    Symbolic = (method == EMPTY) ? KLU_analyze (n, Ap, Ai, Common) :
+        KLU_analyze_partial (n, Ap, Ai, Vc, Vr, nv, method, Common) ;
+    if (Symbolic == NULL)
+    {
+        return (NULL) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* find a free entry, or the least recently used unpinned one */
+    /* ---------------------------------------------------------------------- */
+
+    victim = EMPTY ;
+    for (k = 0 ; k < Cache->max_entries ; k++)
+    {
+        E = &Entries [k] ;
+        if (E->Symbolic == NULL)
+        {
+            victim = k ;
+            break ;
+        }
+        if (!E->pinned &&
+            (victim == EMPTY || E->stamp < Entries [victim].stamp))
+        {
+            victim = k ;
+        }
+    }
+    if (victim == EMPTY)
+    {
+        /* all entries are pinned: do not cache the result */
+        return (Symbolic) ;
+    }
+
+    E = &Entries [victim] ;
+    if (E->Symbolic != NULL)
+    {
+        free_entry (E, Common) ;
+        Cache->nentries-- ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* add the pattern and a copy of the Symbolic object to the cache */
+    /* ---------------------------------------------------------------------- */
+
+    E->Ap = KLU_malloc (n+1, sizeof (Int), Common) ;
+    E->Ai = KLU_malloc (nz, sizeof (Int), Common) ;
+    E->Vc = KLU_malloc (nv, sizeof (Int), Common) ;
+    E->Vr = KLU_malloc (nv, sizeof (Int), Common) ;
+    E->Symbolic = (Common->status < KLU_OK) ? NULL :
+        copy_symbolic (Symbolic, Common) ;
+    if (Common->status < KLU_OK)
+    {
+        /* out of memory: return the result, but do not cache it */
+        KLU_free (E->Ap, n+1, sizeof (Int), Common) ;
+        KLU_free (E->Ai, nz, sizeof (Int), Common) ;
+        KLU_free (E->Vc, nv, sizeof (Int), Common) ;
+        KLU_free (E->Vr, nv, sizeof (Int), Common) ;
+        E->Symbolic = NULL ;
+        Common->status = KLU_OK ;
+        return (Symbolic) ;
+    }
+
+    for (k = 0 ; k <= n ; k++)
+    {
+        E->Ap [k] = Ap [k] ;
+    }
+    for (k = 0 ; k < nz ; k++)
+    {
+        E->Ai [k] = Ai [k] ;
+    }
+    for (k = 0 ; k < nv ; k++)
+    {
+        E->Vc [k] = Vc [k] ;
+        E->Vr [k] = Vr [k] ;
+    }
+    E->hash = h ;
+    E->n = n ;
+    E->nz = nz ;
+    E->nv = nv ;
+    E->btf = Common->btf ;
+    E->btf_match = Common->btf_match ;
+    E->ordering = Common->ordering ;
+    E->method = method ;
+    E->maxwork = Common->maxwork ;
+    E->user_order = Common->user_order ;
+    E->user_data = Common->user_data ;
+    E->nd_min = Common->nd_min ;
+    E->nd_domains = Common->nd_domains ;
+    E->pinned = (pin > 0) ;
+    E->stamp = Cache->stamp ;
+    Cache->nentries++ ;
+    return (Symbolic) ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_analyze_cached =================================================== */
+/* ========================================================================== */
+
+/* Same as KLU_analyze, but uses the cache.  pin > 0 pins the cache entry of
+ * this pattern (it is never replaced), pin < 0 unpins it, and pin == 0 leaves
+ * it as is.  If Cache is NULL, this is the same as KLU_analyze. */
+
+KLU_symbolic *KLU_analyze_cached    /* returns NULL if error, or a valid
+                                       KLU_symbolic object if successful */
+(
+    /* inputs, not modified */
+    Int n,              /* A is n-by-n */
+    Int Ap [ ],         /* size n+1, column pointers */
+    Int Ai [ ],         /* size nz, row indices */
+    Int pin,            /* > 0: pin the entry, < 0: unpin it */
+    /* input/output */
+    KLU_cache *Cache,
+    /* -------------------- */
+    KLU_common *Common
+)
+{
+    return (analyze_cached (n, Ap, Ai, NULL, NULL, 0, EMPTY, pin, Cache,
+        Common)) ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_analyze_partial_cached =========================================== */
+/* ========================================================================== */
+
+/* Same as KLU_analyze_partial, but uses the cache.  The varying entries are
+ * part of the key, in the order given. */
+
+KLU_symbolic *KLU_analyze_partial_cached    /* returns NULL if error, or a
+                                               valid KLU_symbolic object */
+(
+    /* inputs, not modified */
+    Int n,              /* A is n-by-n */
+    Int Ap [ ],         /* size n+1, column pointers */
+    Int Ai [ ],         /* size nz, row indices */
+    Int varyingColumns [ ],
+    Int varyingRows [ ],
+    Int n_varyingEntries,
+    Int orderingMethod,
+    Int pin,            /* > 0: pin the entry, < 0: unpin it */
+    /* input/output */
+    KLU_cache *Cache,
+    /* -------------------- */
+    KLU_common *Common
+)
+{
+    if (orderingMethod < 0)
+    {
+        /* EMPTY is reserved for KLU_analyze_cached */
+        if (Common != NULL) Common->status = KLU_INVALID ;
+        return (NULL) ;
+    }
+    return (analyze_cached (n, Ap, Ai, varyingColumns, varyingRows,
+        n_varyingEntries, orderingMethod, pin, Cache, Common)) ;
+}
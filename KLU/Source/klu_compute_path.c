@@ -6,591 +6,424 @@
  * Computes the factorization path given change vector
  * Any new refactorisation can be computed by iterating over entries in factorization path
  * instead of all columns (see klu_partial.c)
+ *
+ * Both KLU_compute_path and KLU_determine_start read the pattern of U
+ * directly from Numeric->LUbx, and use Numeric->Iwork as their only scratch
+ * space.  The path arrays of the Numeric object have fixed sizes (see
+ * alloc_path), so they are allocated by the first call and reused by all
+ * later ones.  After that, partial refactorization and solves make no calls
+ * to malloc or free.
  */
 #include "klu_internal.h"
 
-Int KLU_compute_path(
-                    KLU_symbolic *Symbolic,
-                    KLU_numeric *Numeric,
-                    KLU_common *Common,
-                    Int Ap [ ],
-                    Int Ai [ ],
-                    Int *variable_columns,
-                    Int *variable_rows,
-                    Int n_variable_entries
-                    )
-{
+/* ========================================================================== */
+/* === alloc_path =========================================================== */
+/* ========================================================================== */
 
-    /*
-     * Computes Factorization Path.
-     * Factorization-Path mode partial refactorization works as follows:
-     * five arrays for two cases are needed.
-     * for a variable entry, compute the permutation, i.e. A to LU
-     *                  - case 1: entry is in off-diagonal block F
-     *                          - KLU handles these blocks annoyingly
-     *                          - two new arrays are used for partial refactorization:
-     *                              - variable_offdiag_orig_entry[i]: refers to the i-th entry in Ax that is varying
-     *                              - variable_offdiag_perm_entry[i]: refers to the corresponding position of i in F
-     *                          - these entries are excluded from factorization path computation
-     *                          - in partial refactorization, these values are simply "copied" to the correct location
-     *                              - this can then be done very efficiently, i.e. with parallelization or SIMD (maybe)
-     *                  - case 2: entry is in a diagonal block
-     *                          - three arrays are used:
-     *                              - variable_block: has length n_variable_blocks, contains indices of variable blocks
-     *                                  - e.g. variable_block = {0, 3} means that blocks 0 and 3 contain variable entries
-     *                              - block_path: has length nblocks (number of blocks), indicates position of varying columns for a block in the factorization path
-     *                                  - a bit more complicated
-     *                                  - e.g. block_path = {0, 0, 3, 3} means that block 1's variable columns are from index 0 to 2 in factorization path (variable_block = {1})
-     *                              - path: factorization path
-     *                                  - self-explanatory
-     *                                  - e.g. path = {3, 4}
-     *                           - in total:
-     *                                  - variable_block = {1}
-     *                                  - block_path = {0, 0, 3, 3}
-     *                                  - path = {3, 4, 5}
-     *                                  - means that block 1 contains varying entries. These are from index 0 to 2 in factorization path, which evaluates to columns 3, 4 and 5
-     */
+/* Allocates the path arrays of the Numeric object, if not yet allocated:
+ *
+ *      path                            size n
+ *      block_path                      size nblocks+1
+ *      variable_block                  size nblocks
+ *      variable_offdiag_orig_entry     size nzoff+1
+ *      variable_offdiag_perm_entry     size nzoff+1
+ *
+ * They are freed by KLU_free_numeric. */
+
+static Int alloc_path
+(
+    KLU_numeric *Numeric,
+    KLU_common *Common
+)
+{
+    Int n, nblocks, nzoff ;
+
+    if (Numeric->path != NULL)
+    {
+        /* already allocated by an earlier call */
+        return (TRUE) ;
+    }
+
+    n = Numeric->n ;
+    nblocks = Numeric->nblocks ;
+    nzoff = Numeric->nzoff ;
+
+    Numeric->path = KLU_malloc (n, sizeof (Int), Common) ;
+    Numeric->block_path = KLU_malloc (nblocks+1, sizeof (Int), Common) ;
+    Numeric->variable_block = KLU_malloc (nblocks, sizeof (Int), Common) ;
+    Numeric->variable_offdiag_orig_entry =
+        KLU_malloc (nzoff+1, sizeof (Int), Common) ;
+    Numeric->variable_offdiag_perm_entry =
+        KLU_malloc (nzoff+1, sizeof (Int), Common) ;
+
+    if (Common->status < KLU_OK)
+    {
+        /* out of memory */
+        Numeric->path = KLU_free (Numeric->path, n, sizeof (Int), Common) ;
+        Numeric->block_path = KLU_free (Numeric->block_path, nblocks+1,
+            sizeof (Int), Common) ;
+        Numeric->variable_block = KLU_free (Numeric->variable_block, nblocks,
+            sizeof (Int), Common) ;
+        Numeric->variable_offdiag_orig_entry =
+            KLU_free (Numeric->variable_offdiag_orig_entry, nzoff+1,
+            sizeof (Int), Common) ;
+        Numeric->variable_offdiag_perm_entry =
+            KLU_free (Numeric->variable_offdiag_perm_entry, nzoff+1,
+            sizeof (Int), Common) ;
+        Common->status = KLU_OUT_OF_MEMORY ;
+        return (FALSE) ;
+    }
+    return (TRUE) ;
+}
 
-    if(variable_columns == NULL)
-    {
-        return FALSE;
-    }
-    if(variable_rows == NULL)
-    {
-        return FALSE;
-    }
-    if(n_variable_entries <= 0)
-    {
-        return TRUE;
-    }
 
-    /* This function is very long, because cases with and without BTF are implemented */
-    /* Declarations */
-    /* LU data */
-
-    int n = Symbolic->n;
-    int lnz = Numeric->lnz;
-    int unz = Numeric->unz;
-    int nzoff = Numeric->nzoff;
-    int nb = Symbolic->nblocks;
-    Int *Pinv = Numeric->Pinv;
-    Int *Lp, *Li, *Up, *Ui, *Fi, *Fp;
-    double *Lx, *Ux, *Fx;
-    Int *P, *Q, *R;
-    double *Rs;
-    int RET;
-    int oldcol, pend, p, newrow;
-    int poff = 0, ctr = 0, variable_offdiag_length = 0;
-
-    Int n_variable_entries_new = n_variable_entries, n_variable_columns = 0;
-
-    /* arrays for the offdiagonal entries. are empty if BTF is not used */
-    Int* variable_offdiag_orig_entry = (Int*)calloc(nzoff, sizeof(Int));
-    Int* variable_offdiag_perm_entry = (Int*)calloc(nzoff, sizeof(Int));
-    int* workpath = (int*)calloc(n, sizeof(int));
-    Int* path = (Int*)calloc(n, sizeof(Int)); 
-    Int* nvblocks = (Int*)calloc(nb, sizeof(Int));
-
-    /* indices and temporary variables */
-    int i, k, j, block;
-    int pivot;
-    int col = 0, nextcol;
-    int flag = 1;
-
-    /* blocks */
-    Int k2 = n, k1 = 0, nk = 1;
-
-    Int *Qi = (Int*)calloc(n, sizeof(Int));
-    if(Qi == NULL)
-    {
-        return KLU_OUT_OF_MEMORY;
-    }
+/* ========================================================================== */
+/* === find_block =========================================================== */
+/* ========================================================================== */
 
-    /* variable columns and rows in A are given. We need to know those in LU */
-    Int *variable_columns_in_LU = (Int*)calloc(n_variable_entries, sizeof(Int));
-    if(variable_columns_in_LU == NULL)
-    {
-        return KLU_OUT_OF_MEMORY;
-    }
+/* Returns the block containing column k, by binary search in R. */
 
-    Int *variable_rows_in_LU = (Int*)calloc(n_variable_entries, sizeof(Int));
-    if(variable_rows_in_LU == NULL)
+static Int find_block
+(
+    Int k,
+    Int R [ ],
+    Int nblocks
+)
+{
+    Int lo = 0, hi = nblocks - 1, mid ;
+    while (lo < hi)
     {
-        return KLU_OUT_OF_MEMORY;
+        mid = (lo + hi + 1) / 2 ;
+        if (R [mid] <= k)
+        {
+            lo = mid ;
+        }
+        else
+        {
+            hi = mid - 1 ;
+        }
     }
+    return (lo) ;
+}
 
-    /* if computation of fact. path (i.e. this function) was done before -> free memory */
-    if (Numeric->path)
-    {
-        KLU_free(Numeric->path, n, sizeof(int), Common);
-    }
-    if (Numeric->block_path)
-    {
-        KLU_free(Numeric->block_path, Numeric->nblocks, sizeof(int), Common);
-    }
-    if (Numeric->variable_block)
-    {
-        KLU_free(Numeric->variable_block, Numeric->n_variable_blocks, sizeof(int), Common);
-    }
-    if (Numeric->variable_offdiag_orig_entry)
-    {
-        KLU_free(Numeric->variable_offdiag_orig_entry, Numeric->variable_offdiag_length, sizeof(int), Common);
-    }
-    if (Numeric->variable_offdiag_perm_entry)
-    {
-        KLU_free(Numeric->variable_offdiag_perm_entry, Numeric->variable_offdiag_length, sizeof(int), Common);
-    }
 
-    /* block path can be allocated now since its size is known */
-    Numeric->block_path = KLU_malloc(nb+1, sizeof(int), Common);
+/* ========================================================================== */
+/* === mark_varying ========================================================= */
+/* ========================================================================== */
 
-    for (i = 0; i < nb; i++)
-    {
-        Numeric->block_path[i] = 0;
-    }
+/* Applies the permutation to the varying entries, and sorts them into the two
+ * cases described in KLU_compute_path.  Varying entries in off-diagonal blocks
+ * are stored in Numeric->variable_offdiag_orig_entry and _perm_entry.  For
+ * all others, Mark [k] is set for their column k in the permuted matrix, and
+ * Vblock [block] for their block.
+ *
+ * klu_factor copies column Q [k] of A into Offx [Offp [k] ...] in the order
+ * of Ap and Ai, so the position of an off-diagonal entry is found by
+ * scanning that one column.  Duplicate varying entries are recorded once:
+ * Offi [poff] is flipped while the list is being built.
+ *
+ * Returns FALSE if the varying entries are out of range. */
+
+static Int mark_varying
+(
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    Int Ap [ ],
+    Int Ai [ ],
+    Int *variable_columns,
+    Int *variable_rows,
+    Int n_variable_entries,
+
+    /* workspace */
+    Int Qinv [ ],       /* size n, inverse of Q on output */
+    Int Mark [ ],       /* size n, cleared on input */
+    Int Vblock [ ]      /* size nblocks, cleared on input */
+)
+{
+    Int *Q, *R, *Pinv, *Offp, *Offi, *Orig, *Perm ;
+    Int n, nblocks, i, k, p, pend, oldcol, oldrow, block, k1, poff, noff ;
 
-    Lp = (Int*) calloc(n + 1, sizeof(Int));
-    Up = (Int*) calloc(n + 1, sizeof(Int));
-    Fp = (Int*) calloc(n + 1, sizeof(Int));
-    Lx = (double*) calloc(lnz, sizeof(double));
-    Ux = (double*) calloc(unz, sizeof(double));
-    Fx = (double*) calloc(nzoff, sizeof(double));
-    Li = (Int*) calloc(lnz, sizeof(Int));
-    Ui = (Int*) calloc(unz, sizeof(Int));
-    Fi = (Int*) calloc(nzoff, sizeof(Int));
-    P = (Int*) calloc(n, sizeof(Int));
-    Q = (Int*) calloc(n, sizeof(Int));
-    Rs = (double*) calloc(n, sizeof(double));
-    R = (Int*) calloc(nb + 1, sizeof(Int));
-
-    /* ---------------------------------------------------------------- */
-    /* first, get LU decomposition */
-    /* sloppy implementation, there might be a smarter way to do this */
-    /* ---------------------------------------------------------------- */
-    RET = KLU_extract(Numeric, Symbolic, Lp, Li, Lx, Up, Ui, Ux, Fp, Fi, Fx, P, Q, Rs, R, Common);
-
-    /* check if extraction of LU matrix broke */
-    if (RET != (TRUE))
-    {
-        return (FALSE);
-    }
+    n = Symbolic->n ;
+    nblocks = Symbolic->nblocks ;
+    Q = Symbolic->Q ;
+    R = Symbolic->R ;
+    Pinv = Numeric->Pinv ;
+    Offp = Numeric->Offp ;
+    Offi = Numeric->Offi ;
+    Orig = Numeric->variable_offdiag_orig_entry ;
+    Perm = Numeric->variable_offdiag_perm_entry ;
 
-    /* ---------------------------------------------------------------- */
-    /* second, invert permutation vector */
-    /* Q gives "oldcol", we need "newcol" */
-    /* ---------------------------------------------------------------- */
-    for (i = 0; i < n; i++)
+    for (k = 0 ; k < n ; k++)
     {
-        Qi[Q[i]] = i;
+        Qinv [Q [k]] = k ;
     }
 
-    /* ---------------------------------------------------------------- */
-    /* third, apply permutation on variable_columns and rows */
-    /* ---------------------------------------------------------------- */
-
-    for (i = 0; i < n_variable_entries; i++)
+    noff = 0 ;
+    for (i = 0 ; i < n_variable_entries ; i++)
     {
-        variable_columns_in_LU[i] = Qi[variable_columns[i]];
-        variable_rows_in_LU[i] = Pinv[variable_rows[i]];
-    }
+        oldcol = variable_columns [i] ;
+        oldrow = variable_rows [i] ;
+        if (oldcol < 0 || oldcol >= n || oldrow < 0 || oldrow >= n)
+        {
+            break ;
+        }
+        k = Qinv [oldcol] ;
+        block = find_block (k, R, nblocks) ;
+        k1 = R [block] ;
 
-    /* ---------------------------------------------------------------- */
-    /* fourth, determine variable off-diagonal entries */
-    /* only necessary if BTF used */
-    /* if BTF is not used, no off-diagonal blocks are available */
-    /* ---------------------------------------------------------------- */
+        if (Pinv [oldrow] >= k1)
+        {
+            /* entry in a diagonal block */
+            Mark [k] = TRUE ;
+            Vblock [block] = TRUE ;
+            continue ;
+        }
 
-    /* maybe write this function externally, because it's needed again by pr-rr */
-    if(Common->btf == TRUE)
-    {
-        /* iterate over all blocks */
-        for(block = 0 ; block < nb ; block++)
+        /* entry in an off-diagonal block */
+        poff = Offp [k] ;
+        pend = Ap [oldcol+1] ;
+        for (p = Ap [oldcol] ; p < pend ; p++)
         {
-            k1 = R [block];
-            k2 = R [block+1];
-            nk = k2 - k1;
-            for (k = 0 ; k < nk ; k++)
+            if (Pinv [Ai [p]] >= k1)
             {
-                oldcol = Q [k+k1] ;
-                pend = Ap [oldcol+1] ;
-                for (p = Ap [oldcol] ; p < pend ; p++)
+                continue ;
+            }
+            if (Ai [p] == oldrow)
+            {
+                if (!BTF_ISFLIPPED (Offi [poff]))
                 {
-                    newrow = Pinv [Ai [p]] - k1 ;
-                    if (newrow < 0 && poff < nzoff)
-                    {
-                        /* entry in off-diagonal block */
-
-                        /* check if entry is in variable column */
-                        /* TODO */
-                        for(i = 0 ; i < n_variable_entries ; i++)
-                        {
-                            if(variable_columns_in_LU[i] == k+k1 && variable_rows_in_LU[i] == Pinv [Ai [p]])
-                            {
-                                /* set to -1, because they're off-diagonal now */
-                                /* indicates that they are "removed" from variable columns and row "list" */
-                                /* subsequently, add to variable off-diag entries and reduce length of variable entries */
-                                variable_columns_in_LU[i] = -1;
-                                variable_rows_in_LU[i] = -1;
-
-                                variable_offdiag_orig_entry[variable_offdiag_length] = p;
-                                variable_offdiag_perm_entry[variable_offdiag_length++] = poff;
-
-                                n_variable_entries_new--;
-                                break;
-                            }
-                        }
-                        poff++ ;
-                    }
+                    Offi [poff] = BTF_FLIP (Offi [poff]) ;
+                    Orig [noff] = p ;
+                    Perm [noff] = poff ;
+                    noff++ ;
                 }
+                break ;
             }
+            poff++ ;
         }
     }
 
-    /* safety first */
-    ASSERT(variable_offdiag_length == n_variable_entries - n_variable_entries_new);
-
-    Numeric->variable_offdiag_orig_entry = KLU_malloc(variable_offdiag_length, sizeof(Int), Common);
-    Numeric->variable_offdiag_perm_entry = KLU_malloc(variable_offdiag_length, sizeof(Int), Common);
-    Numeric->variable_offdiag_length = variable_offdiag_length;
-
-    for(i = 0; i < variable_offdiag_length ; i++)
+    /* restore Offi */
+    for (p = 0 ; p < noff ; p++)
     {
-        Numeric->variable_offdiag_orig_entry[i] = variable_offdiag_orig_entry[i];
-        Numeric->variable_offdiag_perm_entry[i] = variable_offdiag_perm_entry[i];
+        Offi [Perm [p]] = BTF_UNFLIP (Offi [Perm [p]]) ;
     }
+    Numeric->variable_offdiag_length = noff ;
 
-    if(n_variable_entries_new == 0)
-    {
-        /* very good case, no varying columns in LU blocks */
-        /* free memory and return */
-        Numeric->pathLen = 0;
-        Numeric->n_variable_blocks = 0;
-        Numeric->path = KLU_malloc(0, sizeof(int), Common);
-        Numeric->variable_block = KLU_malloc(Numeric->n_variable_blocks, sizeof(int), Common);
-        goto EXIT;
-    }
+    return (i == n_variable_entries) ;
+}
 
-    int* cV = (int*) calloc(n, sizeof(int));
-    if(cV == NULL)
-    {
-        return KLU_OUT_OF_MEMORY;
-    }
 
-    for(i = 0; i < n_variable_entries ; i++)
-    {
-        if(variable_columns_in_LU[i] != -1)
-        {
-            cV[variable_columns_in_LU[i]] = 1;
-        }
-    }
-    for( i = 0; i < n_variable_entries ; i++)
+/* ========================================================================== */
+/* === get_path_workspace =================================================== */
+/* ========================================================================== */
+
+/* Checks the inputs of KLU_compute_path and KLU_determine_start, allocates
+ * the path arrays, and returns the scratch space Qinv, Mark and Vblock in
+ * Numeric->Iwork.  Iwork is at least 3*n*sizeof (Entry) bytes (see
+ * KLU_factor), which holds 3*n integers. */
+
+static Int get_path_workspace
+(
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    KLU_common *Common,
+    Int Ap [ ],
+    Int Ai [ ],
+    Int *variable_columns,
+    Int *variable_rows,
+    Int n_variable_entries,
+    Int **Qinv,
+    Int **Mark,
+    Int **Vblock
+)
+{
+    Int k, n, nblocks ;
+
+    if (Common == NULL)
     {
-        variable_columns_in_LU[i] = 0;
+        return (FALSE) ;
     }
+    Common->status = KLU_OK ;
 
-
-    for ( i = 0 ; i < n ; i++)
+    if (Symbolic == NULL || Numeric == NULL || Ap == NULL || Ai == NULL
+        || (n_variable_entries > 0
+            && (variable_columns == NULL || variable_rows == NULL)))
     {
-        if(cV[i] == 1)
-        {
-            n_variable_columns++;
-        }
+        Common->status = KLU_INVALID ;
+        return (FALSE) ;
     }
 
-    variable_columns_in_LU  = (Int*)realloc(variable_columns_in_LU, sizeof(Int)*n_variable_columns);
-    if(variable_columns_in_LU == NULL)
+    if (!alloc_path (Numeric, Common))
     {
-        return KLU_OUT_OF_MEMORY;
+        return (FALSE) ;
     }
-    for ( i = 0; i< n_variable_columns ; i++)
+
+    n = Symbolic->n ;
+    nblocks = Symbolic->nblocks ;
+    ASSERT (Numeric->worksize >= n * sizeof (Entry) + 3 * n * sizeof (Int)) ;
+    *Qinv = Numeric->Iwork ;
+    *Mark = Numeric->Iwork + n ;
+    *Vblock = Numeric->Iwork + 2*n ;
+    for (k = 0 ; k < n ; k++)
     {
-        variable_columns_in_LU[i] = 0;
+        (*Mark) [k] = FALSE ;
     }
-    for ( i = 0 ; i < n ; i++)
+    for (k = 0 ; k < nblocks ; k++)
     {
-        if(cV[i] != 0)
-        {
-            variable_columns_in_LU[ctr++] = i;
-        }
+        (*Vblock) [k] = FALSE ;
     }
-    free(cV);
 
-    ASSERT(ctr == variable_entries_new);
+    Numeric->pathLen = 0 ;
+    Numeric->n_variable_blocks = 0 ;
+    Numeric->variable_offdiag_length = 0 ;
 
-    /* ---------------------------------------------------------------- */
-    /* fifth, compute factorization path of blocks */
-    /* ---------------------------------------------------------------- */
-
-    if (Common->btf == FALSE)
+    if (!mark_varying (Symbolic, Numeric, Ap, Ai, variable_columns,
+        variable_rows, n_variable_entries, *Qinv, *Mark, *Vblock))
     {
-        Numeric->variable_block = KLU_malloc(1, sizeof(int), Common);
-        Numeric->block_path[0] = 0;
-        Numeric->variable_block[0] = 0;
-        Numeric->n_variable_blocks = 1;
-        /* no blocks */
-        for (i = 0; i < n_variable_columns; i++)
-        {
-            flag = 1;
-            pivot = variable_columns_in_LU[i];
-            if (path[pivot] == 1)
-            {
-                /* already computed pivot? */
-                continue;
-            }
-            path[pivot] = 1;
+        Common->status = KLU_INVALID ;
+        return (FALSE) ;
+    }
+    return (TRUE) ;
+}
 
-            /* GP-based version */
-            while (pivot < n && flag)
-            {
-                flag = 0;
-                nextcol = Up[pivot + 1];
 
-                /* scan Ui for values in row "pivot" */
-                for (j = nextcol; j < unz; j++)
-                {
-                    if (Ui[j] == pivot)
-                    {
-                        /* column j is affected
-                            * find column in which j is
-                        */
-                        for (k = 0; k < n; k++)
-                        {
-                            if (j >= Up[k] && j < Up[k + 1])
-                            {
-                                col = k;
-                                break;
-                            }
-                        }
-                        /* col is always well-defined */
-                        path[col] = 1;
-                        workpath[col] = 1;
-                    }
-                }
-                for (j = pivot + 1; j < n; j++)
-                {
-                    if (workpath[j] == 1)
-                    {
-                        workpath[j] = 0;
-                        pivot = j;
-                        flag = 1;
-                        break;
-                    }
-                }
-            }
-        }
-        ctr = 0;
-        for( i = 0 ; i < n ; i++)
-        {
-            if(path[i] == 1)
-            {
-                ctr++;
-            }
-        }
-        Numeric->pathLen = ctr;
-        Numeric->path = KLU_malloc(ctr, sizeof(int), Common);
-        for(i = 0; i < ctr ; i++)
-        {
-            Numeric->path[i] = 0;
-        }
-        Numeric->block_path[1] = ctr;
-        ctr = 0;
-        for(i = 0; i < n ; i++)
-        {
-            if(path[i] == 1)
-            {
-                Numeric->path[ctr++] = i;
-            }
-        }
-    }
-    else
-    {
-        Numeric->n_variable_blocks = 0;
-        for (i = 0; i < n_variable_columns; i++)
-        {
-            flag = 1;
-            /* get next changing column */
-            pivot = variable_columns_in_LU[i];
+/* ========================================================================== */
+/* === KLU_compute_path ===================================================== */
+/* ========================================================================== */
 
-            /* check if it was already computed */
-            if (path[pivot] == 1)
-            {
-                /* already computed pivot
-                 * do nothing, go to next pivot
-                 */
-                continue;
-            }
+Int KLU_compute_path(
+                    KLU_symbolic *Symbolic,
+                    KLU_numeric *Numeric,
+                    KLU_common *Common,
+                    Int Ap [ ],
+                    Int Ai [ ],
+                    Int *variable_columns,
+                    Int *variable_rows,
+                    Int n_variable_entries
+                    )
+{
 
-            /* set first value of singleton path */
-            path[pivot] = 1;
+    /*
+     * Computes Factorization Path.
+     * Factorization-Path mode partial refactorization works as follows:
+     * five arrays for two cases are needed.
+     * for a variable entry, compute the permutation, i.e. A to LU
+     *                  - case 1: entry is in off-diagonal block F
+     *                          - KLU handles these blocks annoyingly
+     *                          - two new arrays are used for partial refactorization:
+     *                              - variable_offdiag_orig_entry[i]: refers to the i-th entry in Ax that is varying
+     *                              - variable_offdiag_perm_entry[i]: refers to the corresponding position of i in F
+     *                          - these entries are excluded from factorization path computation
+     *                          - in partial refactorization, these values are simply "copied" to the correct location
+     *                              - this can then be done very efficiently, i.e. with parallelization or SIMD (maybe)
+     *                  - case 2: entry is in a diagonal block
+     *                          - three arrays are used:
+     *                              - variable_block: has length n_variable_blocks, contains indices of variable blocks
+     *                                  - e.g. variable_block = {0, 3} means that blocks 0 and 3 contain variable entries
+     *                              - block_path: has length nblocks+1, the columns of block k in the
+     *                                factorization path are path [block_path [k] ... block_path [k+1]-1]
+     *                                  - e.g. block_path = {0, 0, 3, 3} means that block 1's variable columns are from index 0 to 2 in factorization path (variable_block = {1})
+     *                              - path: factorization path
+     *                                  - self-explanatory
+     *                                  - e.g. path = {3, 4}
+     *                           - in total:
+     *                                  - variable_block = {1}
+     *                                  - block_path = {0, 0, 3, 3}
+     *                                  - path = {3, 4, 5}
+     *                                  - means that block 1 contains varying entries. These are from index 0 to 2 in factorization path, which evaluates to columns 3, 4 and 5
+     *
+     * Column j of a block is in the path if it has a varying entry, or if
+     * U (i,j) is nonzero for some column i < j in the path.  A single sweep
+     * over the columns of U of each varying block finds all of them.
+     */
 
-            /* find block of pivot */
-            for (k = 0; k < nb; k++)
-            {
-                k1 = R[k];
-                k2 = R[k + 1];
-                if (k1 <= pivot && pivot < k2)
-                {
-                    nk = k2 - k1;
+    Unit *LU ;
+    Int *Qinv, *Mark, *Vblock, *R, *Ui, *Uip, *Ulen, *path, *block_path ;
+    Int nb, block, k1, k2, nk, k, p, len, ctr, nvblocks ;
 
-                    /* set varying block */
+    if (!get_path_workspace (Symbolic, Numeric, Common, Ap, Ai,
+        variable_columns, variable_rows, n_variable_entries,
+        &Qinv, &Mark, &Vblock))
+    {
+        return (FALSE) ;
+    }
 
-                    if(nvblocks[k] != 1)
-                    {
-                        nvblocks[k] = 1;
-                        Numeric->n_variable_blocks += 1;
-                    }
-                    break;
-                }
-            }
+    nb = Symbolic->nblocks ;
+    R = Symbolic->R ;
+    path = Numeric->path ;
+    block_path = Numeric->block_path ;
 
-            if (nk == 1)
-            {
-                /* 1x1-block, its pivot already in path */
-                continue;
-            }
+    ctr = 0 ;
+    nvblocks = 0 ;
+    for (block = 0 ; block < nb ; block++)
+    {
+        k1 = R [block] ;
+        k2 = R [block+1] ;
+        nk = k2 - k1 ;
+        block_path [block] = ctr ;
+        if (!Vblock [block])
+        {
+            continue ;
+        }
+        Numeric->variable_block [nvblocks++] = block ;
 
-            /* propagate until end
-             * in blocks, pivot < n_block[k]
-             *
-             * k2 is the first column of the NEXT block
-             *
-             * if pivot == k2 - 1, it is the last column of the
-             * current block. then, "nextcol" would be k2, which is already
-             * in the next block. Thus, only do loop if pivot < k2 - 1
-             */
-            while (pivot < k2 - 1 && flag == 1)
+        if (nk > 1)
+        {
+            /* propagate along the columns of U, starting at the first
+             * varying column of the block */
+            LU = (Unit *) Numeric->LUbx [block] ;
+            Uip = Numeric->Uip + k1 ;
+            Ulen = Numeric->Ulen + k1 ;
+            for (k = 0 ; k < nk && !Mark [k1+k] ; k++) ;
+            for (k++ ; k < nk ; k++)
             {
-                flag = 0;
-                nextcol = Up[pivot + 1];
-                /* find closest off-diagonal entries in U */
-                /* u saved in csc:
-                   Ux = [x, x, x, x, x] entries saved column-wise
-                   Ui = [0, 2, 1, 4, 3] row position of those entries in columns
-                   Up = [0, 1, 2, 3, 4, 5] column pointers
-                   to find closest off-diagonal of row k:
-                   find all Ui[j] == pivot
-                   find Up[k] <= j < Up[k+1], k > pivot
-                   ALTERNATIVELY
-                   Transpose U
-                 */
-
-                /* This loop finds all nnz in row "pivot",
-                 * meaning their respective columns depend on pivot column
-                 */
-                for (j = nextcol; j < unz; j++)
+                if (Mark [k1+k])
                 {
-                    if (Ui[j] == pivot)
-                    {
-                        /* find column in which j is */
-                        for (k = k1; k < k2; k++)
-                        {
-                            if (j >= Up[k] && j < Up[k + 1])
-                            {
-                                col = k;
-                                path[col] = 1;
-                                workpath[col] = 1;
-                                break;
-                            }
-                        }
-                    }
+                    continue ;
                 }
-                for (j = pivot + 1; j < k2; j++)
+                GET_I_POINTER (LU, Uip, Ui, k) ;
+                len = Ulen [k] ;
+                for (p = 0 ; p < len ; p++)
                 {
-                    if (workpath[j] == 1)
+                    if (Mark [k1 + Ui [p]])
                     {
-                        workpath[j] = 0;
-                        pivot = j;
-                        flag = 1;
-                        break;
+                        Mark [k1+k] = TRUE ;
+                        break ;
                     }
                 }
             }
         }
 
-        /* count how many variable columns there are */
-        ctr = 0;
-        for( i = 0 ; i < n ; i++)
+        for (k = k1 ; k < k2 ; k++)
         {
-            if(path[i] == 1)
+            if (Mark [k])
             {
-                ctr++;
+                path [ctr++] = k ;
             }
         }
-        Numeric->pathLen = ctr;
-        /* allocate and initialize memory */
-        Numeric->path = KLU_malloc(ctr, sizeof(int), Common);
-        Numeric->variable_block = KLU_malloc(Numeric->n_variable_blocks, sizeof(int), Common);
-        for(i = 0; i < ctr ; i++)
-        {
-            Numeric->path[i] = 0;
-        }
-
-        /* set variable blocks */
-        ctr = 0;
-        for(i = 0 ; i < nb ; i++)
-        {
-            if(nvblocks[i] == 1)
-            {
-                Numeric->variable_block[ctr++] = i;
-            }
-        }
-
-        ASSERT(ctr == Numeric->n_variable_blocks);
+    }
+    block_path [nb] = ctr ;
 
-        /* assemble factorization path */
-        ctr = 0;
-        for(i = 0; i < n ; i++)
-        {
-            if(path[i] == 1)
-            {
-                Numeric->path[ctr++] = i;
-            }
-        }
-        block = 0;
+    Numeric->pathLen = ctr ;
+    Numeric->n_variable_blocks = nvblocks ;
 
-        /* determine from where to where in each block there are variable columns */
-        k = 0;
-        for(i = 0 ; i < Numeric->n_variable_blocks ; i++)
-        {
-            k1 = R[Numeric->variable_block[i]];
-            k2 = R[Numeric->variable_block[i]+1];
-            Numeric->block_path[Numeric->variable_block[i]] = k;
-            while(k < ctr && Numeric->path[k] < k2 - 1)
-            {
-                k++;
-            }
-            k++;
-            Numeric->block_path[Numeric->variable_block[i]+1] = k;
-        }
+    if (Numeric->Rowp != NULL)
+    {
+        /* Qinv, Mark and Vblock are no longer needed */
+        KLU_offdiag_rows_pattern (Symbolic, Numeric) ;
     }
-EXIT:
-    free(Lp);
-    free(Li);
-    free(Lx);
-    free(Up);
-    free(Ui);
-    free(Ux);
-    free(Fi);
-    free(Fp);
-    free(Fx);
-    free(P);
-    free(Q);
-    free(Qi);
-    free(R);
-    free(Rs);
-    free(variable_columns_in_LU);
-    free(variable_rows_in_LU);
-    free(variable_offdiag_orig_entry);
-    free(variable_offdiag_perm_entry);
-    free(workpath);
-    free(path);
-    free(nvblocks);
-    return (TRUE);
+    return (TRUE) ;
 }
 
 /*
  * This function determines the first varying column for
  * partial refactorization by refactorization restart (PR-RR)
+ *
+ * On output, block_path [k] is the first varying column of block k (n if
+ * block k has none), and variable_block holds the blocks with varying
+ * entries in the diagonal blocks.  The off-diagonal entries are found as
+ * in KLU_compute_path.
  */
 Int KLU_determine_start(
         KLU_symbolic *Symbolic,
@@ -603,327 +436,190 @@ Int KLU_determine_start(
         Int n_variable_entries
     )
 {
-    int n = Symbolic->n;
-    int lnz = Numeric->lnz;
-    int unz = Numeric->unz;
-    int nzoff = Numeric->nzoff;
-    int nb = Symbolic->nblocks;
-    Int *Pinv = Numeric->Pinv;
-    Int *Lp, *Li, *Up, *Ui, *Fi, *Fp;
-    double *Lx, *Ux, *Fx;
-    Int *P, *Q, *R;
-    double *Rs;
-    int RET;
-
-    int *variable_offdiag_orig_entry = (int*)calloc(nzoff, sizeof(int));
-    int *variable_offdiag_perm_entry = (int*)calloc(nzoff, sizeof(int));
-    int *nvblocks = (int*)calloc(nb, sizeof(int));
-
-    Numeric->pathLen = 0;
-
-    /* indices and temporary variables */
-    int i, k, p, block;
-    int pivot;
-    int oldcol, pend, newrow, poff = 0, variable_offdiag_length = 0;
-    int n_variable_entries_new = n_variable_entries;
-
-    /* blocks */
-    Int k2, k1, nk;
-
-    Int *Qi = (Int*)calloc(n, sizeof(Int));
-    if(Qi == NULL)
-    {
-        return KLU_OUT_OF_MEMORY;
-    }
-
-    Int *variable_columns_in_LU = (Int*)calloc(n_variable_entries, sizeof(Int));
-    if(variable_columns_in_LU == NULL)
-    {
-        free(Qi);
-        return KLU_OUT_OF_MEMORY;
-    }
+    Int *Qinv, *Mark, *Vblock, *R, *block_path ;
+    Int n, nb, block, k1, k2, k, nvblocks ;
 
-    Int *variable_rows_in_LU = (Int*)calloc(n_variable_entries, sizeof(Int));
-    if(variable_rows_in_LU == NULL)
+    if (!get_path_workspace (Symbolic, Numeric, Common, Ap, Ai,
+        variable_columns, variable_rows, n_variable_entries,
+        &Qinv, &Mark, &Vblock))
     {
-        free(Qi);
-        free(variable_columns_in_LU);
-        return KLU_OUT_OF_MEMORY;
+        return (FALSE) ;
     }
 
-    if (Numeric->path)
-    {
-        KLU_free(Numeric->path, n, sizeof(int), Common);
-    }
-    if (Numeric->block_path)
-    {
-        KLU_free(Numeric->block_path, Numeric->nblocks, sizeof(int), Common);
-    }
-
-    Numeric->block_path = KLU_malloc(nb+1, sizeof(int), Common);
+    n = Symbolic->n ;
+    nb = Symbolic->nblocks ;
+    R = Symbolic->R ;
+    block_path = Numeric->block_path ;
 
-    for (i = 0; i < nb; i++)
+    nvblocks = 0 ;
+    for (block = 0 ; block < nb ; block++)
     {
-        Numeric->block_path[i] = n;
+        k1 = R [block] ;
+        k2 = R [block+1] ;
+        block_path [block] = n ;
+        if (!Vblock [block])
+        {
+            continue ;
+        }
+        Numeric->variable_block [nvblocks++] = block ;
+        for (k = k1 ; k < k2 ; k++)
+        {
+            if (Mark [k])
+            {
+                block_path [block] = k ;
+                break ;
+            }
+        }
     }
+    block_path [nb] = n ;
 
-    Lp = (Int*) calloc(n + 1, sizeof(Int));
-    Up = (Int*) calloc(n + 1, sizeof(Int));
-    Fp = (Int*) calloc(n + 1, sizeof(Int));
-    Lx = (double*) calloc(lnz, sizeof(double));
-    Ux = (double*) calloc(unz, sizeof(double));
-    Fx = (double*) calloc(nzoff, sizeof(double));
-    Li = (Int*) calloc(lnz, sizeof(Int));
-    Ui = (Int*) calloc(unz, sizeof(Int));
-    Fi = (Int*) calloc(nzoff, sizeof(Int));
-    P = (Int*) calloc(n, sizeof(Int));
-    Q = (Int*) calloc(n, sizeof(Int));
-    Rs = (double*) calloc(n, sizeof(double));
-    R = (Int*) calloc(nb + 1, sizeof(Int));
-
-    /* first, get LU decomposition
-     * sloppy implementation, as there might be a smarter way to do this
-     */
-    RET = KLU_extract(Numeric, Symbolic, Lp, Li, Lx, Up, Ui, Ux, Fp, Fi, Fx, P, Q, Rs, R, Common);
+    Numeric->n_variable_blocks = nvblocks ;
 
-    /* check if extraction of LU matrix broke */
-    if (RET != (TRUE))
+    if (Numeric->Rowp != NULL)
     {
-        free(Qi);
-        free(variable_columns_in_LU);
-        free(variable_rows_in_LU);
-        return (FALSE);
+        KLU_offdiag_rows_pattern (Symbolic, Numeric) ;
     }
+    return (TRUE) ;
+}
 
-    /* second, invert permutation vector
-     * Q gives "oldcol", we need "newcol"
-     */
-    for (i = 0; i < n; i++)
-    {
-        Qi[Q[i]] = i;
-    }
-
-    /* ---------------------------------------------------------------- */
-    /* third, apply permutation on variable_columns and rows */
-    /* ---------------------------------------------------------------- */
-
-    for (i = 0; i < n_variable_entries; i++)
-    {
-        variable_columns_in_LU[i] = Qi[variable_columns[i]];
-        variable_rows_in_LU[i] = Pinv[variable_rows[i]];
-    }
 
-    /* ---------------------------------------------------------------- */
-    /* fourth, determine variable off-diagonal entries */
-    /* only necessary if BTF used */
-    /* if BTF is not used, no off-diagonal blocks are available */
-    /* ---------------------------------------------------------------- */
+/* ========================================================================== */
+/* === KLU_offdiag_rows_pattern ============================================= */
+/* ========================================================================== */
 
-    if(Common->btf == TRUE)
-    {
-        /* iterate over all blocks */
-        for(block = 0 ; block < nb ; block++)
+/* Lays out the off-diagonal blocks by rows (see klu_offdiag_rows.c).  The
+ * entries that do not vary come first, in compressed-row form:  row i is
+ * Rowj [Rowp [i] ... Rowp [i+1]-1], in increasing order of column.  The
+ * varying entries follow, from Rowvar [0] = nzoff - variable_offdiag_length
+ * to nzoff-1, grouped by the block of their row.  The list of varying entries
+ * is sorted the same way, so entry t of the list is entry Rowvar [0] + t of
+ * the rows, and a partial refactorization copies their values with one
+ * contiguous loop.
+ *
+ * The values are not moved, since this is not specific to real or complex
+ * matrices; Numeric->rows_stale is set, and klu_solve uses the columns until
+ * the next factorization gathers the values into Rowx.  Uses Numeric->Iwork
+ * (size 2n) as workspace, and does not allocate any memory. */
+
+void KLU_offdiag_rows_pattern
+(
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric
+)
+{
+    Int *R, *Offp, *Offi, *Orig, *Perm, *Rowp, *Rowj, *Rowi, *Rowoff, *Rowvar,
+        *Blk, *Next ;
+    Int n, nb, nzoff, noff, nfixed, block, i, k, p, pend, q, t ;
+
+    n = Symbolic->n ;
+    nb = Symbolic->nblocks ;
+    R = Symbolic->R ;
+    Offp = Numeric->Offp ;
+    Offi = Numeric->Offi ;
+    nzoff = Offp [n] ;
+    noff = Numeric->variable_offdiag_length ;
+    nfixed = nzoff - noff ;
+    Orig = Numeric->variable_offdiag_orig_entry ;
+    Perm = Numeric->variable_offdiag_perm_entry ;
+    Rowp = Numeric->Rowp ;
+    Rowj = Numeric->Rowj ;
+    Rowi = Numeric->Rowi ;
+    Rowoff = Numeric->Rowoff ;
+    Rowvar = Numeric->Rowvar ;
+
+    Blk = Numeric->Iwork ;      /* size n, block of each row */
+    Next = Blk + n ;            /* size n */
+
+    for (block = 0 ; block < nb ; block++)
+    {
+        for (k = R [block] ; k < R [block+1] ; k++)
         {
-            k1 = R [block];
-            k2 = R [block+1];
-            nk = k2 - k1;
-            for (k = 0 ; k < nk ; k++)
-            {
-                oldcol = Q [k+k1] ;
-                pend = Ap [oldcol+1] ;
-                for (p = Ap [oldcol] ; p < pend ; p++)
-                {
-                    newrow = Pinv [Ai [p]] - k1 ;
-                    if (newrow < 0 && poff < nzoff)
-                    {
-                        /* entry in off-diagonal block */
-
-                        /* check if entry is in variable column */
-                        /* TODO */
-                        for(i = 0 ; i < n_variable_entries ; i++)
-                        {
-                            if(variable_columns_in_LU[i] == k+k1 && variable_rows_in_LU[i] == Pinv [Ai [p]])
-                            {
-                                /* set to -1, because they're off-diagonal now */
-                                /* indicates that they are "removed" from variable columns and row "list" */
-                                /* subsequently, add to variable off-diag entries and reduce length of variable entries */
-                                variable_columns_in_LU[i] = -1;
-                                variable_rows_in_LU[i] = -1;
-
-                                variable_offdiag_orig_entry[variable_offdiag_length] = p;
-                                variable_offdiag_perm_entry[variable_offdiag_length++] = poff;
-
-                                n_variable_entries_new--;
-                                break;
-                            }
-                        }
-                        poff++ ;
-                    }
-                }
-            }
+            Blk [k] = block ;
         }
     }
 
-    /* safety first */
-    ASSERT(variable_offdiag_length == n_variable_entries - n_variable_entries_new);
+    /* ---------------------------------------------------------------------- */
+    /* sort the varying entries by the block of their row */
+    /* ---------------------------------------------------------------------- */
 
-    Numeric->variable_offdiag_orig_entry = KLU_malloc(variable_offdiag_length, sizeof(Int), Common);
-    Numeric->variable_offdiag_perm_entry = KLU_malloc(variable_offdiag_length, sizeof(Int), Common);
-    Numeric->variable_offdiag_length = variable_offdiag_length;
-
-    for(i = 0; i < variable_offdiag_length ; i++)
+    /* Rowj and Rowoff hold a copy of the list */
+    for (block = 0 ; block < nb ; block++)
     {
-        Numeric->variable_offdiag_orig_entry[i] = variable_offdiag_orig_entry[i];
-        Numeric->variable_offdiag_perm_entry[i] = variable_offdiag_perm_entry[i];
+        Next [block] = 0 ;
     }
-
-    if(n_variable_entries_new == 0)
+    for (t = 0 ; t < noff ; t++)
     {
-        /* very good case, no varying columns in LU blocks */
-        /* free memory and return */
-        goto EXIT;
+        Rowj [t] = Orig [t] ;
+        Rowoff [t] = Perm [t] ;
+        Next [Blk [Offi [Perm [t]]]]++ ;
     }
-
-    int* cV = (int*) calloc(n, sizeof(int));
-    for ( i = 0 ; i < n_variable_entries ; i++)
+    q = nfixed ;
+    for (block = 0 ; block < nb ; block++)
     {
-        if(variable_columns_in_LU[i] != -1)
-        {
-            cV[variable_columns_in_LU[i]] = 1;
-        }
+        Rowvar [block] = q ;
+        q += Next [block] ;
+        Next [block] = Rowvar [block] - nfixed ;
     }
-
-    /* count how many variable columns there are (not necessarily equal to n_variable_entries_new) */
-    n_variable_entries = 0;
-    for ( i = 0 ; i < n ; i++)
+    Rowvar [nb] = nzoff ;
+    for (t = 0 ; t < noff ; t++)
     {
-        if(cV[i] == 1)
-        {
-            n_variable_entries++;
-        }
+        q = Next [Blk [Offi [Rowoff [t]]]]++ ;
+        Orig [q] = Rowj [t] ;
+        Perm [q] = Rowoff [t] ;
     }
-    int ctr = 0;
-    variable_columns_in_LU = (Int*) realloc(variable_columns_in_LU, sizeof(Int)*n_variable_entries);
-    if(variable_columns_in_LU == NULL)
+
+    /* flag the varying entries in Offi with their place in the list */
+    for (t = 0 ; t < noff ; t++)
     {
-        return KLU_OUT_OF_MEMORY;
+        Rowi [nfixed + t] = Offi [Perm [t]] ;
+        Offi [Perm [t]] = BTF_FLIP (t) ;
     }
-    for ( i = 0; i< n_variable_entries ; i++)
+
+    /* ---------------------------------------------------------------------- */
+    /* count the entries that do not vary in each row */
+    /* ---------------------------------------------------------------------- */
+
+    for (i = 0 ; i <= n ; i++)
     {
-        variable_columns_in_LU[i] = 0;
+        Rowp [i] = 0 ;
     }
-    for ( i = 0 ; i < n ; i++)
+    for (p = 0 ; p < nzoff ; p++)
     {
-        if(cV[i] == 1)
+        if (!BTF_ISFLIPPED (Offi [p]))
         {
-            variable_columns_in_LU[ctr] = i;
-            ctr++;
+            Rowp [Offi [p] + 1]++ ;
         }
     }
-    free(cV);
-
-    if (Common->btf == FALSE)
+    for (i = 0 ; i < n ; i++)
     {
-        /* no btf case
-         * => identify first varying entry in entire matrix */
-        Numeric->n_variable_blocks = 1;
-        Numeric->variable_block = KLU_malloc(Numeric->n_variable_blocks, sizeof(int), Common);
-        Numeric->variable_block[0] = 0;
-
-        /* find minimum in variable_columns_in_LU */
-        pivot = variable_columns_in_LU[0];
-        for(i = 1; i < n_variable_entries ; i++)
-        {
-            if(pivot > variable_columns_in_LU[i])
-            {
-                pivot = variable_columns_in_LU[i];
-            }
-        }
-
-        /* set first varying column internally */
-        Numeric->block_path[0] = pivot;
+        Rowp [i+1] += Rowp [i] ;
+        Next [i] = Rowp [i] ;
     }
-    else
-    {
-        Numeric->n_variable_blocks = 0;
-        /* btf case
-         *
-         * iterate over variable_columns_in_LU
-         * for each variable column
-         * find its block
-         *      put block in block-path
-         *      if block larger than 1
-         *          start[block] = min(start[block], column), if start[block] != 0
-         */
-
-         for(i = 0; i < n_variable_entries ; i++)
-         {
-            /* grab variable column number i */
-            pivot = variable_columns_in_LU[i];
-
-            /* find block */
-            for (k = 0; k < nb; k++)
-            {
-                k1 = R[k];
-                k2 = R[k + 1];
-                if (k1 <= pivot && pivot < k2)
-                {
-                    nk = k2 - k1;
 
-                    /* set varying block */
+    /* ---------------------------------------------------------------------- */
+    /* place each entry, and restore Offi */
+    /* ---------------------------------------------------------------------- */
 
-                    if(nvblocks[k] != 1)
-                    {
-                        nvblocks[k] = 1;
-                        Numeric->n_variable_blocks += 1;
-                    }
-                    break;
-                }
-            }
-
-            if (nk == 1)
-            {
-                /* 1x1-block, nothing left to do */
-                continue;
-            }
-
-            /* nk x nk block. check if pivot column is smaller (before) current minimum */
-            if(Numeric->block_path[k] > pivot)
+    for (k = 0 ; k < n ; k++)
+    {
+        pend = Offp [k+1] ;
+        for (p = Offp [k] ; p < pend ; p++)
+        {
+            i = Offi [p] ;
+            if (BTF_ISFLIPPED (i))
             {
-                Numeric->block_path[k] = pivot;
+                q = nfixed + BTF_UNFLIP (i) ;
+                Offi [p] = Rowi [q] ;
             }
-         }
-        ctr = 0;
-        Numeric->variable_block = KLU_malloc(Numeric->n_variable_blocks, sizeof(int), Common);
-        for(i = 0 ; i < nb ; i++)
-        {
-            if(nvblocks[i] == 1)
+            else
             {
-                /* block i is varying */
-                Numeric->variable_block[ctr++] = i;
+                q = Next [i]++ ;
+                Rowi [q] = i ;
             }
+            Rowj [q] = k ;
+            Rowoff [q] = p ;
         }
-        ASSERT(ctr == Numeric->n_variable_blocks);
     }
-EXIT:
-    free(Lp);
-    free(Li);
-    free(Lx);
-    free(Up);
-    free(Ui);
-    free(Ux);
-    free(Fi);
-    free(Fp);
-    free(Fx);
-    free(P);
-    free(Q);
-    free(Qi);
-    free(R);
-    free(Rs);
-    free(variable_columns_in_LU);
-    free(variable_offdiag_orig_entry);
-    free(variable_offdiag_perm_entry);
-    free(nvblocks);
-
-    return (TRUE);
+
+    Numeric->rows_stale = TRUE ;
 }
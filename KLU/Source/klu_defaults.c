@@ -24,7 +24,8 @@ Int KLU_defaults
     Common->btf = TRUE ;        /* use BTF pre-ordering, or not */
     Common->maxwork = 0 ;       /* no limit to work done by btf_order */
     Common->ordering = 0 ;      /* 0: AMD, 1: COLAMD, 2: user-provided P and Q,
-                                 * 3: user-provided function */
+                                 * 3: user-provided function, 4: AUTO,
+                                 * 5: ND */
     Common->scale = 2 ;         /* scale: -1: none, and do not check for errors
                                  * in the input matrix in KLU_refactor.
                                  * 0: none, but check for errors,
@@ -38,6 +39,7 @@ Int KLU_defaults
     /* statistics */
     Common->status = KLU_OK ;
     Common->nrealloc = 0 ;
+    Common->nrepivot = 0 ;
     Common->structural_rank = EMPTY ;
     Common->numerical_rank = EMPTY ;
     Common->noffdiag = EMPTY ;
@@ -53,5 +55,19 @@ Int KLU_defaults
     Common->halt_if_pivot_fails = TRUE ;   /* quick halt if pivot is too small */
     Common->pivot_tol_fail = 1e-8;
 
+    Common->max_updates = 8 ;       /* klu_update: refactorize after 8 updates */
+    Common->update_tol = 1e-8 ;     /* or if an update is ill-conditioned */
+
+    Common->nd_min = 1000 ;         /* ND: split blocks of size 1000 or more */
+    Common->nd_domains = 16 ;       /* into about 16 independent subtrees */
+
+    Common->btf_match = 0 ;         /* btf_maxtrans, limited by maxwork */
+
+    Common->monitor = FALSE ;       /* no rcond/rgrowth monitor */
+    Common->monitor_rcond_tol = 1e-12 ;
+    Common->monitor_rgrowth_tol = 1e-8 ;
+    Common->offdiag_rows = FALSE ;  /* off-diagonal blocks by columns only */
+    Common->monitor_flag = 0 ;
+
     return (TRUE) ;
 }
@@ -248,10 +248,22 @@ static void factor2
             }
 
             /* allocates 1 arrays: LUbx [block] */
-            Numeric->LUsize [block] = KLU_kernel_factor (nk, Ap, Ai, Ax, Q,
-                    lsize, &LUbx [block], Udiag + k1, Llen + k1, Ulen + k1,
+            if (Symbolic->Domain != NULL && Symbolic->Domain [k1] != EMPTY)
+            {
+                /* the block was split by nested dissection (ordering 5) */
+                Numeric->LUsize [block] = KLU_kernel_nd (nk, Ap, Ai, Ax, Q,
+                    lsize, Symbolic->Domain + k1, &LUbx [block], Udiag + k1,
+                    Llen + k1, Ulen + k1, Lip + k1, Uip + k1, Pblock,
+                    &lnz_block, &unz_block, X, Iwork, k1, Pinv, Rs, Offp,
+                    Offi, Offx, Common) ;
+            }
+            else
+            {
+                Numeric->LUsize [block] = KLU_kernel_factor (nk, Ap, Ai, Ax,
+                    Q, lsize, &LUbx [block], Udiag + k1, Llen + k1, Ulen + k1,
                     Lip + k1, Uip + k1, Pblock, &lnz_block, &unz_block,
                     X, Iwork, k1, Pinv, Rs, Offp, Offi, Offx, Common) ;
+            }
 
             if (Common->status < KLU_OK ||
                (Common->status == KLU_SINGULAR && Common->halt_if_singular))
@@ -501,6 +513,30 @@ KLU_numeric *KLU_factor         /* returns NULL if error, or a valid
     Numeric->variable_block = NULL;
     Numeric->variable_offdiag_orig_entry = NULL;
     Numeric->variable_offdiag_perm_entry = NULL;
+    Numeric->pathLen = 0;
+    Numeric->n_variable_blocks = 0;
+    Numeric->variable_offdiag_length = 0;
+
+    /* only allocate if klu_update is called */
+    Numeric->nupdates = 0;
+    Numeric->maxupdates = 0;
+    Numeric->Updu = NULL;
+    Numeric->Updv = NULL;
+    Numeric->Updw = NULL;
+    Numeric->Updz = NULL;
+    Numeric->Updg = NULL;
+
+    /* only allocate if Common->monitor is set */
+    Numeric->Monitor = NULL;
+
+    /* only allocate if Common->offdiag_rows is set */
+    Numeric->Rowp = NULL;
+    Numeric->Rowj = NULL;
+    Numeric->Rowi = NULL;
+    Numeric->Rowoff = NULL;
+    Numeric->Rowx = NULL;
+    Numeric->Rowvar = NULL;
+    Numeric->rows_stale = FALSE;
 
     /* allocate permanent workspace for factorization and solve.  Note that the
      * solver will use an Xwork of size 4n, whereas the factorization codes use
@@ -555,6 +591,20 @@ KLU_numeric *KLU_factor         /* returns NULL if error, or a valid
         Common->numerical_rank = n ;
         Common->singular_col = n ;
     }
+
+    if (Numeric != NULL && Common->monitor &&
+        !KLU_monitor_all (Ap, Ai, Ax, Symbolic, Numeric, Common))
+    {
+        /* out of memory */
+        KLU_free_numeric (&Numeric, Common) ;
+    }
+
+    if (Numeric != NULL && Common->offdiag_rows &&
+        !KLU_offdiag_rows (Symbolic, Numeric, Common))
+    {
+        /* out of memory */
+        KLU_free_numeric (&Numeric, Common) ;
+    }
 #ifdef KLU_PRINT
     static int counter = 0;
     if(counter == 0)
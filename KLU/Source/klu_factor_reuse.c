@@ -0,0 +1,552 @@
+/* ========================================================================== */
+/* === KLU_factor_reuse ===================================================== */
+/* ========================================================================== */
+
+/* Factor the matrix again, reusing the pivots and the pattern of L and U from
+ * the last KLU_factor (or KLU_factor_reuse), as long as the pivots are still
+ * acceptable.  The pattern of each column of L and U is the reach that the
+ * depth-first search of KLU_kernel_factor found, so the numeric phase runs on
+ * the known patterns with no search at all, as in KLU_refactor.  Unlike
+ * KLU_refactor, each pivot is checked against the same threshold test that
+ * KLU_kernel_factor uses to select it:
+ *
+ *      abs (U (k,k)) >= Common->tol * max (abs (U (k,k)), abs (L (:,k)))
+ *
+ * where L (:,k) is taken before the division by the pivot.  If a pivot fails
+ * the test, or is zero, its block is factorized again with KLU_kernel_factor
+ * (or KLU_kernel_nd), with partial pivoting.  The whole block is factorized,
+ * not just the column, since a new pivot row changes the pattern of all the
+ * columns after it.  The kernel prefers the old pivot row of each column, so
+ * most of the pivots are kept.  Common->nrepivot is the number of blocks
+ * factorized again.
+ *
+ * If no block is factorized again, the factorization path of
+ * klu_compute_path and klu_determine_start is still valid.  Otherwise it
+ * must be computed again before the next partial refactorization.  The
+ * pattern of the input matrix (Ap, Ai) must be identical to the pattern
+ * given to KLU_factor.
+ */
+
+#include "klu_internal.h"
+
+/* ========================================================================== */
+/* === reuse_columns ======================================================== */
+/* ========================================================================== */
+
+/* Refactorizes the columns of the block from k1 to k1+nk-1, with the same
+ * pivots and pattern as before, as refactor_columns in klu_refactor.c does.
+ * The off-diagonal entries of the block start at Offx [poff].  Returns the
+ * first column (local to the block) whose pivot fails the threshold test, or
+ * EMPTY if there is none.  X is zero on input and output. */
+
+static Int reuse_columns
+(
+    Int k1,
+    Int nk,
+    Int poff,
+    Int Ap [ ],
+    Int Ai [ ],
+    Entry Az [ ],
+    double Rs [ ],      /* NULL if not scaled */
+    Int Q [ ],
+    Int Pinv [ ],
+    Unit *LU,
+    Int Lip [ ],
+    Int Llen [ ],
+    Int Uip [ ],
+    Int Ulen [ ],
+    Entry Udiag [ ],
+    Entry Offx [ ],
+    Entry X [ ],
+    double tol
+)
+{
+    Entry ukk, ujk ;
+    Entry *Lx, *Ux ;
+    double abs_ukk, xmax, temp ;
+    Int *Li, *Ui ;
+    Int k, p, pend, oldcol, oldrow, newrow, i, j, up, ulen, llen ;
+
+    for (k = 0 ; k < nk ; k++)
+    {
+        /* scatter kth column of the block into workspace X */
+        oldcol = Q [k+k1] ;
+        pend = Ap [oldcol+1] ;
+        for (p = Ap [oldcol] ; p < pend ; p++)
+        {
+            oldrow = Ai [p] ;
+            newrow = Pinv [oldrow] - k1 ;
+            if (newrow < 0)
+            {
+                /* entry in off-diagonal part */
+                if (Rs == NULL)
+                {
+                    Offx [poff] = Az [p] ;
+                }
+                else
+                {
+                    SCALE_DIV_ASSIGN (Offx [poff], Az [p], Rs [oldrow]) ;
+                }
+                poff++ ;
+            }
+            else if (Rs == NULL)
+            {
+                X [newrow] = Az [p] ;
+            }
+            else
+            {
+                SCALE_DIV_ASSIGN (X [newrow], Az [p], Rs [oldrow]) ;
+            }
+        }
+
+        /* compute kth column of U, and update kth column of A */
+        GET_POINTER (LU, Uip, Ulen, Ui, Ux, k, ulen) ;
+        for (up = 0 ; up < ulen ; up++)
+        {
+            j = Ui [up] ;
+            ujk = X [j] ;
+            CLEAR (X [j]) ;
+            Ux [up] = ujk ;
+            GET_POINTER (LU, Lip, Llen, Li, Lx, j, llen) ;
+            for (p = 0 ; p < llen ; p++)
+            {
+                MULT_SUB (X [Li [p]], Lx [p], ujk) ;
+            }
+        }
+
+        /* get the diagonal entry of U */
+        ukk = X [k] ;
+        CLEAR (X [k]) ;
+
+        /* threshold test of the old pivot against the rest of the column */
+        GET_POINTER (LU, Lip, Llen, Li, Lx, k, llen) ;
+        xmax = 0 ;
+        for (p = 0 ; p < llen ; p++)
+        {
+            ABS (temp, X [Li [p]]) ;
+            if (temp > xmax)
+            {
+                xmax = temp ;
+            }
+        }
+        ABS (abs_ukk, ukk) ;
+        if (IS_ZERO (ukk) || abs_ukk < tol * xmax)
+        {
+            /* the pivot fails; leave X zero for the kernel */
+            for (p = 0 ; p < llen ; p++)
+            {
+                CLEAR (X [Li [p]]) ;
+            }
+            return (k) ;
+        }
+        Udiag [k+k1] = ukk ;
+
+        /* gather and divide by pivot to get kth column of L */
+        for (p = 0 ; p < llen ; p++)
+        {
+            i = Li [p] ;
+            DIV (Lx [p], X [i], ukk) ;
+            CLEAR (X [i]) ;
+        }
+    }
+    return (EMPTY) ;
+}
+
+
+/* ========================================================================== */
+/* === repivot_block ======================================================== */
+/* ========================================================================== */
+
+/* Factorizes the block from k1 to k1+nk-1 again with partial pivoting, as
+ * factor2 in klu_factor.c does, and updates Pnum, Pinv, Offi and the
+ * statistics for its new pivot rows.  The scale factors Rs are not yet
+ * permuted.  Returns FALSE if out of memory, or if the block is singular and
+ * Common->halt_if_singular is true. */
+
+static Int repivot_block
+(
+    Int block,
+    Int k1,
+    Int nk,
+    Int Ap [ ],
+    Int Ai [ ],
+    Entry Az [ ],
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    KLU_common *Common
+)
+{
+    double lsize ;
+    double *Lnz ;
+    Int *Q, *Pnum, *Pinv, *Offp, *Offi, *Iwork, *Pblock, *Lip, *Uip, *Llen,
+        *Ulen ;
+    Entry *X ;
+    Unit **LUbx ;
+    Int k, k2, n, p, i, lnz_old, unz_old, lnz_block, unz_block ;
+
+    n = Symbolic->n ;
+    Q = Symbolic->Q ;
+    Lnz = Symbolic->Lnz ;
+    k2 = k1 + nk ;
+
+    Pnum = Numeric->Pnum ;
+    Pinv = Numeric->Pinv ;
+    Offp = Numeric->Offp ;
+    Offi = Numeric->Offi ;
+    Lip = Numeric->Lip ;
+    Uip = Numeric->Uip ;
+    Llen = Numeric->Llen ;
+    Ulen = Numeric->Ulen ;
+    LUbx = (Unit **) Numeric->LUbx ;
+    X = (Entry *) Numeric->Xwork ;
+    Iwork = Numeric->Iwork ;
+    Pblock = Iwork + 5*((size_t) Symbolic->maxblock) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* the rows of the block in the columns after it, as rows of A, flipped */
+    /* ---------------------------------------------------------------------- */
+
+    for (p = Offp [k2] ; p < Offp [n] ; p++)
+    {
+        i = Offi [p] ;
+        if (i >= k1 && i < k2)
+        {
+            Offi [p] = BTF_FLIP (Pnum [i]) ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* free the old factors of the block */
+    /* ---------------------------------------------------------------------- */
+
+    lnz_old = 0 ;
+    unz_old = 0 ;
+    for (k = k1 ; k < k2 ; k++)
+    {
+        lnz_old += Llen [k] + 1 ;
+        unz_old += Ulen [k] + 1 ;
+    }
+    LUbx [block] = KLU_free (LUbx [block], Numeric->LUsize [block],
+        sizeof (Unit), Common) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* factorize the block with partial pivoting */
+    /* ---------------------------------------------------------------------- */
+
+    /* The rows of the block are in the order of the old pivots, so the
+     * kernel tries the old pivot row of each column first.  It leaves the
+     * rows of A in Offi for the columns of the block. */
+    if (Lnz [block] < 0)
+    {
+        lsize = -(Common->initmem) ;
+    }
+    else
+    {
+        lsize = Common->initmem_amd * Lnz [block] + nk ;
+    }
+    if (Symbolic->Domain != NULL && Symbolic->Domain [k1] != EMPTY)
+    {
+        Numeric->LUsize [block] = KLU_kernel_nd (nk, Ap, Ai, Az, Q, lsize,
+            Symbolic->Domain + k1, &LUbx [block], (Entry *) Numeric->Udiag + k1,
+            Llen + k1, Ulen + k1, Lip + k1, Uip + k1, Pblock, &lnz_block,
+            &unz_block, X, Iwork, k1, Pinv, Numeric->Rs, Offp, Offi,
+            (Entry *) Numeric->Offx, Common) ;
+    }
+    else
+    {
+        Numeric->LUsize [block] = KLU_kernel_factor (nk, Ap, Ai, Az, Q, lsize,
+            &LUbx [block], (Entry *) Numeric->Udiag + k1, Llen + k1,
+            Ulen + k1, Lip + k1, Uip + k1, Pblock, &lnz_block, &unz_block, X,
+            Iwork, k1, Pinv, Numeric->Rs, Offp, Offi,
+            (Entry *) Numeric->Offx, Common) ;
+    }
+    if (Common->status < KLU_OK ||
+       (Common->status == KLU_SINGULAR && Common->halt_if_singular))
+    {
+        /* out of memory, or singular */
+        return (FALSE) ;
+    }
+    Common->nrepivot++ ;
+
+    /* ---------------------------------------------------------------------- */
+    /* the new pivot rows of the block */
+    /* ---------------------------------------------------------------------- */
+
+    for (k = 0 ; k < nk ; k++)
+    {
+        Pblock [k] = Pnum [Pblock [k] + k1] ;
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        Pnum [k+k1] = Pblock [k] ;
+        Pinv [Pblock [k]] = k+k1 ;
+    }
+
+    /* the off-diagonal rows of the columns of the block, and of the rows of
+     * the block in the columns after it */
+    for (p = Offp [k1] ; p < Offp [k2] ; p++)
+    {
+        Offi [p] = Pinv [Offi [p]] ;
+    }
+    for (p = Offp [k2] ; p < Offp [n] ; p++)
+    {
+        i = Offi [p] ;
+        if (i < EMPTY)
+        {
+            Offi [p] = Pinv [BTF_UNFLIP (i)] ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* statistics */
+    /* ---------------------------------------------------------------------- */
+
+    Numeric->lnz += lnz_block - lnz_old ;
+    Numeric->unz += unz_block - unz_old ;
+    Numeric->max_lnz_block = MAX (Numeric->max_lnz_block, lnz_block) ;
+    Numeric->max_unz_block = MAX (Numeric->max_unz_block, unz_block) ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_factor_reuse ===================================================== */
+/* ========================================================================== */
+
+Int KLU_factor_reuse    /* returns TRUE if successful, FALSE otherwise */
+(
+    /* inputs, not modified */
+    Int Ap [ ],         /* size n+1, column pointers */
+    Int Ai [ ],         /* size nz, row indices */
+    double Ax [ ],
+    KLU_symbolic *Symbolic,
+
+    /* input/output */
+    KLU_numeric *Numeric,
+    KLU_common  *Common
+)
+{
+    Entry s ;
+    Entry *Offx, *X, *Az, *Udiag ;
+    double *Rs ;
+    Int *Q, *R, *Pnum, *Pinv, *Offp ;
+    Int k1, k2, nk, k, block, oldcol, pend, oldrow, n, p, scale, nblocks,
+        poff, maxblock, bad, repivoted ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    if (Common == NULL)
+    {
+        return (FALSE) ;
+    }
+    Common->status = KLU_OK ;
+
+    if (Numeric == NULL)
+    {
+        /* invalid Numeric object */
+        Common->status = KLU_INVALID ;
+        return (FALSE) ;
+    }
+
+    /* the new factors include any klu_update since the last one */
+    Numeric->nupdates = 0 ;
+
+    Common->numerical_rank = EMPTY ;
+    Common->singular_col = EMPTY ;
+    Common->nrealloc = 0 ;
+    Common->nrepivot = 0 ;
+
+    Az = (Entry *) Ax ;
+
+    /* ---------------------------------------------------------------------- */
+    /* get the contents of the Symbolic and Numeric objects */
+    /* ---------------------------------------------------------------------- */
+
+    n = Symbolic->n ;
+    Q = Symbolic->Q ;
+    R = Symbolic->R ;
+    nblocks = Symbolic->nblocks ;
+    maxblock = Symbolic->maxblock ;
+
+    Pnum = Numeric->Pnum ;
+    Pinv = Numeric->Pinv ;
+    Offp = Numeric->Offp ;
+    Offx = (Entry *) Numeric->Offx ;
+    Udiag = (Entry *) Numeric->Udiag ;
+    X = (Entry *) Numeric->Xwork ;
+
+    scale = Common->scale ;
+    if (scale > 0)
+    {
+        /* factorization was not scaled, but this one is */
+        if (Numeric->Rs == NULL)
+        {
+            Numeric->Rs = KLU_malloc (n, sizeof (double), Common) ;
+            if (Common->status < KLU_OK)
+            {
+                Common->status = KLU_OUT_OF_MEMORY ;
+                return (FALSE) ;
+            }
+        }
+    }
+    else
+    {
+        /* no scaling; ensure Numeric->Rs is freed */
+        Numeric->Rs = KLU_free (Numeric->Rs, n, sizeof (double), Common) ;
+    }
+    Rs = Numeric->Rs ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check the input matrix compute the row scale factors, Rs */
+    /* ---------------------------------------------------------------------- */
+
+    if (scale >= 0)
+    {
+        /* check for out-of-range indices, but do not check for duplicates */
+        if (!KLU_scale (scale, n, Ap, Ai, Ax, Rs, NULL, Common))
+        {
+            return (FALSE) ;
+        }
+    }
+
+    for (k = 0 ; k < maxblock ; k++)
+    {
+        CLEAR (X [k]) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* factor each block */
+    /* ---------------------------------------------------------------------- */
+
+    repivoted = FALSE ;
+    for (block = 0 ; block < nblocks ; block++)
+    {
+        k1 = R [block] ;
+        k2 = R [block+1] ;
+        nk = k2 - k1 ;
+
+        if (nk == 1)
+        {
+
+            /* -------------------------------------------------------------- */
+            /* singleton case */
+            /* -------------------------------------------------------------- */
+
+            poff = Offp [k1] ;
+            oldcol = Q [k1] ;
+            pend = Ap [oldcol+1] ;
+            CLEAR (s) ;
+            for (p = Ap [oldcol] ; p < pend ; p++)
+            {
+                oldrow = Ai [p] ;
+                if (Pinv [oldrow] < k1)
+                {
+                    /* entry in off-diagonal block */
+                    if (Rs == NULL)
+                    {
+                        Offx [poff] = Az [p] ;
+                    }
+                    else
+                    {
+                        SCALE_DIV_ASSIGN (Offx [poff], Az [p], Rs [oldrow]) ;
+                    }
+                    poff++ ;
+                }
+                else if (Rs == NULL)
+                {
+                    s = Az [p] ;
+                }
+                else
+                {
+                    SCALE_DIV_ASSIGN (s, Az [p], Rs [oldrow]) ;
+                }
+            }
+            Udiag [k1] = s ;
+
+            if (IS_ZERO (s))
+            {
+                /* singular singleton */
+                Common->status = KLU_SINGULAR ;
+                if (Common->numerical_rank == EMPTY)
+                {
+                    Common->numerical_rank = k1 ;
+                    Common->singular_col = oldcol ;
+                }
+                if (Common->halt_if_singular)
+                {
+                    return (FALSE) ;
+                }
+            }
+
+        }
+        else
+        {
+
+            /* -------------------------------------------------------------- */
+            /* reuse the pivots of the block, or factorize it again */
+            /* -------------------------------------------------------------- */
+
+            bad = reuse_columns (k1, nk, Offp [k1], Ap, Ai, Az, Rs, Q, Pinv,
+                (Unit *) Numeric->LUbx [block], Numeric->Lip + k1,
+                Numeric->Llen + k1, Numeric->Uip + k1, Numeric->Ulen + k1,
+                Udiag, Offx, X, Common->tol) ;
+            if (bad != EMPTY)
+            {
+                PRINTF (("block %d: pivot %d fails, factorize again\n",
+                    block, bad + k1)) ;
+                if (!repivot_block (block, k1, nk, Ap, Ai, Az, Symbolic,
+                    Numeric, Common))
+                {
+                    return (FALSE) ;
+                }
+                repivoted = TRUE ;
+            }
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* permute scale factors Rs according to pivotal row order */
+    /* ---------------------------------------------------------------------- */
+
+    if (scale > 0)
+    {
+        for (k = 0 ; k < n ; k++)
+        {
+            REAL (X [k]) = Rs [Pnum [k]] ;
+        }
+        for (k = 0 ; k < n ; k++)
+        {
+            Rs [k] = REAL (X [k]) ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* update the rcond and rgrowth monitor */
+    /* ---------------------------------------------------------------------- */
+
+    if (Common->monitor &&
+        !KLU_monitor_all (Ap, Ai, Ax, Symbolic, Numeric, Common))
+    {
+        return (FALSE) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* copy the off-diagonal blocks by rows */
+    /* ---------------------------------------------------------------------- */
+
+    if (repivoted && Numeric->Rowp != NULL)
+    {
+        /* the rows of the off-diagonal entries have changed */
+        KLU_offdiag_rows_pattern (Symbolic, Numeric) ;
+    }
+    if ((Common->offdiag_rows || Numeric->Rowp != NULL) &&
+        !KLU_offdiag_rows (Symbolic, Numeric, Common))
+    {
+        return (FALSE) ;
+    }
+
+    ASSERT (KLU_valid (n, Offp, Numeric->Offi, Offx)) ;
+    return (TRUE) ;
+}
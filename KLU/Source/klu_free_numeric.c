@@ -15,7 +15,8 @@ Int KLU_free_numeric
     KLU_numeric *Numeric ;
     Unit **LUbx ;
     size_t *LUsize ;
-    Int block, n, nzoff, nblocks ;
+    size_t s ;
+    Int block, n, nzoff, nblocks, ok = TRUE ;
 
     if (Common == NULL)
     {
@@ -64,28 +65,38 @@ Int KLU_free_numeric
 
     KLU_free (Numeric->Work, Numeric->worksize, 1, Common) ;
 
-    /* Numeric->path or Numeric->bpath only allocated if klu_compute_path
-     * is called, i.e. partial refactorization is used */
-    if(Numeric->path)
+    /* the path arrays are only allocated if klu_compute_path or
+     * klu_determine_start is called, i.e. partial refactorization is used.
+     * Their sizes are fixed; see KLU_compute_path. */
+    KLU_free (Numeric->path, n, sizeof (Int), Common) ;
+    KLU_free (Numeric->block_path, nblocks+1, sizeof (Int), Common) ;
+    KLU_free (Numeric->variable_block, nblocks, sizeof (Int), Common) ;
+    KLU_free (Numeric->variable_offdiag_orig_entry, nzoff+1,
+        sizeof (Int), Common) ;
+    KLU_free (Numeric->variable_offdiag_perm_entry, nzoff+1,
+        sizeof (Int), Common) ;
+
+    /* the update arrays are only allocated if klu_update is called */
+    if (Numeric->maxupdates > 0)
     {
-        KLU_free (Numeric->path, Numeric->pathLen, sizeof (int), Common) ;
-    }
-    if(Numeric->block_path)
-    {
-        KLU_free (Numeric->block_path, Numeric->nblocks, sizeof (int), Common);
-    }
-    if(Numeric->variable_block)
-    {
-        KLU_free (Numeric->variable_block, Numeric->n_variable_blocks, sizeof (int), Common);
-    }
-    if(Numeric->variable_offdiag_orig_entry)
-    {
-        KLU_free (Numeric->variable_offdiag_orig_entry, Numeric->variable_offdiag_length, sizeof (int), Common);
-    }
-    if(Numeric->variable_offdiag_perm_entry)
-    {
-        KLU_free (Numeric->variable_offdiag_perm_entry, Numeric->variable_offdiag_length, sizeof (int), Common);
+        s = KLU_mult_size_t (n, Numeric->maxupdates, &ok) ;
+        KLU_free (Numeric->Updu, s, sizeof (Entry), Common) ;
+        KLU_free (Numeric->Updv, s, sizeof (Entry), Common) ;
+        KLU_free (Numeric->Updw, s, sizeof (Entry), Common) ;
+        KLU_free (Numeric->Updz, s, sizeof (Entry), Common) ;
+        KLU_free (Numeric->Updg, Numeric->maxupdates, sizeof (Entry), Common) ;
     }
+
+    /* only allocated if Common->monitor is set; see klu_monitor.c */
+    KLU_free (Numeric->Monitor, 6*n, sizeof (double), Common) ;
+
+    /* only allocated if Common->offdiag_rows is set; see klu_offdiag_rows.c */
+    KLU_free (Numeric->Rowp, n+1, sizeof (Int), Common) ;
+    KLU_free (Numeric->Rowj, nzoff+1, sizeof (Int), Common) ;
+    KLU_free (Numeric->Rowi, nzoff+1, sizeof (Int), Common) ;
+    KLU_free (Numeric->Rowoff, nzoff+1, sizeof (Int), Common) ;
+    KLU_free (Numeric->Rowx, nzoff+1, sizeof (Entry), Common) ;
+    KLU_free (Numeric->Rowvar, nblocks+1, sizeof (Int), Common) ;
     KLU_free (Numeric, 1, sizeof (KLU_numeric), Common) ;
 
     *NumericHandle = NULL ;
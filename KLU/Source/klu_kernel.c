@@ -9,6 +9,10 @@
 
 #include "klu_internal.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /* ========================================================================== */
 /* === dfs ================================================================== */
 /* ========================================================================== */
@@ -203,9 +207,10 @@ static Int lsolve_symbolic
 
 /* Construct the kth column of A, and the off-diagonal part, if requested.
  * Scatter the numerical values into the workspace X, and construct the
- * corresponding column of the off-diagonal matrix. */
+ * corresponding column of the off-diagonal matrix.  Returns the start of the
+ * next column of the off-diagonal part. */
 
-static void construct_column
+static Int construct_column
 (
     /* inputs, not modified on output */
     Int k,          /* the column of A (or the column of the block) to get */
@@ -225,8 +230,8 @@ static void construct_column
     double Rs [ ],  /* scale factors for A */
     Int scale,      /* 0: no scaling, nonzero: scale the rows with Rs */
 
-    /* inputs, modified on output */
-    Int Offp [ ],   /* off-diagonal matrix (modified by this routine) */
+    /* inputs, Offi and Offx modified on output */
+    Int Offp [ ],   /* off-diagonal matrix */
     Int Offi [ ],
     Entry Offx [ ]
 )
@@ -289,7 +294,7 @@ static void construct_column
         }
     }
 
-    Offp [kglobal+1] = poff ;   /* start of the next col of off-diag part */
+    return (poff) ;             /* start of the next col of off-diag part */
 }
 
 
@@ -339,7 +344,7 @@ static void lsolve_numeric
         for (p = 0 ; p < len ; p++)
         {
             /*X [Li [p]] -= Lx [p] * xj ; */
-            MULT_SUB (X [Li [p]], Lx [p], xj) ;
+            MULT_SUB (X [*Li++], *Lx++, xj) ;
         }
     }
 }
@@ -349,7 +354,8 @@ static void lsolve_numeric
 /* === lpivot =============================================================== */
 /* ========================================================================== */
 
-/* Find a pivot via partial pivoting, and scale the column of L. */
+/* Find a pivot via partial pivoting, and scale the column of L.  Only rows
+ * prow0 to prow1-1 are candidates (all rows, except in KLU_kernel_nd). */
 
 static Int lpivot
 (
@@ -363,16 +369,17 @@ static Int lpivot
     Int Lip [ ],
     Int Llen [ ],
     Int k,
-    Int n,
 
     Int Pinv [ ],       /* Pinv [i] = k if row i is kth pivot row, or EMPTY if
                          * row i is not yet pivotal.  */
 
     Int *p_firstrow,
+    Int prow0,          /* pivot rows are restricted to prow0..prow1-1 */
+    Int prow1,
     KLU_common *Common
 )
 {
-    Entry x, pivot, *Lx ;
+    Entry x, pivot, *Lx, *Lx2 ;
     double abs_pivot, xabs ;
     Int p, i, ppivrow, pdiag, pivrow, *Li, last_row_index, firstrow, len ;
 
@@ -384,7 +391,7 @@ static Int lpivot
         {
             return (FALSE) ;
         }
-        for (firstrow = *p_firstrow ; firstrow < n ; firstrow++)
+        for (firstrow = *p_firstrow ; firstrow < prow1 ; firstrow++)
         {
             PRINTF (("check %d\n", firstrow)) ;
             if (Pinv [firstrow] < 0)
@@ -395,7 +402,7 @@ static Int lpivot
                 break ;
             }
         }
-        ASSERT (pivrow >= 0 && pivrow < n) ;
+        ASSERT (pivrow >= prow0 && pivrow < prow1) ;
         CLEAR (pivot) ;
         *p_pivrow = pivrow ;
         *p_pivot = pivot ;
@@ -434,7 +441,7 @@ static Int lpivot
         }
 
         /* find the partial-pivoting choice */
-        if (xabs > abs_pivot)
+        if (xabs > abs_pivot && i >= prow0 && i < prow1)
         {
             abs_pivot = xabs ;
             ppivrow = p ;
@@ -443,11 +450,43 @@ static Int lpivot
 
     /* xabs = ABS (X [last_row_index]) ;*/
     ABS (xabs, X [last_row_index]) ;
-    if (xabs > abs_pivot)
+    if (xabs > abs_pivot && last_row_index >= prow0 && last_row_index < prow1)
     {
         abs_pivot = xabs ;
         ppivrow = EMPTY ;
     }
+    else if (abs_pivot < 0)
+    {
+        /* no row of the column is a candidate (only in KLU_kernel_nd): the
+         * block is structurally singular with the restricted pivots.  Put
+         * the last row back in the column of L, which is left unscaled, and
+         * pick the lowest-numbered candidate row that is not yet pivotal,
+         * with a zero pivot.  Lx moves up if the longer Li needs more
+         * Units, so it is copied from the end. */
+        Lx2 = (Entry *) (LU + Lip [k] + UNITS (Int, len+1)) ;
+        for (p = len-1 ; p >= 0 ; p--)
+        {
+            Lx2 [p] = Lx [p] ;
+        }
+        Li [len] = last_row_index ;
+        Lx2 [len] = X [last_row_index] ;
+        CLEAR (X [last_row_index]) ;
+        Llen [k] = len+1 ;
+        for (firstrow = *p_firstrow ; firstrow < prow1 ; firstrow++)
+        {
+            if (Pinv [firstrow] < 0)
+            {
+                break ;
+            }
+        }
+        ASSERT (firstrow >= prow0 && firstrow < prow1) ;
+        CLEAR (pivot) ;
+        *p_pivrow = firstrow ;
+        *p_pivot = pivot ;
+        *p_abs_pivot = 0 ;
+        *p_firstrow = firstrow ;
+        return (FALSE) ;
+    }
 
     /* compare the diagonal with the largest entry */
     if (last_row_index == diagrow)
@@ -488,7 +527,7 @@ static Int lpivot
     *p_pivrow = pivrow ;
     *p_pivot = pivot ;
     *p_abs_pivot = abs_pivot ;
-    ASSERT (pivrow >= 0 && pivrow < n) ;
+    ASSERT (pivrow >= prow0 && pivrow < prow1) ;
 
     if (IS_ZERO (pivot) && Common->halt_if_singular)
     {
@@ -834,7 +873,7 @@ size_t KLU_kernel   /* final size of LU on output */
         /* get the column of the matrix to factorize and scatter into X */
         /* ------------------------------------------------------------------ */
 
-        construct_column (k, Ap, Ai, Ax, Q, X,
+        Offp [k+k1+1] = construct_column (k, Ap, Ai, Ax, Q, X,
             k1, PSinv, Rs, scale, Offp, Offi, Offx) ;
 
         /* ------------------------------------------------------------------ */
@@ -868,7 +907,7 @@ size_t KLU_kernel   /* final size of LU on output */
 
         /* find a pivot and scale the pivot column */
         if (!lpivot (diagrow, &pivrow, &pivot, &abs_pivot, tol, X, LU, Lip,
-                    Llen, k, n, Pinv, &firstrow, Common))
+                    Llen, k, Pinv, &firstrow, 0, n, Common))
         {
             /* matrix is structurally or numerically singular */
             Common->status = KLU_SINGULAR ;
@@ -1008,3 +1047,708 @@ size_t KLU_kernel   /* final size of LU on output */
     *p_LU = LU ;
     return (newlusize) ;
 }
+
+
+/* ========================================================================== */
+/* === factor_columns ======================================================= */
+/* ========================================================================== */
+
+/* Factorizes columns kstart to kend-1 of the block, with the pivot rows
+ * restricted to prow0 to prow1-1.  This is the column loop of KLU_kernel,
+ * for KLU_kernel_nd, which calls it once for each independent subtree of a
+ * nested dissection, with the subtree's own LU array and workspace, and then
+ * once for the separators.  Offp [k1+kstart+1 ... k1+kend] must already be
+ * computed, since the subtrees are factorized concurrently.  lnz and unz are
+ * incremented.  Returns FALSE if the factorization must stop (out of memory,
+ * too large, or singular with Common->halt_if_singular true), TRUE otherwise.
+ */
+
+static Int factor_columns
+(
+    /* input, not modified */
+    Int kstart,     /* first column to factorize */
+    Int kend,       /* one past the last column to factorize */
+    Int prow0,      /* the pivot rows, and the rows of U (:,kstart:kend-1), */
+    Int prow1,      /* are restricted to prow0 to prow1-1 */
+    Int nextra,     /* max # of rows of L (:,kstart:kend-1) outside of
+                     * prow0 to prow1-1 */
+    Int n,          /* A is n-by-n */
+    Int Ap [ ],     /* size n+1, column pointers for A */
+    Int Ai [ ],     /* size nz = Ap [n], row indices for A */
+    Entry Ax [ ],   /* size nz, values of A */
+    Int Q [ ],      /* size n, optional input permutation */
+
+    /* input/output */
+    size_t *p_lusize,   /* size of LU */
+    Int *p_lup,         /* first free position in LU */
+    Int *p_firstrow,    /* no row before this is a non-pivotal candidate */
+    Unit **p_LU,        /* LU array, size *p_lusize */
+    Int Pinv [ ],       /* size n, inverse row permutation */
+    Int P [ ],          /* size n, row permutation */
+    Entry Udiag [ ],    /* size n, diagonal of U */
+    Int Llen [ ],       /* size n, column length of L */
+    Int Ulen [ ],       /* size n, column length of U */
+    Int Lip [ ],        /* size n, column pointers for L */
+    Int Uip [ ],        /* size n, column pointers for U */
+    Int *lnz,           /* size of L */
+    Int *unz,           /* size of U */
+
+    /* workspace, zero on input and output */
+    Entry X [ ],    /* size n */
+
+    /* workspace, not defined on input or output */
+    Int Stack [ ],  /* size n */
+    Int Flag [ ],   /* size n, Flag [i] != k for all k >= kstart on input */
+    Int Ap_pos [ ],     /* size n */
+    Int Lpend [ ],      /* size n, for pruning only */
+
+    /* inputs, not modified on output */
+    Int k1,             /* the block of A is from k1 to k2-1 */
+    Int PSinv [ ],      /* inverse of P from symbolic factorization */
+    double Rs [ ],      /* scale factors for A */
+
+    /* inputs, Offi and Offx modified on output */
+    Int Offp [ ],   /* off-diagonal matrix */
+    Int Offi [ ],
+    Entry Offx [ ],
+    /* --------------- */
+    KLU_common *Common
+)
+{
+    Entry pivot ;
+    double abs_pivot, xsize, nunits, tol, memgrow ;
+    Entry *Ux ;
+    Int *Ui ;
+    Unit *LU ;          /* LU factors (pattern and values) */
+    Int k, p, i, j, pivrow = 0, kbar, diagrow, firstrow, lup, top, scale, len,
+        nrows ;
+    size_t lusize, newlusize ;
+
+#ifndef NDEBUG
+    Entry *Lx ;
+    Int *Li ;
+#endif
+
+    scale = Common->scale ;
+    tol = Common->tol ;
+    memgrow = Common->memgrow ;
+    CLEAR (pivot) ;
+    LU = *p_LU ;
+    lusize = *p_lusize ;
+    lup = *p_lup ;
+    firstrow = *p_firstrow ;
+    nrows = prow1 - prow0 + nextra ;
+
+    for (k = kstart ; k < kend ; k++)
+    {
+
+        PRINTF (("\n\n==================================== k: %d\n", k)) ;
+
+        /* ------------------------------------------------------------------ */
+        /* determine if LU factors have grown too big */
+        /* ------------------------------------------------------------------ */
+
+        /* (prow1 - k + nextra) entries for L and (k - prow0) entries for U,
+         * which is (n - k) and k for the whole block */
+        nunits = DUNITS (Int, prow1 - k + nextra) + DUNITS (Int, k - prow0) +
+                 DUNITS (Entry, prow1 - k + nextra) + DUNITS (Entry, k - prow0);
+
+        /* LU can grow by at most 'nunits' entries if the column is dense */
+        PRINTF (("lup %d lusize %g lup+nunits: %g\n", lup, (double) lusize,
+            lup+nunits));
+        xsize = ((double) lup) + nunits ;
+        if (xsize > (double) lusize)
+        {
+            /* check here how much to grow */
+            xsize = (memgrow * ((double) lusize) + 4*nrows + 1) ;
+            if (INT_OVERFLOW (xsize))
+            {
+                PRINTF (("Matrix is too large (Int overflow)\n")) ;
+                Common->status = KLU_TOO_LARGE ;
+                *p_lusize = lusize ;
+                return (FALSE) ;
+            }
+            newlusize = memgrow * lusize + 2*nrows + 1 ;
+            /* Future work: retry mechanism in case of malloc failure */
+            LU = KLU_realloc (newlusize, lusize, sizeof (Unit), LU, Common) ;
+            Common->nrealloc++ ;
+            *p_LU = LU ;
+            if (Common->status == KLU_OUT_OF_MEMORY)
+            {
+                PRINTF (("Matrix is too large (LU)\n")) ;
+                *p_lusize = lusize ;
+                return (FALSE) ;
+            }
+            lusize = newlusize ;
+            PRINTF (("inc LU to %d done\n", lusize)) ;
+        }
+
+        /* ------------------------------------------------------------------ */
+        /* start the kth column of L and U */
+        /* ------------------------------------------------------------------ */
+
+        Lip [k] = lup ;
+
+        /* ------------------------------------------------------------------ */
+        /* compute the nonzero pattern of the kth column of L and U */
+        /* ------------------------------------------------------------------ */
+
+#ifndef NDEBUG
+        for (i = 0 ; i < n ; i++)
+        {
+            ASSERT (Flag [i] != k) ;
+            /* ASSERT (X [i] == 0) ; */
+            ASSERT (IS_ZERO (X [i])) ;
+        }
+#endif
+
+        top = lsolve_symbolic (n, k, Ap, Ai, Q, Pinv, Stack, Flag,
+                    Lpend, Ap_pos, LU, lup, Llen, Lip, k1, PSinv) ;
+
+#ifndef NDEBUG
+        PRINTF (("--- in U:\n")) ;
+        for (p = top ; p < n ; p++)
+        {
+            PRINTF (("pattern of X for U: %d : %d pivot row: %d\n",
+                p, Stack [p], Pinv [Stack [p]])) ;
+            ASSERT (Flag [Stack [p]] == k) ;
+        }
+        PRINTF (("--- in L:\n")) ;
+        Li = (Int *) (LU + Lip [k]);
+        for (p = 0 ; p < Llen [k] ; p++)
+        {
+            PRINTF (("pattern of X in L: %d : %d pivot row: %d\n",
+                p, Li [p], Pinv [Li [p]])) ;
+            ASSERT (Flag [Li [p]] == k) ;
+        }
+#endif
+
+        /* ------------------------------------------------------------------ */
+        /* get the column of the matrix to factorize and scatter into X */
+        /* ------------------------------------------------------------------ */
+
+        /* Offp [k+k1+1] is already known, so it is not set here */
+        construct_column (k, Ap, Ai, Ax, Q, X,
+            k1, PSinv, Rs, scale, Offp, Offi, Offx) ;
+
+        /* ------------------------------------------------------------------ */
+        /* compute the numerical values of the kth column (s = L \ A (:,k)) */
+        /* ------------------------------------------------------------------ */
+
+        lsolve_numeric (Pinv, LU, Stack, Lip, top, n, Llen, X) ;
+
+#ifndef NDEBUG
+        for (p = top ; p < n ; p++)
+        {
+            PRINTF (("X for U %d : ",  Stack [p])) ;
+            PRINT_ENTRY (X [Stack [p]]) ;
+        }
+        Li = (Int *) (LU + Lip [k]) ;
+        for (p = 0 ; p < Llen [k] ; p++)
+        {
+            PRINTF (("X for L %d : ", Li [p])) ;
+            PRINT_ENTRY (X [Li [p]]) ;
+        }
+#endif
+
+        /* ------------------------------------------------------------------ */
+        /* partial pivoting with diagonal preference */
+        /* ------------------------------------------------------------------ */
+
+        /* determine what the "diagonal" is */
+        diagrow = P [k] ;   /* might already be pivotal */
+        PRINTF (("k %d, diagrow = %d, UNFLIP (diagrow) = %d\n",
+            k, diagrow, UNFLIP (diagrow))) ;
+
+        /* find a pivot and scale the pivot column */
+        if (!lpivot (diagrow, &pivrow, &pivot, &abs_pivot, tol, X, LU, Lip,
+                    Llen, k, Pinv, &firstrow, prow0, prow1, Common))
+        {
+            /* matrix is structurally or numerically singular */
+            Common->status = KLU_SINGULAR ;
+            if (Common->numerical_rank == EMPTY)
+            {
+                Common->numerical_rank = k+k1 ;
+                Common->singular_col = Q [k+k1] ;
+            }
+            if (Common->halt_if_singular)
+            {
+                /* do not continue the factorization */
+                *p_lusize = lusize ;
+                return (FALSE) ;
+            }
+        }
+
+        /* we now have a valid pivot row, even if the column has NaN's or
+         * has no entries on or below the diagonal at all. */
+        PRINTF (("\nk %d : Pivot row %d : ", k, pivrow)) ;
+        PRINT_ENTRY (pivot) ;
+        ASSERT (pivrow >= prow0 && pivrow < prow1) ;
+        ASSERT (Pinv [pivrow] < 0) ;
+
+        /* set the Uip pointer */
+        Uip [k] = Lip [k] + UNITS (Int, Llen [k]) + UNITS (Entry, Llen [k]) ;
+
+        /* move the lup pointer to the position where indices of U
+         * should be stored */
+        lup += UNITS (Int, Llen [k]) + UNITS (Entry, Llen [k]) ;
+
+        Ulen [k] = n - top ;
+
+        /* extract Stack [top..n-1] to Ui and the values to Ux and clear X */
+        GET_POINTER (LU, Uip, Ulen, Ui, Ux, k, len) ;
+        for (p = top, i = 0 ; p < n ; p++, i++)
+        {
+            j = Stack [p] ;
+            Ui [i] = Pinv [j] ;
+            Ux [i] = X [j] ;
+            CLEAR (X [j]) ;
+        }
+
+        /* position the lu index at the starting point for next column */
+        lup += UNITS (Int, Ulen [k]) + UNITS (Entry, Ulen [k]) ;
+
+        /* U(k,k) = pivot */
+        Udiag [k] = pivot ;
+
+        /* ------------------------------------------------------------------ */
+        /* log the pivot permutation */
+        /* ------------------------------------------------------------------ */
+
+        ASSERT (UNFLIP (Pinv [diagrow]) < n) ;
+        ASSERT (P [UNFLIP (Pinv [diagrow])] == diagrow) ;
+
+        if (pivrow != diagrow)
+        {
+            /* an off-diagonal pivot has been chosen */
+            Common->noffdiag++ ;
+            PRINTF ((">>>>>>>>>>>>>>>>> pivrow %d k %d off-diagonal\n",
+                        pivrow, k)) ;
+            if (Pinv [diagrow] < 0)
+            {
+                /* the former diagonal row index, diagrow, has not yet been
+                 * chosen as a pivot row.  Log this diagrow as the "diagonal"
+                 * entry in the column kbar for which the chosen pivot row,
+                 * pivrow, was originally logged as the "diagonal" */
+                kbar = FLIP (Pinv [pivrow]) ;
+                P [kbar] = diagrow ;
+                Pinv [diagrow] = FLIP (kbar) ;
+            }
+        }
+        P [k] = pivrow ;
+        Pinv [pivrow] = k ;
+
+#ifndef NDEBUG
+        for (i = 0 ; i < n ; i++) { ASSERT (IS_ZERO (X [i])) ;}
+        GET_POINTER (LU, Uip, Ulen, Ui, Ux, k, len) ;
+        for (p = 0 ; p < len ; p++)
+        {
+            PRINTF (("Column %d of U: %d : ", k, Ui [p])) ;
+            PRINT_ENTRY (Ux [p]) ;
+        }
+        GET_POINTER (LU, Lip, Llen, Li, Lx, k, len) ;
+        for (p = 0 ; p < len ; p++)
+        {
+            PRINTF (("Column %d of L: %d : ", k, Li [p])) ;
+            PRINT_ENTRY (Lx [p]) ;
+        }
+#endif
+
+        /* ------------------------------------------------------------------ */
+        /* symmetric pruning */
+        /* ------------------------------------------------------------------ */
+
+        prune (Lpend, Pinv, k, pivrow, LU, Uip, Lip, Ulen, Llen) ;
+
+        *lnz += Llen [k] + 1 ; /* 1 added to lnz for diagonal */
+        *unz += Ulen [k] + 1 ; /* 1 added to unz for diagonal */
+    }
+
+    *p_lusize = lusize ;
+    *p_lup = lup ;
+    *p_firstrow = firstrow ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === finish_lu ============================================================ */
+/* ========================================================================== */
+
+/* Puts the row indices of L in the pivotal order, and shrinks the LU factors
+ * to just the required size.  Returns the new size of LU. */
+
+static size_t finish_lu
+(
+    Int n,
+    Int Pinv [ ],
+    Int Lip [ ],
+    Int Llen [ ],
+    Int lup,
+    size_t lusize,
+    Unit **p_LU,
+    KLU_common *Common
+)
+{
+    Int *Li ;
+    Unit *LU ;
+    Int p, i ;
+    size_t newlusize ;
+
+    LU = *p_LU ;
+    for (p = 0 ; p < n ; p++)
+    {
+        Li = (Int *) (LU + Lip [p]) ;
+        for (i = 0 ; i < Llen [p] ; i++)
+        {
+            Li [i] = Pinv [Li [i]] ;
+        }
+    }
+
+#ifndef NDEBUG
+    for (i = 0 ; i < n ; i++)
+    {
+        ASSERT (Pinv [i] >= 0 && Pinv [i] < n) ;
+    }
+#endif
+
+    newlusize = lup ;
+    ASSERT ((size_t) newlusize <= lusize) ;
+
+    /* this cannot fail, since the block is descreasing in size */
+    LU = KLU_realloc (newlusize, lusize, sizeof (Unit), LU, Common) ;
+    *p_LU = LU ;
+    return (newlusize) ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_kernel_nd ======================================================== */
+/* ========================================================================== */
+
+/* Factorizes a block that klu_analyze split by nested dissection (ordering 5)
+ * into independent subtrees, or domains, and the separators that follow them
+ * (see Symbolic->Domain).  A column of a domain has entries only in the rows
+ * of the domain and of the separators, so the domains are factorized
+ * independently, in parallel if KLU is compiled with OpenMP, each into an LU
+ * array of its own, and with its own workspace and its own copy of Common.
+ * The pivot rows of a domain are restricted to the rows of the domain, to
+ * keep them independent.  The LU arrays of the domains are then concatenated,
+ * and the separators are factorized last with no restriction on the pivots.
+ * The result is laid out exactly like the result of KLU_kernel_factor.
+ *
+ * Restricting the pivots gives up some stability for the parallelism.  KLU
+ * prefers the diagonal anyway (Common->tol), so this only matters when a
+ * diagonal entry of a domain is too small and the largest entry of its column
+ * is in a separator row.  Such a pivot is then kept instead.  If a column of
+ * a domain has no nonzero entry in the rows of the domain at all, the block
+ * is reported as singular (KLU_SINGULAR, with a zero pivot) even if
+ * unrestricted pivoting would have found a nonzero pivot in a separator row.
+ * Use another ordering for such matrices.
+ *
+ * Returns the size of LU, or 0 if an error occurred or if the matrix is
+ * singular and Common->halt_if_singular is true (*p_LU is then NULL). */
+
+size_t KLU_kernel_nd
+(
+    /* inputs, not modified */
+    Int n,          /* A is n-by-n. n must be > 0. */
+    Int Ap [ ],     /* size n+1, column pointers for A */
+    Int Ai [ ],     /* size nz = Ap [n], row indices for A */
+    Entry Ax [ ],   /* size nz, values of A */
+    Int Q [ ],      /* size n, optional column permutation */
+    double Lsize,   /* estimate of number of nonzeros in L */
+    Int Domain [ ], /* size n, Symbolic->Domain + k1 */
+
+    /* outputs, not defined on input */
+    Unit **p_LU,        /* row indices and values of L and U */
+    Entry Udiag [ ],    /* size n, diagonal of U */
+    Int Llen [ ],       /* size n, column length of L */
+    Int Ulen [ ],       /* size n, column length of U */
+    Int Lip [ ],        /* size n, column pointers for L */
+    Int Uip [ ],        /* size n, column pointers for U */
+    Int P [ ],          /* row permutation, size n */
+    Int *lnz,           /* size of L */
+    Int *unz,           /* size of U */
+
+    /* workspace, undefined on input */
+    Entry *X,       /* size n double's, zero on output */
+    Int *Work,      /* size 5n Int's */
+
+    /* inputs, not modified on output */
+    Int k1,             /* the block of A is from k1 to k2-1 */
+    Int PSinv [ ],      /* inverse of P from symbolic factorization */
+    double Rs [ ],      /* scale factors for A */
+
+    /* inputs, modified on output */
+    Int Offp [ ],   /* off-diagonal matrix (modified by this routine) */
+    Int Offi [ ],
+    Entry Offx [ ],
+    /* --------------- */
+    KLU_common *Common
+)
+{
+    KLU_common Dcommon ;
+    double dunits ;
+    Unit *LU, **Dlu ;
+    Entry *Tx ;
+    Int *Pinv, *Stack, *Flag, *Lpend, *Ap_pos, *Dstart, *Dlup, *Tw ;
+    size_t lusize, *Dsize ;
+    Int k, d, p, ndom, s0, poff, oldcol, nthreads, lup, firstrow, offset, ok ;
+
+    /* ---------------------------------------------------------------------- */
+    /* find the domains, and the start of the separators */
+    /* ---------------------------------------------------------------------- */
+
+    ndom = 0 ;
+    for (s0 = 0 ; s0 < n && Domain [s0] != EMPTY ; s0 = Domain [s0] - k1)
+    {
+        ndom++ ;
+    }
+    PRINTF (("KLU_kernel_nd: n %d, %d domains, separators %d\n", n, ndom,
+        n - s0)) ;
+
+    /* the initial size of LU, as in KLU_kernel_factor */
+    Lsize = (Lsize <= 0) ? (MAX (-Lsize, 1.0) * (Ap [n+k1] - Ap [k1]) + n)
+        : Lsize ;
+    Lsize = MAX (n+1, Lsize) ;
+    Lsize = MIN ((((double) n) * ((double) n) + ((double) n)) / 2., Lsize) ;
+    dunits = 2 * (DUNITS (Int, Lsize) + DUNITS (Entry, Lsize)) ;
+
+#ifdef _OPENMP
+    nthreads = MAX (1, MIN (omp_get_max_threads ( ), ndom)) ;
+#else
+    nthreads = 1 ;
+#endif
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate workspace */
+    /* ---------------------------------------------------------------------- */
+
+    *p_LU = (Unit *) NULL ;
+    Pinv = Work ;
+    Stack = Work + n ;
+    Flag = Work + 2*n ;
+    Lpend = Work + 3*n ;
+    Ap_pos = Work + 4*n ;
+
+    Dstart = KLU_malloc (3*ndom+1, sizeof (Int), Common) ;
+    Dsize = KLU_malloc (ndom, sizeof (size_t), Common) ;
+    Dlu = KLU_malloc (ndom, sizeof (Unit *), Common) ;
+    Tx = KLU_malloc (((size_t) n) * nthreads, sizeof (Entry), Common) ;
+    Tw = KLU_malloc (3 * ((size_t) n) * nthreads, sizeof (Int), Common) ;
+    if (Common->status < KLU_OK)
+    {
+        KLU_free (Dstart, 3*ndom+1, sizeof (Int), Common) ;
+        KLU_free (Dsize, ndom, sizeof (size_t), Common) ;
+        KLU_free (Dlu, ndom, sizeof (Unit *), Common) ;
+        KLU_free (Tx, ((size_t) n) * nthreads, sizeof (Entry), Common) ;
+        KLU_free (Tw, 3 * ((size_t) n) * nthreads, sizeof (Int), Common) ;
+        Common->status = KLU_OUT_OF_MEMORY ;
+        return (0) ;
+    }
+    Dlup = Dstart + ndom + 1 ;      /* size ndom, lup of each domain */
+
+    /* ---------------------------------------------------------------------- */
+    /* initializations */
+    /* ---------------------------------------------------------------------- */
+
+    *lnz = 0 ;
+    *unz = 0 ;
+    for (k = 0 ; k < n ; k++)
+    {
+        CLEAR (X [k]) ;
+        Flag [k] = EMPTY ;
+        Lpend [k] = EMPTY ;
+        P [k] = k ;
+        Pinv [k] = FLIP (k) ;
+    }
+    for (k = 0 ; k < n * nthreads ; k++)
+    {
+        CLEAR (Tx [k]) ;
+    }
+    for (k = 0 ; k < 3 * n * nthreads ; k++)
+    {
+        Tw [k] = EMPTY ;
+    }
+    for (d = 0, k = 0 ; d < ndom ; d++)
+    {
+        Dstart [d] = k ;
+        Dlu [d] = NULL ;
+        Dsize [d] = 0 ;
+        Dlup [d] = 0 ;
+        k = Domain [k] - k1 ;
+    }
+    Dstart [ndom] = s0 ;
+
+    /* the domains write their off-diagonal entries concurrently, so the
+     * column pointers of the off-diagonal part are computed first */
+    for (k = 0 ; k < n ; k++)
+    {
+        poff = Offp [k+k1] ;
+        oldcol = Q [k+k1] ;
+        for (p = Ap [oldcol] ; p < Ap [oldcol+1] ; p++)
+        {
+            if (PSinv [Ai [p]] < k1)
+            {
+                poff++ ;
+            }
+        }
+        Offp [k+k1+1] = poff ;
+    }
+
+    /* each domain starts with a copy of Common with no statistics */
+    Dcommon = *Common ;
+    Dcommon.status = KLU_OK ;
+    Dcommon.nrealloc = 0 ;
+    Dcommon.noffdiag = 0 ;
+    Dcommon.numerical_rank = EMPTY ;
+    Dcommon.singular_col = EMPTY ;
+    Dcommon.memusage = 0 ;
+    Dcommon.mempeak = 0 ;
+
+    /* ---------------------------------------------------------------------- */
+    /* factorize the domains */
+    /* ---------------------------------------------------------------------- */
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+#endif
+    for (d = 0 ; d < ndom ; d++)
+    {
+        KLU_common DC ;
+        Entry *Xt ;
+        Int *Tt, t, c0, c1, dlup, dfirst, dlnz, dunz ;
+        size_t dsize ;
+
+#ifdef _OPENMP
+        t = omp_get_thread_num ( ) ;
+#else
+        t = 0 ;
+#endif
+        Xt = Tx + ((size_t) n) * t ;
+        Tt = Tw + 3 * ((size_t) n) * t ;
+        DC = Dcommon ;
+        c0 = Dstart [d] ;
+        c1 = Dstart [d+1] ;
+        dlup = 0 ;
+        dfirst = c0 ;
+        dlnz = 0 ;
+        dunz = 0 ;
+
+        /* the share of the estimate for this domain */
+        dsize = (size_t) (dunits * (c1 - c0) / n) + 4*(c1 - c0 + n - s0) + 1 ;
+        Dlu [d] = KLU_malloc (dsize, sizeof (Unit), &DC) ;
+        if (Dlu [d] != NULL)
+        {
+            factor_columns (c0, c1, c0, c1, n - s0, n, Ap, Ai, Ax, Q,
+                &dsize, &dlup, &dfirst, &Dlu [d], Pinv, P, Udiag, Llen, Ulen,
+                Lip, Uip, &dlnz, &dunz, Xt, Tt, Tt + n, Tt + 2*n, Lpend,
+                k1, PSinv, Rs, Offp, Offi, Offx, &DC) ;
+        }
+        Dsize [d] = dsize ;
+        Dlup [d] = dlup ;
+
+#ifdef _OPENMP
+        #pragma omp critical (klu_kernel_nd)
+#endif
+        {
+            if (DC.status < KLU_OK)
+            {
+                Common->status = DC.status ;
+            }
+            else if (DC.status == KLU_SINGULAR && Common->status == KLU_OK)
+            {
+                Common->status = KLU_SINGULAR ;
+            }
+            if (DC.numerical_rank != EMPTY && (Common->numerical_rank == EMPTY
+                || DC.numerical_rank < Common->numerical_rank))
+            {
+                Common->numerical_rank = DC.numerical_rank ;
+                Common->singular_col = DC.singular_col ;
+            }
+            Common->nrealloc += DC.nrealloc ;
+            Common->noffdiag += DC.noffdiag ;
+            Common->memusage += DC.memusage ;
+            Common->mempeak = MAX (Common->mempeak, Common->memusage) ;
+            *lnz += dlnz ;
+            *unz += dunz ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* concatenate the LU factors of the domains */
+    /* ---------------------------------------------------------------------- */
+
+    ok = (Common->status == KLU_OK || (Common->status == KLU_SINGULAR
+        && !Common->halt_if_singular)) ;
+    LU = NULL ;
+    lup = 0 ;
+    lusize = 0 ;
+    if (ok)
+    {
+        for (d = 0 ; d < ndom ; d++)
+        {
+            lup += Dlup [d] ;
+        }
+        lusize = MAX (dunits, lup + 2*(n - s0) + 1) ;
+        LU = KLU_malloc (lusize, sizeof (Unit), Common) ;
+        ok = (LU != NULL) ;
+    }
+    offset = 0 ;
+    for (d = 0 ; d < ndom ; d++)
+    {
+        if (ok)
+        {
+            for (p = 0 ; p < Dlup [d] ; p++)
+            {
+                LU [offset + p] = Dlu [d][p] ;
+            }
+            for (k = Dstart [d] ; k < Dstart [d+1] ; k++)
+            {
+                Lip [k] += offset ;
+                Uip [k] += offset ;
+            }
+            offset += Dlup [d] ;
+        }
+        KLU_free (Dlu [d], Dsize [d], sizeof (Unit), Common) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* factorize the separators */
+    /* ---------------------------------------------------------------------- */
+
+    if (ok)
+    {
+        firstrow = 0 ;
+        ok = factor_columns (s0, n, 0, n, 0, n, Ap, Ai, Ax, Q,
+            &lusize, &lup, &firstrow, &LU, Pinv, P, Udiag, Llen, Ulen, Lip,
+            Uip, lnz, unz, X, Stack, Flag, Ap_pos, Lpend, k1, PSinv, Rs, Offp,
+            Offi, Offx, Common) ;
+    }
+    if (ok)
+    {
+        lusize = finish_lu (n, Pinv, Lip, Llen, lup, lusize, &LU, Common) ;
+    }
+    else
+    {
+        LU = KLU_free (LU, lusize, sizeof (Unit), Common) ;
+        lusize = 0 ;
+        if (Common->status == KLU_OK)
+        {
+            Common->status = KLU_OUT_OF_MEMORY ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* free workspace */
+    /* ---------------------------------------------------------------------- */
+
+    KLU_free (Dstart, 3*ndom+1, sizeof (Int), Common) ;
+    KLU_free (Dsize, ndom, sizeof (size_t), Common) ;
+    KLU_free (Dlu, ndom, sizeof (Unit *), Common) ;
+    KLU_free (Tx, ((size_t) n) * nthreads, sizeof (Entry), Common) ;
+    KLU_free (Tw, 3 * ((size_t) n) * nthreads, sizeof (Int), Common) ;
+    *p_LU = LU ;
+    return (lusize) ;
+}
@@ -0,0 +1,362 @@
+/* ========================================================================== */
+/* === KLU_monitor ========================================================== */
+/* ========================================================================== */
+
+/* Incremental condition and pivot growth monitor.  If Common->monitor is TRUE,
+ * klu_factor, klu_refactor, klu_partial_factorization_path and
+ * klu_partial_refactorization_restart leave in Common->rcond and
+ * Common->rgrowth the same values klu_rcond and klu_rgrowth would compute,
+ * and set Common->monitor_flag if one of them crosses its threshold.  The
+ * caller can then run klu_condest, or refactorize with pivoting, only when
+ * the flag is raised.
+ *
+ * Both estimates are reductions over the columns of the factors:
+ *
+ *      rcond   = min (abs (Udiag)) / max (abs (Udiag))
+ *      rgrowth = min over j of max (abs (A (:,j))) / max (abs (U (:,j)))
+ *
+ * (see KLU_rgrowth for the details of the second).  Numeric->Monitor keeps a
+ * tournament tree for each of the three reductions: min and max of
+ * abs (Udiag), and min of the column growth.  A full (re)factorization
+ * rebuilds the trees in O(|A|+|U|) time, the same cost as klu_rgrowth.  A
+ * partial refactorization only touches the columns on the factorization path,
+ * so only their leaves are recomputed, and each one is propagated to the root
+ * in O(log n) time.  The partial refactorizations do not call malloc; the
+ * trees are allocated by klu_factor, or by klu_refactor if Common->monitor
+ * was set afterwards.
+ */
+
+#include "klu_internal.h"
+
+/* ========================================================================== */
+/* === tree_set ============================================================= */
+/* ========================================================================== */
+
+/* Set leaf k of a tree of n leaves and update its ancestors.  The leaves are
+ * T [n ... 2n-1], the parent of node i is i/2, and the root is T [1].  This
+ * works for any n, not just powers of two. */
+
+static void tree_set (double *T, Int n, Int k, double x, Int is_min)
+{
+    double a, b ;
+    Int i ;
+    i = n + k ;
+    T [i] = x ;
+    for (i = i / 2 ; i >= 1 ; i = i / 2)
+    {
+        a = T [2*i] ;
+        b = T [2*i+1] ;
+        T [i] = is_min ? MIN (a, b) : MAX (a, b) ;
+    }
+}
+
+/* compute all internal nodes from the leaves */
+static void tree_build (double *T, Int n, Int is_min)
+{
+    double a, b ;
+    Int i ;
+    for (i = n-1 ; i >= 1 ; i--)
+    {
+        a = T [2*i] ;
+        b = T [2*i+1] ;
+        T [i] = is_min ? MIN (a, b) : MAX (a, b) ;
+    }
+}
+
+/* ========================================================================== */
+/* === column_growth ======================================================== */
+/* ========================================================================== */
+
+/* The reciprocal pivot growth of column k of a block that starts at column
+ * k1, as in KLU_rgrowth: max (abs (A (:,k))) / max (abs (U (:,k))), taken as 1
+ * if larger, for a singleton, or if U (:,k) is zero.  NaN's are ignored. */
+
+static double column_growth
+(
+    Int k,
+    Int k1,
+    Int nk,
+    Unit *LU,
+    Int Ap [ ],
+    Int Ai [ ],
+    Entry Az [ ],
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric
+)
+{
+    double temp, max_ai, max_ui, *Rs ;
+    Entry aik, *Ux ;
+    Int *Uip, *Ulen, *Pinv ;
+    Int p, pend, oldcol, oldrow, newrow, len ;
+
+    if (nk == 1)
+    {
+        return (1) ;    /* skip singleton blocks */
+    }
+    Pinv = Numeric->Pinv ;
+    Rs = Numeric->Rs ;
+
+    max_ai = 0 ;
+    oldcol = Symbolic->Q [k] ;
+    pend = Ap [oldcol + 1] ;
+    for (p = Ap [oldcol] ; p < pend ; p++)
+    {
+        oldrow = Ai [p] ;
+        newrow = Pinv [oldrow] ;
+        if (newrow < k1)
+        {
+            continue ;  /* skip entry outside the block */
+        }
+        if (Rs != NULL)
+        {
+            /* aik = Az [p] / Rs [newrow] */
+            SCALE_DIV_ASSIGN (aik, Az [p], Rs [newrow]) ;
+        }
+        else
+        {
+            aik = Az [p] ;
+        }
+        ABS (temp, aik) ;
+        if (temp > max_ai)
+        {
+            max_ai = temp ;
+        }
+    }
+
+    max_ui = 0 ;
+    Uip = Numeric->Uip + k1 ;
+    Ulen = Numeric->Ulen + k1 ;
+    GET_X_POINTER (LU, Uip, Ulen, Ux, k - k1) ;
+    len = Ulen [k - k1] ;
+    for (p = 0 ; p < len ; p++)
+    {
+        ABS (temp, Ux [p]) ;
+        if (temp > max_ui)
+        {
+            max_ui = temp ;
+        }
+    }
+    ABS (temp, ((Entry *) Numeric->Udiag) [k]) ;
+    if (temp > max_ui)
+    {
+        max_ui = temp ;
+    }
+
+    if (SCALAR_IS_ZERO (max_ui))
+    {
+        return (1) ;
+    }
+    temp = max_ai / max_ui ;
+    return ((temp < 1) ? temp : 1) ;
+}
+
+
+/* ========================================================================== */
+/* === set_column =========================================================== */
+/* ========================================================================== */
+
+/* Recompute the leaves of column k.  If update is TRUE, the ancestors of the
+ * leaves are updated too; otherwise the caller rebuilds the trees. */
+
+static void set_column
+(
+    Int k,
+    Int k1,
+    Int nk,
+    Unit *LU,
+    Int Ap [ ],
+    Int Ai [ ],
+    Entry Az [ ],
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    Int update
+)
+{
+    double *Umin, *Umax, *Grow, ukk, g ;
+    Int n ;
+
+    n = Numeric->n ;
+    Umin = Numeric->Monitor ;
+    Umax = Umin + 2*n ;
+    Grow = Umin + 4*n ;
+
+    /* a zero or NaN pivot makes rcond zero, as in KLU_rcond */
+    ABS (ukk, ((Entry *) Numeric->Udiag) [k]) ;
+    if (SCALAR_IS_NAN (ukk))
+    {
+        ukk = 0 ;
+    }
+    g = column_growth (k, k1, nk, LU, Ap, Ai, Az, Symbolic, Numeric) ;
+
+    if (update)
+    {
+        tree_set (Umin, n, k, ukk, TRUE) ;
+        tree_set (Umax, n, k, ukk, FALSE) ;
+        tree_set (Grow, n, k, g, TRUE) ;
+    }
+    else
+    {
+        Umin [n+k] = ukk ;
+        Umax [n+k] = ukk ;
+        Grow [n+k] = g ;
+    }
+}
+
+
+/* ========================================================================== */
+/* === monitor_flag ========================================================= */
+/* ========================================================================== */
+
+/* Read the estimates at the roots of the trees, and raise the flag */
+
+static void monitor_flag
+(
+    KLU_numeric *Numeric,
+    KLU_common *Common
+)
+{
+    double *Umin, *Umax, rcond ;
+    Int n ;
+
+    n = Numeric->n ;
+    Umin = Numeric->Monitor ;
+    Umax = Umin + 2*n ;
+
+    rcond = 0 ;
+    if (n > 0 && !SCALAR_IS_ZERO (Umin [1]))
+    {
+        rcond = Umin [1] / Umax [1] ;
+        if (SCALAR_IS_NAN (rcond))
+        {
+            /* Inf/Inf */
+            rcond = 0 ;
+        }
+    }
+    Common->rcond = rcond ;
+    Common->rgrowth = (n > 0) ? Umin [4*n+1] : 1 ;
+
+    Common->monitor_flag = 0 ;
+    if (Common->rcond < Common->monitor_rcond_tol)
+    {
+        Common->monitor_flag |= KLU_MONITOR_RCOND ;
+    }
+    if (Common->rgrowth < Common->monitor_rgrowth_tol)
+    {
+        Common->monitor_flag |= KLU_MONITOR_RGROWTH ;
+    }
+}
+
+
+/* ========================================================================== */
+/* === KLU_monitor_all ====================================================== */
+/* ========================================================================== */
+
+/* Rebuild the monitor after a full factorization or refactorization.
+ * Allocates Numeric->Monitor if needed.  Returns FALSE if out of memory. */
+
+Int KLU_monitor_all
+(
+    Int Ap [ ],
+    Int Ai [ ],
+    double Ax [ ],
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    KLU_common *Common
+)
+{
+    double *Umin ;
+    Int n, block, k, k1, k2 ;
+
+    n = Numeric->n ;
+    if (Numeric->Monitor == NULL)
+    {
+        Numeric->Monitor = KLU_malloc (6*n, sizeof (double), Common) ;
+        if (Common->status < KLU_OK)
+        {
+            Common->status = KLU_OUT_OF_MEMORY ;
+            return (FALSE) ;
+        }
+    }
+    Umin = Numeric->Monitor ;
+
+    for (block = 0 ; block < Symbolic->nblocks ; block++)
+    {
+        k1 = Symbolic->R [block] ;
+        k2 = Symbolic->R [block+1] ;
+        for (k = k1 ; k < k2 ; k++)
+        {
+            set_column (k, k1, k2-k1, (Unit *) Numeric->LUbx [block], Ap, Ai,
+                (Entry *) Ax, Symbolic, Numeric, FALSE) ;
+        }
+    }
+    tree_build (Umin, n, TRUE) ;
+    tree_build (Umin + 2*n, n, FALSE) ;
+    tree_build (Umin + 4*n, n, TRUE) ;
+
+    monitor_flag (Numeric, Common) ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_monitor_path ===================================================== */
+/* ========================================================================== */
+
+/* Update the monitor after a partial refactorization, for the columns it
+ * recomputed: the factorization path of each variable block, or, if restart
+ * is TRUE, the columns from the restart point Numeric->block_path [block] to
+ * the end of the block.  Does nothing if the monitor was never built. */
+
+void KLU_monitor_path
+(
+    Int Ap [ ],
+    Int Ai [ ],
+    double Ax [ ],
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    Int restart,
+    KLU_common *Common
+)
+{
+    Unit *LU ;
+    Int vb, block, k, k1, k2, nk, z, kstart ;
+
+    if (Numeric->Monitor == NULL)
+    {
+        return ;
+    }
+
+    for (vb = 0 ; vb < Numeric->n_variable_blocks ; vb++)
+    {
+        block = Numeric->variable_block [vb] ;
+        k1 = Symbolic->R [block] ;
+        k2 = Symbolic->R [block+1] ;
+        nk = k2 - k1 ;
+        LU = (Unit *) Numeric->LUbx [block] ;
+        if (nk == 1)
+        {
+            set_column (k1, k1, 1, LU, Ap, Ai, (Entry *) Ax, Symbolic, Numeric,
+                TRUE) ;
+        }
+        else if (restart)
+        {
+            kstart = Numeric->block_path [block] ;
+            for (k = kstart ; k < k2 ; k++)
+            {
+                set_column (k, k1, nk, LU, Ap, Ai, (Entry *) Ax, Symbolic,
+                    Numeric, TRUE) ;
+            }
+        }
+        else
+        {
+            for (z = Numeric->block_path [block] ;
+                 z < Numeric->block_path [block+1] ; z++)
+            {
+                set_column (Numeric->path [z], k1, nk, LU, Ap, Ai,
+                    (Entry *) Ax, Symbolic, Numeric, TRUE) ;
+            }
+        }
+    }
+
+    monitor_flag (Numeric, Common) ;
+}
@@ -0,0 +1,428 @@
+/* ========================================================================== */
+/* === KLU_nd_order ========================================================= */
+/* ========================================================================== */
+
+/* Orders one diagonal block C with nested dissection, and splits it into
+ * independent subtrees, or domains, for a parallel factorization (ordering 5,
+ * see KLU_kernel_nd).
+ *
+ * The pattern of C+C' is ordered with METIS_NodeND.  The elimination tree of
+ * C+C' in that order is then split from the top: the largest subtree still
+ * left loses its root to the separators, and its children become subtrees of
+ * their own.  This stops when the largest subtree holds no more than
+ * 1/Common->nd_domains of the columns that are left, or when the separators
+ * would hold half of the block.  Two subtrees have no edge between them in
+ * C+C', so the columns of one never update the columns of another, and the
+ * subtrees are grouped into about Common->nd_domains domains of similar size.
+ *
+ * The domains are then ordered one after the other, each in postorder, and
+ * followed by the separators, in postorder.  This is a topological order of
+ * the elimination tree, so nnz(L) is the same as that of the METIS ordering.
+ * On output, Dom [k] is one past the last column of the domain of column k,
+ * or EMPTY for the separators.  Dom is all EMPTY if the block has fewer than
+ * two domains.
+ *
+ * If KLU is compiled with -DNPARTITION, METIS is not available and AMD is
+ * used instead.  The elimination tree of an AMD ordering is usually less
+ * balanced, but the domains are found the same way.
+ *
+ * Returns TRUE if successful, FALSE if out of memory.
+ */
+
+#include "klu_internal.h"
+#ifndef NPARTITION
+#include "metis.h"
+#endif
+
+Int KLU_nd_order
+(
+    /* inputs, not modified */
+    Int nk,             /* C is nk-by-nk */
+    Int Cp [ ],         /* size nk+1, column pointers of C */
+    Int Ci [ ],         /* size Cp [nk], row indices of C */
+
+    /* outputs, not defined on input */
+    Int Pblk [ ],       /* size nk, fill-reducing ordering of C */
+    Int Dom [ ],        /* size nk, the domain of each column */
+    double *lnz,        /* nz in L, including the diagonal */
+    double *flops,      /* flop count of the factorization */
+
+    /* --------------- */
+    KLU_common *Common
+)
+{
+    Int *W, *Sp, *Si, *Pinv, *Parent, *Ancestor, *Size, *Head, *Next, *Cand,
+        *Post, *Pnew ;
+    Int i, j, k, p, pend, nz, snz, ncand, nsep, best, left, ndom, target,
+        gsize, c0, r, child, ok ;
+    size_t wlen ;
+#ifndef NPARTITION
+    idx_t *Mp, *Mi, *Mperm, *Miperm, nn ;
+    int result ;
+#else
+    double amd_Info [AMD_INFO] ;
+#endif
+
+    nz = Cp [nk] ;
+    wlen = 11 * ((size_t) nk) + 1 + 2 * ((size_t) nz) ;
+    W = KLU_malloc (wlen, sizeof (Int), Common) ;
+    if (W == NULL)
+    {
+        return (FALSE) ;
+    }
+    Sp       = W ;                  /* size nk+1 */
+    Pinv     = W + nk + 1 ;
+    Parent   = W + 2*nk + 1 ;
+    Ancestor = W + 3*nk + 1 ;
+    Size     = W + 4*nk + 1 ;
+    Head     = W + 5*nk + 1 ;
+    Next     = W + 6*nk + 1 ;
+    Cand     = W + 7*nk + 1 ;
+    Post     = W + 8*nk + 1 ;
+    Pnew     = W + 9*nk + 1 ;
+    Si       = W + 10*nk + 1 ;      /* size 2*nz */
+
+    /* ---------------------------------------------------------------------- */
+    /* construct the pattern of C+C', without the diagonal or duplicates */
+    /* ---------------------------------------------------------------------- */
+
+    for (k = 0 ; k <= nk ; k++)
+    {
+        Sp [k] = 0 ;
+    }
+    for (j = 0 ; j < nk ; j++)
+    {
+        for (p = Cp [j] ; p < Cp [j+1] ; p++)
+        {
+            i = Ci [p] ;
+            if (i != j)
+            {
+                Sp [i+1]++ ;
+                Sp [j+1]++ ;
+            }
+        }
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        Sp [k+1] += Sp [k] ;
+        Head [k] = Sp [k] ;
+    }
+    for (j = 0 ; j < nk ; j++)
+    {
+        for (p = Cp [j] ; p < Cp [j+1] ; p++)
+        {
+            i = Ci [p] ;
+            if (i != j)
+            {
+                Si [Head [i]++] = j ;
+                Si [Head [j]++] = i ;
+            }
+        }
+    }
+
+    /* remove duplicates, using Pinv as the mark */
+    for (k = 0 ; k < nk ; k++)
+    {
+        Pinv [k] = EMPTY ;
+    }
+    snz = 0 ;
+    for (j = 0 ; j < nk ; j++)
+    {
+        p = Sp [j] ;
+        pend = Sp [j+1] ;
+        Sp [j] = snz ;
+        for ( ; p < pend ; p++)
+        {
+            i = Si [p] ;
+            if (Pinv [i] != j)
+            {
+                Pinv [i] = j ;
+                Si [snz++] = i ;
+            }
+        }
+    }
+    Sp [nk] = snz ;
+
+    /* ---------------------------------------------------------------------- */
+    /* order C+C' */
+    /* ---------------------------------------------------------------------- */
+
+    ok = TRUE ;
+    if (snz == 0)
+    {
+        /* no off-diagonal entries: METIS fails in this case, and any order
+         * is as good as another */
+        for (k = 0 ; k < nk ; k++)
+        {
+            Pblk [k] = k ;
+        }
+    }
+    else
+    {
+#ifndef NPARTITION
+        Mp = KLU_malloc (nk+1, sizeof (idx_t), Common) ;
+        Mi = KLU_malloc (snz, sizeof (idx_t), Common) ;
+        Mperm = KLU_malloc (nk, sizeof (idx_t), Common) ;
+        Miperm = KLU_malloc (nk, sizeof (idx_t), Common) ;
+        ok = (Common->status == KLU_OK) ;
+        if (ok)
+        {
+            for (k = 0 ; k <= nk ; k++)
+            {
+                Mp [k] = Sp [k] ;
+            }
+            for (p = 0 ; p < snz ; p++)
+            {
+                Mi [p] = Si [p] ;
+            }
+            nn = nk ;
+            result = METIS_NodeND (&nn, Mp, Mi, NULL, NULL, Mperm, Miperm) ;
+            ok = (result == METIS_OK) ;
+            if (ok)
+            {
+                for (k = 0 ; k < nk ; k++)
+                {
+                    Pblk [k] = (Int) Mperm [k] ;
+                }
+            }
+            else if (result == METIS_ERROR_MEMORY)
+            {
+                Common->status = KLU_OUT_OF_MEMORY ;
+            }
+            else
+            {
+                Common->status = KLU_INVALID ;
+            }
+        }
+        KLU_free (Mp, nk+1, sizeof (idx_t), Common) ;
+        KLU_free (Mi, snz, sizeof (idx_t), Common) ;
+        KLU_free (Mperm, nk, sizeof (idx_t), Common) ;
+        KLU_free (Miperm, nk, sizeof (idx_t), Common) ;
+#else
+        ok = (AMD_order (nk, Cp, Ci, Pblk, NULL, amd_Info) >= AMD_OK) ;
+        Common->mempeak = MAX (Common->mempeak,
+            Common->memusage + amd_Info [AMD_MEMORY]) ;
+        if (!ok)
+        {
+            Common->status = KLU_OUT_OF_MEMORY ;
+        }
+#endif
+    }
+    if (!ok)
+    {
+        KLU_free (W, wlen, sizeof (Int), Common) ;
+        return (FALSE) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* elimination tree of C+C' in the new order */
+    /* ---------------------------------------------------------------------- */
+
+    for (k = 0 ; k < nk ; k++)
+    {
+        Pinv [Pblk [k]] = k ;
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        Parent [k] = EMPTY ;
+        Ancestor [k] = EMPTY ;
+        j = Pblk [k] ;
+        for (p = Sp [j] ; p < Sp [j+1] ; p++)
+        {
+            /* traverse from Pinv [Si [p]] up to the root, with path
+             * compression */
+            for (i = Pinv [Si [p]] ; i != EMPTY && i < k ; i = r)
+            {
+                r = Ancestor [i] ;
+                Ancestor [i] = k ;
+                if (r == EMPTY)
+                {
+                    Parent [i] = k ;
+                }
+            }
+        }
+    }
+
+    /* subtree sizes, and the children of each node (in increasing order) */
+    for (k = 0 ; k < nk ; k++)
+    {
+        Size [k] = 1 ;
+        Head [k] = EMPTY ;
+    }
+    for (k = nk-1 ; k >= 0 ; k--)
+    {
+        if (Parent [k] != EMPTY)
+        {
+            Next [k] = Head [Parent [k]] ;
+            Head [Parent [k]] = k ;
+        }
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        if (Parent [k] != EMPTY)
+        {
+            Size [Parent [k]] += Size [k] ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* split the tree from the top */
+    /* ---------------------------------------------------------------------- */
+
+    /* the roots are the first candidates.  Ancestor [k] is now TRUE if k is a
+     * separator. */
+    ncand = 0 ;
+    for (k = 0 ; k < nk ; k++)
+    {
+        Ancestor [k] = FALSE ;
+        if (Parent [k] == EMPTY)
+        {
+            Cand [ncand++] = k ;
+        }
+    }
+    nsep = 0 ;
+    for ( ; ; )
+    {
+        best = 0 ;
+        for (i = 1 ; i < ncand ; i++)
+        {
+            if (Size [Cand [i]] > Size [Cand [best]])
+            {
+                best = i ;
+            }
+        }
+        left = nk - nsep ;
+        if (ncand == 0 || Size [Cand [best]] <= 1
+            || Size [Cand [best]] * (double) Common->nd_domains <= left
+            || 2 * (nsep + 1) > nk)
+        {
+            break ;
+        }
+        /* the root of the largest subtree becomes a separator */
+        k = Cand [best] ;
+        Cand [best] = Cand [--ncand] ;
+        Ancestor [k] = TRUE ;
+        nsep++ ;
+        for (child = Head [k] ; child != EMPTY ; child = Next [child])
+        {
+            Cand [ncand++] = child ;
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* postorder, with the separators last */
+    /* ---------------------------------------------------------------------- */
+
+    /* Post [0..nk-nsep-1] are the domains, and Post [nk-nsep..nk-1] the
+     * separators.  A node is visited after its children, and the children in
+     * increasing order, so each subtree is contiguous. */
+    c0 = 0 ;
+    r = nk - nsep ;
+    for (k = 0 ; k < nk ; k++)
+    {
+        if (Parent [k] != EMPTY)
+        {
+            continue ;
+        }
+        /* depth-first search from the root k, using Cand as the stack */
+        j = 0 ;
+        Cand [0] = k ;
+        Pnew [k] = Head [k] ;           /* next child to visit */
+        while (j >= 0)
+        {
+            i = Cand [j] ;
+            child = Pnew [i] ;
+            if (child != EMPTY)
+            {
+                Pnew [i] = Next [child] ;
+                Pnew [child] = Head [child] ;
+                Cand [++j] = child ;
+            }
+            else
+            {
+                j-- ;
+                if (Ancestor [i])
+                {
+                    Post [r++] = i ;
+                }
+                else
+                {
+                    Post [c0++] = i ;
+                }
+            }
+        }
+    }
+    ASSERT (c0 == nk - nsep && r == nk) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* group the subtrees into domains */
+    /* ---------------------------------------------------------------------- */
+
+    /* a subtree ends at its root, which is a node whose parent is a separator
+     * or a root of the tree */
+    for (k = 0 ; k < nk ; k++)
+    {
+        Dom [k] = EMPTY ;
+    }
+    left = nk - nsep ;
+    target = MAX (1, left / MAX (1, Common->nd_domains)) ;
+    ndom = 0 ;
+    gsize = 0 ;
+    c0 = 0 ;
+    for (k = 0 ; k < left && nsep > 0 ; k++)
+    {
+        i = Post [k] ;
+        gsize++ ;
+        if (gsize >= target && (Parent [i] == EMPTY || Ancestor [Parent [i]]))
+        {
+            for (j = c0 ; j <= k ; j++)
+            {
+                Dom [j] = k+1 ;
+            }
+            ndom++ ;
+            c0 = k+1 ;
+            gsize = 0 ;
+        }
+    }
+    if (gsize > 0 && ndom > 0)
+    {
+        /* the last subtrees join the last domain */
+        for (j = c0 ; j < left ; j++)
+        {
+            Dom [j] = left ;
+        }
+        for (j = c0-1 ; j >= 0 && Dom [j] == c0 ; j--)
+        {
+            Dom [j] = left ;
+        }
+    }
+    if (ndom < 2)
+    {
+        for (k = 0 ; k < nk ; k++)
+        {
+            Dom [k] = EMPTY ;
+        }
+    }
+
+    /* combine the orderings */
+    for (k = 0 ; k < nk ; k++)
+    {
+        Pnew [k] = Pblk [Post [k]] ;
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        Pblk [k] = Pnew [k] ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* nnz(L) and the flop count */
+    /* ---------------------------------------------------------------------- */
+
+    ok = KLU_path_estimate (nk, Cp, Ci, Pblk, NULL, lnz, flops, NULL, NULL, W);
+    KLU_free (W, wlen, sizeof (Int), Common) ;
+    if (!ok)
+    {
+        Common->status = KLU_INVALID ;
+    }
+    return (ok) ;
+}
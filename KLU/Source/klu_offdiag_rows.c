@@ -0,0 +1,197 @@
+/* ========================================================================== */
+/* === KLU_offdiag_rows ===================================================== */
+/* ========================================================================== */
+
+/* The off-diagonal blocks by rows.  If Common->offdiag_rows is TRUE,
+ * klu_factor keeps a second copy of the off-diagonal blocks, in
+ * Numeric->Rowp, Rowj, Rowi, Rowoff, Rowx and Rowvar, next to the usual
+ * compressed-column form in Offp, Offi and Offx.  The entries that do not vary
+ * are stored by rows; the varying entries given to klu_compute_path or
+ * klu_determine_start are stored after all of them, grouped by the block of
+ * their row (see KLU_offdiag_rows_pattern).  Two things change:
+ *
+ *  (1) klu_partial_factorization_path and klu_partial_refactorization_restart
+ *      write the new values of the varying entries to one contiguous range of
+ *      Rowx, in the order in which they are read from A.
+ *
+ *  (2) klu_solve computes the off-diagonal part of each block row as a
+ *      product of a sparse matrix in compressed-row form with the part of the
+ *      solution already known, just before the block is solved, instead of
+ *      scattering each solved column into the rows above it.  Each row is
+ *      accumulated in a scalar, and X is only read.
+ *
+ * The compressed-column form is kept up to date as well, for klu_tsolve,
+ * klu_extract, and the other routines that use it.  The arrays are allocated
+ * by klu_factor, or by klu_refactor if Common->offdiag_rows was set
+ * afterwards.
+ */
+
+#include "klu_internal.h"
+
+/* ========================================================================== */
+/* === KLU_offdiag_rows_values ============================================== */
+/* ========================================================================== */
+
+/* Copy all of Offx into Rowx, in the current layout */
+
+void KLU_offdiag_rows_values
+(
+    KLU_numeric *Numeric
+)
+{
+    Entry *Offx, *Rowx ;
+    Int *Rowoff ;
+    Int p, nzoff ;
+
+    nzoff = Numeric->nzoff ;
+    Offx = (Entry *) Numeric->Offx ;
+    Rowx = (Entry *) Numeric->Rowx ;
+    Rowoff = Numeric->Rowoff ;
+    for (p = 0 ; p < nzoff ; p++)
+    {
+        Rowx [p] = Offx [Rowoff [p]] ;
+    }
+    Numeric->rows_stale = FALSE ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_offdiag_rows ===================================================== */
+/* ========================================================================== */
+
+/* Build the rows after a full factorization or refactorization.  Allocates
+ * the arrays if needed.  Returns FALSE if out of memory. */
+
+Int KLU_offdiag_rows
+(
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    KLU_common *Common
+)
+{
+    Int n, nzoff, nblocks ;
+
+    n = Numeric->n ;
+    nzoff = Numeric->nzoff ;
+    nblocks = Numeric->nblocks ;
+
+    if (Numeric->Rowp == NULL)
+    {
+        Numeric->Rowp = KLU_malloc (n+1, sizeof (Int), Common) ;
+        Numeric->Rowj = KLU_malloc (nzoff+1, sizeof (Int), Common) ;
+        Numeric->Rowi = KLU_malloc (nzoff+1, sizeof (Int), Common) ;
+        Numeric->Rowoff = KLU_malloc (nzoff+1, sizeof (Int), Common) ;
+        Numeric->Rowx = KLU_malloc (nzoff+1, sizeof (Entry), Common) ;
+        Numeric->Rowvar = KLU_malloc (nblocks+1, sizeof (Int), Common) ;
+        if (Common->status < KLU_OK)
+        {
+            /* out of memory */
+            Numeric->Rowp = KLU_free (Numeric->Rowp, n+1, sizeof (Int),
+                Common) ;
+            Numeric->Rowj = KLU_free (Numeric->Rowj, nzoff+1, sizeof (Int),
+                Common) ;
+            Numeric->Rowi = KLU_free (Numeric->Rowi, nzoff+1, sizeof (Int),
+                Common) ;
+            Numeric->Rowoff = KLU_free (Numeric->Rowoff, nzoff+1,
+                sizeof (Int), Common) ;
+            Numeric->Rowx = KLU_free (Numeric->Rowx, nzoff+1, sizeof (Entry),
+                Common) ;
+            Numeric->Rowvar = KLU_free (Numeric->Rowvar, nblocks+1,
+                sizeof (Int), Common) ;
+            Common->status = KLU_OUT_OF_MEMORY ;
+            return (FALSE) ;
+        }
+        KLU_offdiag_rows_pattern (Symbolic, Numeric) ;
+    }
+
+    KLU_offdiag_rows_values (Numeric) ;
+    return (TRUE) ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_offdiag_rows_solve =============================================== */
+/* ========================================================================== */
+
+/* X (k1:k2-1,:) -= Off (k1:k2-1,:) * X, for the block row of the given block,
+ * with nr right-hand sides interleaved in X as in klu_solve.  The blocks
+ * after this one must already be solved. */
+
+void KLU_offdiag_rows_solve
+(
+    Int block,
+    Int k1,
+    Int k2,
+    Int nr,
+    Entry X [ ],
+    KLU_numeric *Numeric
+)
+{
+    Entry s [4], rowx ;
+    Entry *Rowx ;
+    Int *Rowp, *Rowj, *Rowi ;
+    Int i, j, p, pend, r ;
+
+    Rowp = Numeric->Rowp ;
+    Rowj = Numeric->Rowj ;
+    Rowi = Numeric->Rowi ;
+    Rowx = (Entry *) Numeric->Rowx ;
+
+    /* ---------------------------------------------------------------------- */
+    /* the entries that do not vary, row by row */
+    /* ---------------------------------------------------------------------- */
+
+    if (nr == 1)
+    {
+        for (i = k1 ; i < k2 ; i++)
+        {
+            pend = Rowp [i+1] ;
+            s [0] = X [i] ;
+            for (p = Rowp [i] ; p < pend ; p++)
+            {
+                MULT_SUB (s [0], Rowx [p], X [Rowj [p]]) ;
+            }
+            X [i] = s [0] ;
+        }
+    }
+    else
+    {
+        for (i = k1 ; i < k2 ; i++)
+        {
+            pend = Rowp [i+1] ;
+            for (r = 0 ; r < nr ; r++)
+            {
+                s [r] = X [nr*i + r] ;
+            }
+            for (p = Rowp [i] ; p < pend ; p++)
+            {
+                rowx = Rowx [p] ;
+                j = nr * Rowj [p] ;
+                for (r = 0 ; r < nr ; r++)
+                {
+                    MULT_SUB (s [r], rowx, X [j + r]) ;
+                }
+            }
+            for (r = 0 ; r < nr ; r++)
+            {
+                X [nr*i + r] = s [r] ;
+            }
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* the varying entries of the block row */
+    /* ---------------------------------------------------------------------- */
+
+    pend = Numeric->Rowvar [block+1] ;
+    for (p = Numeric->Rowvar [block] ; p < pend ; p++)
+    {
+        rowx = Rowx [p] ;
+        i = nr * Rowi [p] ;
+        j = nr * Rowj [p] ;
+        for (r = 0 ; r < nr ; r++)
+        {
+            MULT_SUB (X [i + r], rowx, X [j + r]) ;
+        }
+    }
+}
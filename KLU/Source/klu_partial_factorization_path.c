@@ -31,14 +31,14 @@ Int KLU_partial_factorization_path /* returns TRUE if successful, FALSE otherwis
         )
 {
     Entry ukk, ujk, s;
-    Entry *Offx, *Lx, *Ux, *X, *Az, *Udiag;
+    Entry *Offx, *Lx, *Ux, *X, *Az, *Udiag, *Rowx;
     double *Rs;
     double abs_pivot;
     Int *Q, *R, *Pnum, *Ui, *Li, *Pinv, *Lip, *Uip, *Llen, *Ulen;
     Unit **LUbx;
     Unit *LU;
     Int k1, k2, nk, k, block, oldcol, pend, oldrow, n, p, newrow, scale, nblocks, poff, i, j, up, ulen, llen, maxblock,
-        nzoff;
+        nzoff, vb;
 
     Int z = 0;
 
@@ -76,6 +76,9 @@ Int KLU_partial_factorization_path /* returns TRUE if successful, FALSE otherwis
         return (FALSE);
     }
 
+    /* the new factors include any klu_update since the last one */
+    Numeric->nupdates = 0;
+
     Common->numerical_rank = EMPTY;
     Common->singular_col = EMPTY;
 
@@ -165,7 +168,34 @@ Int KLU_partial_factorization_path /* returns TRUE if successful, FALSE otherwis
     /* assemble off-diagonal blocks */
     /* ---------------------------------------------------------------------- */
 
-    if (scale <= 0)
+    if (Numeric->Rowp != NULL && !Numeric->rows_stale)
+    {
+        /* the varying entries are contiguous in the rows of the off-diagonal
+         * blocks, in the order of the list (see klu_offdiag_rows.c) */
+        Rowx = (Entry *) Numeric->Rowx + Numeric->Rowvar[0];
+        if (scale <= 0)
+        {
+            for (i = 0; i < variable_offdiag_length ; i++)
+            {
+                Rowx[i] = Az[variable_offdiag_orig_entry[i]];
+            }
+        }
+        else
+        {
+            for (i = 0; i < variable_offdiag_length ; i++)
+            {
+                SCALE_DIV_ASSIGN(Rowx[i], Az[variable_offdiag_orig_entry[i]], Rs[Ai[variable_offdiag_orig_entry[i]]]);
+                #ifdef KLU_PRINT
+                    countflops += SCALE_FLOPS;
+                #endif
+            }
+        }
+        for (i = 0; i < variable_offdiag_length ; i++)
+        {
+            Offx[variable_offdiag_perm_entry[i]] = Rowx[i];
+        }
+    }
+    else if (scale <= 0)
     {
         for (i = 0; i < variable_offdiag_length ; i++)
         {
@@ -182,6 +212,12 @@ Int KLU_partial_factorization_path /* returns TRUE if successful, FALSE otherwis
             #endif
         }
     }
+    if (Numeric->Rowp != NULL && Numeric->rows_stale)
+    {
+        /* first refactorization after klu_compute_path or
+         * klu_determine_start: gather all the values in the new layout */
+        KLU_offdiag_rows_values(Numeric);
+    }
 
     /* ---------------------------------------------------------------------- */
     /* factor each block */
@@ -193,14 +229,14 @@ Int KLU_partial_factorization_path /* returns TRUE if successful, FALSE otherwis
         /* no scaling */
         /* ------------------------------------------------------------------ */
 
-        for (i = 0 ; i < n_variable_blocks ; i++)
+        for (vb = 0 ; vb < n_variable_blocks ; vb++)
         {
 
             /* -------------------------------------------------------------- */
             /* only iterate over variable blocks */
             /* -------------------------------------------------------------- */
 
-            block = Numeric->variable_block[i];
+            block = Numeric->variable_block[vb];
 
             /* -------------------------------------------------------------- */
             /* the block is from rows/columns k1 to k2-1 */
@@ -340,14 +376,14 @@ Int KLU_partial_factorization_path /* returns TRUE if successful, FALSE otherwis
         /* scaling */
         /* ------------------------------------------------------------------ */
 
-        for (i = 0 ; i < n_variable_blocks ; i++)
+        for (vb = 0 ; vb < n_variable_blocks ; vb++)
         {
             
             /* -------------------------------------------------------------- */
             /* only iterate over variable blocks */
             /* -------------------------------------------------------------- */
 
-            block = Numeric->variable_block[i];
+            block = Numeric->variable_block[vb];
 
             /* -------------------------------------------------------------- */
             /* the block is from rows/columns k1 to k2-1 */
@@ -504,6 +540,15 @@ Int KLU_partial_factorization_path /* returns TRUE if successful, FALSE otherwis
         }
     }
 
+    /* ---------------------------------------------------------------------- */
+    /* update the rcond and rgrowth monitor, for the refactorized columns */
+    /* ---------------------------------------------------------------------- */
+
+    if (Common->monitor)
+    {
+        KLU_monitor_path(Ap, Ai, Ax, Symbolic, Numeric, FALSE, Common);
+    }
+
 #ifndef NDEBUG
     ASSERT(Numeric->Offp[n] == poff);
     ASSERT(Symbolic->nzoff == poff);
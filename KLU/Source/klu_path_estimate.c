@@ -0,0 +1,231 @@
+/* ========================================================================== */
+/* === KLU_path_estimate ==================================================== */
+/* ========================================================================== */
+
+/* Estimates the cost of a partial refactorization of one diagonal block from
+ * its ordering alone, without any numerical work.
+ *
+ * The block C is permuted symmetrically with the fill-reducing ordering Pblk,
+ * and the nonzero pattern of S = C(p,p) + C(p,p)' is used as a stand-in for
+ * the pattern of L+U.  This is exact if KLU picks diagonal pivots, which it
+ * prefers (Common->tol), and the symbolic pattern of S is structurally
+ * symmetric, as assumed by AMD.
+ *
+ * With a symmetric pattern, column k of U depends on column j < k if and only
+ * if k is an ancestor of j in the elimination tree of S.  The factorization
+ * path of a set of varying columns is thus the union of their paths to the
+ * root of the etree, and a partial refactorization computes exactly those
+ * columns of L and U.  The flop count of column k is:
+ *
+ *      (|L(:,k)|-1) divisions, plus 2*(|L(:,j)|-1) flops for each U(j,k) != 0
+ *
+ * which is the same flop model as AMD_NDIV + 2*AMD_NMULTSUBS_LU.  Note that
+ * varying entries in off-diagonal blocks are not included, since they are
+ * copied, not factorized.
+ *
+ * Takes O(|L|) time.  Returns TRUE if successful, FALSE if the inputs are
+ * invalid.
+ */
+
+#include "klu_internal.h"
+
+Int KLU_path_estimate
+(
+    /* inputs, not modified */
+    Int nk,             /* C is nk-by-nk */
+    Int Cp [ ],         /* size nk+1, column pointers of C */
+    Int Ci [ ],         /* size Cp [nk], row indices of C */
+    Int Pblk [ ],       /* size nk, fill-reducing ordering of C */
+    Int Varying [ ],    /* size nk, Varying [j] != 0 if column j of C is
+                         * varying.  May be NULL (no factorization path). */
+
+    /* outputs, not defined on input */
+    double *lnz,        /* est. nz in L, including the diagonal */
+    double *flops,      /* est. flop count of a full factorization of C */
+    double *pathlen,    /* est. # of columns on the factorization path */
+    double *pathflops,  /* est. flop count of a partial refactorization */
+
+    /* workspace, not defined on input or output */
+    Int Work [ ]        /* size 7*nk + 1 + Cp [nk] */
+)
+{
+    double lnz1, flops1, pathlen1, pathflops1, c ;
+    Int *Pinv, *Parent, *Ancestor, *Mark, *ColCount, *OnPath, *Sp, *Si ;
+    Int i, j, k, p, pend, pi, pj, inext ;
+
+    if (nk <= 0 || Cp == NULL || Ci == NULL || Pblk == NULL || Work == NULL)
+    {
+        return (FALSE) ;
+    }
+
+    Pinv     = Work ;
+    Parent   = Work + nk ;
+    Ancestor = Work + 2*nk ;
+    Mark     = Work + 3*nk ;
+    ColCount = Work + 4*nk ;
+    OnPath   = Work + 5*nk ;
+    Sp       = Work + 6*nk ;        /* size nk+1 */
+    Si       = Work + 7*nk + 1 ;    /* size nz */
+
+    for (k = 0 ; k < nk ; k++)
+    {
+        Pinv [Pblk [k]] = k ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* construct the strictly upper triangular part of S, column-wise */
+    /* ---------------------------------------------------------------------- */
+
+    /* entry (i,j) of C becomes (min(pi,pj),max(pi,pj)) in triu(S).  Duplicates
+     * (entries present in both C and C') are harmless below. */
+    for (k = 0 ; k <= nk ; k++)
+    {
+        Sp [k] = 0 ;
+    }
+    for (j = 0 ; j < nk ; j++)
+    {
+        pj = Pinv [j] ;
+        pend = Cp [j+1] ;
+        for (p = Cp [j] ; p < pend ; p++)
+        {
+            pi = Pinv [Ci [p]] ;
+            if (pi != pj)
+            {
+                Sp [MAX (pi, pj) + 1]++ ;
+            }
+        }
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        Sp [k+1] += Sp [k] ;
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        Mark [k] = Sp [k] ;
+    }
+    for (j = 0 ; j < nk ; j++)
+    {
+        pj = Pinv [j] ;
+        pend = Cp [j+1] ;
+        for (p = Cp [j] ; p < pend ; p++)
+        {
+            pi = Pinv [Ci [p]] ;
+            if (pi != pj)
+            {
+                Si [Mark [MAX (pi, pj)]++] = MIN (pi, pj) ;
+            }
+        }
+    }
+    ASSERT (Sp [nk] <= Cp [nk]) ;
+
+    /* ---------------------------------------------------------------------- */
+    /* elimination tree of S, with path compression */
+    /* ---------------------------------------------------------------------- */
+
+    for (k = 0 ; k < nk ; k++)
+    {
+        Parent [k] = EMPTY ;
+        Ancestor [k] = EMPTY ;
+        pend = Sp [k+1] ;
+        for (p = Sp [k] ; p < pend ; p++)
+        {
+            for (i = Si [p] ; i != EMPTY && i < k ; i = inext)
+            {
+                inext = Ancestor [i] ;
+                Ancestor [i] = k ;
+                if (inext == EMPTY)
+                {
+                    Parent [i] = k ;
+                }
+            }
+        }
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* column counts of L, by traversing the row subtrees */
+    /* ---------------------------------------------------------------------- */
+
+    for (k = 0 ; k < nk ; k++)
+    {
+        ColCount [k] = 1 ;
+        Mark [k] = EMPTY ;
+    }
+    for (k = 0 ; k < nk ; k++)
+    {
+        /* the pattern of row k of L is the row subtree rooted at k */
+        Mark [k] = k ;
+        pend = Sp [k+1] ;
+        for (p = Sp [k] ; p < pend ; p++)
+        {
+            for (i = Si [p] ; Mark [i] != k ; i = Parent [i])
+            {
+                ASSERT (i != EMPTY && i < k) ;
+                Mark [i] = k ;
+                ColCount [i]++ ;
+            }
+        }
+    }
+
+    lnz1 = 0 ;
+    flops1 = 0 ;
+    for (k = 0 ; k < nk ; k++)
+    {
+        c = ColCount [k] - 1 ;
+        lnz1 += ColCount [k] ;
+        flops1 += c + 2*c*c ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* factorization path: all etree ancestors of the varying columns */
+    /* ---------------------------------------------------------------------- */
+
+    pathlen1 = 0 ;
+    pathflops1 = 0 ;
+    if (Varying != NULL)
+    {
+        for (k = 0 ; k < nk ; k++)
+        {
+            OnPath [k] = (Varying [Pblk [k]] != 0) ;
+        }
+        for (k = 0 ; k < nk ; k++)
+        {
+            /* ancestors of k are all > k, so a single sweep suffices */
+            if (OnPath [k] && Parent [k] != EMPTY)
+            {
+                OnPath [Parent [k]] = TRUE ;
+            }
+        }
+
+        /* flops for refactorizing the path columns, which needs U(:,k), the
+         * row subtree of k, once more */
+        for (k = 0 ; k < nk ; k++)
+        {
+            Mark [k] = EMPTY ;
+        }
+        for (k = 0 ; k < nk ; k++)
+        {
+            if (!OnPath [k])
+            {
+                continue ;
+            }
+            pathlen1++ ;
+            pathflops1 += ColCount [k] - 1 ;
+            Mark [k] = k ;
+            pend = Sp [k+1] ;
+            for (p = Sp [k] ; p < pend ; p++)
+            {
+                for (i = Si [p] ; Mark [i] != k ; i = Parent [i])
+                {
+                    Mark [i] = k ;
+                    pathflops1 += 2 * (double) (ColCount [i] - 1) ;
+                }
+            }
+        }
+    }
+
+    if (lnz != NULL) *lnz = lnz1 ;
+    if (flops != NULL) *flops = flops1 ;
+    if (pathlen != NULL) *pathlen = pathlen1 ;
+    if (pathflops != NULL) *pathflops = pathflops1 ;
+    return (TRUE) ;
+}
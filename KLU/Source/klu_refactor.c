@@ -9,6 +9,248 @@
  */
 
 #include "klu_internal.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* ========================================================================== */
+/* === refactor_columns ===================================================== */
+/* ========================================================================== */
+
+/* Refactorizes columns c0 to c1-1 of the block from k1 to k1+nk-1, with the
+ * same pivots and pattern as before.  The off-diagonal entries of column c0
+ * start at Offx [poff].  Returns the first column (local to the block) with a
+ * zero pivot, or EMPTY if there is none.  X is zero on input and output. */
+
+static Int refactor_columns
+(
+    Int c0,
+    Int c1,
+    Int k1,
+    Int poff,
+    Int Ap [ ],
+    Int Ai [ ],
+    Entry Az [ ],
+    double Rs [ ],      /* NULL if not scaled */
+    Int Q [ ],
+    Int Pinv [ ],
+    Unit *LU,
+    Int Lip [ ],
+    Int Llen [ ],
+    Int Uip [ ],
+    Int Ulen [ ],
+    Entry Udiag [ ],
+    Entry Offx [ ],
+    Entry X [ ],
+    Int halt_if_singular
+)
+{
+    Entry ukk, ujk ;
+    Entry *Lx, *Ux ;
+    Int *Li, *Ui ;
+    Int k, p, pend, oldcol, oldrow, newrow, i, j, up, ulen, llen, singular ;
+
+    singular = EMPTY ;
+    for (k = c0 ; k < c1 ; k++)
+    {
+        /* scatter kth column of the block into workspace X */
+        oldcol = Q [k+k1] ;
+        pend = Ap [oldcol+1] ;
+        for (p = Ap [oldcol] ; p < pend ; p++)
+        {
+            oldrow = Ai [p] ;
+            newrow = Pinv [oldrow] - k1 ;
+            if (newrow < 0)
+            {
+                /* entry in off-diagonal part */
+                if (Rs == NULL)
+                {
+                    Offx [poff] = Az [p] ;
+                }
+                else
+                {
+                    SCALE_DIV_ASSIGN (Offx [poff], Az [p], Rs [oldrow]) ;
+                }
+                poff++ ;
+            }
+            else if (Rs == NULL)
+            {
+                X [newrow] = Az [p] ;
+            }
+            else
+            {
+                SCALE_DIV_ASSIGN (X [newrow], Az [p], Rs [oldrow]) ;
+            }
+        }
+
+        /* compute kth column of U, and update kth column of A */
+        GET_POINTER (LU, Uip, Ulen, Ui, Ux, k, ulen) ;
+        for (up = 0 ; up < ulen ; up++)
+        {
+            j = Ui [up] ;
+            ujk = X [j] ;
+            CLEAR (X [j]) ;
+            Ux [up] = ujk ;
+            GET_POINTER (LU, Lip, Llen, Li, Lx, j, llen) ;
+            for (p = 0 ; p < llen ; p++)
+            {
+                MULT_SUB (X [Li [p]], Lx [p], ujk) ;
+            }
+        }
+
+        /* get the diagonal entry of U */
+        ukk = X [k] ;
+        CLEAR (X [k]) ;
+        if (IS_ZERO (ukk) && singular == EMPTY)
+        {
+            singular = k ;
+            if (halt_if_singular)
+            {
+                return (singular) ;
+            }
+        }
+        Udiag [k+k1] = ukk ;
+
+        /* gather and divide by pivot to get kth column of L */
+        GET_POINTER (LU, Lip, Llen, Li, Lx, k, llen) ;
+        for (p = 0 ; p < llen ; p++)
+        {
+            i = Li [p] ;
+            DIV (Lx [p], X [i], ukk) ;
+            CLEAR (X [i]) ;
+        }
+    }
+    return (singular) ;
+}
+
+
+/* ========================================================================== */
+/* === refactor_nd ========================================================== */
+/* ========================================================================== */
+
+/* Refactorizes a block split by nested dissection (see KLU_kernel_nd).  The
+ * domains are independent, and are refactorized in parallel if KLU is
+ * compiled with OpenMP, each with its own part of the workspace Xt.  The
+ * separators follow.  Returns FALSE if out of memory, or if the block is
+ * singular and Common->halt_if_singular is true. */
+
+static Int refactor_nd
+(
+    Int k1,
+    Int nk,
+    Int block,
+    Int Ap [ ],
+    Int Ai [ ],
+    Entry Az [ ],
+    double Rs [ ],      /* NULL if not scaled */
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    KLU_common *Common
+)
+{
+    Entry *Xt ;
+    Int *Domain, *Dstart, *Q, *Pinv, *Offp, *Lip, *Llen, *Uip, *Ulen ;
+    Unit *LU ;
+    Entry *Udiag, *Offx ;
+    Int d, k, ndom, s0, nthreads, singular, halt ;
+
+    Domain = Symbolic->Domain + k1 ;
+    Q = Symbolic->Q ;
+    Pinv = Numeric->Pinv ;
+    Offp = Numeric->Offp ;
+    Udiag = (Entry *) Numeric->Udiag ;
+    Offx = (Entry *) Numeric->Offx ;
+    Lip  = Numeric->Lip  + k1 ;
+    Llen = Numeric->Llen + k1 ;
+    Uip  = Numeric->Uip  + k1 ;
+    Ulen = Numeric->Ulen + k1 ;
+    LU = (Unit *) Numeric->LUbx [block] ;
+    halt = Common->halt_if_singular ;
+
+    ndom = 0 ;
+    for (s0 = 0 ; s0 < nk && Domain [s0] != EMPTY ; s0 = Domain [s0] - k1)
+    {
+        ndom++ ;
+    }
+#ifdef _OPENMP
+    nthreads = MAX (1, MIN (omp_get_max_threads ( ), ndom)) ;
+#else
+    nthreads = 1 ;
+#endif
+
+    Dstart = KLU_malloc (ndom+1, sizeof (Int), Common) ;
+    Xt = KLU_malloc (((size_t) nk) * nthreads, sizeof (Entry), Common) ;
+    if (Common->status < KLU_OK)
+    {
+        KLU_free (Dstart, ndom+1, sizeof (Int), Common) ;
+        KLU_free (Xt, ((size_t) nk) * nthreads, sizeof (Entry), Common) ;
+        Common->status = KLU_OUT_OF_MEMORY ;
+        return (FALSE) ;
+    }
+    for (d = 0, k = 0 ; d < ndom ; d++)
+    {
+        Dstart [d] = k ;
+        k = Domain [k] - k1 ;
+    }
+    Dstart [ndom] = s0 ;
+    for (k = 0 ; k < nk * nthreads ; k++)
+    {
+        CLEAR (Xt [k]) ;
+    }
+
+    /* the domains */
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+#endif
+    for (d = 0 ; d < ndom ; d++)
+    {
+        Int t, dsing ;
+#ifdef _OPENMP
+        t = omp_get_thread_num ( ) ;
+#else
+        t = 0 ;
+#endif
+        dsing = refactor_columns (Dstart [d], Dstart [d+1], k1,
+            Offp [k1 + Dstart [d]], Ap, Ai, Az, Rs, Q, Pinv, LU, Lip, Llen,
+            Uip, Ulen, Udiag, Offx, Xt + ((size_t) nk) * t, halt) ;
+        if (dsing != EMPTY)
+        {
+#ifdef _OPENMP
+            #pragma omp critical (klu_refactor_nd)
+#endif
+            {
+                if (Common->numerical_rank == EMPTY
+                    || dsing + k1 < Common->numerical_rank)
+                {
+                    Common->numerical_rank = dsing + k1 ;
+                    Common->singular_col = Q [dsing + k1] ;
+                }
+            }
+        }
+    }
+
+    /* the separators, unless a domain stopped early */
+    singular = (Common->numerical_rank != EMPTY) ;
+    if (!(singular && halt))
+    {
+        singular = refactor_columns (s0, nk, k1, Offp [k1 + s0], Ap, Ai, Az,
+            Rs, Q, Pinv, LU, Lip, Llen, Uip, Ulen, Udiag, Offx, Xt, halt) ;
+        if (singular != EMPTY && Common->numerical_rank == EMPTY)
+        {
+            Common->numerical_rank = singular + k1 ;
+            Common->singular_col = Q [singular + k1] ;
+        }
+    }
+
+    KLU_free (Dstart, ndom+1, sizeof (Int), Common) ;
+    KLU_free (Xt, ((size_t) nk) * nthreads, sizeof (Entry), Common) ;
+    if (Common->numerical_rank != EMPTY)
+    {
+        Common->status = KLU_SINGULAR ;
+        return (!halt) ;
+    }
+    return (TRUE) ;
+}
 
 /* ========================================================================== */
 /* === KLU_refactor ========================================================= */
@@ -58,6 +300,9 @@ Int KLU_refactor        /* returns TRUE if successful, FALSE otherwise */
         return (FALSE) ;
     }
 
+    /* the new factors include any klu_update since the last one */
+    Numeric->nupdates = 0 ;
+
     Common->numerical_rank = EMPTY ;
     Common->singular_col = EMPTY ;
 
@@ -185,6 +430,22 @@ Int KLU_refactor        /* returns TRUE if successful, FALSE otherwise */
                 }
                 Udiag [k1] = s ;
 
+            }
+            else if (Symbolic->Domain != NULL
+                && Symbolic->Domain [k1] != EMPTY)
+            {
+
+                /* ---------------------------------------------------------- */
+                /* the block was split by nested dissection (ordering 5) */
+                /* ---------------------------------------------------------- */
+
+                if (!refactor_nd (k1, nk, block, Ap, Ai, Az, NULL, Symbolic,
+                    Numeric, Common))
+                {
+                    return (FALSE) ;
+                }
+                poff = Numeric->Offp [k2] ;
+
             }
             else
             {
@@ -331,6 +592,22 @@ Int KLU_refactor        /* returns TRUE if successful, FALSE otherwise */
                 }
                 Udiag [k1] = s ;
 
+            }
+            else if (Symbolic->Domain != NULL
+                && Symbolic->Domain [k1] != EMPTY)
+            {
+
+                /* ---------------------------------------------------------- */
+                /* the block was split by nested dissection (ordering 5) */
+                /* ---------------------------------------------------------- */
+
+                if (!refactor_nd (k1, nk, block, Ap, Ai, Az, Rs, Symbolic,
+                    Numeric, Common))
+                {
+                    return (FALSE) ;
+                }
+                poff = Numeric->Offp [k2] ;
+
             }
             else
             {
@@ -446,6 +723,26 @@ Int KLU_refactor        /* returns TRUE if successful, FALSE otherwise */
         }
     }
 
+    /* ---------------------------------------------------------------------- */
+    /* update the rcond and rgrowth monitor */
+    /* ---------------------------------------------------------------------- */
+
+    if (Common->monitor &&
+        !KLU_monitor_all (Ap, Ai, Ax, Symbolic, Numeric, Common))
+    {
+        return (FALSE) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* copy the off-diagonal blocks by rows */
+    /* ---------------------------------------------------------------------- */
+
+    if ((Common->offdiag_rows || Numeric->Rowp != NULL) &&
+        !KLU_offdiag_rows (Symbolic, Numeric, Common))
+    {
+        return (FALSE) ;
+    }
+
 #ifndef NDEBUG
     ASSERT (Numeric->Offp [n] == poff) ;
     ASSERT (Symbolic->nzoff == poff) ;
@@ -31,7 +31,7 @@ Int KLU_solve
     Entry *Offx, *X, *Bz, *Udiag ;
     Int *Q, *R, *Pnum, *Offp, *Offi, *Lip, *Uip, *Llen, *Ulen ;
     Unit **LUbx ;
-    Int k1, k2, nk, k, block, pend, n, p, nblocks, chunk, nr, i ;
+    Int k1, k2, nk, k, block, pend, n, p, nblocks, chunk, nr, i, rows ;
 
     /* ---------------------------------------------------------------------- */
     /* check inputs */
@@ -69,6 +69,9 @@ Int KLU_solve
     Offi = Numeric->Offi ;
     Offx = (Entry *) Numeric->Offx ;
 
+    /* use the off-diagonal blocks by rows, if they are up to date */
+    rows = (Numeric->Rowp != NULL && !Numeric->rows_stale) ;
+
     Lip  = Numeric->Lip ;
     Llen = Numeric->Llen ;
     Uip  = Numeric->Uip ;
@@ -216,6 +219,12 @@ Int KLU_solve
             nk = k2 - k1 ;
             PRINTF (("solve %d, k1 %d k2-1 %d nk %d\n", block, k1,k2-1,nk)) ;
 
+            /* the off-diagonal part of the block row, by rows */
+            if (rows)
+            {
+                KLU_offdiag_rows_solve (block, k1, k2, nr, X, Numeric) ;
+            }
+
             /* solve the block system */
             if (nk == 1)
             {
@@ -259,7 +268,7 @@ Int KLU_solve
             /* block back-substitution for the off-diagonal-block entries */
             /* -------------------------------------------------------------- */
 
-            if (block > 0)
+            if (block > 0 && !rows)
             {
                 switch (nr)
                 {
@@ -392,5 +401,14 @@ Int KLU_solve
 
         Bz  += d*4 ;
     }
+
+    /* ---------------------------------------------------------------------- */
+    /* apply the rank-1 updates from KLU_update, if any */
+    /* ---------------------------------------------------------------------- */
+
+    if (Numeric->nupdates > 0)
+    {
+        KLU_apply_updates (Numeric, d, nrhs, 0, (Entry *) B) ;
+    }
     return (TRUE) ;
 }
@@ -461,5 +461,18 @@ Int KLU_tsolve
 
         Bz  += d*4 ;
     }
+
+    /* ---------------------------------------------------------------------- */
+    /* apply the rank-1 updates from KLU_update, if any */
+    /* ---------------------------------------------------------------------- */
+
+    if (Numeric->nupdates > 0)
+    {
+#ifdef COMPLEX
+        KLU_apply_updates (Numeric, d, nrhs, conj_solve ? 2 : 1, (Entry *) B) ;
+#else
+        KLU_apply_updates (Numeric, d, nrhs, 1, (Entry *) B) ;
+#endif
+    }
     return (TRUE) ;
 }
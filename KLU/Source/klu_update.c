@@ -0,0 +1,309 @@
+/* ========================================================================== */
+/* === KLU_update =========================================================== */
+/* ========================================================================== */
+
+/* Rank-1 update of the factorization of A, without refactorizing it.  After
+ * KLU_update (..., u, v, ...), KLU_solve and KLU_tsolve solve with the
+ * updated matrix A + u*v.'.  A rank-k change of A (a line switching, for
+ * example) is applied as k successive rank-1 updates.
+ *
+ * The LU factors are not modified.  Instead, a product-form sequence of
+ * Sherman-Morrison corrections is kept in the Numeric object.  If A_k is the
+ * matrix after the kth update, A_k = A_(k-1) + u_k*v_k.', then
+ *
+ *      inv (A_k) = inv (A_(k-1)) - w_k * v_k.' * inv (A_(k-1)) / (1+v_k.'*w_k)
+ *
+ * where w_k = A_(k-1)\u_k.  KLU_update computes w_k with one KLU_solve, and
+ * z_k = A_(k-1).'\v_k with one KLU_tsolve (for the transposed solves), which
+ * takes O(nnz(L+U)) time.  Each later solve costs an extra O(n) per update.
+ *
+ * The number of updates is limited by Common->max_updates, and an update is
+ * rejected if it is ill-conditioned, that is, if
+ *
+ *      |1 + v.'*w| < Common->update_tol * norm (w,inf) * norm (v,inf)
+ *
+ * In both cases, the matrix is refactorized with KLU_refactor if Ap, Ai, and
+ * Ax are given (the pattern must be the same as the matrix passed to
+ * KLU_factor, and the values must already include the update), which clears
+ * all updates.  Numeric->nupdates is zero on output if this happens.  If Ap
+ * is NULL, FALSE is returned with Common->status = KLU_UPDATE_LIMIT instead,
+ * and the Numeric object is not modified.
+ *
+ * KLU_refactor, KLU_partial_factorization_path and
+ * KLU_partial_refactorization_restart also clear all updates.  KLU_rcond,
+ * KLU_condest, KLU_rgrowth and KLU_extract ignore them.
+ *
+ * The update arrays are allocated by the first KLU_update, with room for
+ * Common->max_updates updates, and are reused until the Numeric object is
+ * freed.  Later calls do not allocate any memory.
+ */
+
+#include "klu_internal.h"
+
+/* ========================================================================== */
+/* === KLU_apply_updates ==================================================== */
+/* ========================================================================== */
+
+/* Apply the updates to the solution B = inv (A_0)*B (if trans is 0),
+ * B = inv (A_0.')*B (if trans is 1), or B = inv (A_0')*B (if trans is 2, the
+ * conjugate transpose in the complex case), giving inv (A_k)*B, and so on.
+ * Called by KLU_solve and KLU_tsolve.
+ */
+
+void KLU_apply_updates
+(
+    /* inputs, not modified */
+    KLU_numeric *Numeric,
+    Int d,                  /* leading dimension of B */
+    Int nrhs,               /* number of right-hand-sides */
+    Int trans,              /* 0: A\B, 1: A.'\B, 2: A'\B */
+
+    /* input/output */
+    Entry B [ ]             /* size n*nrhs, with leading dimension d */
+)
+{
+    Entry s, t ;
+    Entry *Updu, *Updv, *Updw, *Updz, *Updg, *X, *Y, *Bz ;
+    Int n, i, j, k, nupdates ;
+
+    n = Numeric->n ;
+    nupdates = Numeric->nupdates ;
+    Updu = (Entry *) Numeric->Updu ;
+    Updv = (Entry *) Numeric->Updv ;
+    Updw = (Entry *) Numeric->Updw ;
+    Updz = (Entry *) Numeric->Updz ;
+    Updg = (Entry *) Numeric->Updg ;
+
+    for (j = 0 ; j < nrhs ; j++)
+    {
+        Bz = B + j*d ;
+        for (k = 0 ; k < nupdates ; k++)
+        {
+            /* s = -v.'*b (or -u.'*b or -u'*b), and the correction is
+             * b = b - t*w (or b = b - t*z or b = b - t*conj(z)), with
+             * t = -s/(1+v.'*w) = s*g */
+            CLEAR (s) ;
+            if (trans == 0)
+            {
+                X = Updv + k*n ;
+                Y = Updw + k*n ;
+                for (i = 0 ; i < n ; i++)
+                {
+                    MULT_SUB (s, X [i], Bz [i]) ;
+                }
+                MULT (t, s, Updg [k]) ;
+                for (i = 0 ; i < n ; i++)
+                {
+                    MULT_SUB (Bz [i], t, Y [i]) ;
+                }
+            }
+            else if (trans == 1)
+            {
+                X = Updu + k*n ;
+                Y = Updz + k*n ;
+                for (i = 0 ; i < n ; i++)
+                {
+                    MULT_SUB (s, X [i], Bz [i]) ;
+                }
+                MULT (t, s, Updg [k]) ;
+                for (i = 0 ; i < n ; i++)
+                {
+                    MULT_SUB (Bz [i], t, Y [i]) ;
+                }
+            }
+            else
+            {
+                X = Updu + k*n ;
+                Y = Updz + k*n ;
+                for (i = 0 ; i < n ; i++)
+                {
+                    MULT_SUB_CONJ (s, Bz [i], X [i]) ;
+                }
+                MULT_CONJ (t, s, Updg [k]) ;
+                for (i = 0 ; i < n ; i++)
+                {
+                    MULT_SUB_CONJ (Bz [i], t, Y [i]) ;
+                }
+            }
+        }
+    }
+}
+
+
+/* ========================================================================== */
+/* === refactor_updates ===================================================== */
+/* ========================================================================== */
+
+/* The update limit was reached: refactorize if A is given, or give up */
+
+static Int refactor_updates
+(
+    Int Ap [ ],
+    Int Ai [ ],
+    double Ax [ ],
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    KLU_common *Common
+)
+{
+    if (Ap == NULL || Ai == NULL || Ax == NULL)
+    {
+        Common->status = KLU_UPDATE_LIMIT ;
+        return (FALSE) ;
+    }
+    /* KLU_refactor clears Numeric->nupdates */
+    return (KLU_refactor (Ap, Ai, Ax, Symbolic, Numeric, Common)) ;
+}
+
+
+/* ========================================================================== */
+/* === KLU_update =========================================================== */
+/* ========================================================================== */
+
+Int KLU_update          /* returns TRUE if successful, FALSE otherwise */
+(
+    /* inputs, not modified */
+    Int Ap [ ],         /* size n+1, column pointers of A+u*v.' (may be NULL) */
+    Int Ai [ ],         /* size nz, row indices of A+u*v.' (may be NULL) */
+    double Ax [ ],      /* size nz, numerical values of A+u*v.' (may be NULL) */
+    double u [ ],       /* size n */
+    double v [ ],       /* size n */
+    KLU_symbolic *Symbolic,
+
+    /* input/output */
+    KLU_numeric *Numeric,
+    KLU_common  *Common
+)
+{
+    Entry s, g ;
+    Entry *Uk, *Vk, *Wk, *Zk, *Uz, *Vz ;
+    double wnorm, vnorm, snorm, a ;
+    Int n, i, k, maxupdates ;
+    size_t s1 ;
+    Int ok = TRUE ;
+
+    /* ---------------------------------------------------------------------- */
+    /* check inputs */
+    /* ---------------------------------------------------------------------- */
+
+    if (Common == NULL)
+    {
+        return (FALSE) ;
+    }
+    if (Numeric == NULL || Symbolic == NULL || u == NULL || v == NULL)
+    {
+        Common->status = KLU_INVALID ;
+        return (FALSE) ;
+    }
+    Common->status = KLU_OK ;
+
+    n = Symbolic->n ;
+    Uz = (Entry *) u ;
+    Vz = (Entry *) v ;
+
+    /* ---------------------------------------------------------------------- */
+    /* allocate the update arrays, if not yet done */
+    /* ---------------------------------------------------------------------- */
+
+    if (Numeric->maxupdates == 0 && Common->max_updates > 0)
+    {
+        maxupdates = Common->max_updates ;
+        s1 = KLU_mult_size_t (n, maxupdates, &ok) ;
+        if (!ok)
+        {
+            Common->status = KLU_TOO_LARGE ;
+            return (FALSE) ;
+        }
+        Numeric->Updu = KLU_malloc (s1, sizeof (Entry), Common) ;
+        Numeric->Updv = KLU_malloc (s1, sizeof (Entry), Common) ;
+        Numeric->Updw = KLU_malloc (s1, sizeof (Entry), Common) ;
+        Numeric->Updz = KLU_malloc (s1, sizeof (Entry), Common) ;
+        Numeric->Updg = KLU_malloc (maxupdates, sizeof (Entry), Common) ;
+        if (Common->status < KLU_OK)
+        {
+            KLU_free (Numeric->Updu, s1, sizeof (Entry), Common) ;
+            KLU_free (Numeric->Updv, s1, sizeof (Entry), Common) ;
+            KLU_free (Numeric->Updw, s1, sizeof (Entry), Common) ;
+            KLU_free (Numeric->Updz, s1, sizeof (Entry), Common) ;
+            KLU_free (Numeric->Updg, maxupdates, sizeof (Entry), Common) ;
+            Numeric->Updu = NULL ;
+            Numeric->Updv = NULL ;
+            Numeric->Updw = NULL ;
+            Numeric->Updz = NULL ;
+            Numeric->Updg = NULL ;
+            Common->status = KLU_OUT_OF_MEMORY ;
+            return (FALSE) ;
+        }
+        Numeric->maxupdates = maxupdates ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* refactorize if all updates are in use */
+    /* ---------------------------------------------------------------------- */
+
+    k = Numeric->nupdates ;
+    if (k >= MIN (Numeric->maxupdates, Common->max_updates))
+    {
+        return (refactor_updates (Ap, Ai, Ax, Symbolic, Numeric, Common)) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* w = A\u and z = A.'\v, with the current updates */
+    /* ---------------------------------------------------------------------- */
+
+    Uk = (Entry *) Numeric->Updu + k*n ;
+    Vk = (Entry *) Numeric->Updv + k*n ;
+    Wk = (Entry *) Numeric->Updw + k*n ;
+    Zk = (Entry *) Numeric->Updz + k*n ;
+    for (i = 0 ; i < n ; i++)
+    {
+        Uk [i] = Uz [i] ;
+        Vk [i] = Vz [i] ;
+        Wk [i] = Uz [i] ;
+        Zk [i] = Vz [i] ;
+    }
+
+    if (!KLU_solve (Symbolic, Numeric, n, 1, (double *) Wk, Common)
+#ifdef COMPLEX
+        || !KLU_tsolve (Symbolic, Numeric, n, 1, (double *) Zk, FALSE, Common)
+#else
+        || !KLU_tsolve (Symbolic, Numeric, n, 1, (double *) Zk, Common)
+#endif
+        )
+    {
+        return (FALSE) ;
+    }
+
+    /* ---------------------------------------------------------------------- */
+    /* check the growth of the update */
+    /* ---------------------------------------------------------------------- */
+
+    /* s = 1 + v.'*w, computed as -(-1 - v.'*w) */
+    CLEAR (s) ;
+    REAL (s) = -1 ;
+    wnorm = 0 ;
+    vnorm = 0 ;
+    for (i = 0 ; i < n ; i++)
+    {
+        MULT_SUB (s, Vk [i], Wk [i]) ;
+        ABS (a, Wk [i]) ;
+        wnorm = MAX (wnorm, a) ;
+        ABS (a, Vk [i]) ;
+        vnorm = MAX (vnorm, a) ;
+    }
+    ABS (snorm, s) ;
+
+    if (SCALAR_IS_NAN (snorm) || SCALAR_IS_NAN (wnorm) ||
+        snorm == 0 || snorm < Common->update_tol * wnorm * vnorm)
+    {
+        return (refactor_updates (Ap, Ai, Ax, Symbolic, Numeric, Common)) ;
+    }
+
+    /* g = -1/(1+v.'*w) = 1/s, since s holds -(1+v.'*w) */
+    CLEAR (g) ;
+    REAL (g) = 1 ;
+    DIV (((Entry *) Numeric->Updg) [k], g, s) ;
+
+    Numeric->nupdates = k+1 ;
+    return (TRUE) ;
+}